@@ -0,0 +1,99 @@
+/**
+ * @file binary_arch.ts
+ * @description Capability for loading ELF and Mach-O executables directly.
+ *
+ * This plays the role that bfd_arch plays in the C++ decompiler: the file is opened with
+ * LoadImageBinary and the language is taken from the file header, so a whole executable can
+ * be decompiled without first converting it to a binaryimage XML document.
+ */
+
+import { ArchitectureCapability, Architecture } from '../decompiler/architecture.js';
+import type { Writer } from '../decompiler/architecture.js';
+import { DocumentStorage, Document } from '../core/xml.js';
+import { SleighArchitecture } from './sleigh_arch.js';
+import { LoadImageBinary } from './loadimage_binary.js';
+
+// ---------------------------------------------------------------------------
+// BinaryArchitectureCapability
+// ---------------------------------------------------------------------------
+
+/**
+ * Extension for building an Architecture from an ELF or Mach-O file.
+ *
+ * This is registered as a singleton at module load time. It matches files that start with
+ * an ELF, Mach-O 64-bit or fat binary header. There is no save file format of its own.
+ */
+export class BinaryArchitectureCapability extends ArchitectureCapability {
+  constructor() {
+    super();
+    this.name = 'binary';
+  }
+
+  /**
+   * Build a BinaryArchitecture from the given file.
+   * @param filename - path to the executable
+   * @param target - language id string (if non-empty)
+   * @param estream - output stream for error messages
+   * @returns a new BinaryArchitecture instance
+   */
+  buildArchitecture(filename: string, target: string, estream: Writer | null): Architecture {
+    return new BinaryArchitecture(filename, target, estream) as any;
+  }
+
+  /**
+   * Check the file header for a recognized executable format.
+   * @param filename - path to the file to examine
+   * @returns true for ELF, Mach-O 64-bit and fat binaries
+   */
+  isFileMatch(filename: string): boolean {
+    return LoadImageBinary.isBinaryFile(filename);
+  }
+
+  /** Executables are never restored from XML */
+  isXmlMatch(_doc: Document): boolean {
+    return false;
+  }
+}
+
+// Register the singleton at module load time (mirrors C++ static initialization)
+const binaryArchitectureCapability = new BinaryArchitectureCapability();
+
+// ---------------------------------------------------------------------------
+// BinaryArchitecture
+// ---------------------------------------------------------------------------
+
+/**
+ * An Architecture that reads an ELF or Mach-O executable through LoadImageBinary.
+ */
+export class BinaryArchitecture extends SleighArchitecture {
+  /**
+   * @param fname - path to the executable
+   * @param targ - language id string
+   * @param estream - output stream for error messages
+   */
+  constructor(fname: string, targ: string, estream: Writer | null) {
+    super(fname, targ, estream ?? { write: (_s: string) => {} });
+  }
+
+  /**
+   * Build the loader, parsing the file headers and symbol tables.
+   * @param store - document storage (unused for executables)
+   */
+  protected buildLoader(store: DocumentStorage): void {
+    SleighArchitecture.collectSpecFiles(this.errorstream);
+    this.loader = new LoadImageBinary(this.getFilename());
+  }
+
+  /**
+   * Post-specification-file initialization.
+   *
+   * Once the spec file has defined the address spaces, the segments are attached to the
+   * default code space.
+   */
+  protected postSpecFile(): void {
+    super.postSpecFile();
+    if (this.loader !== null) {
+      (this.loader as LoadImageBinary).open(this as any);
+    }
+  }
+}
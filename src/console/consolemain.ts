@@ -29,6 +29,9 @@ import {
   IfaceExecutionError,
 } from './interface.js';
 import { startDecompilerLibrary, shutdownDecompilerLibrary } from './libdecomp.js';
+import { SlaCache } from '../sleigh/slacache.js';
+// Register BinaryArchitectureCapability singleton (side-effect import)
+import './binary_arch.js';
 import type { Writer } from '../util/writer.js';
 
 // Forward type declarations for not-yet-wired modules
@@ -144,8 +147,8 @@ export class IfcLoadFile extends IfaceDecompCommand {
       return;
     }
 
-    if (capa.getName() === 'xml') {
-      // If file is xml, read in loader symbols
+    if (capa.getName() === 'xml' || capa.getName() === 'binary') {
+      // If file is xml or an executable, read in loader symbols
       this.dcp.conf.readLoaderSymbols('::');
     }
 
@@ -353,6 +356,11 @@ export function main(args: string[]): number {
   let workerCount: number = 0;
   /** Enhanced display: standard C types + Ghidra GUI-style globals */
   let enhancedDisplay: boolean = false;
+  /** Per-function decompilation budget (0 = unlimited) */
+  let timeLimitMs: number = 0;
+  let heapGrowthMb: number = 0;
+  /** Directory of the persistent decompilation result cache (null = disabled) */
+  let resultCacheDir: string | null = null;
 
   {
     const extrapaths: string[] = [];
@@ -374,6 +382,20 @@ export function main(args: string[]): number {
         extrapaths.push(args[i]);
       } else if (args[i] === '--enhance') {
         enhancedDisplay = true;
+      } else if (args[i] === '--timeout') {
+        i++;
+        const n = parseInt(args[i], 10);
+        timeLimitMs = isNaN(n) ? 0 : Math.max(0, n);
+      } else if (args[i] === '--heap-budget') {
+        i++;
+        const n = parseInt(args[i], 10);
+        heapGrowthMb = isNaN(n) ? 0 : Math.max(0, n);
+      } else if (args[i] === '--sla-cache') {
+        i++;
+        SlaCache.directory = args[i];
+      } else if (args[i] === '--result-cache') {
+        i++;
+        resultCacheDir = args[i];
       }
       i += 1;
     }
@@ -437,6 +459,13 @@ export function main(args: string[]): number {
   if (enhancedDisplay) {
     (status as any).enhancedDisplay = true;
   }
+  if (timeLimitMs > 0 || heapGrowthMb > 0) {
+    (status as any).budgetLimits = { timeMs: timeLimitMs, heapGrowthMb };
+  }
+  if (resultCacheDir !== null) {
+    (status as any).resultCacheDir = resultCacheDir;
+    status.keepCommandLog();       // Commands issued are part of the cache key
+  }
 
   if (!status.done) {
     mainloop(status);
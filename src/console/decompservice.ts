@@ -0,0 +1,599 @@
+/**
+ * @file decompservice.ts
+ * @description Long-lived decompiler service that answers requests from warm Architectures.
+ *
+ * A program is loaded once: the parent builds its Architecture and load image snapshot
+ * (see worker_arch.ts), then forks N replica processes (worker_entry.ts) that restore
+ * from the snapshot and stay resident. Decompile requests go to the least loaded replica.
+ * Rename and retype requests are broadcast to every replica and recorded in a journal once
+ * they have been applied, so a replica that is restarted after a crash replays them and
+ * stays coherent. A replica the edit failed on, while others took it, is rebuilt the same way.
+ *
+ * Requests and responses are newline-delimited JSON, over stdio or a socket:
+ *   {"id":1,"method":"load","params":{"program":"p","path":"p.xml"}}
+ *   {"id":2,"method":"decompile","params":{"program":"p","function":"main","format":"packed"?}}
+ *   {"id":3,"method":"rename","params":{"program":"p","function":"main","symbol":"iVar1","name":"count"}}
+ *   {"id":4,"method":"retype","params":{"program":"p","function":"main","symbol":"count","type":"uint4"}}
+ *   {"id":5,"method":"metrics"}
+ *   {"id":6,"method":"unload","params":{"program":"p"}}
+ *   {"id":7,"method":"shutdown"}
+ * Each response is {"id":..,"result":..} or {"id":..,"error":".."}.
+ * A decompile result holds the C text in "c", or with format "packed" the markup of
+ * `print C xml` as a base64 packed token stream in "tokens" (see tokenstream.ts).
+ */
+
+import { fork, type ChildProcess } from 'child_process';
+import * as net from 'net';
+import * as readline from 'readline';
+import * as os from 'os';
+import { fileURLToPath, pathToFileURL } from 'url';
+import { dirname, resolve } from 'path';
+import type { Readable, Writable } from 'stream';
+import { startDecompilerLibrary } from './libdecomp.js';
+import {
+  buildXmlArchitectureFromFile,
+  encodeArchitectureSnapshot,
+  encodeCoreTypeTable,
+  writeSnapshotFile,
+  removeSnapshotFile,
+} from '../decompiler/worker_arch.js';
+import type { CoreTypeTable } from '../decompiler/type.js';
+import type { Writer } from '../util/writer.js';
+
+const __filename = fileURLToPath(import.meta.url);
+const __dirname = dirname(__filename);
+
+// ---------------------------------------------------------------------------
+// Latency metrics
+// ---------------------------------------------------------------------------
+
+/** Summary of request latencies for one method */
+export interface LatencySummary {
+  count: number;
+  errors: number;
+  meanMs: number;
+  p50Ms: number;
+  p95Ms: number;
+  maxMs: number;
+}
+
+/**
+ * Latency accumulator for one request method.
+ * Percentiles are computed over a ring of the most recent samples.
+ */
+export class LatencyStats {
+  private static readonly WINDOW = 1024;
+  private samples: number[] = [];
+  private next: number = 0;
+  private count: number = 0;
+  private errors: number = 0;
+  private total: number = 0;
+  private max: number = 0;
+
+  /** Record one request */
+  record(ms: number, ok: boolean): void {
+    this.count += 1;
+    if (!ok) this.errors += 1;
+    this.total += ms;
+    if (ms > this.max) this.max = ms;
+    if (this.samples.length < LatencyStats.WINDOW) {
+      this.samples.push(ms);
+    } else {
+      this.samples[this.next] = ms;
+      this.next = (this.next + 1) % LatencyStats.WINDOW;
+    }
+  }
+
+  /** Summarize everything recorded so far */
+  summary(): LatencySummary {
+    const sorted = [...this.samples].sort((a, b) => a - b);
+    const pick = (q: number): number =>
+      sorted.length === 0 ? 0 : sorted[Math.min(sorted.length - 1, Math.floor(q * sorted.length))];
+    return {
+      count: this.count,
+      errors: this.errors,
+      meanMs: this.count === 0 ? 0 : this.total / this.count,
+      p50Ms: pick(0.5),
+      p95Ms: pick(0.95),
+      maxMs: this.max,
+    };
+  }
+}
+
+// ---------------------------------------------------------------------------
+// Replicas
+// ---------------------------------------------------------------------------
+
+/** Result of running a command sequence on a replica */
+interface ReplicaOutput {
+  output: string;
+  messages: string;
+  timeMs: number;
+  success: boolean;
+  error?: string;
+}
+
+/**
+ * One resident child process holding a warm Architecture for a program.
+ */
+class WarmReplica {
+  readonly index: number;
+  private child: ChildProcess;
+  private nextId: number = 0;
+  private pending = new Map<number, { resolve: (r: ReplicaOutput) => void; reject: (e: Error) => void }>();
+  /** Resolves once the replica has restored its Architecture */
+  readonly ready: Promise<void>;
+  /** Set once the child has restored its Architecture */
+  private warm: boolean = false;
+  /** Set when the child has exited */
+  dead: boolean = false;
+
+  constructor(index: number, snapshotPath: string, coreTypes: CoreTypeTable | null, enhancedDisplay: boolean,
+              onExit: (r: WarmReplica) => void) {
+    this.index = index;
+    this.child = fork(resolve(__dirname, '../decompiler/worker_entry.ts'), [], {
+      stdio: ['pipe', 'pipe', 'pipe', 'ipc'],
+    });
+    this.child.stdout?.on('data', () => {});
+    this.child.stderr?.on('data', () => {});
+    this.ready = new Promise<void>((res, rej) => {
+      this.child.on('message', (msg: any) => {
+        if (msg.type === 'ready') {
+          this.warm = true;
+          res();
+        } else if (msg.type === 'init_error') {
+          rej(new Error(msg.error));
+        } else if (msg.type === 'output') {
+          const p = this.pending.get(msg.id);
+          if (p === undefined) return;
+          this.pending.delete(msg.id);
+          p.resolve(msg as ReplicaOutput);
+        }
+      });
+      this.child.on('exit', () => {
+        this.dead = true;
+        rej(new Error('Replica exited during initialization'));
+        for (const p of this.pending.values()) {
+          p.reject(new Error('Replica exited unexpectedly'));
+        }
+        this.pending.clear();
+        if (this.warm) onExit(this);  // Restart only replicas that initialized once
+      });
+    });
+    // Keep an unobserved init failure from becoming an unhandled rejection
+    this.ready.catch(() => {});
+    this.child.send({
+      type: 'init',
+      snapshotPath,
+      coreTypes: coreTypes ?? undefined,
+      workerId: index,
+      enhancedDisplay,
+    });
+  }
+
+  /** Number of requests sent but not yet answered */
+  load(): number {
+    return this.pending.size;
+  }
+
+  /** Run console commands; the child processes them in the order they were sent */
+  run(commands: string[]): Promise<ReplicaOutput> {
+    if (this.dead) return Promise.reject(new Error('Replica is not running'));
+    const id = this.nextId++;
+    return new Promise<ReplicaOutput>((res, rej) => {
+      this.pending.set(id, { resolve: res, reject: rej });
+      this.child.send({ type: 'run', id, commands });
+    });
+  }
+
+  shutdown(): void {
+    if (this.dead) return;
+    try { this.child.send({ type: 'shutdown' }); } catch {}
+  }
+}
+
+/**
+ * A loaded program: its snapshot file, replicas and the journal of edits.
+ */
+class WarmProgram {
+  readonly name: string;
+  readonly path: string;
+  private snapshotPath: string;
+  private coreTypes: CoreTypeTable | null;
+  private enhancedDisplay: boolean;
+  private replicas: WarmReplica[] = [];
+  /** Mutating command sequences applied so far, replayed onto restarted replicas */
+  private journal: string[][] = [];
+  private closed: boolean = false;
+
+  constructor(name: string, path: string, snapshotPath: string, coreTypes: CoreTypeTable | null,
+              count: number, enhancedDisplay: boolean) {
+    this.name = name;
+    this.path = path;
+    this.snapshotPath = snapshotPath;
+    this.coreTypes = coreTypes;
+    this.enhancedDisplay = enhancedDisplay;
+    for (let i = 0; i < count; ++i) {
+      this.replicas.push(this.spawn(i));
+    }
+  }
+
+  private spawn(index: number): WarmReplica {
+    const replica = new WarmReplica(index, this.snapshotPath, this.coreTypes, this.enhancedDisplay,
+                                    r => this.restart(r));
+    for (const edit of this.journal) {
+      replica.ready.then(() => replica.run(edit)).catch(() => {});
+    }
+    return replica;
+  }
+
+  private restart(dead: WarmReplica): void {
+    if (this.closed) return;
+    const pos = this.replicas.indexOf(dead);
+    if (pos >= 0) this.replicas[pos] = this.spawn(dead.index);
+  }
+
+  /** Replace the replica at the given index with a fresh one, which replays the journal */
+  private rebuild(index: number): void {
+    if (this.closed) return;
+    const pos = this.replicas.findIndex(r => r.index === index);
+    if (pos < 0) return;
+    const old = this.replicas[pos];
+    this.replicas[pos] = this.spawn(index);
+    old.shutdown();     // No longer listed, so its exit does not restart it again
+  }
+
+  /** Wait until every replica has restored its Architecture */
+  async waitReady(): Promise<void> {
+    await Promise.all(this.replicas.map(r => r.ready));
+  }
+
+  /** Run a read-only request on the least loaded live replica */
+  async query(commands: string[]): Promise<ReplicaOutput> {
+    let best: WarmReplica | null = null;
+    for (const r of this.replicas) {
+      if (r.dead) continue;
+      if (best === null || r.load() < best.load()) best = r;
+    }
+    if (best === null) throw new Error('No live replica for ' + this.name);
+    await best.ready;
+    return best.run(commands);
+  }
+
+  /**
+   * Apply a mutating request to every replica and record it for restarts.
+   * If it failed everywhere, nothing changed and nothing is recorded. If it was applied on
+   * some replicas only, it is recorded and the others are rebuilt from the journal.
+   */
+  async mutate(commands: string[]): Promise<ReplicaOutput> {
+    const targets = [...this.replicas];
+    const settled = await Promise.allSettled(targets.map(async r => {
+      await r.ready;
+      return r.run(commands);
+    }));
+    const outs = settled.map(st => st.status === 'fulfilled' ? st.value : null);
+    const applied = outs.find(o => o !== null && o.success);
+    if (applied === undefined) {
+      const failed = outs.find(o => o !== null);
+      if (failed !== undefined) return failed;
+      throw (settled[0] as PromiseRejectedResult).reason;
+    }
+    this.journal.push(commands);
+    targets.forEach((r, k) => {
+      const o = outs[k];
+      if (o === null || !o.success) this.rebuild(r.index);
+    });
+    return applied;
+  }
+
+  replicaCount(): number {
+    return this.replicas.length;
+  }
+
+  close(): void {
+    this.closed = true;
+    for (const r of this.replicas) r.shutdown();
+    removeSnapshotFile(this.snapshotPath);
+  }
+}
+
+// ---------------------------------------------------------------------------
+// DecompService
+// ---------------------------------------------------------------------------
+
+/** A single framed request */
+export interface ServiceRequest {
+  id?: number | string;
+  method: string;
+  params?: any;
+}
+
+/** A single framed response */
+export interface ServiceResponse {
+  id?: number | string;
+  result?: any;
+  error?: string;
+}
+
+/**
+ * Resident decompiler service keeping warm Architectures for each loaded program.
+ */
+export class DecompService {
+  private programs = new Map<string, WarmProgram>();
+  private stats = new Map<string, LatencyStats>();
+  private replicasPerProgram: number;
+  private log: Writer | null;
+  private started: number = Date.now();
+  /** Called after a shutdown request has been answered */
+  onShutdown: (() => void) | null = null;
+
+  /**
+   * @param replicasPerProgram number of warm Architectures kept per program
+   * @param log optional writer for service diagnostics
+   */
+  constructor(replicasPerProgram?: number, log?: Writer) {
+    this.replicasPerProgram = replicasPerProgram ?? Math.max(1, Math.min(4, os.cpus().length - 1));
+    this.log = log ?? null;
+  }
+
+  /** Load a program from an XML export and bring up its replicas */
+  async load(program: string, path: string, enhancedDisplay: boolean = false): Promise<any> {
+    if (this.programs.has(program)) {
+      throw new Error('Program already loaded: ' + program);
+    }
+    const conf = buildXmlArchitectureFromFile(path, { write: () => {} });
+    let coreTypes: CoreTypeTable | null = null;
+    try {
+      coreTypes = encodeCoreTypeTable(conf);
+    } catch (err: any) {
+      this.writeLog(`${program}: replicas use the default core types: ${err.explain ?? err.message}\n`);
+    }
+    const snapshotPath = writeSnapshotFile(encodeArchitectureSnapshot(conf));
+    const warm = new WarmProgram(program, path, snapshotPath, coreTypes,
+                                 this.replicasPerProgram, enhancedDisplay);
+    this.programs.set(program, warm);
+    try {
+      await warm.waitReady();
+    } catch (err) {
+      this.programs.delete(program);
+      warm.close();
+      throw err;
+    }
+    this.writeLog(`Loaded ${program} (${warm.replicaCount()} replicas)\n`);
+    return { program, replicas: warm.replicaCount() };
+  }
+
+  /** Drop a program and its replicas */
+  unload(program: string): any {
+    const warm = this.getProgram(program);
+    warm.close();
+    this.programs.delete(program);
+    return { program };
+  }
+
+  /** Decompile a function and return its C text, or its packed token stream */
+  async decompile(program: string, func: string, format: string = 'c'): Promise<any> {
+    if (format !== 'c' && format !== 'packed') {
+      throw new Error('Unknown output format: ' + format);
+    }
+    const packed = format === 'packed';
+    const out = await this.getProgram(program).query([
+      `load function ${token(func)}`,
+      'decompile',
+      packed ? 'print C packed' : 'print C',
+    ]);
+    if (packed) return this.unwrap(out, { function: func, tokens: out.output.trim() });
+    return this.unwrap(out, { function: func, c: out.output });
+  }
+
+  /** Rename a symbol in the scope of a function */
+  async rename(program: string, func: string, symbol: string, name: string): Promise<any> {
+    const out = await this.getProgram(program).mutate([
+      `load function ${token(func)}`,
+      `rename ${token(symbol)} ${token(name)}`,
+    ]);
+    return this.unwrap(out, { function: func, symbol, name });
+  }
+
+  /** Change the data-type of a symbol in the scope of a function */
+  async retype(program: string, func: string, symbol: string, decl: string): Promise<any> {
+    const out = await this.getProgram(program).mutate([
+      `load function ${token(func)}`,
+      `retype ${token(symbol)} ${line(decl)}`,
+    ]);
+    return this.unwrap(out, { function: func, symbol, type: decl });
+  }
+
+  /** Latency summaries per method, plus loaded programs */
+  metrics(): any {
+    const methods: Record<string, LatencySummary> = {};
+    for (const [name, st] of this.stats) {
+      methods[name] = st.summary();
+    }
+    const programs: Record<string, any> = {};
+    for (const [name, warm] of this.programs) {
+      programs[name] = { path: warm.path, replicas: warm.replicaCount() };
+    }
+    return {
+      uptimeMs: Date.now() - this.started,
+      rssBytes: process.memoryUsage().rss,
+      methods,
+      programs,
+    };
+  }
+
+  /** Dispatch one request, recording its latency */
+  async handle(req: ServiceRequest): Promise<ServiceResponse> {
+    const start = performance.now();
+    const p = req.params ?? {};
+    let resp: ServiceResponse;
+    try {
+      let result: any;
+      switch (req.method) {
+        case 'load':
+          result = await this.load(p.program, p.path, p.enhance === true);
+          break;
+        case 'unload':
+          result = this.unload(p.program);
+          break;
+        case 'decompile':
+          result = await this.decompile(p.program, p.function, p.format ?? 'c');
+          break;
+        case 'rename':
+          result = await this.rename(p.program, p.function, p.symbol, p.name);
+          break;
+        case 'retype':
+          result = await this.retype(p.program, p.function, p.symbol, p.type);
+          break;
+        case 'metrics':
+          result = this.metrics();
+          break;
+        case 'shutdown':
+          this.shutdown();
+          result = {};
+          break;
+        default:
+          throw new Error('Unknown method: ' + req.method);
+      }
+      resp = { id: req.id, result };
+    } catch (err: any) {
+      resp = { id: req.id, error: err.explain ?? err.message ?? String(err) };
+    }
+    let st = this.stats.get(req.method);
+    if (st === undefined) {
+      st = new LatencyStats();
+      this.stats.set(req.method, st);
+    }
+    st.record(performance.now() - start, resp.error === undefined);
+    return resp;
+  }
+
+  /**
+   * Serve newline-delimited JSON requests from a stream, writing responses to another.
+   * Requests are handled concurrently; responses carry the request id. Once the input
+   * ends and every response has been written, the output is ended.
+   * @returns a promise that resolves when the output has been ended
+   */
+  serveStream(input: Readable, output: Writable): Promise<void> {
+    const rl = readline.createInterface({ input, terminal: false });
+    let pending = 0;
+    let inputEnded = false;
+    let finish: () => void = () => {};
+    const finished = new Promise<void>(res => { finish = res; });
+    const endIfDone = (): void => {
+      if (!inputEnded || pending > 0) return;
+      output.end();
+      finish();
+    };
+    rl.on('line', (text: string) => {
+      if (text.trim().length === 0) return;
+      let req: ServiceRequest;
+      try {
+        req = JSON.parse(text);
+      } catch {
+        output.write(JSON.stringify({ error: 'Malformed request' }) + '\n');
+        return;
+      }
+      pending++;
+      this.handle(req).then(resp => {
+        output.write(JSON.stringify(resp) + '\n');
+        pending--;
+        if (req.method === 'shutdown' && this.onShutdown !== null) this.onShutdown();
+        endIfDone();
+      });
+    });
+    rl.on('close', () => {
+      inputEnded = true;
+      endIfDone();
+    });
+    return finished;
+  }
+
+  /**
+   * Listen on a TCP port or a Unix socket path; every connection uses the same framing.
+   */
+  listen(target: number | string): net.Server {
+    const server = net.createServer(sock => { this.serveStream(sock, sock); });
+    server.listen(target);
+    return server;
+  }
+
+  /** Stop all replicas of all programs */
+  shutdown(): void {
+    for (const warm of this.programs.values()) warm.close();
+    this.programs.clear();
+  }
+
+  private getProgram(program: string): WarmProgram {
+    const warm = this.programs.get(program);
+    if (warm === undefined) throw new Error('Program not loaded: ' + program);
+    return warm;
+  }
+
+  private unwrap(out: ReplicaOutput, result: any): any {
+    if (!out.success) throw new Error(out.error ?? 'Command failed');
+    result.timeMs = out.timeMs;
+    return result;
+  }
+
+  private writeLog(msg: string): void {
+    if (this.log !== null) this.log.write(msg);
+  }
+}
+
+/** Validate a single console token (no whitespace) */
+function token(s: any): string {
+  if (typeof s !== 'string' || s.length === 0 || /\s/.test(s)) {
+    throw new Error('Invalid name: ' + String(s));
+  }
+  return s;
+}
+
+/** Validate the remainder of a console line (no line breaks) */
+function line(s: any): string {
+  if (typeof s !== 'string' || s.length === 0 || /[\r\n]/.test(s)) {
+    throw new Error('Invalid declaration: ' + String(s));
+  }
+  return s;
+}
+
+// ---------------------------------------------------------------------------
+// CLI entry point
+// ---------------------------------------------------------------------------
+
+/**
+ * Start the service: `decompservice [-s specpath] [-n replicas] [--listen port|path]`.
+ * Without --listen, requests are read from stdin and responses written to stdout.
+ */
+export function serviceMain(args: string[]): void {
+  const extrapaths: string[] = [];
+  let replicas: number | undefined;
+  let listenTarget: string | null = null;
+  for (let i = 0; i < args.length; ++i) {
+    if (args[i] === '-s') {
+      extrapaths.push(args[++i]);
+    } else if (args[i] === '-n') {
+      const n = parseInt(args[++i], 10);
+      if (!isNaN(n) && n > 0) replicas = n;
+    } else if (args[i] === '--listen') {
+      listenTarget = args[++i];
+    }
+  }
+  startDecompilerLibrary(undefined, extrapaths);
+  const log: Writer = { write: (s: string) => { process.stderr.write(s); } };
+  const service = new DecompService(replicas, log);
+  if (listenTarget !== null) {
+    const port = parseInt(listenTarget, 10);
+    const server = service.listen(isNaN(port) ? listenTarget : port);
+    service.onShutdown = () => { server.close(); process.exit(0); };
+    log.write(`Decompiler service listening on ${listenTarget}\n`);
+  } else {
+    service.onShutdown = () => process.exit(0);
+    // End of stdin is a shutdown once the last response is out
+    service.serveStream(process.stdin, process.stdout).then(() => service.shutdown());
+  }
+}
+
+if (process.argv[1] !== undefined && import.meta.url === pathToFileURL(process.argv[1]).href) {
+  serviceMain(process.argv.slice(2));
+}
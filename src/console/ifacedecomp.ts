@@ -26,7 +26,7 @@ import {
   IfcEcho,
 } from './interface.js';
 
-import { Writer } from '../util/writer.js';
+import { Writer, StringWriter } from '../util/writer.js';
 
 // ---------------------------------------------------------------------------
 // Forward type declarations for decompiler types not yet wired
@@ -34,8 +34,6 @@ import { Writer } from '../util/writer.js';
 
 type Architecture = any;
 type Funcdata = any;
-type CallGraph = any;
-type CallGraphNode = any;
 type Scope = any;
 type Symbol = any;
 type FunctionSymbol = any;
@@ -45,12 +43,19 @@ type PcodeOp = any;
 import { Address, SeqNum, Range } from '../core/address.js';
 import { AddrSpace } from '../core/space.js';
 import { OpCode } from '../core/opcodes.js';
-import { ElementId } from '../core/marshal.js';
+import { LowlevelError } from '../core/error.js';
+import { ElementId, XmlEncode, XmlDecode } from '../core/marshal.js';
+import { DocumentStorage } from '../core/xml.js';
 import { FuncProto } from '../decompiler/fspec.js';
 import { TypePointerRel, type_metatype } from '../decompiler/type.js';
+import { ActionBudget } from '../decompiler/action.js';
+import { ActionProfiler } from '../decompiler/actionprofile.js';
+import { EventTracer } from '../decompiler/eventtrace.js';
+import { ResultCache } from '../decompiler/resultcache.js';
+import { CallGraph, CallGraphNode } from '../decompiler/callgraph.js';
+import { formatHeritageStats } from '../decompiler/heritage.js';
 type Datatype = any;
 type TypeFactory = any;
-type DocumentStorage = any;
 type Document = any;
 type Element = any;
 type Encoder = any;
@@ -287,16 +292,19 @@ export class IfaceDecompData extends IfaceData {
   /** Executable environment from a datatest */
   testCollection: FunctionTestCollection | null = null;
 
+  /** Rule and Action timing collected by the `profile` command */
+  profiler: ActionProfiler | null = null;
+
+  /** Timeline collected by the `profile trace` command */
+  tracer: EventTracer | null = null;
+
   constructor() {
     super();
   }
 
   /** Allocate (or re-allocate) the call-graph object. */
   allocateCallGraph(): void {
-    this.cgraph = null; // Release old graph
-    // In a full wiring: this.cgraph = new CallGraph(this.conf);
-    // For now, leave as a no-op placeholder until CallGraph is wired.
-    throw new IfaceExecutionError('CallGraph not yet wired');
+    this.cgraph = new CallGraph(this.conf);
   }
 
   /**
@@ -531,12 +539,11 @@ export abstract class IfaceDecompCommand extends IfaceCommand {
    * Iterate over every function in the given scope, calling iterationCallback().
    */
   protected iterateFunctionsAddrOrderInScope(scope: Scope): void {
-    const miter = scope.begin();
     const menditer = scope.end();
-    let current = miter;
-    while (current !== menditer) {
-      const sym = current.getSymbol();
-      current = current.next();
+    const miter = scope.begin();
+    while (!miter.equals(menditer)) {
+      const sym = miter.deref().getSymbol();
+      miter.increment();
       // In C++ this is a dynamic_cast<FunctionSymbol*>
       if (sym !== null && typeof sym.getFunction === 'function') {
         this.iterationCallback(sym.getFunction());
@@ -1256,8 +1263,13 @@ export class IfcDecompile extends IfaceDecompCommand {
     }
 
     this.status.optr.write('Decompiling ' + this.dcp.fd.getName() + '\n');
-    this.dcp.conf.allacts.getCurrent().reset(this.dcp.fd);
-    const res: number = this.dcp.conf.allacts.getCurrent().perform(this.dcp.fd);
+    const act = this.dcp.conf.allacts.getCurrent();
+    act.reset(this.dcp.fd);
+    // Limits from --timeout / --heap-budget; an overrun surfaces as a Budget ERROR
+    const limits = (this.status as any).budgetLimits;
+    const res: number = ActionBudget.isLimited(limits)
+      ? ActionBudget.run(new ActionBudget(limits), () => act.perform(this.dcp.fd))
+      : act.perform(this.dcp.fd);
     if (res < 0) {
       this.status.optr.write('Break at ');
       this.dcp.conf.allacts.getCurrent().printState(this.status.optr);
@@ -1280,12 +1292,20 @@ export class IfcDecompile extends IfaceDecompCommand {
  * Decompile all functions in parallel: `decompile parallel [<N>]`
  *
  * Decompiles all functions in the program using parallel infrastructure.
- * Each function gets an independent clone of the action tree to avoid
- * shared mutable state corruption. An optional concurrency parameter
- * specifies how many jobs can run concurrently (default 4).
+ * Every job runs the one shared root Action, keeping its own progress in a
+ * per-job ActionJobState. The optional concurrency parameter (default 4, or the
+ * --parallel option) is the number of jobs decompileIter() keeps in flight: it
+ * decompiles up to N functions ahead of the one being printed, and each of those
+ * jobs buffers its comment writes until its function is printed. Each function is
+ * printed and released in order, so memory is bounded by N functions.
  *
  * Results are printed to the file output stream. Output is identical
  * to sequential decompilation.
+ *
+ * With the --result-cache command-line option, functions whose output is in the cache
+ * from an earlier run are printed from it without running the action tree, and new
+ * results are stored. Every command issued before this one is part of the cache key.
+ * The hit and miss counts are printed at the end.
  */
 export class IfcDecompileParallel extends IfaceDecompCommand {
   execute(s: InputStream): void {
@@ -1293,7 +1313,8 @@ export class IfcDecompileParallel extends IfaceDecompCommand {
       throw new IfaceExecutionError('No load image present');
     }
 
-    let concurrency = 4;
+    // Default concurrency comes from the --parallel command-line option
+    let concurrency = (this.status as any).parallelConcurrency ?? 4;
     if (!s.eof()) {
       const tok = s.readToken();
       const n = parseInt(tok, 10);
@@ -1317,22 +1338,55 @@ export class IfcDecompileParallel extends IfaceDecompCommand {
 
     // Import ParallelDecompiler dynamically to avoid circular imports
     const { ParallelDecompiler } = require('../decompiler/parallel.js');
-    const pd = new ParallelDecompiler(this.dcp.conf, concurrency, this.status.optr);
-
-    // Run decompilation (synchronous wrapper around async)
-    const results = this.runParallel(pd, funcs);
-
-    // Report results
+    const pd = new ParallelDecompiler(this.dcp.conf, concurrency, this.status.optr,
+                                      (this.status as any).budgetLimits);
+
+    const cacheDir: string | undefined = (this.status as any).resultCacheDir;
+    const cache = cacheDir !== undefined ? new ResultCache(cacheDir, 'decompile parallel') : null;
+
+    // Stream results in function order: cache hits are printed from the cache, the other
+    // functions go through decompileIter(), which runs up to `concurrency` of them ahead.
+    // Each result is printed and its analysis released before the next one is taken, so
+    // memory is bounded by the concurrency, not the number of functions.
+    type Pending = { text: string } | { key: string | null };
+    const pending: Pending[] = [];
+    const conf = this.dcp.conf;
+    const log = this.status.getCommandLog();
+    const misses = function* (): Generator<Funcdata> {
+      for (const fd of funcs) {
+        const key = cache !== null ? cache.keyOf(conf, fd, log) : null;
+        const hit = key !== null ? cache!.lookup(conf, key) : null;
+        if (hit !== null) {
+          pending.push({ text: hit });
+          continue;
+        }
+        pending.push({ key });
+        yield fd;
+      }
+    };
     let succeeded = 0;
     let failed = 0;
-    for (const r of results) {
+    const flushHits = (): void => {
+      while (pending.length > 0 && 'text' in pending[0]) {
+        succeeded++;
+        this.status.fileoptr.write((pending.shift() as { text: string }).text);
+      }
+    };
+    for (const r of pd.decompileIter(misses())) {
+      flushHits();
+      const key = (pending.shift() as { key: string | null }).key;
       if (r.success) {
         succeeded++;
-        // Print the decompiled C for each successful function
         if (r.funcdata && !r.funcdata.hasNoCode() && r.funcdata.isProcComplete()) {
           try {
-            this.dcp.conf.print.setOutputStream(this.status.fileoptr);
+            const buf = key !== null ? new StringWriter() : null;
+            this.dcp.conf.print.setOutputStream(buf ?? this.status.fileoptr);
             this.dcp.conf.print.docFunction(r.funcdata);
+            if (buf !== null) {
+              const text = buf.toString();
+              this.status.fileoptr.write(text);
+              cache!.store(key!, ResultCache.describe(this.dcp.conf, r.funcdata), text);
+            }
           } catch (_err) {
             // Printing may fail for some functions
           }
@@ -1341,20 +1395,18 @@ export class IfcDecompileParallel extends IfaceDecompCommand {
         failed++;
         this.status.optr.write(`FAILED: ${r.name}: ${r.error}\n`);
       }
-    }
-
-    this.status.optr.write(`\nParallel decompile complete: ${succeeded} succeeded, ${failed} failed\n`);
-
-    // Clean up analysis for all functions
-    for (const r of results) {
       if (r.funcdata) {
         try {
-          this.dcp.conf.clearAnalysis(r.funcdata);
+          this.dcp.conf.releaseAnalysis(r.funcdata);
         } catch (_e) {
           // Best-effort cleanup
         }
       }
     }
+    flushHits();
+
+    this.status.optr.write(`\nParallel decompile complete: ${succeeded} succeeded, ${failed} failed\n`);
+    if (cache !== null) this.status.optr.write(cache.formatStats() + '\n');
   }
 
   private collectAllFunctions(funcs: Funcdata[]): void {
@@ -1364,12 +1416,9 @@ export class IfcDecompileParallel extends IfaceDecompCommand {
 
   private collectFromScope(scope: Scope, funcs: Funcdata[]): void {
     if (!scope.isGlobal()) return;
-    const miter = scope.begin();
     const menditer = scope.end();
-    let current = miter;
-    while (current !== menditer) {
-      const sym = current.getSymbol();
-      current = current.next();
+    for (const miter = scope.begin(); !miter.equals(menditer); miter.increment()) {
+      const sym = miter.deref().getSymbol();
       if (sym !== null && typeof sym.getFunction === 'function') {
         const fd = sym.getFunction();
         if (fd && !fd.hasNoCode()) {
@@ -1381,40 +1430,6 @@ export class IfcDecompileParallel extends IfaceDecompCommand {
       this.collectFromScope(child, funcs);
     }
   }
-
-  private runParallel(pd: any, funcs: Funcdata[]): any[] {
-    // Since we're in a synchronous context, we need to handle the async
-    // ParallelDecompiler. With concurrency=1, it's purely sequential.
-    // For higher concurrency, the actual parallelism depends on the runtime.
-    let results: any[] = [];
-
-    // Synchronous fallback: decompile each function with a cloned action tree
-    for (const fd of funcs) {
-      const clonedAction = this.dcp.conf.allacts.cloneCurrentAction();
-      const name = fd.getName();
-      try {
-        this.dcp.conf.clearAnalysis(fd);
-        clonedAction.reset(fd);
-        clonedAction.perform(fd);
-        results.push({
-          funcdata: fd,
-          name,
-          success: true,
-          actionCount: 0,
-        });
-      } catch (err: any) {
-        results.push({
-          funcdata: fd,
-          name,
-          success: false,
-          error: err.explain ?? err.message ?? String(err),
-          actionCount: 0,
-        });
-      }
-    }
-
-    return results;
-  }
 }
 
 // ---------------------------------------------------------------------------
@@ -1491,9 +1506,39 @@ export class IfcPrintCXml extends IfaceDecompCommand {
     this.dcp.conf.print.setOutputStream(this.status.fileoptr);
     this.dcp.conf.print.setMarkup(true);
     this.dcp.conf.print.setPackedOutput(false);
-    this.dcp.conf.print.docFunction(this.dcp.fd);
-    this.status.fileoptr.write('\n');
-    this.dcp.conf.print.setMarkup(false);
+    try {
+      this.dcp.conf.print.docFunction(this.dcp.fd);
+      this.status.fileoptr.write('\n');
+    } finally {
+      this.dcp.conf.print.setMarkup(false);
+    }
+  }
+}
+
+// ---------------------------------------------------------------------------
+// IfcPrintCPacked
+// ---------------------------------------------------------------------------
+
+/**
+ * Print the current function as a packed token stream: `print C packed`
+ *
+ * The output is the markup of `print C xml` as one line of base64 encoded binary tokens
+ * (see tokenstream.ts, whose decodeTokenStream() reads it back).
+ */
+export class IfcPrintCPacked extends IfaceDecompCommand {
+  execute(_s: InputStream): void {
+    if (this.dcp.fd === null) {
+      throw new IfaceExecutionError('No function selected');
+    }
+
+    this.dcp.conf.print.setOutputStream(this.status.fileoptr);
+    this.dcp.conf.print.setTokenOutput(true);
+    try {
+      this.dcp.conf.print.docFunction(this.dcp.fd);
+      this.status.fileoptr.write('\n');
+    } finally {
+      this.dcp.conf.print.setTokenOutput(false);
+    }
   }
 }
 
@@ -1564,6 +1609,26 @@ export class IfcPrintRaw extends IfaceDecompCommand {
   }
 }
 
+// ---------------------------------------------------------------------------
+// IfcPrintHeritageStats
+// ---------------------------------------------------------------------------
+
+/**
+ * Print how much work heritage did for the current function: `print heritagestats`
+ *
+ * Shows the passes run, and how many Varnodes and blocks the incremental passes
+ * were able to skip.
+ */
+export class IfcPrintHeritageStats extends IfaceDecompCommand {
+  execute(_s: InputStream): void {
+    if (this.dcp.fd === null) {
+      throw new IfaceExecutionError('No function selected');
+    }
+
+    this.status.fileoptr.write(formatHeritageStats(this.dcp.fd.getHeritageStats()));
+  }
+}
+
 // ---------------------------------------------------------------------------
 // Graph-related commands (stubs)
 // ---------------------------------------------------------------------------
@@ -1596,61 +1661,210 @@ export class IfcGraphDom extends IfaceDecompCommand {
 }
 
 // ---------------------------------------------------------------------------
-// CallGraph-related commands (stubs)
+// CallGraph-related commands
 // ---------------------------------------------------------------------------
 
 /**
- * Stub: Dump the call-graph: `callgraph dump`
+ * Write the current call-graph to a file: `callgraph dump <filename>`
+ *
+ * The graph is encoded as XML and can be read back with `callgraph load`.
  */
 export class IfcCallGraphDump extends IfaceDecompCommand {
-  execute(_s: InputStream): void {
-    throw new IfaceExecutionError('CallGraph commands not yet wired');
+  execute(s: InputStream): void {
+    if (this.dcp.cgraph === null) {
+      throw new IfaceExecutionError('No callgraph has been built');
+    }
+
+    const name = s.readToken();
+    if (name.length === 0) {
+      throw new IfaceParseError('Need file name to write callgraph to');
+    }
+
+    const encoder = new XmlEncode(false);
+    this.dcp.cgraph.encode(encoder);
+    try {
+      const fs = require('fs');
+      fs.writeFileSync(name, encoder.toString());
+    } catch (_e) {
+      throw new IfaceExecutionError('Unable to open file ' + name);
+    }
+    this.status.optr.write('Successfully saved callgraph to ' + name + '\n');
   }
 }
 
 /**
- * Stub: Build the call-graph: `callgraph build`
+ * Build the call-graph for the whole program: `callgraph build`
+ *
+ * Every function is decompiled, in address order, and the call sites it recovers
+ * become the edges of the graph.
  */
 export class IfcCallGraphBuild extends IfaceDecompCommand {
+  /** True if call sites are recovered from flow alone, without decompiling */
   protected quick: boolean = false;
 
   execute(_s: InputStream): void {
-    throw new IfaceExecutionError('CallGraph commands not yet wired');
+    this.dcp.allocateCallGraph();
+    this.dcp.cgraph.buildAllNodes();     // Build a node in the graph for existing symbols
+    this.quick = false;
+    this.iterateFunctionsAddrOrder();
+    this.status.optr.write('Successfully built callgraph\n');
   }
 
-  iterationCallback(_fd: Funcdata): void {
-    // stub
+  iterationCallback(fd: Funcdata): void {
+    if (fd.hasNoCode()) {
+      this.status.optr.write('No code for ' + fd.getName() + '\n');
+      return;
+    }
+    if (this.quick) {
+      this.dcp.fd = fd;
+      this.dcp.followFlow(this.status.optr, 0);
+    } else {
+      try {
+        this.dcp.conf.clearAnalysis(fd);
+        this.dcp.conf.allacts.getCurrent().reset(fd);
+        const start = performance.now();
+        this.dcp.conf.allacts.getCurrent().perform(fd);
+        const duration = performance.now() - start;
+        this.status.optr.write('Decompiled ' + fd.getName() + '(' + duration.toFixed(0) + ')\n');
+      } catch (err: any) {
+        if (!(err instanceof LowlevelError)) throw err;
+        this.status.optr.write('Skipping ' + fd.getName() + ': ' + err.explain + '\n');
+      }
+    }
+    this.dcp.cgraph.buildEdges(fd);
+    this.dcp.conf.releaseAnalysis(fd);
   }
 }
 
 /**
- * Stub: Build the call-graph quickly: `callgraph build quick`
+ * Build the call-graph using only flow analysis: `callgraph build quick`
+ *
+ * Call sites are found by following control-flow in each function, which is much
+ * faster than full decompilation but misses indirect calls that only data-flow resolves.
  */
 export class IfcCallGraphBuildQuick extends IfcCallGraphBuild {
   execute(_s: InputStream): void {
-    throw new IfaceExecutionError('CallGraph commands not yet wired');
+    this.dcp.allocateCallGraph();
+    this.dcp.cgraph.buildAllNodes();
+    this.quick = true;
+    this.iterateFunctionsAddrOrder();
+    this.status.optr.write('Successfully built callgraph\n');
   }
 }
 
 /**
- * Stub: Load a call-graph from file: `callgraph load`
+ * Read a call-graph from a file: `callgraph load <filename>`
+ *
+ * The file must have been produced by `callgraph dump`, and every function it names
+ * must already be present in the current program.
  */
 export class IfcCallGraphLoad extends IfaceDecompCommand {
-  execute(_s: InputStream): void {
-    throw new IfaceExecutionError('CallGraph commands not yet wired');
+  execute(s: InputStream): void {
+    if (this.dcp.cgraph !== null) {
+      throw new IfaceExecutionError('Callgraph already loaded');
+    }
+
+    const name = s.readToken();
+    if (name.length === 0) {
+      throw new IfaceExecutionError('Need name of file to read callgraph from');
+    }
+
+    try {
+      const fs = require('fs');
+      fs.accessSync(name, fs.constants.R_OK);
+    } catch (_e) {
+      throw new IfaceExecutionError('Unable to open callgraph file ' + name);
+    }
+
+    const store = new DocumentStorage();
+    const doc = store.openDocumentStream(name);
+
+    this.dcp.allocateCallGraph();
+    const decoder = new XmlDecode(this.dcp.conf, doc.getRoot());
+    this.dcp.cgraph.decoder(decoder);
+    this.status.optr.write('Successfully read in callgraph\n');
+
+    const gscope: Scope = this.dcp.conf.symboltab.getGlobalScope();
+    for (const node of this.dcp.cgraph.nodes()) {
+      const fd: Funcdata | null = gscope.queryFunction(node.getName());
+      if (fd === null) {
+        throw new IfaceExecutionError('Function:' + node.getName() + ' in callgraph has not been loaded');
+      }
+      node.setFuncdata(fd);
+    }
+
+    this.status.optr.write('Successfully associated functions with callgraph nodes\n');
   }
 }
 
 /**
- * Stub: List call-graph information: `callgraph list`
+ * List all functions in leaf order: `callgraph list`
+ *
+ * Callees are listed before the functions that call them.
  */
 export class IfcCallGraphList extends IfaceDecompCommand {
   execute(_s: InputStream): void {
-    throw new IfaceExecutionError('CallGraph commands not yet wired');
+    if (this.dcp.cgraph === null) {
+      throw new IfaceExecutionError('Callgraph not generated');
+    }
+    this.iterateFunctionsLeafOrder();
   }
 
-  iterationCallback(_fd: Funcdata): void {
-    // stub
+  iterationCallback(fd: Funcdata): void {
+    this.status.optr.write(fd.getName() + '\n');
+  }
+}
+
+/**
+ * Decompile the whole program bottom-up along the call-graph: `callgraph decompile`
+ *
+ * Strongly connected components of the call-graph are decompiled callees first, and
+ * the prototype recovered for each function is locked before any of its callers are
+ * decompiled, so call sites see the callee's real parameters and return value. If no
+ * call-graph has been built or loaded, one is built from flow first. Output is printed
+ * and released per function, as with `decompile parallel`.
+ */
+export class IfcCallGraphDecompile extends IfaceDecompCommand {
+  execute(_s: InputStream): void {
+    if (this.dcp.conf === null) {
+      throw new IfaceExecutionError('No load image present');
+    }
+    if (this.dcp.cgraph === null) {
+      this.dcp.allocateCallGraph();
+      this.dcp.cgraph.buildFromFlow();
+      this.status.optr.write('Successfully built callgraph\n');
+    }
+
+    // Import ParallelDecompiler dynamically to avoid circular imports
+    const { ParallelDecompiler } = require('../decompiler/parallel.js');
+    const pd = new ParallelDecompiler(this.dcp.conf, 1, this.status.optr,
+                                      (this.status as any).budgetLimits);
+
+    let succeeded = 0;
+    let failed = 0;
+    for (const r of pd.decompileBottomUp(this.dcp.cgraph)) {
+      if (r.success) {
+        succeeded++;
+        if (!r.funcdata.hasNoCode() && r.funcdata.isProcComplete()) {
+          try {
+            this.dcp.conf.print.setOutputStream(this.status.fileoptr);
+            this.dcp.conf.print.docFunction(r.funcdata);
+          } catch (_err) {
+            // Printing may fail for some functions
+          }
+        }
+      } else {
+        failed++;
+        this.status.optr.write(`FAILED: ${r.name}: ${r.error}\n`);
+      }
+      try {
+        this.dcp.conf.releaseAnalysis(r.funcdata);
+      } catch (_e) {
+        // Best-effort cleanup
+      }
+    }
+
+    this.status.optr.write(`\nBottom-up decompile complete: ${succeeded} succeeded, ${failed} failed\n`);
   }
 }
 
@@ -1739,19 +1953,22 @@ export class IfaceDecompCapability extends IfaceCapability {
     status.registerCom(new IfcPrintCGlobals(), 'print', 'C', 'globals');
     status.registerCom(new IfcPrintCTypes(), 'print', 'C', 'types');
     status.registerCom(new IfcPrintCXml(), 'print', 'C', 'xml');
+    status.registerCom(new IfcPrintCPacked(), 'print', 'C', 'packed');
     status.registerCom(new IfcPrintRaw(), 'print', 'raw');
+    status.registerCom(new IfcPrintHeritageStats(), 'print', 'heritagestats');
 
     // Graph commands (stubs)
     status.registerCom(new IfcGraphDataflow(), 'graph', 'dataflow');
     status.registerCom(new IfcGraphControlflow(), 'graph', 'controlflow');
     status.registerCom(new IfcGraphDom(), 'graph', 'dom');
 
-    // CallGraph commands (stubs)
+    // CallGraph commands
     status.registerCom(new IfcCallGraphBuild(), 'callgraph', 'build');
     status.registerCom(new IfcCallGraphBuildQuick(), 'callgraph', 'build', 'quick');
     status.registerCom(new IfcCallGraphDump(), 'callgraph', 'dump');
     status.registerCom(new IfcCallGraphLoad(), 'callgraph', 'load');
     status.registerCom(new IfcCallGraphList(), 'callgraph', 'list');
+    status.registerCom(new IfcCallGraphDecompile(), 'callgraph', 'decompile');
 
     // Part 2 commands
     status.registerCom(new IfcForcegoto(), 'force', 'goto');
@@ -1790,6 +2007,7 @@ export class IfaceDecompCapability extends IfaceCapability {
     status.registerCom(new IfcPrintExtrapop(), 'print', 'extrapop');
     status.registerCom(new IfcPrintActionstats(), 'print', 'actionstats');
     status.registerCom(new IfcResetActionstats(), 'reset', 'actionstats');
+    status.registerCom(new IfcProfile(), 'profile');
     status.registerCom(new IfcCountPcode(), 'count', 'pcode');
     status.registerCom(new IfcTypeVarnode(), 'type', 'varnode');
     status.registerCom(new IfcNameVarnode(), 'name', 'varnode');
@@ -3153,7 +3371,7 @@ export class IfcPrintInputsAll extends IfaceDecompCommand {
     } catch (err: any) {
       this.status.optr.write('Skipping ' + fd.getName() + ': ' + (err.explain ?? err.message) + '\n');
     }
-    this.dcp.conf.clearAnalysis(fd);
+    this.dcp.conf.releaseAnalysis(fd);
   }
 }
 
@@ -3302,7 +3520,7 @@ export class IfcProduceC extends IfaceDecompCommand {
     } catch (err: any) {
       this.status.optr.write('Skipping ' + fd.getName() + ': ' + (err.explain ?? err.message) + '\n');
     }
-    this.dcp.conf.clearAnalysis(fd);
+    this.dcp.conf.releaseAnalysis(fd);
   }
 }
 
@@ -3727,6 +3945,103 @@ export class IfcResetActionstats extends IfaceDecompCommand {
   }
 }
 
+// ---------------------------------------------------------------------------
+// IfcProfile
+// ---------------------------------------------------------------------------
+
+/**
+ * Time Actions and Rules across decompilations: `profile on|off|reset|print [N]|json <file>|folded <file>|merge <file>`
+ *
+ * `profile on` starts accumulating timing for every function decompiled afterward, including
+ * `decompile parallel`, until `profile off`.  `print` lists the N most expensive entries by
+ * self time (default 30).  `json` saves the profile, and `merge` folds in a profile saved by
+ * another process, such as a worker.  `folded` writes a folded-stack file for flamegraphs.
+ * `profile trace on|off|save <file>` records a timeline instead, in the Chrome trace-event format.
+ */
+export class IfcProfile extends IfaceDecompCommand {
+  execute(s: InputStream): void {
+    const cmd = s.eof() ? 'print' : s.readToken();
+    if (cmd === 'trace') {
+      this.executeTrace(s);
+      return;
+    }
+    if (cmd === 'on') {
+      if (this.dcp.profiler === null) this.dcp.profiler = new ActionProfiler();
+      ActionProfiler.active = this.dcp.profiler;
+      this.status.optr.write('Profiling on\n');
+      return;
+    }
+    if (cmd === 'off') {
+      ActionProfiler.active = null;
+      this.status.optr.write('Profiling off\n');
+      return;
+    }
+    const fs = require('fs');
+    if (cmd === 'merge') {
+      const filename = this.readFilename(s);
+      let data: any;
+      try {
+        data = JSON.parse(fs.readFileSync(filename, 'utf-8'));
+      } catch (_e) {
+        throw new IfaceExecutionError('Unable to read profile: ' + filename);
+      }
+      if (this.dcp.profiler === null) this.dcp.profiler = new ActionProfiler();
+      this.dcp.profiler.merge(data);
+      return;
+    }
+    if (this.dcp.profiler === null) {
+      throw new IfaceExecutionError('No profile collected: use "profile on"');
+    }
+    if (cmd === 'reset') {
+      this.dcp.profiler.reset();
+    } else if (cmd === 'print') {
+      let limit = 30;
+      if (!s.eof()) {
+        const n = parseInt(s.readToken(), 10);
+        if (!isNaN(n)) limit = n;
+      }
+      this.dcp.profiler.print(this.status.fileoptr, limit);
+    } else if (cmd === 'json') {
+      fs.writeFileSync(this.readFilename(s), JSON.stringify(this.dcp.profiler.toData()));
+    } else if (cmd === 'folded') {
+      fs.writeFileSync(this.readFilename(s), this.dcp.profiler.toFolded());
+    } else {
+      throw new IfaceParseError('Unknown profile command: ' + cmd);
+    }
+  }
+
+  /** Handle `profile trace on|off|save <file>` */
+  private executeTrace(s: InputStream): void {
+    const cmd = s.readToken();
+    if (cmd === 'on') {
+      if (this.dcp.tracer === null) {
+        this.dcp.tracer = new EventTracer('console');
+        this.dcp.tracer.observeGc();
+      }
+      EventTracer.active = this.dcp.tracer;
+      this.status.optr.write('Tracing on\n');
+    } else if (cmd === 'off') {
+      EventTracer.active = null;
+      this.status.optr.write('Tracing off\n');
+    } else if (cmd === 'save') {
+      if (this.dcp.tracer === null) {
+        throw new IfaceExecutionError('No trace collected: use "profile trace on"');
+      }
+      this.dcp.tracer.write(this.readFilename(s));
+    } else {
+      throw new IfaceParseError('Unknown profile trace command: ' + cmd);
+    }
+  }
+
+  private readFilename(s: InputStream): string {
+    const filename = s.readToken();
+    if (filename.length === 0) {
+      throw new IfaceParseError('Missing filename');
+    }
+    return filename;
+  }
+}
+
 // ---------------------------------------------------------------------------
 // IfcVolatile
 // ---------------------------------------------------------------------------
@@ -4074,6 +4389,9 @@ export function execute(status: IfaceStatus, dcp: IfaceDecompData): void {
       status.optr.write('Parse ERROR: ' + (err.explain ?? err.message) + '\n');
     } else if (err.constructor && err.constructor.name === 'RecovError') {
       status.optr.write('Function ERROR: ' + (err.explain ?? err.message) + '\n');
+    } else if (err.constructor && err.constructor.name === 'ActionBudgetExceeded') {
+      status.optr.write('Budget ERROR: ' + (err.explain ?? err.message) + '\n');
+      dcp.abortFunction(status.optr);
     } else if (err.constructor && err.constructor.name === 'LowlevelError') {
       status.optr.write('Low-level ERROR: ' + (err.explain ?? err.message) + '\n');
       dcp.abortFunction(status.optr);
@@ -6,7 +6,7 @@
 
 import * as fs from 'fs';
 import { CapabilityPoint } from '../core/capability.js';
-import { Writer } from '../util/writer.js';
+import { Writer, ChunkedWriter } from '../util/writer.js';
 
 // ---------------------------------------------------------------------------
 // InputStream: replaces C++ istream for command parameter parsing
@@ -424,6 +424,7 @@ export abstract class IfaceStatus {
   private maxhistory: number;
   private curhistory: number = 0;
   private history: string[] = [];
+  private commandlog: string[] | null = null;  // Every command line executed, if kept
   private sorted: boolean = false;
   private errorisdone: boolean = false;
 
@@ -624,7 +625,13 @@ export abstract class IfaceStatus {
       this.optr.write('ERROR: Incomplete command\n');
     }
 
-    this.comlist[range.first].execute(is);  // Try to execute the (first) command
+    try {
+      this.comlist[range.first].execute(is);  // Try to execute the (first) command
+    } finally {
+      if (this.commandlog !== null) this.commandlog.push(line);
+      // Bulk output to a file is buffered, so it is complete on disk after each command
+      if (this.fileoptr instanceof ChunkedWriter) this.fileoptr.flush();
+    }
     return true;  // Indicate a command was executed
   }
 
@@ -645,6 +652,22 @@ export abstract class IfaceStatus {
     return this.history.length;
   }
 
+  /**
+   * Start keeping every command line executed from now on. Unlike the history, the log is
+   * not limited in size, so it is only kept for consoles that need it.
+   */
+  keepCommandLog(): void {
+    if (this.commandlog === null) this.commandlog = [];
+  }
+
+  /**
+   * Get the command lines executed since keepCommandLog(), not including the command
+   * currently executing.
+   */
+  getCommandLog(): readonly string[] {
+    return this.commandlog ?? [];
+  }
+
   /** Return true if the current stream is finished. */
   abstract isStreamFinished(): boolean;
 
@@ -873,14 +896,10 @@ export class IfcOpenfile extends IfaceBaseCommand {
 
     try {
       const fd = fs.openSync(filename, 'w');
-      const fileWriter: Writer = {
-        write(str: string): void {
-          fs.writeSync(fd, str);
-        }
-      };
+      const fileWriter = new ChunkedWriter(fd);
       // Attach close method for later cleanup
       (fileWriter as any)._fd = fd;
-      (fileWriter as any)._close = (): void => { fs.closeSync(fd); };
+      (fileWriter as any)._close = (): void => { fileWriter.flush(); fs.closeSync(fd); };
       this.status.fileoptr = fileWriter;
     } catch (_e) {
       throw new IfaceExecutionError('Unable to open file: ' + filename);
@@ -903,13 +922,9 @@ export class IfcOpenfileAppend extends IfaceBaseCommand {
 
     try {
       const fd = fs.openSync(filename, 'a');
-      const fileWriter: Writer = {
-        write(str: string): void {
-          fs.writeSync(fd, str);
-        }
-      };
+      const fileWriter = new ChunkedWriter(fd);
       (fileWriter as any)._fd = fd;
-      (fileWriter as any)._close = (): void => { fs.closeSync(fd); };
+      (fileWriter as any)._close = (): void => { fileWriter.flush(); fs.closeSync(fd); };
       this.status.fileoptr = fileWriter;
     } catch (_e) {
       throw new IfaceExecutionError('Unable to open file: ' + filename);
@@ -0,0 +1,218 @@
+/**
+ * @file loadimage_binary.ts
+ * @description LoadImage that reads ELF and Mach-O executables directly.
+ *
+ * The file is read into a single buffer and parsed with the parsers from binary_to_xml.ts.
+ * Every loadable segment becomes a view into that buffer, so no bytes are copied, hex
+ * encoded or re-parsed. This replaces the binary -> XML -> LoadImageXml round trip for
+ * whole executables.
+ */
+
+import * as fs from 'fs';
+import { LowlevelError } from '../core/error.js';
+import { Address, RangeList } from '../core/address.js';
+import { AddrSpace } from '../core/space.js';
+import {
+  LoadImage,
+  LoadImageFunc,
+  LoadImageSection,
+  DataUnavailError,
+} from '../decompiler/loadimage.js';
+import { parseBinary } from './binary_to_xml.js';
+import type { ParsedBinary } from './binary_to_xml.js';
+
+// Forward type declarations
+type AddrSpaceManager = any;
+
+/** Magic numbers recognized by LoadImageBinary.isBinaryFile */
+const ELF_MAGIC = 0x7f454c46;
+const MH_MAGIC_64 = 0xfeedfacf;
+const MH_CIGAM_64 = 0xcffaedfe;
+const FAT_MAGIC = 0xcafebabe;
+const FAT_CIGAM = 0xbebafeca;
+
+/**
+ * A LoadImage backed by the parsed segments of an ELF or Mach-O file.
+ *
+ * Segments are kept sorted by address, so loadFill() is a binary search followed by a copy
+ * out of the original file buffer. As with RawLoadImage, a read that starts inside a segment
+ * but runs past the mapped bytes is padded with zeros, which lets the instruction decoder
+ * read its full window at the end of a segment.
+ */
+export class LoadImageBinary extends LoadImage {
+  private parsed: ParsedBinary;
+  private spaceid: AddrSpace | null = null;
+  private starts: bigint[] = [];             // Sorted start offset of each segment
+  private views: Uint8Array[] = [];          // Bytes of each segment, views into the file buffer
+  private readonly: boolean[] = [];          // Is each segment read-only
+  private vma: bigint = 0n;                  // Adjustment added to all addresses
+  private symbolIndex: number = 0;           // Iterator position for getNextSymbol
+  private sectionIndex: number = 0;          // Iterator position for getNextSection
+
+  /**
+   * @param f is the path to the executable
+   * @param buf is the contents of the file, if already read
+   */
+  constructor(f: string, buf?: Uint8Array) {
+    super(f);
+    const data = buf ?? fs.readFileSync(f);
+    const view = Buffer.isBuffer(data) ? data : Buffer.from(data.buffer, data.byteOffset, data.byteLength);
+    try {
+      this.parsed = parseBinary(view);
+    } catch (err: any) {
+      throw new LowlevelError('Unable to parse executable ' + f + ': ' + (err.message ?? String(err)));
+    }
+    const order = this.parsed.sections.map((_s, i) => i);
+    order.sort((a, b) => {
+      const x = this.parsed.sections[a].vaddr;
+      const y = this.parsed.sections[b].vaddr;
+      return x < y ? -1 : x > y ? 1 : 0;
+    });
+    for (const i of order) {
+      const sec = this.parsed.sections[i];
+      if (sec.data.length === 0) continue;
+      this.starts.push(sec.vaddr);
+      this.views.push(sec.data);
+      this.readonly.push(sec.readonly);
+    }
+  }
+
+  /**
+   * Check whether a file starts with an ELF, Mach-O 64-bit or fat binary header.
+   * @param filename is the file to examine
+   */
+  static isBinaryFile(filename: string): boolean {
+    const buf = Buffer.alloc(4);
+    try {
+      const fd = fs.openSync(filename, 'r');
+      const n = fs.readSync(fd, buf, 0, 4, 0);
+      fs.closeSync(fd);
+      if (n < 4) return false;
+    } catch {
+      return false;
+    }
+    const be = buf.readUInt32BE(0);
+    return be === ELF_MAGIC || be === MH_MAGIC_64 || be === MH_CIGAM_64 ||
+           be === FAT_MAGIC || be === FAT_CIGAM;
+  }
+
+  /**
+   * Attach the image to the default code space of the Architecture.
+   * @param m is the address space manager (the Architecture)
+   */
+  open(m: AddrSpaceManager): void {
+    this.spaceid = m.getDefaultCodeSpace();
+    if (this.spaceid === null)
+      throw new LowlevelError('No default code space for ' + this.filename);
+  }
+
+  /** Get the entry point recorded in the file header */
+  getEntryPoint(): Address {
+    return new Address(this.spaceid!, this.parsed.entry + this.vma);
+  }
+
+  /**
+   * Find the segment containing an offset.
+   * @returns the index of the segment, or -1
+   */
+  private findSegment(off: bigint): number {
+    let lo = 0;
+    let hi = this.starts.length - 1;
+    let res = -1;
+    while (lo <= hi) {
+      const mid = (lo + hi) >> 1;
+      if (this.starts[mid] <= off) {
+        res = mid;
+        lo = mid + 1;
+      } else {
+        hi = mid - 1;
+      }
+    }
+    if (res < 0) return -1;
+    if (off - this.starts[res] >= BigInt(this.views[res].length)) return -1;
+    return res;
+  }
+
+  /**
+   * Get the mapped bytes starting at an address without copying.
+   * @param size is the number of bytes wanted
+   * @param addr is the address of the first byte
+   * @returns a view of the file buffer, or null if the range is not in one segment
+   */
+  loadView(size: number, addr: Address): Uint8Array | null {
+    const off = addr.getOffset() - this.vma;
+    const i = this.findSegment(off);
+    if (i < 0) return null;
+    const start = Number(off - this.starts[i]);
+    if (start + size > this.views[i].length) return null;
+    return this.views[i].subarray(start, start + size);
+  }
+
+  loadFill(ptr: Uint8Array, size: number, addr: Address): void {
+    let off = addr.getOffset() - this.vma;
+    let pos = 0;
+    let i = this.findSegment(off);
+    if (i < 0) {
+      throw new DataUnavailError('Unable to load ' + size + ' bytes at ' +
+        addr.getShortcut() + addr.printRaw());
+    }
+    while (pos < size) {
+      const view = this.views[i];
+      const start = Number(off - this.starts[i]);
+      const n = Math.min(size - pos, view.length - start);
+      ptr.set(view.subarray(start, start + n), pos);
+      pos += n;
+      off += BigInt(n);
+      if (pos === size) return;
+      i += 1;
+      if (i >= this.starts.length || this.starts[i] !== off) break;   // Not contiguous
+    }
+    ptr.fill(0, pos, size);
+  }
+
+  openSymbols(): void {
+    this.symbolIndex = 0;
+  }
+
+  getNextSymbol(record: LoadImageFunc): boolean {
+    const symbols = this.parsed.symbols;
+    // Symbols are sorted by address; report only the first name at each address
+    while (this.symbolIndex < symbols.length) {
+      const sym = symbols[this.symbolIndex++];
+      if (this.symbolIndex > 1 && symbols[this.symbolIndex - 2].vaddr === sym.vaddr) continue;
+      record.name = sym.name;
+      record.address = new Address(this.spaceid!, sym.vaddr + this.vma);
+      return true;
+    }
+    return false;
+  }
+
+  openSectionInfo(): void {
+    this.sectionIndex = 0;
+  }
+
+  getNextSection(sec: LoadImageSection): boolean {
+    if (this.sectionIndex >= this.starts.length) return false;
+    const i = this.sectionIndex++;
+    sec.address = new Address(this.spaceid!, this.starts[i] + this.vma);
+    sec.size = BigInt(this.views[i].length);
+    sec.flags = this.readonly[i] ? LoadImageSection.readonly : 0;
+    return this.sectionIndex < this.starts.length;
+  }
+
+  getReadonly(list: RangeList): void {
+    for (let i = 0; i < this.starts.length; ++i) {
+      if (!this.readonly[i]) continue;
+      const start = this.starts[i] + this.vma;
+      list.insertRange(this.spaceid!, start, start + BigInt(this.views[i].length) - 1n);
+    }
+  }
+
+  getArchType(): string {
+    return this.parsed.arch;
+  }
+
+  adjustVma(adjust: number): void {
+    this.vma += AddrSpace.addressToByte(BigInt(adjust), this.spaceid!.getWordSize());
+  }
+}
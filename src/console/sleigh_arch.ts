@@ -20,7 +20,7 @@ import { SleighError } from '../sleigh/context.js';
 import { Sleigh } from '../sleigh/sleigh.js';
 import { PcodeInjectLibrarySleigh } from '../sleigh/inject_sleigh.js';
 import { Architecture } from '../decompiler/architecture.js';
-import { TypeFactory } from '../decompiler/type.js';
+import { TypeFactory, DEFAULT_CORE_TYPES, type CoreTypeTable } from '../decompiler/type.js';
 import { CommentDatabaseInternal } from '../decompiler/comment.js';
 import { StringManagerUnicode } from '../decompiler/stringmanage.js';
 import { ConstantPoolInternal } from '../decompiler/cpool.js';
@@ -316,6 +316,9 @@ export class SleighArchitecture extends Architecture {
   /** Error stream associated with this SleighArchitecture */
   protected errorstream: Writer;
 
+  /** Core data-types to use when the store has no coretypes tag (null for the defaults) */
+  protected coreTypeTable: CoreTypeTable | null = null;
+
   /**
    * Construct given executable file.
    * @param fname - the filename of the given executable image
@@ -335,6 +338,15 @@ export class SleighArchitecture extends Architecture {
   /** Get the language id of the active processor */
   getTarget(): string { return this.target; }
 
+  /**
+   * Set the core data-types built on the next init() if the store has no coretypes tag.
+   * A worker gets the table of its parent this way (TypeFactory.exportCoreTable()).
+   * @param table - the core data-types, or null for the defaults
+   */
+  setCoreTypeTable(table: CoreTypeTable | null): void {
+    this.coreTypeTable = table;
+  }
+
   /**
    * Test if last Translate object can be reused.
    * If the current languageindex matches an entry in the translators map,
@@ -372,7 +384,7 @@ export class SleighArchitecture extends Architecture {
   /**
    * Set up core data types.
    * If a "coretypes" tag exists in the store, decode it.
-   * Otherwise set up default core types.
+   * Otherwise load the table given by setCoreTypeTable(), or the default core types.
    */
   protected buildCoreTypes(store: DocumentStorage): void {
     const el = store.getTag('coretypes');
@@ -380,30 +392,8 @@ export class SleighArchitecture extends Architecture {
       const decoder = new XmlDecode(this as any, el);
       this.types!.decodeCoreTypes(decoder);
     } else {
-      this.types!.setCoreType('void', 1, 17 /* TYPE_VOID */, false);
-      this.types!.setCoreType('bool', 1, 12 /* TYPE_BOOL */, false);
-      this.types!.setCoreType('uint1', 1, 13 /* TYPE_UINT */, false);
-      this.types!.setCoreType('uint2', 2, 13, false);
-      this.types!.setCoreType('uint4', 4, 13, false);
-      this.types!.setCoreType('uint8', 8, 13, false);
-      this.types!.setCoreType('int1', 1, 14 /* TYPE_INT */, false);
-      this.types!.setCoreType('int2', 2, 14, false);
-      this.types!.setCoreType('int4', 4, 14, false);
-      this.types!.setCoreType('int8', 8, 14, false);
-      this.types!.setCoreType('float4', 4, 10 /* TYPE_FLOAT */, false);
-      this.types!.setCoreType('float8', 8, 10, false);
-      this.types!.setCoreType('float10', 10, 10, false);
-      this.types!.setCoreType('float16', 16, 10, false);
-      this.types!.setCoreType('xunknown1', 1, 15 /* TYPE_UNKNOWN */, false);
-      this.types!.setCoreType('xunknown2', 2, 15, false);
-      this.types!.setCoreType('xunknown4', 4, 15, false);
-      this.types!.setCoreType('xunknown8', 8, 15, false);
-      this.types!.setCoreType('code', 1, 11 /* TYPE_CODE */, false);
-      this.types!.setCoreType('char', 1, 14 /* TYPE_INT */, true);
-      this.types!.setCoreType('wchar2', 2, 14, true);
-      this.types!.setCoreType('wchar4', 4, 14, true);
+      this.types!.loadCoreTable(this.coreTypeTable ?? DEFAULT_CORE_TYPES);
     }
-    this.types!.cacheCoreTypes();
   }
 
   /** Set up the comment database */
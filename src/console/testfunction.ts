@@ -351,13 +351,12 @@ export class FunctionTestCollection {
   loadTest(filename: string): void {
     this.fileName = filename;
     const docStorage = new DocumentStorage();
-    let content: string;
     try {
-      content = fs.readFileSync(filename, 'utf-8');
+      fs.accessSync(filename, fs.constants.R_OK);
     } catch (_e) {
       throw new IfaceParseError('Unable to open test file: ' + filename);
     }
-    const doc = docStorage.parseDocument(content);
+    const doc = docStorage.openDocumentStream(filename);
     const el = doc.getRoot();
     if (el.getName() === 'decompilertest') {
       this.restoreXml(docStorage, el);
@@ -121,6 +121,8 @@ const xmlArchitectureCapability = new XmlArchitectureCapability();
 export class XmlArchitecture extends SleighArchitecture {
   /** The amount to adjust the virtual memory address */
   private adjustvma: number = 0;
+  /** Packed load image to restore instead of reading a binaryimage tag */
+  private loaderSnapshot: Uint8Array | null = null;
 
   /**
    * @param fname - path to the XML executable file
@@ -142,6 +144,11 @@ export class XmlArchitecture extends SleighArchitecture {
   protected buildLoader(store: DocumentStorage): void {
     SleighArchitecture.collectSpecFiles(this.errorstream);
 
+    if (this.loaderSnapshot !== null) {
+      this.loader = LoadImageXml.fromSnapshot(this.getFilename(), this.loaderSnapshot);
+      this.loaderSnapshot = null;
+      return;
+    }
     let el: Element | null = store.getTag('binaryimage');
     if (el === null) {
       const doc: Document = store.openDocument(this.getFilename());
@@ -154,6 +161,18 @@ export class XmlArchitecture extends SleighArchitecture {
     this.loader = new LoadImageXml(this.getFilename(), el);
   }
 
+  /**
+   * Restore the load image from a packed snapshot on the next init(), bypassing XML.
+   *
+   * The snapshot must come from LoadImageXml.encodeSnapshot() on an architecture for the
+   * same language. Any VMA adjustment was already applied to the snapshot chunks.
+   * @param data - the packed snapshot bytes
+   */
+  setLoaderSnapshot(data: Uint8Array): void {
+    this.loaderSnapshot = data;
+    this.adjustvma = 0;
+  }
+
   /**
    * Post-specification-file initialization.
    *
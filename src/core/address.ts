@@ -91,6 +91,7 @@ export function calc_int_min(size: number): bigint {
  */
 export function pcode_right(val: bigint, sa: number): bigint {
   if (sa >= 64) return 0n;
+  if (sa === 0) return val;
   return val >> BigInt(sa);
 }
 
@@ -120,6 +121,9 @@ export function minimalmask(val: bigint): bigint {
  * All bits above position `bit` are set to match the bit at position `bit`.
  */
 export function sign_extend(val: bigint, bit: number): bigint {
+  // Fast path: BigInt.asIntN performs the truncate + sign-extend in one
+  // intrinsic, without the intermediate shifted/masked bigints.
+  if (bit >= 0 && bit < 63) return BigInt.asIntN(bit + 1, val);
   // Emulate: int sa = 64 - (bit+1); val = (val << sa) >> sa;
   // We operate in signed 64-bit arithmetic.
   const sa = 64 - (bit + 1);
@@ -146,6 +150,7 @@ export function sign_extend(val: bigint, bit: number): bigint {
  * All bits above position `bit` are cleared.
  */
 export function zero_extend(val: bigint, bit: number): bigint {
+  if (bit >= 0 && bit < 63) return BigInt.asUintN(bit + 1, val);
   const sa = 64 - (bit + 1);
   if (sa <= 0) return val & 0xFFFFFFFFFFFFFFFFn;
   return ((val << BigInt(sa)) & 0xFFFFFFFFFFFFFFFFn) >> BigInt(sa);
@@ -298,6 +303,22 @@ export function bit_transitions(val: bigint, sz: number): number {
 // Address class
 // ---------------------------------------------------------------------------
 
+/**
+ * Ordering key for the space portion of an address.
+ * The minimal sentinel (null) sorts first and the maximal sentinel sorts last;
+ * everything else sorts by space index.
+ */
+function spaceOrder(spc: AddrSpace | null): number {
+  if (spc === null) return -Infinity;
+  if (spc === MAXIMAL_SPACE_SENTINEL) return Infinity;
+  return typeof spc.getIndex === 'function' ? spc.getIndex() : -1;
+}
+
+/** Offsets below this (2^52) have a number key equal to the offset */
+const NUM_KEY_SPAN = 2 ** 52;
+/** Offsets at or above this (2^64 - 2^52) have a negative number key (see Address._num) */
+const NUM_KEY_TOP = 2 ** 64 - 2 ** 52;
+
 /** Enum for specifying extremal addresses. */
 export const enum MachExtreme {
   /** Smallest possible address */
@@ -318,8 +339,23 @@ export const enum MachExtreme {
 export class Address {
   /** Pointer to our address space (null means invalid address) */
   base: AddrSpace | null;
+  /** @internal Offset (in bytes), read and written through the offset accessor */
+  _offset: bigint = 0n;
+  /**
+   * @internal Number key for the offset, computed on first comparison. Offsets below 2^52
+   * map to themselves. Offsets within 2^52 of the top of the 64-bit range (negative stack
+   * offsets) map to their signed value minus 2, so they stay small integers; compare()
+   * sorts these negative keys above the others. -1 means not computed yet, and -2 means
+   * the offset is in neither range, so comparisons fall back to the bigint.
+   */
+  _num: number = -1;
+
   /** Offset (in bytes) */
-  offset: bigint;
+  get offset(): bigint { return this._offset; }
+  set offset(val: bigint) {
+    this._offset = val;
+    this._num = -1;
+  }
 
   /**
    * Construct an Address.
@@ -353,7 +389,8 @@ export class Address {
     } else if (arg0 instanceof Address) {
       // Copy constructor
       this.base = arg0.base;
-      this.offset = arg0.offset;
+      this._offset = arg0._offset;
+      this._num = arg0._num;
     } else if (arg1 === undefined && typeof (arg0 as any).getOffset === 'function' && typeof (arg0 as any).base !== 'undefined') {
       // Copy from pcoderaw.Address (not instanceof address.ts Address, but same shape)
       this.base = (arg0 as any).base;
@@ -433,7 +470,12 @@ export class Address {
   /** Copy from another address (mutates this). */
   assign(op2: Address): this {
     this.base = op2.base;
-    this.offset = op2.offset;
+    if (op2 instanceof Address) {
+      this._offset = op2._offset;
+      this._num = op2._num;
+    } else {
+      this.offset = op2.offset;
+    }
     return this;
   }
 
@@ -462,7 +504,10 @@ export class Address {
 
   /** Check if two addresses are equal. */
   equals(op2: Address): boolean {
-    return this.base === op2.base && this.offset === op2.offset;
+    if (this.base !== op2.base) return false;
+    const n1 = this._num;
+    if (n1 === op2._num && (n1 >= 0 || n1 <= -3)) return true;
+    return this.offset === op2.offset;
   }
 
   /** Check if this address is strictly less than op2 in the natural ordering. */
@@ -477,8 +522,7 @@ export class Address {
       const op2Idx = typeof op2.base.getIndex === 'function' ? op2.base.getIndex() : -1;
       return thisIdx < op2Idx;
     }
-    if (this.offset !== op2.offset) return this.offset < op2.offset;
-    return false;
+    return Address.compare(this, op2) < 0;
   }
 
   /** Check if this address is less than or equal to op2. */
@@ -492,8 +536,7 @@ export class Address {
       const op2Idx = typeof op2.base.getIndex === 'function' ? op2.base.getIndex() : -1;
       return thisIdx < op2Idx;
     }
-    if (this.offset !== op2.offset) return this.offset < op2.offset;
-    return true;
+    return Address.compare(this, op2) <= 0;
   }
 
   // ---- Arithmetic ----
@@ -618,8 +661,34 @@ export class Address {
    * Three-way comparison. Returns -1, 0, or 1.
    */
   static compare(a: Address, b: Address): -1 | 0 | 1 {
-    if (a.equals(b)) return 0;
-    return a.lessThan(b) ? -1 : 1;
+    // Single pass: the common case (same space) costs one identity check and
+    // at most two offset comparisons, with no method dispatch.
+    if (a.base === b.base) {
+      let n1 = a._num;
+      if (n1 === -1) n1 = a.cacheNum();
+      let n2 = b._num;
+      if (n2 === -1) n2 = b.cacheNum();
+      if ((n1 >= 0 || n1 <= -3) && (n2 >= 0 || n2 <= -3)) {
+        if (n1 === n2) return 0;
+        if ((n1 < 0) !== (n2 < 0)) return n1 < 0 ? 1 : -1;
+        return n1 < n2 ? -1 : 1;
+      }
+      const off1 = a.offset;
+      const off2 = b.offset;
+      if (off1 === off2) return 0;
+      return off1 < off2 ? -1 : 1;
+    }
+    return spaceOrder(a.base) < spaceOrder(b.base) ? -1 : 1;
+  }
+
+  /** @internal Compute and cache the number key of the offset (see _num), returning it */
+  cacheNum(): number {
+    const off = this._offset;
+    const d = Number(off);        // Exact below 2^53
+    if (d >= 0 && d < NUM_KEY_SPAN) return this._num = d;
+    if (d >= NUM_KEY_TOP && off <= 0xFFFFFFFFFFFFFFFFn)
+      return this._num = Number(BigInt.asIntN(64, off)) - 2;
+    return this._num = -2;
   }
 
   /** Factory: create an invalid address. */
@@ -717,6 +786,17 @@ export class SeqNum {
     return this.pc.lessThan(op2.pc);
   }
 
+  /**
+   * Three-way comparison with the same ordering as lessThan().
+   * Returns -1, 0, or 1.
+   */
+  static compare(a: SeqNum, b: SeqNum): -1 | 0 | 1 {
+    if (a.uniq === b.uniq) return 0;
+    const c = Address.compare(a.pc, b.pc);
+    if (c !== 0) return c;
+    return a.uniq < b.uniq ? -1 : 1;
+  }
+
   /** Human readable representation: "addr:uniq" */
   toString(): string {
     return `${this.pc.printRaw()}:${this.uniq}`;
@@ -312,8 +312,7 @@ export class FreeArray {
  * Compare two Address objects for use in PartMap.
  */
 function addressCompare(a: Address, b: Address): number {
-  if (a.equals(b)) return 0;
-  return a.lessThan(b) ? -1 : 1;
+  return Address.compare(a, b);
 }
 
 // ---------------------------------------------------------------------------
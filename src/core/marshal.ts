@@ -905,7 +905,7 @@ export class XmlDecode extends Decoder {
 // =========================================================================
 
 /** Protocol format constants for PackedEncode and PackedDecode classes */
-const PackedFormat = {
+export const PackedFormat = {
   HEADER_MASK:          0xc0,  // Bits encoding the record type
   ELEMENT_START:        0x40,  // Header for an element start record
   ELEMENT_END:          0x80,  // Header for an element end record
@@ -938,6 +938,23 @@ const IPTR_FSPEC = 4;
 const IPTR_IOP = 5;
 const IPTR_JOIN = 6;
 
+/**
+ * Convert a range of bytes to a latin1 string (one character per byte).
+ * Works in slices so that large ranges do not overflow the argument limit of fromCharCode.
+ */
+export function latin1FromBytes(buf: Uint8Array, start: number, len: number): string {
+  const SLICE = 0x2000;
+  if (len <= SLICE) {
+    return String.fromCharCode.apply(null, buf.subarray(start, start + len) as unknown as number[]);
+  }
+  const parts: string[] = [];
+  for (let i = 0; i < len; i += SLICE) {
+    const end = Math.min(len, i + SLICE);
+    parts.push(String.fromCharCode.apply(null, buf.subarray(start + i, start + end) as unknown as number[]));
+  }
+  return parts.join('');
+}
+
 // =========================================================================
 // PackedEncode
 // =========================================================================
@@ -950,7 +967,29 @@ const IPTR_JOIN = 6;
  * the header bytes, followed by typed value data.
  */
 export class PackedEncode extends Encoder {
-  private outBytes: number[] = [];
+  private outBytes: Uint8Array = new Uint8Array(1024);
+  private outLen: number = 0;
+
+  /** Append a single byte to the output, growing the buffer as needed */
+  private pushByte(b: number): void {
+    if (this.outLen === this.outBytes.length) {
+      const grown = new Uint8Array(this.outBytes.length * 2);
+      grown.set(this.outBytes);
+      this.outBytes = grown;
+    }
+    this.outBytes[this.outLen++] = b;
+  }
+
+  /** Make room for at least n more bytes in the output */
+  private reserve(n: number): void {
+    const need = this.outLen + n;
+    if (need <= this.outBytes.length) return;
+    let size = this.outBytes.length * 2;
+    while (size < need) size *= 2;
+    const grown = new Uint8Array(size);
+    grown.set(this.outBytes.subarray(0, this.outLen));
+    this.outBytes = grown;
+  }
 
   /** Write a header byte (element start, element end, or attribute) with the given id */
   private writeHeader(header: number, id: number): void {
@@ -958,11 +997,11 @@ export class PackedEncode extends Encoder {
       header |= PackedFormat.HEADEREXTEND_MASK;
       header |= (id >> PackedFormat.RAWDATA_BITSPERBYTE);
       const extendByte = (id & PackedFormat.RAWDATA_MASK) | PackedFormat.RAWDATA_MARKER;
-      this.outBytes.push(header & 0xff);
-      this.outBytes.push(extendByte & 0xff);
+      this.pushByte(header & 0xff);
+      this.pushByte(extendByte & 0xff);
     } else {
       header |= id;
-      this.outBytes.push(header & 0xff);
+      this.pushByte(header & 0xff);
     }
   }
 
@@ -1013,11 +1052,11 @@ export class PackedEncode extends Encoder {
       }
     }
     typeByte |= lenCode;
-    this.outBytes.push(typeByte & 0xff);
+    this.pushByte(typeByte & 0xff);
     for (; sa >= 0; sa -= PackedFormat.RAWDATA_BITSPERBYTE) {
       let piece = Number((val >> BigInt(sa)) & BigInt(PackedFormat.RAWDATA_MASK));
       piece |= PackedFormat.RAWDATA_MARKER;
-      this.outBytes.push(piece & 0xff);
+      this.pushByte(piece & 0xff);
     }
   }
 
@@ -1034,7 +1073,7 @@ export class PackedEncode extends Encoder {
     const typeByte = val
       ? ((PackedFormat.TYPECODE_BOOLEAN << PackedFormat.TYPECODE_SHIFT) | 1)
       : (PackedFormat.TYPECODE_BOOLEAN << PackedFormat.TYPECODE_SHIFT);
-    this.outBytes.push(typeByte & 0xff);
+    this.pushByte(typeByte & 0xff);
   }
 
   writeSignedInteger(attribId: AttributeId, val: number): void {
@@ -1061,17 +1100,33 @@ export class PackedEncode extends Encoder {
     this.writeHeader(PackedFormat.ATTRIBUTE, attribId.getId());
     this.writeInteger(PackedFormat.TYPECODE_STRING << PackedFormat.TYPECODE_SHIFT, length);
     // Write string bytes using latin1 encoding (one byte per char)
+    this.reserve(val.length);
     for (let i = 0; i < val.length; i++) {
-      this.outBytes.push(val.charCodeAt(i) & 0xff);
+      this.outBytes[this.outLen++] = val.charCodeAt(i) & 0xff;
     }
   }
 
+  /**
+   * Write a string attribute whose content is given directly as raw bytes.
+   * The encoding is the same as writeString() with one character per byte, but no
+   * intermediate string is built.
+   * @param attribId - the attribute to write
+   * @param val - the raw content bytes
+   */
+  writeBytes(attribId: AttributeId, val: Uint8Array): void {
+    this.writeHeader(PackedFormat.ATTRIBUTE, attribId.getId());
+    this.writeInteger(PackedFormat.TYPECODE_STRING << PackedFormat.TYPECODE_SHIFT, BigInt(val.length));
+    this.reserve(val.length);
+    this.outBytes.set(val, this.outLen);
+    this.outLen += val.length;
+  }
+
   writeStringIndexed(attribId: AttributeId, index: number, val: string): void {
     const length = BigInt(val.length);
     this.writeHeader(PackedFormat.ATTRIBUTE, attribId.getId() + index);
     this.writeInteger(PackedFormat.TYPECODE_STRING << PackedFormat.TYPECODE_SHIFT, length);
     for (let i = 0; i < val.length; i++) {
-      this.outBytes.push(val.charCodeAt(i) & 0xff);
+      this.pushByte(val.charCodeAt(i) & 0xff);
     }
   }
 
@@ -1079,16 +1134,16 @@ export class PackedEncode extends Encoder {
     this.writeHeader(PackedFormat.ATTRIBUTE, attribId.getId());
     const spcType = spc.getType();
     if (spcType === IPTR_FSPEC) {
-      this.outBytes.push((PackedFormat.TYPECODE_SPECIALSPACE << PackedFormat.TYPECODE_SHIFT) | PackedFormat.SPECIALSPACE_FSPEC);
+      this.pushByte((PackedFormat.TYPECODE_SPECIALSPACE << PackedFormat.TYPECODE_SHIFT) | PackedFormat.SPECIALSPACE_FSPEC);
     } else if (spcType === IPTR_IOP) {
-      this.outBytes.push((PackedFormat.TYPECODE_SPECIALSPACE << PackedFormat.TYPECODE_SHIFT) | PackedFormat.SPECIALSPACE_IOP);
+      this.pushByte((PackedFormat.TYPECODE_SPECIALSPACE << PackedFormat.TYPECODE_SHIFT) | PackedFormat.SPECIALSPACE_IOP);
     } else if (spcType === IPTR_JOIN) {
-      this.outBytes.push((PackedFormat.TYPECODE_SPECIALSPACE << PackedFormat.TYPECODE_SHIFT) | PackedFormat.SPECIALSPACE_JOIN);
+      this.pushByte((PackedFormat.TYPECODE_SPECIALSPACE << PackedFormat.TYPECODE_SHIFT) | PackedFormat.SPECIALSPACE_JOIN);
     } else if (spcType === IPTR_SPACEBASE) {
       if (spc.isFormalStackSpace()) {
-        this.outBytes.push((PackedFormat.TYPECODE_SPECIALSPACE << PackedFormat.TYPECODE_SHIFT) | PackedFormat.SPECIALSPACE_STACK);
+        this.pushByte((PackedFormat.TYPECODE_SPECIALSPACE << PackedFormat.TYPECODE_SHIFT) | PackedFormat.SPECIALSPACE_STACK);
       } else {
-        this.outBytes.push((PackedFormat.TYPECODE_SPECIALSPACE << PackedFormat.TYPECODE_SHIFT) | PackedFormat.SPECIALSPACE_SPACEBASE);
+        this.pushByte((PackedFormat.TYPECODE_SPECIALSPACE << PackedFormat.TYPECODE_SHIFT) | PackedFormat.SPECIALSPACE_SPACEBASE);
       }
     } else {
       const spcId = BigInt(spc.getIndex());
@@ -1101,17 +1156,22 @@ export class PackedEncode extends Encoder {
    * Each byte in the output corresponds to one character.
    */
   toString(): string {
-    return String.fromCharCode(...this.outBytes);
+    return latin1FromBytes(this.outBytes, 0, this.outLen);
   }
 
   /** Get the encoded output as a Uint8Array */
   toBytes(): Uint8Array {
-    return new Uint8Array(this.outBytes);
+    return this.outBytes.slice(0, this.outLen);
+  }
+
+  /** Get the number of bytes encoded so far */
+  size(): number {
+    return this.outLen;
   }
 
   /** Clear the output buffer */
   clear(): void {
-    this.outBytes.length = 0;
+    this.outLen = 0;
   }
 }
 
@@ -1309,6 +1369,32 @@ export class PackedDecode extends Decoder {
     this.attributeRead = true;
   }
 
+  /** Get the stream position of the next element, for a later seek() */
+  getPosition(): number {
+    return this.endPos;
+  }
+
+  /**
+   * Move to a position previously returned by getPosition().
+   * The next element opened is the one that started at that position.
+   */
+  seek(pos: number): void {
+    this.startPos = pos;
+    this.curPos = pos;
+    this.endPos = pos;
+    this.attributeRead = true;
+  }
+
+  /** Capture the full read state, so that a nested seek() can be undone */
+  saveState(): [number, number, number, boolean] {
+    return [this.startPos, this.curPos, this.endPos, this.attributeRead];
+  }
+
+  /** Restore the read state captured by saveState() */
+  restoreState(state: [number, number, number, boolean]): void {
+    [this.startPos, this.curPos, this.endPos, this.attributeRead] = state;
+  }
+
   peekElement(): number {
     const header1 = this.getByte(this.endPos);
     if ((header1 & PackedFormat.HEADER_MASK) !== PackedFormat.ELEMENT_START) {
@@ -1424,6 +1510,16 @@ export class PackedDecode extends Decoder {
     return ATTRIB_UNKNOWN.getId(); // PackedDecode never needs to reinterpret an attribute
   }
 
+  /**
+   * Get the type code (PackedFormat.TYPECODE_*) of the attribute last returned by
+   * getNextAttributeId(), so a reader without a schema can pick the matching read method.
+   */
+  getAttributeType(): number {
+    let pos = this.curPos + 1;
+    if ((this.getByte(this.curPos) & PackedFormat.HEADEREXTEND_MASK) !== 0) pos += 1;
+    return this.getByte(pos) >> PackedFormat.TYPECODE_SHIFT;
+  }
+
   readBool(attribId?: AttributeId): boolean {
     if (attribId !== undefined && typeof attribId === 'object') {
       return this.readBoolById(attribId);
@@ -1580,10 +1676,7 @@ export class PackedDecode extends Decoder {
     const strLen = this.readIntegerFromCur(lengthCode);
     this.attributeRead = true;
     // Read strLen bytes as latin1 characters
-    let result = '';
-    for (let i = 0; i < strLen; i++) {
-      result += String.fromCharCode(this.buf[this.curPos + i]);
-    }
+    const result = latin1FromBytes(this.buf, this.curPos, strLen);
     this.curPos = this.advancePosition(this.curPos, strLen);
     return result;
   }
@@ -1595,6 +1688,38 @@ export class PackedDecode extends Decoder {
     return res;
   }
 
+  /**
+   * Read the content of a string attribute as raw bytes, as written by PackedEncode.writeBytes().
+   * The bytes are copied out, so the result does not keep the stream buffer alive.
+   * @param attribId - the attribute to read
+   * @returns a copy of the attribute content
+   */
+  readBytesById(attribId: AttributeId): Uint8Array {
+    this.findMatchingAttribute(attribId);
+    // Consume attribute header
+    const h = this.getNextByte(this.curPos);
+    this.curPos = h.newPos;
+    if ((h.value & PackedFormat.HEADEREXTEND_MASK) !== 0) {
+      const ext = this.getNextByte(this.curPos);
+      this.curPos = ext.newPos;
+    }
+    const tb = this.getNextByte(this.curPos);
+    this.curPos = tb.newPos;
+    const typeByte = tb.value;
+    if ((typeByte >> PackedFormat.TYPECODE_SHIFT) !== PackedFormat.TYPECODE_STRING) {
+      this.skipAttributeRemainingInternal(typeByte);
+      this.attributeRead = true;
+      this.curPos = this.startPos;
+      throw new DecoderError('Expecting string attribute');
+    }
+    const len = this.readIntegerFromCur(this.readLengthCode(typeByte));
+    const end = this.advancePosition(this.curPos, len);
+    const res = this.buf.slice(this.curPos, end);
+    this.attributeRead = true;
+    this.curPos = this.startPos;
+    return res;
+  }
+
   readSpace(attribId?: AttributeId): AddrSpace {
     if (attribId !== undefined && typeof attribId === 'object') {
       return this.readSpaceById(attribId);
@@ -73,10 +73,8 @@ export function sign_extend(val: bigint, sizein: number, sizeout: number): bigin
  * This is the intb sign_extend(intb val, int4 bit) overload from address.hh.
  */
 export function sign_extend_by_bit(val: bigint, bit: number): bigint {
-  const sa = 64 - (bit + 1);
-  let sval = BigInt.asIntN(64, val);
-  sval = (sval << BigInt(sa)) >> BigInt(sa);
-  return sval;
+  // BigInt shifts never wrap, so the C++ shift-left/shift-right idiom is done with asIntN
+  return BigInt.asIntN(bit < 63 ? bit + 1 : 64, val);
 }
 
 /**
@@ -84,11 +82,7 @@ export function sign_extend_by_bit(val: bigint, bit: number): bigint {
  * Equivalent to clearing all bits above position 'bit'.
  */
 export function zero_extend(val: bigint, bit: number): bigint {
-  const sa = 64 - (bit + 1);
-  // Shift left to clear upper bits, then logical shift right
-  let uval = BigInt.asUintN(64, val);
-  uval = (uval << BigInt(sa)) >> BigInt(sa);
-  return BigInt.asUintN(64, uval);
+  return BigInt.asUintN(bit < 63 ? bit + 1 : 64, val);
 }
 
 /**
@@ -132,6 +126,12 @@ export function count_leading_zeros(val: bigint): number {
   return bit;
 }
 
+/** Byte masks for the uint32 evaluators, indexed by size in bytes (0..4) */
+const MASK32: readonly number[] = [0, 0xFF, 0xFFFF, 0xFFFFFF, 0xFFFFFFFF];
+
+/** Multipliers for shifting a uint32 left by a whole number of bytes (0..3) */
+const POW2_BYTES: readonly number[] = [1, 0x100, 0x10000, 0x1000000];
+
 // ---------------------------------------------------------------------------
 // EvaluationError
 // ---------------------------------------------------------------------------
@@ -162,6 +162,8 @@ export class OpBehavior {
   private opcode: OpCode;
   private isunary: boolean;
   private isspecial: boolean;
+  /** True if evaluateUnary32/evaluateBinary32 are implemented for this behavior */
+  protected has32: boolean = false;
 
   /**
    * A behavior constructor.
@@ -190,6 +192,11 @@ export class OpBehavior {
     return this.isunary;
   }
 
+  /** Check if evaluateUnary32() or evaluateBinary32() is implemented */
+  hasUint32(): boolean {
+    return this.has32;
+  }
+
   /** Emulate the unary op-code on an input value */
   evaluateUnary(sizeout: number, sizein: number, in1: bigint): bigint {
     const name = get_opname(this.opcode);
@@ -202,6 +209,50 @@ export class OpBehavior {
     throw new LowlevelError('Binary emulation unimplemented for ' + name);
   }
 
+  /**
+   * Emulate the unary op-code on an input of at most 4 bytes, held as a uint32 number.
+   * Returns -1 if the behavior has no uint32 evaluator or the result cannot be produced
+   * exactly, in which case the caller must fall back to evaluateUnary().
+   */
+  evaluateUnary32(sizeout: number, sizein: number, in1: number): number {
+    return -1;
+  }
+
+  /**
+   * Emulate the binary op-code on inputs of at most 4 bytes, held as uint32 numbers.
+   * Returns -1 if the behavior has no uint32 evaluator or the result cannot be produced
+   * exactly, in which case the caller must fall back to evaluateBinary().
+   */
+  evaluateBinary32(sizeout: number, sizein: number, in1: number, in2: number): number {
+    return -1;
+  }
+
+  /**
+   * Emulate the unary op-code, using the uint32 evaluator when all sizes are at most 4 bytes.
+   * The result is bit-identical to evaluateUnary().
+   */
+  evaluateUnarySized(sizeout: number, sizein: number, in1: bigint): bigint {
+    if (this.has32 && sizeout <= 4 && sizein <= 4 && sizeout > 0 && sizein > 0 &&
+        in1 >= 0n && in1 <= 0xFFFFFFFFn) {
+      const res = this.evaluateUnary32(sizeout, sizein, Number(in1));
+      if (res >= 0) return BigInt(res);
+    }
+    return this.evaluateUnary(sizeout, sizein, in1);
+  }
+
+  /**
+   * Emulate the binary op-code, using the uint32 evaluator when all sizes are at most 4 bytes.
+   * The result is bit-identical to evaluateBinary().
+   */
+  evaluateBinarySized(sizeout: number, sizein: number, in1: bigint, in2: bigint): bigint {
+    if (this.has32 && sizeout <= 4 && sizein <= 4 && sizeout > 0 && sizein > 0 &&
+        in1 >= 0n && in1 <= 0xFFFFFFFFn && in2 >= 0n && in2 <= 0xFFFFFFFFn) {
+      const res = this.evaluateBinary32(sizeout, sizein, Number(in1), Number(in2));
+      if (res >= 0) return BigInt(res);
+    }
+    return this.evaluateBinary(sizeout, sizein, in1, in2);
+  }
+
   /** Emulate the ternary op-code on input values */
   evaluateTernary(sizeout: number, sizein: number, in1: bigint, in2: bigint, in3: bigint): bigint {
     const name = get_opname(this.opcode);
@@ -319,12 +370,17 @@ export class OpBehavior {
 export class OpBehaviorCopy extends OpBehavior {
   constructor() {
     super(OpCode.CPUI_COPY, true);
+    this.has32 = true;
   }
 
   evaluateUnary(sizeout: number, sizein: number, in1: bigint): bigint {
     return in1;
   }
 
+  evaluateUnary32(sizeout: number, sizein: number, in1: number): number {
+    return in1;
+  }
+
   recoverInputUnary(sizeout: number, out: bigint, sizein: number): bigint {
     return out;
   }
@@ -334,28 +390,39 @@ export class OpBehaviorCopy extends OpBehavior {
 export class OpBehaviorEqual extends OpBehavior {
   constructor() {
     super(OpCode.CPUI_INT_EQUAL, false);
+    this.has32 = true;
   }
 
   evaluateBinary(sizeout: number, sizein: number, in1: bigint, in2: bigint): bigint {
     return (in1 === in2) ? 1n : 0n;
   }
+
+  evaluateBinary32(sizeout: number, sizein: number, in1: number, in2: number): number {
+    return (in1 === in2) ? 1 : 0;
+  }
 }
 
 /** CPUI_INT_NOTEQUAL behavior */
 export class OpBehaviorNotEqual extends OpBehavior {
   constructor() {
     super(OpCode.CPUI_INT_NOTEQUAL, false);
+    this.has32 = true;
   }
 
   evaluateBinary(sizeout: number, sizein: number, in1: bigint, in2: bigint): bigint {
     return (in1 !== in2) ? 1n : 0n;
   }
+
+  evaluateBinary32(sizeout: number, sizein: number, in1: number, in2: number): number {
+    return (in1 !== in2) ? 1 : 0;
+  }
 }
 
 /** CPUI_INT_SLESS behavior */
 export class OpBehaviorIntSless extends OpBehavior {
   constructor() {
     super(OpCode.CPUI_INT_SLESS, false);
+    this.has32 = true;
   }
 
   evaluateBinary(sizeout: number, sizein: number, in1: bigint, in2: bigint): bigint {
@@ -368,12 +435,23 @@ export class OpBehaviorIntSless extends OpBehavior {
     }
     return (in1 < in2) ? 1n : 0n;
   }
+
+  evaluateBinary32(sizeout: number, sizein: number, in1: number, in2: number): number {
+    const mask = 0x80 << (8 * (sizein - 1));
+    const bit1 = in1 & mask;
+    const bit2 = in2 & mask;
+    if (bit1 !== bit2) {
+      return (bit1 !== 0) ? 1 : 0;
+    }
+    return (in1 < in2) ? 1 : 0;
+  }
 }
 
 /** CPUI_INT_SLESSEQUAL behavior */
 export class OpBehaviorIntSlessEqual extends OpBehavior {
   constructor() {
     super(OpCode.CPUI_INT_SLESSEQUAL, false);
+    this.has32 = true;
   }
 
   evaluateBinary(sizeout: number, sizein: number, in1: bigint, in2: bigint): bigint {
@@ -386,40 +464,65 @@ export class OpBehaviorIntSlessEqual extends OpBehavior {
     }
     return (in1 <= in2) ? 1n : 0n;
   }
+
+  evaluateBinary32(sizeout: number, sizein: number, in1: number, in2: number): number {
+    const mask = 0x80 << (8 * (sizein - 1));
+    const bit1 = in1 & mask;
+    const bit2 = in2 & mask;
+    if (bit1 !== bit2) {
+      return (bit1 !== 0) ? 1 : 0;
+    }
+    return (in1 <= in2) ? 1 : 0;
+  }
 }
 
 /** CPUI_INT_LESS behavior */
 export class OpBehaviorIntLess extends OpBehavior {
   constructor() {
     super(OpCode.CPUI_INT_LESS, false);
+    this.has32 = true;
   }
 
   evaluateBinary(sizeout: number, sizein: number, in1: bigint, in2: bigint): bigint {
     return (in1 < in2) ? 1n : 0n;
   }
+
+  evaluateBinary32(sizeout: number, sizein: number, in1: number, in2: number): number {
+    return (in1 < in2) ? 1 : 0;
+  }
 }
 
 /** CPUI_INT_LESSEQUAL behavior */
 export class OpBehaviorIntLessEqual extends OpBehavior {
   constructor() {
     super(OpCode.CPUI_INT_LESSEQUAL, false);
+    this.has32 = true;
   }
 
   evaluateBinary(sizeout: number, sizein: number, in1: bigint, in2: bigint): bigint {
     return (in1 <= in2) ? 1n : 0n;
   }
+
+  evaluateBinary32(sizeout: number, sizein: number, in1: number, in2: number): number {
+    return (in1 <= in2) ? 1 : 0;
+  }
 }
 
 /** CPUI_INT_ZEXT behavior */
 export class OpBehaviorIntZext extends OpBehavior {
   constructor() {
     super(OpCode.CPUI_INT_ZEXT, true);
+    this.has32 = true;
   }
 
   evaluateUnary(sizeout: number, sizein: number, in1: bigint): bigint {
     return in1;
   }
 
+  evaluateUnary32(sizeout: number, sizein: number, in1: number): number {
+    return in1;
+  }
+
   recoverInputUnary(sizeout: number, out: bigint, sizein: number): bigint {
     const mask = calc_mask(sizein);
     if ((mask & out) !== out) {
@@ -433,12 +536,18 @@ export class OpBehaviorIntZext extends OpBehavior {
 export class OpBehaviorIntSext extends OpBehavior {
   constructor() {
     super(OpCode.CPUI_INT_SEXT, true);
+    this.has32 = true;
   }
 
   evaluateUnary(sizeout: number, sizein: number, in1: bigint): bigint {
     return sign_extend(in1, sizein, sizeout);
   }
 
+  evaluateUnary32(sizeout: number, sizein: number, in1: number): number {
+    const sa = 32 - 8 * sizein;
+    return (((in1 << sa) >> sa) & MASK32[sizeout]) >>> 0;
+  }
+
   recoverInputUnary(sizeout: number, out: bigint, sizein: number): bigint {
     const masklong = calc_mask(sizeout);
     const maskshort = calc_mask(sizein);
@@ -462,12 +571,17 @@ export class OpBehaviorIntSext extends OpBehavior {
 export class OpBehaviorIntAdd extends OpBehavior {
   constructor() {
     super(OpCode.CPUI_INT_ADD, false);
+    this.has32 = true;
   }
 
   evaluateBinary(sizeout: number, sizein: number, in1: bigint, in2: bigint): bigint {
     return (in1 + in2) & calc_mask(sizeout);
   }
 
+  evaluateBinary32(sizeout: number, sizein: number, in1: number, in2: number): number {
+    return ((in1 + in2) & MASK32[sizeout]) >>> 0;
+  }
+
   recoverInputBinary(slot: number, sizeout: number, out: bigint, sizein: number, inp: bigint): bigint {
     return (out - inp) & calc_mask(sizeout);
   }
@@ -477,12 +591,17 @@ export class OpBehaviorIntAdd extends OpBehavior {
 export class OpBehaviorIntSub extends OpBehavior {
   constructor() {
     super(OpCode.CPUI_INT_SUB, false);
+    this.has32 = true;
   }
 
   evaluateBinary(sizeout: number, sizein: number, in1: bigint, in2: bigint): bigint {
     return (in1 - in2) & calc_mask(sizeout);
   }
 
+  evaluateBinary32(sizeout: number, sizein: number, in1: number, in2: number): number {
+    return ((in1 - in2) & MASK32[sizeout]) >>> 0;
+  }
+
   recoverInputBinary(slot: number, sizeout: number, out: bigint, sizein: number, inp: bigint): bigint {
     let res: bigint;
     if (slot === 0) {
@@ -498,17 +617,23 @@ export class OpBehaviorIntSub extends OpBehavior {
 export class OpBehaviorIntCarry extends OpBehavior {
   constructor() {
     super(OpCode.CPUI_INT_CARRY, false);
+    this.has32 = true;
   }
 
   evaluateBinary(sizeout: number, sizein: number, in1: bigint, in2: bigint): bigint {
     return (in1 > ((in1 + in2) & calc_mask(sizein))) ? 1n : 0n;
   }
+
+  evaluateBinary32(sizeout: number, sizein: number, in1: number, in2: number): number {
+    return (in1 > (((in1 + in2) & MASK32[sizein]) >>> 0)) ? 1 : 0;
+  }
 }
 
 /** CPUI_INT_SCARRY behavior */
 export class OpBehaviorIntScarry extends OpBehavior {
   constructor() {
     super(OpCode.CPUI_INT_SCARRY, false);
+    this.has32 = true;
   }
 
   evaluateBinary(sizeout: number, sizein: number, in1: bigint, in2: bigint): bigint {
@@ -523,12 +648,26 @@ export class OpBehaviorIntScarry extends OpBehavior {
     r &= a;
     return BigInt(r);
   }
+
+  evaluateBinary32(sizeout: number, sizein: number, in1: number, in2: number): number {
+    const res = in1 + in2;
+    const shiftAmt = sizein * 8 - 1;
+    let a = (in1 >>> shiftAmt) & 1;
+    const b = (in2 >>> shiftAmt) & 1;
+    let r = (res >>> shiftAmt) & 1;
+    r ^= a;
+    a ^= b;
+    a ^= 1;
+    r &= a;
+    return r;
+  }
 }
 
 /** CPUI_INT_SBORROW behavior */
 export class OpBehaviorIntSborrow extends OpBehavior {
   constructor() {
     super(OpCode.CPUI_INT_SBORROW, false);
+    this.has32 = true;
   }
 
   evaluateBinary(sizeout: number, sizein: number, in1: bigint, in2: bigint): bigint {
@@ -543,18 +682,36 @@ export class OpBehaviorIntSborrow extends OpBehavior {
     a &= r;
     return BigInt(a);
   }
+
+  evaluateBinary32(sizeout: number, sizein: number, in1: number, in2: number): number {
+    const res = in1 - in2;
+    const shiftAmt = sizein * 8 - 1;
+    let a = (in1 >>> shiftAmt) & 1;
+    const b = (in2 >>> shiftAmt) & 1;
+    let r = (res >>> shiftAmt) & 1;
+    a ^= r;
+    r ^= b;
+    r ^= 1;
+    a &= r;
+    return a;
+  }
 }
 
 /** CPUI_INT_2COMP behavior (two's complement) */
 export class OpBehaviorInt2Comp extends OpBehavior {
   constructor() {
     super(OpCode.CPUI_INT_2COMP, true);
+    this.has32 = true;
   }
 
   evaluateUnary(sizeout: number, sizein: number, in1: bigint): bigint {
     return uintb_negate(in1 - 1n, sizein);
   }
 
+  evaluateUnary32(sizeout: number, sizein: number, in1: number): number {
+    return (~(in1 - 1) & MASK32[sizein]) >>> 0;
+  }
+
   recoverInputUnary(sizeout: number, out: bigint, sizein: number): bigint {
     return uintb_negate(out - 1n, sizein);
   }
@@ -564,12 +721,17 @@ export class OpBehaviorInt2Comp extends OpBehavior {
 export class OpBehaviorIntNegate extends OpBehavior {
   constructor() {
     super(OpCode.CPUI_INT_NEGATE, true);
+    this.has32 = true;
   }
 
   evaluateUnary(sizeout: number, sizein: number, in1: bigint): bigint {
     return uintb_negate(in1, sizein);
   }
 
+  evaluateUnary32(sizeout: number, sizein: number, in1: number): number {
+    return (~in1 & MASK32[sizein]) >>> 0;
+  }
+
   recoverInputUnary(sizeout: number, out: bigint, sizein: number): bigint {
     return uintb_negate(out, sizein);
   }
@@ -579,39 +741,55 @@ export class OpBehaviorIntNegate extends OpBehavior {
 export class OpBehaviorIntXor extends OpBehavior {
   constructor() {
     super(OpCode.CPUI_INT_XOR, false);
+    this.has32 = true;
   }
 
   evaluateBinary(sizeout: number, sizein: number, in1: bigint, in2: bigint): bigint {
     return in1 ^ in2;
   }
+
+  evaluateBinary32(sizeout: number, sizein: number, in1: number, in2: number): number {
+    return (in1 ^ in2) >>> 0;
+  }
 }
 
 /** CPUI_INT_AND behavior */
 export class OpBehaviorIntAnd extends OpBehavior {
   constructor() {
     super(OpCode.CPUI_INT_AND, false);
+    this.has32 = true;
   }
 
   evaluateBinary(sizeout: number, sizein: number, in1: bigint, in2: bigint): bigint {
     return in1 & in2;
   }
+
+  evaluateBinary32(sizeout: number, sizein: number, in1: number, in2: number): number {
+    return (in1 & in2) >>> 0;
+  }
 }
 
 /** CPUI_INT_OR behavior */
 export class OpBehaviorIntOr extends OpBehavior {
   constructor() {
     super(OpCode.CPUI_INT_OR, false);
+    this.has32 = true;
   }
 
   evaluateBinary(sizeout: number, sizein: number, in1: bigint, in2: bigint): bigint {
     return in1 | in2;
   }
+
+  evaluateBinary32(sizeout: number, sizein: number, in1: number, in2: number): number {
+    return (in1 | in2) >>> 0;
+  }
 }
 
 /** CPUI_INT_LEFT behavior */
 export class OpBehaviorIntLeft extends OpBehavior {
   constructor() {
     super(OpCode.CPUI_INT_LEFT, false);
+    this.has32 = true;
   }
 
   evaluateBinary(sizeout: number, sizein: number, in1: bigint, in2: bigint): bigint {
@@ -621,6 +799,13 @@ export class OpBehaviorIntLeft extends OpBehavior {
     return (in1 << in2) & calc_mask(sizeout);
   }
 
+  evaluateBinary32(sizeout: number, sizein: number, in1: number, in2: number): number {
+    if (in2 >= sizeout * 8) {
+      return 0;
+    }
+    return ((in1 << in2) & MASK32[sizeout]) >>> 0;
+  }
+
   recoverInputBinary(slot: number, sizeout: number, out: bigint, sizein: number, inp: bigint): bigint {
     if (slot !== 0 || inp >= BigInt(sizeout * 8)) {
       return super.recoverInputBinary(slot, sizeout, out, sizein, inp);
@@ -637,6 +822,7 @@ export class OpBehaviorIntLeft extends OpBehavior {
 export class OpBehaviorIntRight extends OpBehavior {
   constructor() {
     super(OpCode.CPUI_INT_RIGHT, false);
+    this.has32 = true;
   }
 
   evaluateBinary(sizeout: number, sizein: number, in1: bigint, in2: bigint): bigint {
@@ -646,6 +832,13 @@ export class OpBehaviorIntRight extends OpBehavior {
     return (in1 & calc_mask(sizeout)) >> in2;
   }
 
+  evaluateBinary32(sizeout: number, sizein: number, in1: number, in2: number): number {
+    if (in2 >= sizeout * 8) {
+      return 0;
+    }
+    return ((in1 & MASK32[sizeout]) >>> 0) >>> in2;
+  }
+
   recoverInputBinary(slot: number, sizeout: number, out: bigint, sizein: number, inp: bigint): bigint {
     if (slot !== 0 || inp >= BigInt(sizeout * 8)) {
       return super.recoverInputBinary(slot, sizeout, out, sizein, inp);
@@ -662,6 +855,7 @@ export class OpBehaviorIntRight extends OpBehavior {
 export class OpBehaviorIntSright extends OpBehavior {
   constructor() {
     super(OpCode.CPUI_INT_SRIGHT, false);
+    this.has32 = true;
   }
 
   evaluateBinary(sizeout: number, sizein: number, in1: bigint, in2: bigint): bigint {
@@ -678,6 +872,18 @@ export class OpBehaviorIntSright extends OpBehavior {
     return in1 >> in2;
   }
 
+  evaluateBinary32(sizeout: number, sizein: number, in1: number, in2: number): number {
+    const negative = (in1 & (0x80 << (8 * (sizein - 1)))) !== 0;
+    if (in2 >= 8 * sizeout) {
+      return negative ? MASK32[sizeout] : 0;
+    }
+    if (negative) {
+      const mask = MASK32[sizein];
+      return ((in1 >>> in2) | (((mask >>> in2) ^ mask) >>> 0)) >>> 0;
+    }
+    return in1 >>> in2;
+  }
+
   recoverInputBinary(slot: number, sizeout: number, out: bigint, sizein: number, inp: bigint): bigint {
     if (slot !== 0 || inp >= BigInt(sizeout * 8)) {
       return super.recoverInputBinary(slot, sizeout, out, sizein, inp);
@@ -700,17 +906,23 @@ export class OpBehaviorIntSright extends OpBehavior {
 export class OpBehaviorIntMult extends OpBehavior {
   constructor() {
     super(OpCode.CPUI_INT_MULT, false);
+    this.has32 = true;
   }
 
   evaluateBinary(sizeout: number, sizein: number, in1: bigint, in2: bigint): bigint {
     return (in1 * in2) & calc_mask(sizeout);
   }
+
+  evaluateBinary32(sizeout: number, sizein: number, in1: number, in2: number): number {
+    return (Math.imul(in1, in2) & MASK32[sizeout]) >>> 0;
+  }
 }
 
 /** CPUI_INT_DIV behavior (unsigned division) */
 export class OpBehaviorIntDiv extends OpBehavior {
   constructor() {
     super(OpCode.CPUI_INT_DIV, false);
+    this.has32 = true;
   }
 
   evaluateBinary(sizeout: number, sizein: number, in1: bigint, in2: bigint): bigint {
@@ -719,12 +931,20 @@ export class OpBehaviorIntDiv extends OpBehavior {
     }
     return in1 / in2;
   }
+
+  evaluateBinary32(sizeout: number, sizein: number, in1: number, in2: number): number {
+    if (in2 === 0) {
+      throw new EvaluationError('Divide by 0');
+    }
+    return Math.floor(in1 / in2);
+  }
 }
 
 /** CPUI_INT_SDIV behavior (signed division) */
 export class OpBehaviorIntSdiv extends OpBehavior {
   constructor() {
     super(OpCode.CPUI_INT_SDIV, false);
+    this.has32 = true;
   }
 
   evaluateBinary(sizeout: number, sizein: number, in1: bigint, in2: bigint): bigint {
@@ -737,12 +957,24 @@ export class OpBehaviorIntSdiv extends OpBehavior {
     sres = zero_extend(sres, 8 * sizeout - 1);
     return BigInt.asUintN(64, sres);
   }
+
+  evaluateBinary32(sizeout: number, sizein: number, in1: number, in2: number): number {
+    if (in2 === 0) {
+      throw new EvaluationError('Divide by 0');
+    }
+    const sa = 32 - 8 * sizein;
+    const num = (in1 << sa) >> sa;
+    const denom = (in2 << sa) >> sa;
+    if (denom === 0) return -1;    // Let the bigint path report the error
+    return (Math.trunc(num / denom) & MASK32[sizeout]) >>> 0;
+  }
 }
 
 /** CPUI_INT_REM behavior (unsigned remainder) */
 export class OpBehaviorIntRem extends OpBehavior {
   constructor() {
     super(OpCode.CPUI_INT_REM, false);
+    this.has32 = true;
   }
 
   evaluateBinary(sizeout: number, sizein: number, in1: bigint, in2: bigint): bigint {
@@ -751,12 +983,20 @@ export class OpBehaviorIntRem extends OpBehavior {
     }
     return in1 % in2;
   }
+
+  evaluateBinary32(sizeout: number, sizein: number, in1: number, in2: number): number {
+    if (in2 === 0) {
+      throw new EvaluationError('Remainder by 0');
+    }
+    return in1 % in2;
+  }
 }
 
 /** CPUI_INT_SREM behavior (signed remainder) */
 export class OpBehaviorIntSrem extends OpBehavior {
   constructor() {
     super(OpCode.CPUI_INT_SREM, false);
+    this.has32 = true;
   }
 
   evaluateBinary(sizeout: number, sizein: number, in1: bigint, in2: bigint): bigint {
@@ -769,50 +1009,81 @@ export class OpBehaviorIntSrem extends OpBehavior {
     sres = zero_extend(sres, 8 * sizeout - 1);
     return BigInt.asUintN(64, sres);
   }
+
+  evaluateBinary32(sizeout: number, sizein: number, in1: number, in2: number): number {
+    if (in2 === 0) {
+      throw new EvaluationError('Remainder by 0');
+    }
+    const sa = 32 - 8 * sizein;
+    const val = (in1 << sa) >> sa;
+    const mod = (in2 << sa) >> sa;
+    if (mod === 0) return -1;      // Let the bigint path report the error
+    return ((val % mod) & MASK32[sizeout]) >>> 0;
+  }
 }
 
 /** CPUI_BOOL_NEGATE behavior */
 export class OpBehaviorBoolNegate extends OpBehavior {
   constructor() {
     super(OpCode.CPUI_BOOL_NEGATE, true);
+    this.has32 = true;
   }
 
   evaluateUnary(sizeout: number, sizein: number, in1: bigint): bigint {
     return in1 ^ 1n;
   }
+
+  evaluateUnary32(sizeout: number, sizein: number, in1: number): number {
+    return (in1 ^ 1) >>> 0;
+  }
 }
 
 /** CPUI_BOOL_XOR behavior */
 export class OpBehaviorBoolXor extends OpBehavior {
   constructor() {
     super(OpCode.CPUI_BOOL_XOR, false);
+    this.has32 = true;
   }
 
   evaluateBinary(sizeout: number, sizein: number, in1: bigint, in2: bigint): bigint {
     return in1 ^ in2;
   }
+
+  evaluateBinary32(sizeout: number, sizein: number, in1: number, in2: number): number {
+    return (in1 ^ in2) >>> 0;
+  }
 }
 
 /** CPUI_BOOL_AND behavior */
 export class OpBehaviorBoolAnd extends OpBehavior {
   constructor() {
     super(OpCode.CPUI_BOOL_AND, false);
+    this.has32 = true;
   }
 
   evaluateBinary(sizeout: number, sizein: number, in1: bigint, in2: bigint): bigint {
     return in1 & in2;
   }
+
+  evaluateBinary32(sizeout: number, sizein: number, in1: number, in2: number): number {
+    return (in1 & in2) >>> 0;
+  }
 }
 
 /** CPUI_BOOL_OR behavior */
 export class OpBehaviorBoolOr extends OpBehavior {
   constructor() {
     super(OpCode.CPUI_BOOL_OR, false);
+    this.has32 = true;
   }
 
   evaluateBinary(sizeout: number, sizein: number, in1: bigint, in2: bigint): bigint {
     return in1 | in2;
   }
+
+  evaluateBinary32(sizeout: number, sizein: number, in1: number, in2: number): number {
+    return (in1 | in2) >>> 0;
+  }
 }
 
 // ---------------------------------------------------------------------------
@@ -1155,11 +1426,20 @@ export class OpBehaviorFloatRound extends OpBehavior {
 export class OpBehaviorPiece extends OpBehavior {
   constructor() {
     super(OpCode.CPUI_PIECE, false);
+    this.has32 = true;
   }
 
   evaluateBinary(sizeout: number, sizein: number, in1: bigint, in2: bigint): bigint {
     return (in1 << BigInt((sizeout - sizein) * 8)) | in2;
   }
+
+  evaluateBinary32(sizeout: number, sizein: number, in1: number, in2: number): number {
+    const sa = sizeout - sizein;
+    if (sa < 0) return -1;
+    const hi = in1 * POW2_BYTES[sa];
+    if (hi > 0xFFFFFFFF) return -1;  // Result does not fit in 32 bits
+    return (hi | in2) >>> 0;
+  }
 }
 
 /** CPUI_SUBPIECE behavior - Truncate / extract a sub-piece */
@@ -7,6 +7,7 @@
  */
 
 import * as fs from 'fs';
+import { StringDecoder } from 'string_decoder';
 import { DecoderError } from './error.js';
 
 // ---------------------------------------------------------------------------
@@ -276,6 +277,64 @@ export class Document extends Element {
   }
 }
 
+// ---------------------------------------------------------------------------
+// BinaryContentElement  (hex content decoded during parsing)
+// ---------------------------------------------------------------------------
+
+/** Value of a hex digit character code, or -1 */
+function hexDigitValue(c: number): number {
+  if (c >= 0x30 && c <= 0x39) return c - 0x30;
+  if (c >= 0x61 && c <= 0x66) return c - 0x57;
+  if (c >= 0x41 && c <= 0x46) return c - 0x37;
+  return -1;
+}
+
+/**
+ * An Element whose character content is hex encoded bytes, such as a \<bytechunk\>.
+ *
+ * Content is decoded into a byte buffer as the parser delivers it, so the hex text is never
+ * held as a string. Whitespace and other non-hex characters are ignored.
+ */
+export class BinaryContentElement extends Element {
+  private bytes: Uint8Array = new Uint8Array(256);
+  private count: number = 0;
+  private pending: number = -1;     // High nibble waiting for its low nibble
+
+  override addContent(str: string, start: number, length: number): void {
+    const end = start + length;
+    for (let i = start; i < end; ++i) {
+      const v = hexDigitValue(str.charCodeAt(i));
+      if (v < 0) continue;
+      if (this.pending < 0) {
+        this.pending = v;
+        continue;
+      }
+      if (this.count === this.bytes.length) {
+        const grown = new Uint8Array(Math.max(256, this.bytes.length * 2));
+        grown.set(this.bytes);
+        this.bytes = grown;
+      }
+      this.bytes[this.count++] = (this.pending << 4) | v;
+      this.pending = -1;
+    }
+  }
+
+  /** Get the decoded bytes, trimming the buffer so it holds nothing past the content */
+  getBytes(): Uint8Array {
+    if (this.bytes.length !== this.count)
+      this.bytes = this.bytes.slice(0, this.count);
+    return this.bytes;
+  }
+
+  /** Get the content re-encoded as hex, for callers that expect text */
+  override getContent(): string {
+    let res = '';
+    for (let i = 0; i < this.count; ++i)
+      res += this.bytes[i].toString(16).padStart(2, '0');
+    return res;
+  }
+}
+
 // ---------------------------------------------------------------------------
 // TreeHandler  (SAX -> DOM builder)
 // ---------------------------------------------------------------------------
@@ -296,6 +355,15 @@ export class TreeHandler implements ContentHandler {
     this.cur = root;
   }
 
+  /**
+   * Create the node for a new element.
+   * @param parent - the parent of the new element
+   * @param _name - the tag name of the new element
+   */
+  protected createElement(parent: Element, _name: string): Element {
+    return new Element(parent);
+  }
+
   startDocument(): void {}
 
   endDocument(): void {}
@@ -306,7 +374,7 @@ export class TreeHandler implements ContentHandler {
     _qualifiedName: string,
     atts: Attributes,
   ): void {
-    const newel = new Element(this.cur);
+    const newel = this.createElement(this.cur, localName);
     this.cur.addChild(newel);
     this.cur = newel;
     newel.setName(localName);
@@ -340,6 +408,23 @@ export class TreeHandler implements ContentHandler {
   }
 }
 
+/**
+ * A TreeHandler that decodes the content of selected tags (by default \<bytechunk\>) straight
+ * into byte buffers, using BinaryContentElement. Used for streaming in large program exports.
+ */
+export class ImageTreeHandler extends TreeHandler {
+  private binaryTags: Set<string>;
+
+  constructor(root: Element, binaryTags: string[] = ['bytechunk']) {
+    super(root);
+    this.binaryTags = new Set(binaryTags);
+  }
+
+  protected override createElement(parent: Element, name: string): Element {
+    return this.binaryTags.has(name) ? new BinaryContentElement(parent) : new Element(parent);
+  }
+}
+
 // ---------------------------------------------------------------------------
 // DocumentStorage
 // ---------------------------------------------------------------------------
@@ -400,6 +485,25 @@ export class DocumentStorage {
     const content = fs.readFileSync(filename, 'utf-8');
     return this.parseDocument(content);
   }
+
+  /**
+   * Parse an XML file incrementally, without reading it into a single string.
+   *
+   * The file is read in fixed size blocks, and the content of \<bytechunk\> tags is decoded
+   * into byte buffers as it is parsed (see ImageTreeHandler), so peak memory is the DOM of the
+   * remaining tags plus the decoded image bytes.
+   * @param filename - the path to the XML file
+   * @returns the parsed Document
+   */
+  openDocumentStream(filename: string): Document {
+    const doc = new Document();
+    const handler = new ImageTreeHandler(doc);
+    if (xml_parse_file(filename, handler) !== 0) {
+      throw new DecoderError(handler.getError());
+    }
+    this.doclist.push(doc);
+    return doc;
+  }
 }
 
 // ---------------------------------------------------------------------------
@@ -410,13 +514,31 @@ export class DocumentStorage {
  * Internal parser state for the recursive descent XML parser.
  */
 class XmlParser {
+  /** Bytes read from a file per refill, and the consumed prefix that triggers compaction */
+  private static readonly BLOCK_SIZE = 1 << 20;
+
   private input: string;
   private pos: number = 0;
   private handler: ContentHandler;
+  private source: number | null = null;        // File descriptor still being read, if streaming
+  private block: Buffer | null = null;
+  private utf8: StringDecoder | null = null;
+  private consumed: number = 0;                // Characters dropped from the front of input
 
-  constructor(input: string, handler: ContentHandler) {
-    this.input = input;
+  /**
+   * @param input - the XML text, or an open file descriptor to read it from incrementally
+   * @param handler - receives the parse events
+   */
+  constructor(input: string | number, handler: ContentHandler) {
     this.handler = handler;
+    if (typeof input === 'number') {
+      this.input = '';
+      this.source = input;
+      this.block = Buffer.alloc(XmlParser.BLOCK_SIZE);
+      this.utf8 = new StringDecoder('utf8');
+    } else {
+      this.input = input;
+    }
   }
 
   /** Run the parser. Returns 0 on success, non-zero on error. */
@@ -450,28 +572,68 @@ class XmlParser {
 
   // ---- Utility helpers ----
 
+  /**
+   * Append the next block of a streamed file to the input.
+   * @returns false if there is no more input
+   */
+  private fill(): boolean {
+    while (this.source !== null) {
+      const n = fs.readSync(this.source, this.block!, 0, this.block!.length, null);
+      const text = n === 0 ? this.utf8!.end() : this.utf8!.write(this.block!.subarray(0, n));
+      if (n === 0) this.source = null;
+      if (text.length > 0) {
+        this.input += text;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /** Make sure at least n characters past the current position are loaded, if possible. */
+  private ensure(n: number): void {
+    while (this.input.length - this.pos < n && this.fill()) {
+      // keep reading
+    }
+  }
+
+  /**
+   * Drop consumed input when streaming. Only called between pieces of content, where no
+   * caller holds a start index into the input.
+   */
+  private compact(): void {
+    if (this.source !== null && this.pos >= XmlParser.BLOCK_SIZE) {
+      this.input = this.input.substring(this.pos);
+      this.consumed += this.pos;
+      this.pos = 0;
+    }
+  }
+
   /** Check if end of input has been reached. */
   private eof(): boolean {
-    return this.pos >= this.input.length;
+    return this.pos >= this.input.length && !this.fill();
   }
 
   /** Peek at the current character without consuming. */
   private peek(): string {
+    if (this.pos >= this.input.length) this.fill();
     return this.input[this.pos];
   }
 
   /** Peek at a character at offset i from current position. */
   private peekAt(i: number): string {
+    this.ensure(i + 1);
     return this.input[this.pos + i];
   }
 
   /** Get the current character and advance. */
   private advance(): string {
+    if (this.pos >= this.input.length) this.fill();
     return this.input[this.pos++];
   }
 
   /** Check if the remaining input starts with the given string. */
   private lookingAt(s: string): boolean {
+    this.ensure(s.length);
     return this.input.startsWith(s, this.pos);
   }
 
@@ -501,7 +663,7 @@ class XmlParser {
     const contextStart = Math.max(0, this.pos - 20);
     const contextEnd = Math.min(this.input.length, this.pos + 20);
     const context = this.input.substring(contextStart, contextEnd);
-    throw new DecoderError(`${msg} at position ${this.pos} near: "${context}"`);
+    throw new DecoderError(`${msg} at position ${this.consumed + this.pos} near: "${context}"`);
   }
 
   // ---- Naming ----
@@ -676,6 +838,7 @@ class XmlParser {
    */
   private parseContent(): void {
     while (!this.eof()) {
+      this.compact();
       if (this.lookingAt('</')) {
         // End tag -- caller will handle it
         return;
@@ -836,6 +999,30 @@ export function xml_parse(input: string, handler: ContentHandler): number {
   return parser.parse();
 }
 
+/**
+ * Run the XML parser over a file, reading it incrementally.
+ *
+ * The file is never held in memory as a whole. Only the unparsed part of the current block
+ * (plus any single text run that spans blocks) is kept.
+ * @param filename - the path to the XML file
+ * @param handler - the ContentHandler that stores or processes the XML content events
+ * @returns 0 if there is no error during parsing or a non-zero error condition
+ */
+export function xml_parse_file(filename: string, handler: ContentHandler): number {
+  let fd: number;
+  try {
+    fd = fs.openSync(filename, 'r');
+  } catch (e: any) {
+    handler.setError('Unable to open ' + filename + ': ' + (e.message ?? String(e)));
+    return 1;
+  }
+  try {
+    return new XmlParser(fd, handler).parse();
+  } finally {
+    fs.closeSync(fd);
+  }
+}
+
 /**
  * Parse the given XML string into an in-memory document.
  *
@@ -8,6 +8,8 @@ import type { int4, uint4 } from '../core/types.js';
 import { OPACTION_DEBUG } from '../core/types.js';
 import { OpCode } from '../core/opcodes.js';
 import { LowlevelError } from '../core/error.js';
+import { ActionProfiler } from './actionprofile.js';
+import { EventTracer } from './eventtrace.js';
 
 // ---------------------------------------------------------------------------
 // Forward type declarations for types from not-yet-written modules
@@ -56,6 +58,134 @@ function nextSpecifyTerm(specify: string): { token: string; remain: string } {
   }
 }
 
+// ---------------------------------------------------------------------------
+// ActionBudget
+// ---------------------------------------------------------------------------
+
+/** Limits applied to the decompilation of a single function */
+export interface ActionBudgetLimits {
+  /** Wall-clock limit in milliseconds */
+  timeMs?: number;
+  /** Limit on growth of the JS heap, in megabytes, relative to the start of the function */
+  heapGrowthMb?: number;
+}
+
+/**
+ * Thrown from a safe point in the action loop when the active ActionBudget is exhausted.
+ *
+ * The action tree and the Funcdata are left mid-transformation. Both are restored by the
+ * usual reset() / clearAnalysis() before the next function is decompiled.
+ */
+export class ActionBudgetExceeded extends LowlevelError {
+  /** Which limit was hit */
+  readonly reason: 'time' | 'memory';
+  /** Name of the Action that was running when the limit was detected */
+  readonly actionName: string;
+  /** Time since the budget started, in milliseconds */
+  readonly elapsedMs: number;
+
+  constructor(reason: 'time' | 'memory', actionName: string, elapsedMs: number) {
+    super((reason === 'time' ? 'Timed out' : 'Exceeded memory budget') +
+          ` in ${actionName} after ${Math.round(elapsedMs)}ms`);
+    this.name = 'ActionBudgetExceeded';
+    this.reason = reason;
+    this.actionName = actionName;
+    this.elapsedMs = elapsedMs;
+  }
+}
+
+/**
+ * A time and heap-growth budget for decompiling one function.
+ *
+ * While a budget is active (ActionBudget.run), Action.perform and the ActionPool sweep
+ * call check() / poll() at safe points, between applications of an Action and between
+ * ops of a pool sweep. An overrun throws ActionBudgetExceeded, which unwinds to the caller
+ * of the root Action. The time is read on every check; the heap is sampled less often
+ * because process.memoryUsage() is comparatively expensive.
+ */
+export class ActionBudget {
+  /** The budget of the function currently being decompiled, if any */
+  static active: ActionBudget | null = null;
+
+  private static readonly POLL_INTERVAL = 64;   ///< Pool ops between checks
+  private static readonly HEAP_INTERVAL = 32;   ///< Checks between heap samples
+
+  private start: number;
+  private deadline: number;
+  private heapLimit: number;
+  private polls: number = 0;
+  private checks: number = 0;
+  /** The overrun that ended the run, if any */
+  exceeded: ActionBudgetExceeded | null = null;
+
+  constructor(limits: ActionBudgetLimits) {
+    this.start = performance.now();
+    const timeMs = limits.timeMs ?? 0;
+    this.deadline = timeMs > 0 ? this.start + timeMs : Infinity;
+    const heapMb = limits.heapGrowthMb ?? 0;
+    this.heapLimit = (heapMb > 0 && typeof process !== 'undefined')
+      ? process.memoryUsage().heapUsed + heapMb * 1024 * 1024
+      : Infinity;
+  }
+
+  /** Return true if these limits would produce a budget that can be exceeded */
+  static isLimited(limits: ActionBudgetLimits | null | undefined): boolean {
+    return limits != null && ((limits.timeMs ?? 0) > 0 || (limits.heapGrowthMb ?? 0) > 0);
+  }
+
+  /**
+   * Run a callback with the given budget active, restoring the previous one afterward.
+   * @param budget the budget to install
+   * @param fn the work to perform, typically Action.perform on the root action
+   * @returns the result of fn
+   */
+  static run<T>(budget: ActionBudget, fn: () => T): T {
+    const prev = ActionBudget.active;
+    ActionBudget.active = budget;
+    try {
+      return fn();
+    } finally {
+      ActionBudget.active = prev;
+    }
+  }
+
+  /** Milliseconds since this budget was created */
+  elapsed(): number {
+    return performance.now() - this.start;
+  }
+
+  /**
+   * Check the limits at a safe point.
+   * @param actionName the Action currently executing, reported on overrun
+   */
+  check(actionName: string): void {
+    if (performance.now() > this.deadline) {
+      this.exceed('time', actionName);
+    }
+    if (this.heapLimit !== Infinity && ++this.checks >= ActionBudget.HEAP_INTERVAL) {
+      this.checks = 0;
+      if (process.memoryUsage().heapUsed > this.heapLimit)
+        this.exceed('memory', actionName);
+    }
+  }
+
+  /**
+   * Cheaper form of check() for tight loops: only every POLL_INTERVAL-th call checks.
+   * @param actionName the Action currently executing, reported on overrun
+   */
+  poll(actionName: string): void {
+    if (++this.polls >= ActionBudget.POLL_INTERVAL) {
+      this.polls = 0;
+      this.check(actionName);
+    }
+  }
+
+  private exceed(reason: 'time' | 'memory', actionName: string): never {
+    this.exceeded = new ActionBudgetExceeded(reason, actionName, this.elapsed());
+    throw this.exceeded;
+  }
+}
+
 // ---------------------------------------------------------------------------
 // ActionGroupList
 // ---------------------------------------------------------------------------
@@ -69,6 +199,11 @@ function nextSpecifyTerm(specify: string): { token: string; remain: string } {
  */
 export class ActionGroupList {
   list: Set<string> = new Set<string>();
+  /**
+   * Caps on named groups of the root Action: the number of times a repeating ActionGroup
+   * applies, or the number of restarts of an ActionRestartGroup
+   */
+  limits: Map<string, number> = new Map<string, number>();
 
   /**
    * Check if this ActionGroupList contains a given group.
@@ -78,6 +213,150 @@ export class ActionGroupList {
   contains(nm: string): boolean {
     return this.list.has(nm);
   }
+
+  /**
+   * Get the cap on a named group.
+   * @param nm the name of the ActionGroup
+   * @param def the value to return if there is no cap
+   * @returns the cap or the default
+   */
+  getLimit(nm: string, def: number): number {
+    return this.limits.get(nm) ?? def;
+  }
+}
+
+// ---------------------------------------------------------------------------
+// ActionJobState
+// ---------------------------------------------------------------------------
+
+/**
+ * The traversal state of one ActionPool within an ActionJobState.
+ */
+export class ActionPoolState {
+  op_state: any = null;                   // Iterator state for PcodeOp traversal
+  rule_index: number = 0;
+  useWorklist: boolean = false;           // Retest only dirty ops after the first sweep
+  sweepAll: boolean = true;               // Current sweep tests every op
+  sweepStart: number = 0;                 // Change count at the start of the current sweep
+  dirty: Set<PcodeOp> = new Set();        // Ops to retest in worklist mode
+}
+
+/**
+ * The mutable state of one run of a root Action.
+ *
+ * The Actions and Rules of a derived root hold only their definition (names, groups,
+ * properties, child lists and per-opcode Rule tables) and their statistics, so one tree is
+ * shared by every job decompiling with it. What changes while a function is transformed is
+ * kept here instead, in a record per Action: the change counts, status and breakpoints, the
+ * position of an ActionGroup in its list, the restarts of an ActionRestartGroup or the scalar
+ * state of a leaf Action. Rule breakpoints and the traversal state of each ActionPool are
+ * kept alongside. Creating one allocates two typed arrays; pool state is created on first use.
+ */
+export class ActionJobState {
+  static readonly LCOUNT = 0;       // Changes not including the last call to apply()
+  static readonly COUNT = 1;        // Changes made so far in the current perform()
+  static readonly STATUS = 2;       // Current status
+  static readonly BREAK = 3;        // Breakpoint properties
+  static readonly INDEX = 4;        // Current action index of an ActionGroup
+  static readonly LOCAL = 5;        // Per-function scalar (restarts of an ActionRestartGroup, ...)
+  static readonly STRIDE = 6;       // Fields per Action
+
+  readonly layout: ActionStateLayout;
+  readonly actions: Int32Array;     // STRIDE fields per Action of the tree
+  readonly rules: Uint8Array;       // Breakpoint properties per Rule of the tree
+  private pools: (ActionPoolState | null)[];
+
+  /**
+   * @param layout the layout of the tree this state is for
+   * @param numActions the number of Actions in the tree
+   * @param numRules the number of Rules in the tree
+   * @param numPools the number of ActionPools in the tree
+   */
+  constructor(layout: ActionStateLayout, numActions: number, numRules: number, numPools: number) {
+    this.layout = layout;
+    this.actions = new Int32Array(numActions * ActionJobState.STRIDE);
+    for (let i = ActionJobState.STATUS; i < this.actions.length; i += ActionJobState.STRIDE)
+      this.actions[i] = Action.status_start;
+    this.rules = new Uint8Array(numRules);
+    this.pools = new Array(numPools).fill(null);
+  }
+
+  /**
+   * Get the traversal state of an ActionPool, creating it on first use.
+   * @param slot the pool's index within the layout
+   */
+  pool(slot: number): ActionPoolState {
+    let res = this.pools[slot];
+    if (res === null) {
+      res = new ActionPoolState();
+      this.pools[slot] = res;
+    }
+    return res;
+  }
+}
+
+/**
+ * Assignment of ActionJobState records to the Actions and Rules of one tree.
+ *
+ * A root derived by the ActionDatabase is laid out once, after cloning. Each of its Actions
+ * and Rules refers to the layout and to its own record, and reads its execution state from
+ * the ActionJobState currently bound to the layout: the tree's own (home) state unless a job
+ * has bound another. Actions and Rules are created detached, each laid out on its own.
+ */
+export class ActionStateLayout {
+  private numActions: number = 0;
+  private numRules: number = 0;
+  private numPools: number = 0;
+  /** State of the tree when no job has bound its own */
+  home!: ActionJobState;
+  /** The bound state, read by every Action and Rule of the tree */
+  state!: ActionJobState;
+
+  /** Reserve a record for an Action, returning its offset in ActionJobState.actions */
+  addAction(): number {
+    return ActionJobState.STRIDE * this.numActions++;
+  }
+
+  /** Reserve a record for a Rule, returning its index in ActionJobState.rules */
+  addRule(): number {
+    return this.numRules++;
+  }
+
+  /** Reserve state for an ActionPool, returning its pool slot */
+  addPool(): number {
+    return this.numPools++;
+  }
+
+  /** Create a fresh state for a job, with every Action at status_start and no breakpoints */
+  newState(): ActionJobState {
+    return new ActionJobState(this, this.numActions, this.numRules, this.numPools);
+  }
+
+  /** Finish the layout, creating the home state */
+  private seal(): void {
+    this.home = this.newState();
+    this.state = this.home;
+  }
+
+  /** A layout for a single Action or Rule, not yet part of a laid out tree, using slot 0 of each */
+  static detached(): ActionStateLayout {
+    const res = new ActionStateLayout();
+    res.numActions = 1;
+    res.numRules = 1;
+    res.numPools = 1;
+    res.seal();
+    return res;
+  }
+
+  /**
+   * Lay out the tree under a root Action, replacing the layouts of its nodes.
+   * @param root the root Action
+   */
+  static attach(root: Action): void {
+    const res = new ActionStateLayout();
+    root.layoutState(res);
+    res.seal();
+  }
 }
 
 // ---------------------------------------------------------------------------
@@ -116,15 +395,14 @@ export abstract class Action {
   static readonly break_action = 4;
   static readonly tmpbreak_action = 8;
 
-  protected lcount: number;          // Changes not including last call to apply()
-  protected count: number;           // Number of changes made by this action so far
-  protected status: number;          // Current status
-  protected breakpoint: number;      // Breakpoint properties
   protected flags: number;           // Behavior properties
   protected count_tests: number;     // Number of times apply() has been called
   protected count_apply: number;     // Number of times apply() made changes
   protected name: string;            // Name of the action
   protected basegroup: string;       // Base group this action belongs to
+  protected maxrepeats: number;      // Most applications per perform() with rule_repeatapply (-1 = no cap)
+  protected stateLayout: ActionStateLayout;  // Layout of the tree, holding the bound ActionJobState
+  protected stateSlot: number;       // Offset of this Action's record in ActionJobState.actions
 
   /**
    * Base constructor for an Action.
@@ -134,14 +412,66 @@ export abstract class Action {
    */
   constructor(f: number, nm: string, g: string) {
     this.flags = f;
-    this.status = Action.status_start;
-    this.breakpoint = 0;
     this.name = nm;
     this.basegroup = g;
     this.count_tests = 0;
     this.count_apply = 0;
-    this.lcount = 0;
-    this.count = 0;
+    this.maxrepeats = -1;
+    this.stateLayout = ActionStateLayout.detached();
+    this.stateSlot = 0;
+  }
+
+  // Execution state, read from the ActionJobState bound to the tree
+
+  /** Changes not including last call to apply() */
+  protected get lcount(): number { return this.stateLayout.state.actions[this.stateSlot + ActionJobState.LCOUNT]; }
+  protected set lcount(v: number) { this.stateLayout.state.actions[this.stateSlot + ActionJobState.LCOUNT] = v; }
+
+  /** Number of changes made by this action so far */
+  protected get count(): number { return this.stateLayout.state.actions[this.stateSlot + ActionJobState.COUNT]; }
+  protected set count(v: number) { this.stateLayout.state.actions[this.stateSlot + ActionJobState.COUNT] = v; }
+
+  /** Current status */
+  protected get status(): number { return this.stateLayout.state.actions[this.stateSlot + ActionJobState.STATUS]; }
+  protected set status(v: number) { this.stateLayout.state.actions[this.stateSlot + ActionJobState.STATUS] = v; }
+
+  /** Breakpoint properties */
+  protected get breakpoint(): number { return this.stateLayout.state.actions[this.stateSlot + ActionJobState.BREAK]; }
+  protected set breakpoint(v: number) { this.stateLayout.state.actions[this.stateSlot + ActionJobState.BREAK] = v; }
+
+  /** A per-function scalar, for derived classes that keep one */
+  protected get local(): number { return this.stateLayout.state.actions[this.stateSlot + ActionJobState.LOCAL]; }
+  protected set local(v: number) { this.stateLayout.state.actions[this.stateSlot + ActionJobState.LOCAL] = v; }
+
+  /**
+   * Take a record in the given layout, as part of laying out a tree.
+   * @param layout the layout of the tree containing this Action
+   */
+  layoutState(layout: ActionStateLayout): void {
+    this.stateLayout = layout;
+    this.stateSlot = layout.addAction();
+  }
+
+  /**
+   * Create a fresh execution state for the tree rooted at this Action.
+   * @returns the state, to be bound with bindJobState()
+   */
+  newJobState(): ActionJobState {
+    return this.stateLayout.newState();
+  }
+
+  /**
+   * Bind an execution state to the tree rooted at this Action.
+   * Until the next bind, every Action and Rule of the tree runs against the given state.
+   * @param st the state to bind, from newJobState()
+   * @returns the previously bound state
+   */
+  bindJobState(st: ActionJobState): ActionJobState {
+    if (st.layout !== this.stateLayout)
+      throw new LowlevelError("Job state does not belong to action " + this.name);
+    const prev = this.stateLayout.state;
+    this.stateLayout.state = st;
+    return prev;
   }
 
   /**
@@ -236,8 +566,11 @@ export abstract class Action {
    */
   perform(data: Funcdata): number {
     let res: number;
+    let rounds = 0;
+    const budget = ActionBudget.active;
 
     do {
+      if (budget !== null) budget.check(this.getName());
       switch (this.status) {
         case Action.status_start:
           this.count = 0;
@@ -255,7 +588,11 @@ export abstract class Action {
           if (OPACTION_DEBUG) {
             data.debugActivate();
           }
-          res = this.apply(data);
+          if (EventTracer.active === null)
+            res = ActionProfiler.active === null ? this.apply(data) : ActionProfiler.active.applyAction(this, data);
+          else
+            res = EventTracer.active.traceAction(this.getName(), data, () =>
+              ActionProfiler.active === null ? this.apply(data) : ActionProfiler.active.applyAction(this, data));
           if (OPACTION_DEBUG) {
             data.debugModPrint(this.getName());
           }
@@ -284,7 +621,8 @@ export abstract class Action {
           break;
       }
       this.status = Action.status_repeat;
-    } while ((this.lcount < this.count) && ((this.flags & Action.rule_repeatapply) !== 0));
+    } while ((this.lcount < this.count) && ((this.flags & Action.rule_repeatapply) !== 0) &&
+             (this.maxrepeats < 0 || ++rounds < this.maxrepeats));
 
     if ((this.flags & (Action.rule_onceperfunc | Action.rule_oneactperfunc)) !== 0) {
       if ((this.count > 0) || ((this.flags & Action.rule_onceperfunc) !== 0))
@@ -392,6 +730,9 @@ export abstract class Action {
   /** Get the number of times apply() made changes */
   getNumApply(): number { return this.count_apply; }
 
+  /** Get the number of changes made so far in the current perform() */
+  getCount(): number { return this.count; }
+
   /**
    * Clone the Action.
    * If this Action is a member of one of the groups in the grouplist,
@@ -503,7 +844,6 @@ export abstract class Action {
  */
 export class ActionGroup extends Action {
   protected list: Action[] = [];
-  protected stateIndex: number = 0;    // Current action index being applied (replaces C++ iterator)
 
   /**
    * Construct given properties and a name.
@@ -514,6 +854,16 @@ export class ActionGroup extends Action {
     super(f, nm, "");
   }
 
+  /** Current action index being applied (replaces C++ iterator) */
+  protected get stateIndex(): number { return this.stateLayout.state.actions[this.stateSlot + ActionJobState.INDEX]; }
+  protected set stateIndex(v: number) { this.stateLayout.state.actions[this.stateSlot + ActionJobState.INDEX] = v; }
+
+  layoutState(layout: ActionStateLayout): void {
+    super.layoutState(layout);
+    for (const ac of this.list)
+      ac.layoutState(layout);
+  }
+
   /**
    * Add an Action to the group.
    * To be used only during the construction of this ActionGroup.
@@ -534,8 +884,10 @@ export class ActionGroup extends Action {
     for (const ac of this.list) {
       const cloned = ac.clone(grouplist);
       if (cloned !== null) {
-        if (res === null)
+        if (res === null) {
           res = new ActionGroup(this.flags, this.getName());
+          res.maxrepeats = grouplist.getLimit(this.getName(), this.maxrepeats);
+        }
         res.addAction(cloned);
       }
     }
@@ -680,7 +1032,6 @@ export class ActionGroup extends Action {
  */
 export class ActionRestartGroup extends ActionGroup {
   private maxrestarts: number;
-  private curstart: number = 0;
 
   /**
    * Construct providing maximum number of restarts.
@@ -693,13 +1044,17 @@ export class ActionRestartGroup extends ActionGroup {
     this.maxrestarts = max;
   }
 
+  /** Number of restarts so far, or -1 once finished */
+  private get curstart(): number { return this.local; }
+  private set curstart(v: number) { this.local = v; }
+
   clone(grouplist: ActionGroupList): Action | null {
     let res: ActionGroup | null = null;
     for (const ac of this.list) {
       const cloned = ac.clone(grouplist);
       if (cloned !== null) {
         if (res === null)
-          res = new ActionRestartGroup(this.flags, this.getName(), this.maxrestarts);
+          res = new ActionRestartGroup(this.flags, this.getName(), grouplist.getLimit(this.getName(), this.maxrestarts));
         res.addAction(cloned);
       }
     }
@@ -730,6 +1085,8 @@ export class ActionRestartGroup extends ActionGroup {
         this.curstart = -1;
         return 0;
       }
+      EventTracer.active?.instant('restart', 'action',
+                                  { function: data.getName(), group: this.getName(), restart: this.curstart });
       data.getArch().clearAnalysis(data);
 
       // Reset everything but ourselves
@@ -765,9 +1122,10 @@ export abstract class Rule {
   static readonly warnings_given = 8;
 
   private flags: number;
-  private breakpoint_: number;
   private name: string;
   private basegroup: string;
+  private stateLayout: ActionStateLayout;  // Layout of the tree, holding the bound ActionJobState
+  private stateSlot: number;      // Index of this Rule's breakpoints in ActionJobState.rules
   count_tests: number;    // public for ActionPool access (friend in C++)
   count_apply: number;    // public for ActionPool access (friend in C++)
 
@@ -780,10 +1138,24 @@ export abstract class Rule {
   constructor(g: string, fl: number, nm: string) {
     this.flags = fl;
     this.name = nm;
-    this.breakpoint_ = 0;
     this.basegroup = g;
     this.count_tests = 0;
     this.count_apply = 0;
+    this.stateLayout = ActionStateLayout.detached();
+    this.stateSlot = 0;
+  }
+
+  /** Breakpoint properties, read from the ActionJobState bound to the tree */
+  private get breakpoint_(): number { return this.stateLayout.state.rules[this.stateSlot]; }
+  private set breakpoint_(v: number) { this.stateLayout.state.rules[this.stateSlot] = v; }
+
+  /**
+   * Take a record in the given layout, as part of laying out a tree.
+   * @param layout the layout of the tree containing this Rule
+   */
+  layoutState(layout: ActionStateLayout): void {
+    this.stateLayout = layout;
+    this.stateSlot = layout.addRule();
   }
 
   /** Return the name of this Rule */
@@ -948,8 +1320,8 @@ export abstract class Rule {
 export class ActionPool extends Action {
   private allrules: Rule[] = [];
   private perop: Rule[][] = [];
-  private op_state: any = null;     // Iterator state for PcodeOp traversal
-  private rule_index: number = 0;
+  private poolSlot: number = 0;     // Index of this pool's ActionPoolState in the job state
+  private watcher: (op: PcodeOp, vn: any) => void;
 
   /**
    * Construct providing properties and name.
@@ -962,6 +1334,45 @@ export class ActionPool extends Action {
     for (let i = 0; i < CPUI_MAX; ++i) {
       this.perop.push([]);
     }
+    this.watcher = (op: PcodeOp, vn: any): void => { this.markDirty(this.poolState().dirty, op, vn); };
+  }
+
+  /** Get the traversal state of this pool in the bound job state */
+  private poolState(): ActionPoolState {
+    return this.stateLayout.state.pool(this.poolSlot);
+  }
+
+  layoutState(layout: ActionStateLayout): void {
+    super.layoutState(layout);
+    this.poolSlot = layout.addPool();
+    for (const rl of this.allrules)
+      rl.layoutState(layout);
+  }
+
+  /**
+   * Queue an edited PcodeOp, and the ops whose view of the data-flow it changes, for retesting.
+   * The ops defining or reading the edited op's operands (and the attached or detached Varnode)
+   * are queued along with the op itself.
+   * @param dirty the worklist of ops to retest
+   * @param op the PcodeOp being edited
+   * @param vn the Varnode being attached or detached, or null
+   */
+  private markDirty(dirty: Set<PcodeOp>, op: PcodeOp, vn: any): void {
+    dirty.add(op);
+    if (vn !== null) ActionPool.markVarnode(dirty, vn);
+    const out = op.getOut();
+    if (out !== null) ActionPool.markVarnode(dirty, out);
+    for (let i = 0; i < op.numInput(); ++i) {
+      const invn = op.getIn(i);
+      if (invn !== null) ActionPool.markVarnode(dirty, invn);
+    }
+  }
+
+  /** Queue the defining op and all reading ops of a Varnode */
+  private static markVarnode(dirty: Set<PcodeOp>, vn: any): void {
+    const def = vn.getDef();
+    if (def !== null) dirty.add(def);
+    for (const d of vn.descend) dirty.add(d);
   }
 
   /**
@@ -984,28 +1395,30 @@ export class ActionPool extends Action {
    * Action breakpoints are checked if the Rule successfully applies.
    * @param op the current PcodeOp
    * @param data the function being transformed
+   * @param ps the traversal state of this pool
    * @returns 0 if no breakpoint, -1 otherwise
    */
-  private processOp(op: PcodeOp, data: Funcdata): number {
+  private processOp(op: PcodeOp, data: Funcdata, ps: ActionPoolState): number {
     let rl: Rule;
     let res: number;
     let opc: number;
+    const prof = ActionProfiler.active;
 
     if (op.isDead()) {
-      this.op_state.next();
+      ps.op_state.next();
       data.opDeadAndGone(op);
-      this.rule_index = 0;
+      ps.rule_index = 0;
       return 0;
     }
     opc = op.code();
-    while (this.rule_index < this.perop[opc].length) {
-      rl = this.perop[opc][this.rule_index++];
+    while (ps.rule_index < this.perop[opc].length) {
+      rl = this.perop[opc][ps.rule_index++];
       if (rl.isDisabled()) continue;
       if (OPACTION_DEBUG) {
         data.debugActivate();
       }
       rl.count_tests += 1;
-      res = rl.applyOp(op, data);
+      res = prof === null ? rl.applyOp(op, data) : prof.applyRule(rl, op, data);
       if (OPACTION_DEBUG) {
         data.debugModPrint(rl.getName());
       }
@@ -1024,28 +1437,70 @@ export class ActionPool extends Action {
         if (op.isDead()) break;
         if (opc !== op.code()) {
           opc = op.code();
-          this.rule_index = 0;
+          ps.rule_index = 0;
         }
       } else if (opc !== op.code()) {
         data.getArch().printMessage("ERROR: Rule " + rl.getName() + " changed op without returning result of 1!");
         opc = op.code();
-        this.rule_index = 0;
+        ps.rule_index = 0;
       }
     }
-    this.op_state.next();
-    this.rule_index = 0;
+    ps.op_state.next();
+    ps.rule_index = 0;
 
     return 0;
   }
 
+  /**
+   * Make one sweep over the ops of the function.
+   *
+   * In worklist mode (the actionworklist option) only the first sweep for a function tests
+   * every op. Later sweeps visit ops in the same order but skip any op that has not been
+   * edited, or had a neighbor edited, since it was last tested. A sweep that skipped ops and
+   * changed nothing is followed by a full sweep, so the pool ends only when no Rule applies
+   * to any op, exactly as without the worklist.
+   *
+   * A Rule that only reads its op and the ops one step away therefore applies at the same
+   * points in the same order as without the worklist. A Rule that looks further can find a
+   * match on a skipped op, which it then applies in a later sweep than the full scan would.
+   */
   apply(data: Funcdata): number {
+    const ps = this.poolState();
     if (this.status !== Action.status_mid) {
-      this.op_state = data.beginOpAll();
-      this.rule_index = 0;
+      ps.op_state = data.beginOpAll();
+      ps.rule_index = 0;
+      if (this.status !== Action.status_repeat) {   // First sweep for this function
+        ps.useWorklist = data.getArch().action_worklist === true;
+        ps.dirty.clear();
+        ps.sweepAll = true;
+      } else {
+        ps.sweepAll = !ps.useWorklist;
+      }
+      ps.sweepStart = this.count;
     }
-    while (!this.op_state.isEnd) {
-      const op = this.op_state.get();
-      if (this.processOp(op, data) !== 0) return -1;
+    const budget = ActionBudget.active;
+    const prevWatcher = ps.useWorklist ? data.setOpWatcher(this.watcher) : null;
+    try {
+      for (;;) {
+        while (!ps.op_state.isEnd) {
+          if (budget !== null) budget.poll(this.getName());
+          const op = ps.op_state.get();
+          if (ps.useWorklist && ps.rule_index === 0) {
+            if (!ps.sweepAll && !ps.dirty.has(op) && !op.isDead()) {
+              ps.op_state.next();
+              continue;
+            }
+            ps.dirty.delete(op);
+          }
+          if (this.processOp(op, data, ps) !== 0) return -1;
+        }
+        if (ps.sweepAll || this.count !== ps.sweepStart) break;
+        // Nothing changed on the worklist: confirm with a full sweep
+        ps.sweepAll = true;
+        ps.op_state = data.beginOpAll();
+      }
+    } finally {
+      if (ps.useWorklist) data.setOpWatcher(prevWatcher);
     }
 
     return 0;
@@ -1072,6 +1527,7 @@ export class ActionPool extends Action {
 
   reset(data: Funcdata): void {
     super.reset(data);
+    this.poolState().dirty.clear();
     for (const rl of this.allrules)
       rl.reset(data);
   }
@@ -1103,8 +1559,9 @@ export class ActionPool extends Action {
   printState(s: { write(s: string): void }): void {
     super.printState(s);
     if (this.status === Action.status_mid) {
-      if (this.op_state !== null && !this.op_state.isEnd) {
-        const op = this.op_state.get();
+      const ps = this.poolState();
+      if (ps.op_state !== null && !ps.op_state.isEnd) {
+        const op = ps.op_state.get();
         s.write(' ' + op.getSeqNum().toString());
       }
     }
@@ -1221,9 +1678,9 @@ export class ActionDatabase {
 
   /**
    * Create a fresh deep clone of the current root Action.
-   * Unlike getCurrent(), this always returns a NEW independent action tree
-   * with reset mutable state. Used for parallel decompilation where each
-   * job needs its own action tree to avoid shared mutable state corruption.
+   * Unlike getCurrent(), this always returns a NEW independent action tree, with its own
+   * statistics. Jobs that only need their own progress state share getCurrent() and bind an
+   * ActionJobState instead (see Action.newJobState()), which is much cheaper.
    * @returns a fresh clone of the current action tree
    */
   cloneCurrentAction(): Action {
@@ -1234,6 +1691,7 @@ export class ActionDatabase {
     const cloned = universal.clone(curgrp);
     if (cloned === null)
       throw new LowlevelError("Failed to clone current action tree");
+    ActionStateLayout.attach(cloned);
     return cloned;
   }
 
@@ -1306,6 +1764,7 @@ export class ActionDatabase {
       this.groupmap.set(grp, curgrp);
     }
     curgrp.list.clear();
+    curgrp.limits.clear();
     for (let i = 0; i < argv.length; ++i) {
       if (argv[i] === '') break;
       curgrp.list.add(argv[i]);
@@ -1313,6 +1772,32 @@ export class ActionDatabase {
     this.isDefaultGroups_ = false;
   }
 
+  /**
+   * Cap a named group within a root Action.
+   * For a repeating ActionGroup the cap is the most times it applies in one perform(); for
+   * an ActionRestartGroup it is the most restarts. A cap of 0 runs either kind of group
+   * through one round only. If the root Action has already been derived, it is derived
+   * again with the new cap.
+   * @param grp the name of the root Action
+   * @param actname the name of the ActionGroup to cap
+   * @param max the cap, or -1 to remove it
+   */
+  setLimit(grp: string, actname: string, max: number): void {
+    const curgrp = this.getGroup(grp);
+    if (max < 0)
+      curgrp.limits.delete(actname);
+    else
+      curgrp.limits.set(actname, max);
+    this.isDefaultGroups_ = false;
+    if (!this.actionmap.has(grp)) return;
+    const newact = this.getAction(ActionDatabase.universalname).clone(curgrp);
+    if (newact === null)
+      throw new LowlevelError("Failed to derive action: " + grp);
+    this.registerAction(grp, newact);
+    if (grp === this.currentactname)
+      this.currentact = newact;
+  }
+
   /**
    * Clone a root Action.
    * Copy an existing root Action by copying its grouplist, giving it a new name.
@@ -1324,6 +1809,8 @@ export class ActionDatabase {
     const newgrp = new ActionGroupList();
     for (const g of curgrp.list)
       newgrp.list.add(g);
+    for (const [nm, max] of curgrp.limits)
+      newgrp.limits.set(nm, max);
     this.groupmap.set(newname, newgrp);
     this.isDefaultGroups_ = false;
   }
@@ -1390,6 +1877,7 @@ export class ActionDatabase {
    * @param act the Action object
    */
   private registerAction(nm: string, act: Action): void {
+    ActionStateLayout.attach(act);
     this.actionmap.set(nm, act);
   }
 
@@ -0,0 +1,328 @@
+/**
+ * @file actionprofile.ts
+ * @description Optional high-resolution timing of Actions and Rules.
+ *
+ * Action.perform and ActionPool.processOp route their apply() / applyOp() calls through the
+ * active ActionProfiler when one is installed. With no profiler installed the cost is one null
+ * check per call. The profiler keeps, per Action and per Rule, the call count, cumulative time,
+ * self time (excluding nested actions and rules) and the worst single call along with the
+ * function it happened in. It also keeps self time per call path, which exports directly as a
+ * folded-stack file for flamegraph tools. Other modules can bump named event counters through
+ * count(), for instance the symbol lookups of ScopeInternal, and report the time of phases
+ * outside the action tree, such as lifting and printing, through addPhase(). Setting
+ * recordFunctions keeps a breakdown per function as well, for the benchmark runner.
+ *
+ * Profiles are plain data (ProfileData) so that workers can send them to the parent over IPC,
+ * where merge() aggregates them.
+ */
+
+// Forward types
+type Funcdata = any;
+type PcodeOp = any;
+
+/** Timing for one Action or Rule */
+export interface ProfileEntry {
+  name: string;
+  kind: 'action' | 'rule';
+  /** Number of timed calls */
+  calls: number;
+  /** Calls that made at least one change */
+  applied: number;
+  /** Cumulative time in milliseconds, including nested actions and rules */
+  totalMs: number;
+  /** Cumulative time in milliseconds, excluding nested actions and rules */
+  selfMs: number;
+  /** Worst single call in milliseconds */
+  maxMs: number;
+  /** Function being decompiled during the worst call */
+  maxFunction: string;
+}
+
+/** Breakdown of the time spent on one function, kept when recordFunctions is set */
+export interface FunctionProfile {
+  name: string;
+  /**
+   * Milliseconds per phase: 'lift', 'print', 'actions' for the root action and
+   * 'action:<name>' for each child of the root action
+   */
+  phases: Record<string, number>;
+  /** Rule applyOp() calls */
+  ruleTests: number;
+  /** Rule applyOp() calls that made a change */
+  ruleApplies: number;
+}
+
+/** Serializable form of a profile */
+export interface ProfileData {
+  /** Number of distinct functions seen */
+  functions: number;
+  entries: ProfileEntry[];
+  /** Self time in microseconds keyed by ';' separated call path */
+  stacks: Record<string, number>;
+  /** Event counts keyed by name (absent in profiles without counters) */
+  counters?: Record<string, number>;
+  /** Milliseconds per phase, as for FunctionProfile (absent in older profiles) */
+  phases?: Record<string, number>;
+  /** Breakdown per function (present when recordFunctions was set) */
+  functionProfiles?: FunctionProfile[];
+}
+
+/**
+ * Collects timing for Actions and Rules while installed as ActionProfiler.active.
+ */
+export class ActionProfiler {
+  /** The installed profiler, or null when profiling is off */
+  static active: ActionProfiler | null = null;
+
+  private entries: Map<string, ProfileEntry> = new Map();
+  private stacks: Map<string, number> = new Map();
+  private counters: Map<string, number> = new Map();
+  private phases: Map<string, number> = new Map();
+  private functionProfiles: FunctionProfile[] = [];
+  private currentProfile: FunctionProfile | null = null;
+  private currentData: Funcdata = null;
+  private pathStack: string[] = [''];
+  private childStack: number[] = [0];
+  private lastFunction: Funcdata = null;
+  private functions = 0;
+  /** Keep a FunctionProfile for each function */
+  recordFunctions = false;
+
+  /** Time the apply() of an Action */
+  applyAction(act: { getName(): string; getCount(): number; apply(data: Funcdata): number },
+              data: Funcdata): number {
+    const name = act.getName();
+    const before = act.getCount();
+    this.enter(name, data);
+    const start = performance.now();
+    try {
+      return act.apply(data);
+    } finally {
+      this.leave('action', name, performance.now() - start, act.getCount() > before, data);
+    }
+  }
+
+  /** Time the applyOp() of a Rule */
+  applyRule(rl: { getName(): string; applyOp(op: PcodeOp, data: Funcdata): number },
+            op: PcodeOp, data: Funcdata): number {
+    const name = rl.getName();
+    this.enter(name, data);
+    const start = performance.now();
+    let res = 0;
+    try {
+      res = rl.applyOp(op, data);
+      return res;
+    } finally {
+      this.leave('rule', name, performance.now() - start, res > 0, data);
+    }
+  }
+
+  /** Add to a named event counter */
+  count(name: string, n: number = 1): void {
+    this.counters.set(name, (this.counters.get(name) ?? 0) + n);
+  }
+
+  /**
+   * Add to the time of a phase outside the action tree, such as lifting or printing.
+   * @param name is the phase
+   * @param ms is the time in milliseconds
+   * @param data is the function the phase ran on
+   */
+  addPhase(name: string, ms: number, data: Funcdata): void {
+    this.phases.set(name, (this.phases.get(name) ?? 0) + ms);
+    if (this.recordFunctions) {
+      const rec = this.functionProfile(data);
+      rec.phases[name] = (rec.phases[name] ?? 0) + ms;
+    }
+  }
+
+  /** Get the time per phase in milliseconds */
+  getPhases(): Record<string, number> {
+    const res: Record<string, number> = {};
+    for (const [name, ms] of this.phases) res[name] = ms;
+    return res;
+  }
+
+  /** Get the breakdown per function, in the order the functions were first seen */
+  getFunctionProfiles(): FunctionProfile[] {
+    return this.functionProfiles;
+  }
+
+  /** Get the FunctionProfile of the given function, starting one if it changed */
+  private functionProfile(data: Funcdata): FunctionProfile {
+    if (data !== this.currentData || this.currentProfile === null) {
+      this.currentData = data;
+      this.currentProfile = { name: data?.getName?.() ?? '', phases: {}, ruleTests: 0, ruleApplies: 0 };
+      this.functionProfiles.push(this.currentProfile);
+    }
+    return this.currentProfile;
+  }
+
+  /** Get the event counters, sorted by name */
+  getCounters(): [string, number][] {
+    return [...this.counters.entries()].sort((a, b) => (a[0] < b[0] ? -1 : a[0] > b[0] ? 1 : 0));
+  }
+
+  private enter(name: string, data: Funcdata): void {
+    if (data !== this.lastFunction) {
+      this.lastFunction = data;
+      this.functions += 1;
+    }
+    const parent = this.pathStack[this.pathStack.length - 1];
+    this.pathStack.push(parent.length === 0 ? name : parent + ';' + name);
+    this.childStack.push(0);
+  }
+
+  private leave(kind: 'action' | 'rule', name: string, ms: number, changed: boolean, data: Funcdata): void {
+    const path = this.pathStack.pop()!;
+    const childMs = this.childStack.pop()!;
+    this.childStack[this.childStack.length - 1] += ms;
+    const self = ms - childMs;
+
+    const key = kind === 'rule' ? 'r:' + name : 'a:' + name;
+    let ent = this.entries.get(key);
+    if (ent === undefined) {
+      ent = { name, kind, calls: 0, applied: 0, totalMs: 0, selfMs: 0, maxMs: 0, maxFunction: '' };
+      this.entries.set(key, ent);
+    }
+    ent.calls += 1;
+    if (changed) ent.applied += 1;
+    ent.totalMs += ms;
+    ent.selfMs += self;
+    if (ms > ent.maxMs) {
+      ent.maxMs = ms;
+      ent.maxFunction = data?.getName?.() ?? '';
+    }
+    this.stacks.set(path, (this.stacks.get(path) ?? 0) + self * 1000);
+
+    // Depth 1 is the root action, depth 2 its children
+    const depth = this.pathStack.length;
+    if (kind === 'action' && depth === 1)
+      this.phases.set('actions', (this.phases.get('actions') ?? 0) + ms);
+    if (this.recordFunctions) {
+      const rec = this.functionProfile(data);
+      if (kind === 'rule') {
+        rec.ruleTests += 1;
+        if (changed) rec.ruleApplies += 1;
+      } else if (depth === 1) {
+        rec.phases['actions'] = (rec.phases['actions'] ?? 0) + ms;
+      } else if (depth === 2) {
+        rec.phases['action:' + name] = (rec.phases['action:' + name] ?? 0) + ms;
+      }
+    }
+  }
+
+  /** Discard all collected timing */
+  reset(): void {
+    this.entries.clear();
+    this.stacks.clear();
+    this.counters.clear();
+    this.phases.clear();
+    this.functionProfiles = [];
+    this.currentProfile = null;
+    this.currentData = null;
+    this.pathStack = [''];
+    this.childStack = [0];
+    this.lastFunction = null;
+    this.functions = 0;
+  }
+
+  /** Number of distinct functions profiled */
+  getFunctionCount(): number {
+    return this.functions;
+  }
+
+  /** Get all entries, sorted by decreasing self time */
+  getEntries(): ProfileEntry[] {
+    return [...this.entries.values()].sort((a, b) => b.selfMs - a.selfMs);
+  }
+
+  /** Export the profile as plain data */
+  toData(): ProfileData {
+    const stacks: Record<string, number> = {};
+    for (const [path, us] of this.stacks) stacks[path] = us;
+    const counters: Record<string, number> = {};
+    for (const [name, n] of this.counters) counters[name] = n;
+    const res: ProfileData = { functions: this.functions, entries: this.getEntries().map(e => ({ ...e })), stacks, counters,
+                               phases: this.getPhases() };
+    if (this.recordFunctions) res.functionProfiles = this.functionProfiles.map(f => ({ ...f, phases: { ...f.phases } }));
+    return res;
+  }
+
+  /** Fold another profile, e.g. from a worker process, into this one */
+  merge(other: ProfileData): void {
+    this.functions += other.functions;
+    for (const e of other.entries) {
+      const key = e.kind === 'rule' ? 'r:' + e.name : 'a:' + e.name;
+      const ent = this.entries.get(key);
+      if (ent === undefined) {
+        this.entries.set(key, { ...e });
+        continue;
+      }
+      ent.calls += e.calls;
+      ent.applied += e.applied;
+      ent.totalMs += e.totalMs;
+      ent.selfMs += e.selfMs;
+      if (e.maxMs > ent.maxMs) {
+        ent.maxMs = e.maxMs;
+        ent.maxFunction = e.maxFunction;
+      }
+    }
+    for (const path of Object.keys(other.stacks)) {
+      this.stacks.set(path, (this.stacks.get(path) ?? 0) + other.stacks[path]);
+    }
+    for (const name of Object.keys(other.counters ?? {})) {
+      this.count(name, other.counters![name]);
+    }
+    for (const name of Object.keys(other.phases ?? {})) {
+      this.phases.set(name, (this.phases.get(name) ?? 0) + other.phases![name]);
+    }
+    if (other.functionProfiles !== undefined) {
+      for (const f of other.functionProfiles) this.functionProfiles.push({ ...f, phases: { ...f.phases } });
+      this.currentProfile = null;
+    }
+  }
+
+  /**
+   * Render the profile in the folded-stack format ("a;b;c <count>" per line) read by
+   * flamegraph.pl, speedscope and similar tools. Counts are whole microseconds.
+   */
+  toFolded(): string {
+    const lines: string[] = [];
+    for (const [path, us] of this.stacks) {
+      const n = Math.round(us);
+      if (n > 0) lines.push(path + ' ' + n);
+    }
+    lines.sort();
+    return lines.length === 0 ? '' : lines.join('\n') + '\n';
+  }
+
+  /**
+   * Print the most expensive entries as a table.
+   * @param s is the stream to write to
+   * @param limit is the maximum number of rows (0 for all)
+   */
+  print(s: { write(s: string): void }, limit: number = 0): void {
+    const rows = this.getEntries();
+    const n = limit > 0 ? Math.min(limit, rows.length) : rows.length;
+    s.write(`Profiled ${this.functions} functions\n`);
+    const phases = [...this.phases.entries()].sort((a, b) => b[1] - a[1]);
+    if (phases.length > 0)
+      s.write('phases: ' + phases.map(([name, ms]) => name + ' ' + ms.toFixed(2) + 'ms').join(', ') + '\n');
+    s.write('kind    self(ms)   total(ms)      calls    applied   max(ms)  name [worst function]\n');
+    for (let i = 0; i < n; ++i) {
+      const e = rows[i];
+      s.write(e.kind.padEnd(6) +
+              e.selfMs.toFixed(2).padStart(10) + e.totalMs.toFixed(2).padStart(12) +
+              String(e.calls).padStart(11) + String(e.applied).padStart(11) +
+              e.maxMs.toFixed(3).padStart(10) + '  ' + e.name +
+              (e.maxFunction.length > 0 ? ' [' + e.maxFunction + ']' : '') + '\n');
+    }
+    const counters = this.getCounters();
+    if (counters.length > 0) {
+      s.write('     count  counter\n');
+      for (const [name, n] of counters)
+        s.write(String(n).padStart(10) + '  ' + name + '\n');
+    }
+  }
+}
@@ -66,6 +66,7 @@ import { PrintCCapability } from '../decompiler/printc.js';
 import { PreferSplitRecord, PreferSplitManager } from '../decompiler/prefersplit.js';
 import { Action, ActionDatabase } from '../decompiler/action.js';
 import { ValueSetSolver, WidenerNone } from '../decompiler/rangeutil.js';
+import type { IrPool } from './irpool.js';
 
 // ---------------------------------------------------------------------------
 // Forward type declarations for types from not-yet-written modules
@@ -384,6 +385,7 @@ export abstract class Architecture extends AddrSpaceManager {
   readonlypropagate: boolean = false;
   infer_pointers: boolean = true;
   analyze_for_loops: boolean = true;
+  action_worklist: boolean = false;
   nan_ignore_all: boolean = false;
   nan_ignore_compare: boolean = true;
   inferPtrSpaces: AddrSpace[] = [];
@@ -420,6 +422,9 @@ export abstract class Architecture extends AddrSpaceManager {
   lanerecords: LanedRegister[] = [];
   allacts: ActionDatabase;
   loadersymbols_parsed: boolean = false;
+  // Recycles Varnode, PcodeOp and BlockBasic objects between functions (null unless the
+  // irpool option is on; see irpool.ts for why it is not on by default)
+  irpool: IrPool | null = null;
 
   /**
    * Construct an uninitialized Architecture.
@@ -495,6 +500,8 @@ export abstract class Architecture extends AddrSpaceManager {
     this.max_instructions = 100000;
     this.infer_pointers = true;
     this.analyze_for_loops = true;
+    this.action_worklist = false;
+    this.irpool = null;
     this.readonlypropagate = false;
     this.nan_ignore_all = false;
     this.nan_ignore_compare = true;
@@ -655,6 +662,17 @@ export abstract class Architecture extends AddrSpaceManager {
     this.commentdb!.clearType(fd.getAddress(), Comment_warning | Comment_warningheader);
   }
 
+  /**
+   * Release the analysis of a function whose output has been produced.
+   * Like clearAnalysis(), but also gives up the storage the function keeps for being
+   * analyzed again (Funcdata.release()). Batch runs call this after printing each function.
+   * @param fd is the function to release
+   */
+  releaseAnalysis(fd: Funcdata): void {
+    fd.release();
+    this.commentdb!.clearType(fd.getAddress(), Comment_warning | Comment_warningheader);
+  }
+
   /**
    * Read any symbols from loader into database.
    * @param delim is the delimiter separating namespaces from symbol base names
@@ -669,6 +687,7 @@ export abstract class Architecture extends AddrSpaceManager {
       result.scope.addFunction(record.address, result.basename);
     }
     this.loader!.closeSymbols();
+    this.symboltab!.buildIndexes();      // Sort the bulk-loaded maps once
   }
 
   /**
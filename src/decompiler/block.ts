@@ -19,6 +19,7 @@ import {
 import { LowlevelError } from '../core/error.js';
 import { OpCode } from '../core/opcodes.js';
 import { ListIter } from '../util/listiter.js';
+import type { IrPool } from './irpool.js';
 
 // ---------------------------------------------------------------------------
 // Forward type declarations for not-yet-written modules
@@ -1141,6 +1142,33 @@ export class BlockBasicClass extends FlowBlock {
     this.cover = new RangeList();
   }
 
+  /**
+   * (Re)initialize as an empty block of the given function, as the constructor does.
+   * Used on objects taken from the IrPool, after recycle() has emptied them.
+   */
+  init(fd: Funcdata): void {
+    this.flags = 0;
+    this.index = 0;
+    this.visitcount = 0;
+    this.numdesc = 0;
+    this.data = fd;
+  }
+
+  /**
+   * Drop every reference into the function, before this goes back to the IrPool.
+   * The op list, edge lists and address cover are emptied and kept for reuse.
+   */
+  recycle(): void {
+    this.parent = null;
+    this.immed_dom = null;
+    this.copymap = null;
+    this.intothis.length = 0;
+    this.outofthis.length = 0;
+    this.op.length = 0;
+    this.cover.clear();
+    this.data = null;
+  }
+
   /** Get the list of p-code operations in this block */
   getOpList(): PcodeOp[] { return this.op; }
 
@@ -2497,7 +2525,12 @@ export class BlockGraph extends FlowBlock {
 
   /** Build a new BlockBasic (BlockBasicClass) */
   newBlockBasic(fd: Funcdata): BlockBasicClass {
-    const ret = new BlockBasicClass(fd);
+    const pool: IrPool | null = fd.getArch()?.irpool ?? null;
+    let ret: BlockBasicClass | undefined = pool !== null ? pool.blocks.take() : undefined;
+    if (ret === undefined)
+      ret = new BlockBasicClass(fd);
+    else
+      ret.init(fd);
     this.addBlock(ret);
     return ret;
   }
@@ -0,0 +1,796 @@
+/* ###
+ * IP: GHIDRA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file callgraph.ts
+ * @description Call graph of a program, translated from callgraph.hh / callgraph.cc
+ *
+ * Beyond the C++ classes, the graph can be split into strongly connected components in
+ * callee-first order (getComponents()), which drives bottom-up decompilation, and the
+ * recovered prototype of a decompiled function can be captured and locked onto the
+ * function in another Architecture (capturePrototype() / applyPrototype()), so callers
+ * decompiled afterwards see the callee's real parameters.
+ */
+
+import { Address } from '../core/address.js';
+import { LowlevelError } from '../core/error.js';
+import {
+  Encoder,
+  Decoder,
+  ElementId,
+  XmlEncode,
+  XmlDecode,
+  ATTRIB_NAME,
+} from '../core/marshal.js';
+import { xml_tree } from '../core/xml.js';
+import { SortedMap } from '../util/sorted-set.js';
+import { ELEM_EDGE } from './block.js';
+import { PrototypePieces } from './fspec.js';
+
+// Forward type declarations
+type Architecture = any;
+type Funcdata = any;
+type Scope = any;
+type Datatype = any;
+
+// ---------------------------------------------------------------------------
+// Marshaling element IDs
+// ---------------------------------------------------------------------------
+
+export const ELEM_CALLGRAPH = new ElementId("callgraph", 226);
+export const ELEM_NODE = new ElementId("node", 227);
+
+// ---------------------------------------------------------------------------
+// CallGraphEdge
+// ---------------------------------------------------------------------------
+
+/**
+ * A directed edge from a calling function to a called function.
+ *
+ * Each edge is stored twice: as an out edge of the caller and as an in edge of the callee.
+ * The complement field is the index of the twin in the other node's list.
+ */
+export class CallGraphEdge {
+  static readonly cycle = 1;            ///< Edge completes a cycle in the graph
+  static readonly dontfollow = 2;       ///< Edge is not followed by the leaf walk
+
+  /** @internal */ from: CallGraphNode | null = null;
+  /** @internal */ to: CallGraphNode | null = null;
+  /** @internal */ callsiteaddr: Address = new Address();
+  /** @internal */ complement: number = 0;
+  /** @internal */ flags: number = 0;
+
+  /** Copy the fields of another edge into this one */
+  assign(op2: CallGraphEdge): void {
+    this.from = op2.from;
+    this.to = op2.to;
+    this.callsiteaddr = op2.callsiteaddr;
+    this.complement = op2.complement;
+    this.flags = op2.flags;
+  }
+
+  /** Does this edge complete a cycle */
+  isCycle(): boolean { return (this.flags & CallGraphEdge.cycle) !== 0; }
+
+  /** Get the address of the call instruction */
+  getCallSiteAddr(): Address { return this.callsiteaddr; }
+
+  /**
+   * Encode this edge to a stream as an \<edge> element.
+   * @param encoder is the stream encoder
+   */
+  encode(encoder: Encoder): void {
+    encoder.openElement(ELEM_EDGE);
+    this.from!.getAddr().encode(encoder);
+    this.to!.getAddr().encode(encoder);
+    this.callsiteaddr.encode(encoder);
+    encoder.closeElement(ELEM_EDGE);
+  }
+
+  /**
+   * Decode an \<edge> element and add the edge to the graph.
+   * Both end nodes must already be in the graph.
+   * @param decoder is the stream decoder
+   * @param graph is the graph receiving the edge
+   */
+  static decode(decoder: Decoder, graph: CallGraph): void {
+    const elemId = decoder.openElementId(ELEM_EDGE);
+    const fromaddr = Address.decode(decoder);
+    const toaddr = Address.decode(decoder);
+    const siteaddr = Address.decode(decoder);
+    decoder.closeElement(elemId);
+
+    const fromnode = graph.findNode(fromaddr);
+    if (fromnode === null)
+      throw new LowlevelError("Could not find from node");
+    const tonode = graph.findNode(toaddr);
+    if (tonode === null)
+      throw new LowlevelError("Could not find to node");
+
+    graph.addEdge(fromnode, tonode, siteaddr);
+  }
+}
+
+// ---------------------------------------------------------------------------
+// CallGraphNode
+// ---------------------------------------------------------------------------
+
+/**
+ * A function in the call graph, identified by its entry point.
+ *
+ * A node may exist without a Funcdata, for call targets that have no function symbol or
+ * for a graph read back from a file before its functions are associated.
+ */
+export class CallGraphNode {
+  static readonly mark = 1;             ///< Node has been visited
+  static readonly onlycyclein = 2;      ///< All in edges are cycle edges
+  static readonly currentcycle = 4;     ///< Node is on the current DFS path
+  static readonly entrynode = 8;        ///< Node is a seed of the leaf walk
+
+  /** @internal */ entryaddr: Address = new Address();
+  /** @internal */ name: string = '';
+  /** @internal */ fd: Funcdata | null = null;
+  /** @internal */ inedge: CallGraphEdge[] = [];
+  /** @internal */ outedge: CallGraphEdge[] = [];
+  /** @internal */ parentedge: number = -1;
+  /** @internal */ flags: number = 0;
+
+  clearMark(): void { this.flags &= ~CallGraphNode.mark; }
+  isMark(): boolean { return (this.flags & CallGraphNode.mark) !== 0; }
+  getAddr(): Address { return this.entryaddr; }
+  getName(): string { return this.name; }
+  getFuncdata(): Funcdata | null { return this.fd; }
+  numInEdge(): number { return this.inedge.length; }
+  getInEdge(i: number): CallGraphEdge { return this.inedge[i]; }
+  getInNode(i: number): CallGraphNode { return this.inedge[i].from!; }
+  numOutEdge(): number { return this.outedge.length; }
+  getOutEdge(i: number): CallGraphEdge { return this.outedge[i]; }
+  getOutNode(i: number): CallGraphNode { return this.outedge[i].to!; }
+
+  /**
+   * Associate a function with this node.
+   * @param f is the function, which must be at this node's entry point
+   */
+  setFuncdata(f: Funcdata): void {
+    if (this.fd !== null && this.fd !== f)
+      throw new LowlevelError("Multiple functions at one address in callgraph");
+    if (!f.getAddress().equals(this.entryaddr))
+      throw new LowlevelError("Setting function data at wrong address in callgraph");
+    this.fd = f;
+  }
+
+  /**
+   * Encode this node to a stream as a \<node> element.
+   * @param encoder is the stream encoder
+   */
+  encode(encoder: Encoder): void {
+    encoder.openElement(ELEM_NODE);
+    if (this.name.length !== 0)
+      encoder.writeString(ATTRIB_NAME, this.name);
+    this.entryaddr.encode(encoder);
+    encoder.closeElement(ELEM_NODE);
+  }
+
+  /**
+   * Decode a \<node> element and add the node to the graph.
+   * @param decoder is the stream decoder
+   * @param graph is the graph receiving the node
+   */
+  static decode(decoder: Decoder, graph: CallGraph): void {
+    const elemId = decoder.openElementId(ELEM_NODE);
+    let name = '';
+    for (;;) {
+      const attribId = decoder.getNextAttributeId();
+      if (attribId === 0) break;
+      if (attribId === ATTRIB_NAME.getId())
+        name = decoder.readString();
+    }
+    const addr = Address.decode(decoder);
+    decoder.closeElement(elemId);
+    graph.addNode(addr, name);
+  }
+}
+
+/** A position in the leaf walk: a node and the next out edge to try */
+class LeafIterator {
+  node: CallGraphNode;
+  outslot: number = 0;
+  constructor(n: CallGraphNode) { this.node = n; }
+}
+
+/**
+ * A strongly connected component of the call graph: a single function, or a set of
+ * mutually recursive functions.
+ */
+export interface CallGraphComponent {
+  /** The functions in the component, in address order */
+  nodes: CallGraphNode[];
+  /** Indices (into the component list) of the components this one calls */
+  callees: number[];
+  /** 0 for components that call nothing else, otherwise 1 + the highest callee level */
+  level: number;
+}
+
+// ---------------------------------------------------------------------------
+// CallGraph
+// ---------------------------------------------------------------------------
+
+/**
+ * The call graph of a program.
+ *
+ * Nodes are created for every function symbol (buildAllNodes()) and edges are added per
+ * function from its call sites once it has been through flow (buildEdges()). The leaf walk
+ * (initLeafWalk() / nextLeaf()) visits callees before callers, breaking cycles at a
+ * heuristically chosen edge; getComponents() gives the exact strongly connected components.
+ */
+export class CallGraph {
+  private glb: Architecture;
+  private graph: SortedMap<Address, CallGraphNode> = new SortedMap<Address, CallGraphNode>(Address.compare);
+  private seeds: CallGraphNode[] = [];
+
+  /**
+   * @param g is the Architecture whose functions make up the graph
+   */
+  constructor(g: Architecture) {
+    this.glb = g;
+  }
+
+  /**
+   * Add any unmarked node with no in edges (other than cycle edges) to the seeds.
+   * If there are none, but some nodes are still uncovered, the one with the fewest in edges
+   * is added, under the assumption that the remaining in edges belong to cycles.
+   * @returns true if every node is now marked
+   */
+  private findNoEntry(seeds: CallGraphNode[]): boolean {
+    let lownode: CallGraphNode | null = null;
+    let allcovered = true;
+    let newseeds = false;
+
+    for (const node of this.graph.values()) {
+      if (node.isMark()) continue;
+      if (node.inedge.length === 0 || (node.flags & CallGraphNode.onlycyclein) !== 0) {
+        seeds.push(node);
+        node.flags |= CallGraphNode.mark | CallGraphNode.entrynode;
+        newseeds = true;
+      } else {
+        allcovered = false;
+        if (lownode === null || node.numInEdge() < lownode.numInEdge())
+          lownode = node;
+      }
+    }
+    if (!newseeds && !allcovered) {
+      seeds.push(lownode!);
+      lownode!.flags |= CallGraphNode.mark | CallGraphNode.entrynode;
+    }
+    return allcovered;
+  }
+
+  /**
+   * Depth-first walk from a root, snipping any edge that closes a cycle and marking edges
+   * to nodes traced earlier as not followed. This makes the followed edges a forest.
+   */
+  private snipCycles(node: CallGraphNode): void {
+    const stack: LeafIterator[] = [];
+
+    node.flags |= CallGraphNode.currentcycle;
+    stack.push(new LeafIterator(node));
+
+    while (stack.length > 0) {
+      const top = stack[stack.length - 1];
+      const cur = top.node;
+      const st = top.outslot;
+      if (st >= cur.outedge.length) {
+        cur.flags &= ~CallGraphNode.currentcycle;
+        stack.pop();
+        continue;
+      }
+      top.outslot += 1;
+      if ((cur.outedge[st].flags & CallGraphEdge.cycle) !== 0) continue;
+      const next = cur.outedge[st].to!;
+      if ((next.flags & CallGraphNode.currentcycle) !== 0) {     // Found a cycle
+        this.snipEdge(cur, st);
+        continue;
+      } else if ((next.flags & CallGraphNode.mark) !== 0) {      // Already traced before
+        cur.outedge[st].flags |= CallGraphEdge.dontfollow;
+        continue;
+      }
+      next.parentedge = cur.outedge[st].complement;
+      next.flags |= CallGraphNode.currentcycle | CallGraphNode.mark;
+      stack.push(new LeafIterator(next));
+    }
+  }
+
+  /** Mark the i-th out edge of a node as a cycle edge */
+  private snipEdge(node: CallGraphNode, i: number): void {
+    node.outedge[i].flags |= CallGraphEdge.cycle | CallGraphEdge.dontfollow;
+    const toi = node.outedge[i].complement;
+    const to = node.outedge[i].to!;
+    to.inedge[toi].flags |= CallGraphEdge.cycle;
+    let onlycycle = true;
+    for (let j = 0; j < to.inedge.length; ++j) {
+      if ((to.inedge[j].flags & CallGraphEdge.cycle) === 0) {
+        onlycycle = false;
+        break;
+      }
+    }
+    if (onlycycle)
+      to.flags |= CallGraphNode.onlycyclein;
+  }
+
+  private clearMarks(): void {
+    for (const node of this.graph.values())
+      node.clearMark();
+  }
+
+  /** Generate the seed nodes, from which every node can be reached, and snip all cycles */
+  private cycleStructure(): void {
+    if (this.seeds.length !== 0)
+      return;
+    let walked = 0;
+    let allcovered: boolean;
+
+    do {
+      allcovered = this.findNoEntry(this.seeds);
+      while (walked < this.seeds.length) {
+        const rootnode = this.seeds[walked];
+        rootnode.parentedge = walked;
+        this.snipCycles(rootnode);
+        walked += 1;
+      }
+    } while (!allcovered);
+    this.clearMarks();
+  }
+
+  /**
+   * Step up from a node to its parent in the walk.
+   * @returns the parent (null for a seed) and the slot of the edge that was followed
+   */
+  private popPossible(node: CallGraphNode): { node: CallGraphNode | null; outslot: number } {
+    if ((node.flags & CallGraphNode.entrynode) !== 0)
+      return { node: null, outslot: node.parentedge };
+    const edge = node.inedge[node.parentedge];
+    return { node: edge.from, outslot: edge.complement };
+  }
+
+  /** Get the first followed child of a node at or after the given out slot, or null */
+  private pushPossible(node: CallGraphNode | null, outslot: number): CallGraphNode | null {
+    if (node === null) {
+      if (outslot >= this.seeds.length)
+        return null;
+      return this.seeds[outslot];
+    }
+    while (outslot < node.outedge.length) {
+      if ((node.outedge[outslot].flags & CallGraphEdge.dontfollow) !== 0)
+        outslot += 1;
+      else
+        return node.outedge[outslot].to;
+    }
+    return null;
+  }
+
+  /** Open up a new out edge at the given slot, fixing up the complements of later edges */
+  private insertBlankEdge(node: CallGraphNode, slot: number): CallGraphEdge {
+    node.outedge.push(new CallGraphEdge());
+    for (let i = node.outedge.length - 2; i >= slot; --i) {
+      const edge = node.outedge[i + 1];
+      edge.assign(node.outedge[i]);
+      edge.to!.inedge[edge.complement].complement += 1;
+    }
+    const res = new CallGraphEdge();
+    node.outedge[slot] = res;
+    return res;
+  }
+
+  private iterateScopesRecursive(scope: Scope): void {
+    if (!scope.isGlobal()) return;
+    this.iterateFunctionsAddrOrder(scope);
+    for (const [, child] of scope.childrenBegin())
+      this.iterateScopesRecursive(child);
+  }
+
+  private iterateFunctionsAddrOrder(scope: Scope): void {
+    const menditer = scope.end();
+    for (const miter = scope.begin(); !miter.equals(menditer); miter.increment()) {
+      const sym = miter.deref().getSymbol();
+      // In C++ this is a dynamic_cast<FunctionSymbol*>
+      if (sym !== null && typeof sym.getFunction === 'function')
+        this.addNode(sym.getFunction());
+    }
+  }
+
+  /**
+   * Add a node for an existing function.
+   * @param f is the function
+   * @returns the node
+   */
+  addNode(f: Funcdata): CallGraphNode;
+
+  /**
+   * Add a node for an entry point with no Funcdata.
+   * @param addr is the entry point
+   * @param nm is the name of the function
+   * @returns the node
+   */
+  addNode(addr: Address, nm: string): CallGraphNode;
+
+  addNode(arg: Funcdata | Address, nm?: string): CallGraphNode {
+    const addr: Address = arg instanceof Address ? arg : arg.getAddress();
+    let node = this.graph.get(addr);
+    if (node === undefined) {
+      node = new CallGraphNode();
+      this.graph.set(addr, node);
+    }
+    if (arg instanceof Address) {
+      node.entryaddr = addr;
+      node.name = nm!;
+      return node;
+    }
+    if (node.getFuncdata() !== null && node.getFuncdata() !== arg)
+      throw new LowlevelError("Functions with duplicate entry points: " + arg.getName() + " " +
+                              node.getFuncdata().getName());
+    node.entryaddr = addr;
+    node.name = arg.getDisplayName();
+    node.fd = arg;
+    return node;
+  }
+
+  /**
+   * Find the node at an entry point.
+   * @param addr is the entry point
+   * @returns the node, or null
+   */
+  findNode(addr: Address): CallGraphNode | null {
+    return this.graph.get(addr) ?? null;
+  }
+
+  /**
+   * Add an edge between two nodes, unless one already exists.
+   * Out edges are kept sorted by the entry point of the called node.
+   * @param from is the calling node
+   * @param to is the called node
+   * @param addr is the address of the call site
+   */
+  addEdge(from: CallGraphNode, to: CallGraphNode, addr: Address): void {
+    let i: number;
+    for (i = 0; i < from.outedge.length; ++i) {
+      const outnode = from.outedge[i].to!;
+      if (outnode === to) return;          // Already have an out edge
+      if (to.entryaddr.lessThan(outnode.entryaddr)) break;
+    }
+
+    const fromedge = this.insertBlankEdge(from, i);
+
+    const toi = to.inedge.length;
+    const toedge = new CallGraphEdge();
+    to.inedge.push(toedge);
+
+    fromedge.from = from;
+    fromedge.to = to;
+    fromedge.callsiteaddr = addr;
+    fromedge.complement = toi;
+
+    toedge.from = from;
+    toedge.to = to;
+    toedge.callsiteaddr = addr;
+    toedge.complement = i;
+  }
+
+  /**
+   * Remove the i-th in edge of a node (and its twin out edge).
+   * @param node is the called node
+   * @param i is the index of the in edge
+   */
+  deleteInEdge(node: CallGraphNode, i: number): void {
+    const tosize = node.inedge.length;
+    const fromi = node.inedge[i].complement;
+    const from = node.inedge[i].from!;
+    const fromsize = from.outedge.length;
+
+    for (let j = i + 1; j < tosize; ++j) {
+      node.inedge[j - 1] = node.inedge[j];
+      if (node.inedge[j - 1].complement >= fromi)
+        node.inedge[j - 1].complement -= 1;
+    }
+    node.inedge.pop();
+
+    for (let j = fromi + 1; j < fromsize; ++j) {
+      from.outedge[j - 1] = from.outedge[j];
+      if (from.outedge[j - 1].complement >= i)
+        from.outedge[j - 1].complement -= 1;
+    }
+    from.outedge.pop();
+  }
+
+  /**
+   * Start a leaf-first walk of the graph.
+   * @returns the first leaf, or null if the graph is empty
+   */
+  initLeafWalk(): CallGraphNode | null {
+    this.cycleStructure();
+    if (this.seeds.length === 0) return null;
+    let node = this.seeds[0];
+    for (;;) {
+      const pushnode = this.pushPossible(node, 0);
+      if (pushnode === null)
+        break;
+      node = pushnode;
+    }
+    return node;
+  }
+
+  /**
+   * Get the next node of the leaf-first walk. A node is only returned after everything
+   * it calls (other than through a snipped cycle edge).
+   * @param node is the current node
+   * @returns the next node, or null when the walk is complete
+   */
+  nextLeaf(node: CallGraphNode): CallGraphNode | null {
+    const pop = this.popPossible(node);
+    let cur = pop.node;
+    let outslot = pop.outslot + 1;
+    for (;;) {
+      const pushnode = this.pushPossible(cur, outslot);
+      if (pushnode === null)
+        break;
+      cur = pushnode;
+      outslot = 0;
+    }
+    return cur;
+  }
+
+  /** Iterate over all nodes in entry point order */
+  nodes(): IterableIterator<CallGraphNode> {
+    return this.graph.values();
+  }
+
+  /** Get the number of nodes */
+  numNodes(): number {
+    return this.graph.size;
+  }
+
+  /** Make a node for every function symbol in the program */
+  buildAllNodes(): void {
+    const scope = this.glb.symboltab.getGlobalScope();
+    this.iterateScopesRecursive(scope);
+  }
+
+  /**
+   * Add the edges for the call sites of a function, which must have been through flow.
+   * Call targets without a node get one, named by the Architecture.
+   * @param fd is the function
+   */
+  buildEdges(fd: Funcdata): void {
+    const fdnode = this.findNode(fd.getAddress());
+    if (fdnode === null)
+      throw new LowlevelError("Function is missing from callgraph");
+    if (fd.getFuncProto().getModelName() === "unknown") return;
+
+    const numcalls = fd.numCalls();
+    for (let i = 0; i < numcalls; ++i) {
+      const fs = fd.getCallSpecs_byIndex(i);
+      const addr: Address = fs.getEntryAddress();
+      if (!addr.isInvalid()) {
+        let tonode = this.findNode(addr);
+        if (tonode === null)
+          tonode = this.addNode(addr, this.glb.nameFunction(addr));
+        this.addEdge(fdnode, tonode, fs.getOp().getAddr());
+      }
+    }
+  }
+
+  /**
+   * Build the whole graph without decompiling: make all nodes, then follow flow in each
+   * function to find its call sites. Flow is released again afterward, and functions whose
+   * flow fails are left without out edges.
+   */
+  buildFromFlow(): void {
+    this.buildAllNodes();
+    for (const node of [...this.graph.values()]) {
+      const fd = node.getFuncdata();
+      if (fd === null || fd.hasNoCode()) continue;
+      try {
+        const space = fd.getAddress().getSpace();
+        fd.followFlow(new Address(space, 0n), new Address(space, space.getHighest()));
+        this.buildEdges(fd);
+      } catch {
+        // No out edges; the function is still scheduled, just without ordering
+      }
+      this.glb.releaseAnalysis(fd);
+    }
+  }
+
+  /**
+   * Split the graph into strongly connected components, callee-first.
+   *
+   * Every component comes after all the components it calls, so decompiling in list order
+   * sees each callee before its callers. Components of equal level never call each other
+   * and can be decompiled concurrently. Uses an iterative form of Tarjan's algorithm.
+   */
+  getComponents(): CallGraphComponent[] {
+    const nodes = [...this.graph.values()];
+    const indexOf = new Map<CallGraphNode, number>();
+    nodes.forEach((n, i) => indexOf.set(n, i));
+    const order = new Int32Array(nodes.length).fill(-1);    // DFS discovery order
+    const low = new Int32Array(nodes.length);
+    const compOf = new Int32Array(nodes.length).fill(-1);
+    const onStack = new Uint8Array(nodes.length);
+    const stack: number[] = [];
+    const components: CallGraphComponent[] = [];
+    let counter = 0;
+
+    for (let root = 0; root < nodes.length; ++root) {
+      if (order[root] >= 0) continue;
+      const work: [number, number][] = [[root, 0]];          // Node and next out edge
+      order[root] = low[root] = counter++;
+      stack.push(root);
+      onStack[root] = 1;
+      while (work.length > 0) {
+        const top = work[work.length - 1];
+        const v = top[0];
+        const outedge = nodes[v].outedge;
+        if (top[1] < outedge.length) {
+          const w = indexOf.get(outedge[top[1]++].to!)!;
+          if (order[w] < 0) {
+            order[w] = low[w] = counter++;
+            stack.push(w);
+            onStack[w] = 1;
+            work.push([w, 0]);
+          } else if (onStack[w] !== 0 && order[w] < low[v]) {
+            low[v] = order[w];
+          }
+          continue;
+        }
+        work.pop();
+        if (work.length > 0) {
+          const parent = work[work.length - 1][0];
+          if (low[v] < low[parent]) low[parent] = low[v];
+        }
+        if (low[v] !== order[v]) continue;
+        // v is the root of a component; everything it calls is already in a component
+        const comp: CallGraphComponent = { nodes: [], callees: [], level: 0 };
+        const ci = components.length;
+        let w: number;
+        do {
+          w = stack.pop()!;
+          onStack[w] = 0;
+          compOf[w] = ci;
+          comp.nodes.push(nodes[w]);
+        } while (w !== v);
+        comp.nodes.sort((a, b) => Address.compare(a.entryaddr, b.entryaddr));
+        const callees = new Set<number>();
+        for (const n of comp.nodes) {
+          for (const edge of n.outedge) {
+            const c = compOf[indexOf.get(edge.to!)!];
+            if (c !== ci) callees.add(c);
+          }
+        }
+        comp.callees = [...callees].sort((a, b) => a - b);
+        for (const c of comp.callees)
+          comp.level = Math.max(comp.level, components[c].level + 1);
+        components.push(comp);
+      }
+    }
+    return components;
+  }
+
+  /**
+   * Encode the graph to a stream as a \<callgraph> element: all nodes, then all edges.
+   * @param encoder is the stream encoder
+   */
+  encode(encoder: Encoder): void {
+    encoder.openElement(ELEM_CALLGRAPH);
+    for (const node of this.graph.values())
+      node.encode(encoder);
+    // Dump all the "in" edges
+    for (const node of this.graph.values()) {
+      for (let i = 0; i < node.inedge.length; ++i)
+        node.inedge[i].encode(encoder);
+    }
+    encoder.closeElement(ELEM_CALLGRAPH);
+  }
+
+  /**
+   * Decode a \<callgraph> element into this graph.
+   * @param decoder is the stream decoder
+   */
+  decoder(decoder: Decoder): void {
+    const elemId = decoder.openElementId(ELEM_CALLGRAPH);
+    for (;;) {
+      const subId = decoder.peekElement();
+      if (subId !== ELEM_NODE.getId()) break;
+      CallGraphNode.decode(decoder, this);
+    }
+    while (decoder.peekElement() !== 0)
+      CallGraphEdge.decode(decoder, this);
+    decoder.closeElement(elemId);
+  }
+}
+
+// ---------------------------------------------------------------------------
+// Prototype feed-forward
+// ---------------------------------------------------------------------------
+
+/**
+ * The recovered prototype of a decompiled function, as plain data.
+ * Data-types are XML type references, so the record can be applied in another process
+ * whose Architecture was loaded from the same program.
+ */
+export interface PrototypeRecord {
+  /** Name of the prototype model */
+  model: string;
+  /** Output data-type */
+  output: string;
+  /** Input data-types */
+  inputs: string[];
+  /** Input names */
+  names: string[];
+  /** True if the function takes variable arguments */
+  dotdotdot: boolean;
+}
+
+function encodeTypeRef(dt: Datatype): string {
+  const encoder = new XmlEncode(false);
+  dt.encodeRef(encoder);
+  return encoder.toString();
+}
+
+function decodeTypeRef(glb: Architecture, xml: string): Datatype {
+  const decoder = new XmlDecode(glb, xml_tree(xml).getRoot());
+  return glb.types.decodeType(decoder);
+}
+
+/**
+ * Capture the prototype that decompilation recovered for a function.
+ * @param fd is the function, after decompilation and before its analysis is cleared
+ * @returns the record, or null if the prototype was already locked or nothing was recovered
+ */
+export function capturePrototype(fd: Funcdata): PrototypeRecord | null {
+  if (!fd.isProcComplete()) return null;
+  const proto = fd.getFuncProto();
+  if (proto.isInputLocked() || proto.isOutputLocked()) return null;
+  if (proto.getModelName() === "unknown") return null;
+  const pieces = new PrototypePieces();
+  proto.getPieces(pieces);
+  if (pieces.outtype === null) return null;
+  return {
+    model: proto.getModelName(),
+    output: encodeTypeRef(pieces.outtype),
+    inputs: pieces.intypes.map(encodeTypeRef),
+    names: [...pieces.innames],
+    dotdotdot: pieces.firstVarArgSlot >= 0,
+  };
+}
+
+/**
+ * Lock a captured prototype onto a function, so that call sites decompiled afterwards use
+ * its parameters instead of recovering them. Any analysis of the function is cleared first.
+ * @param glb is the Architecture holding the function
+ * @param fd is the function
+ * @param rec is the record from capturePrototype()
+ */
+export function applyPrototype(glb: Architecture, fd: Funcdata, rec: PrototypeRecord): void {
+  const pieces = new PrototypePieces();
+  pieces.model = glb.getModel(rec.model);
+  if (pieces.model === null)
+    throw new LowlevelError("Unknown prototype model: " + rec.model);
+  pieces.outtype = decodeTypeRef(glb, rec.output);
+  pieces.intypes = rec.inputs.map(xml => decodeTypeRef(glb, xml));
+  pieces.innames = [...rec.names];
+  pieces.firstVarArgSlot = rec.dotdotdot ? rec.inputs.length : -1;
+  if (fd.isProcStarted())
+    glb.clearAnalysis(fd);
+  fd.getFuncProto().setPieces(pieces);
+}
@@ -871,7 +871,10 @@ export class ActionStartTypes extends Action {
 /** Analyze change to the stack pointer across sub-function calls. */
 export class ActionStackPtrFlow extends Action {
   private stackspace: AddrSpace | null;
-  private analysis_finished: boolean = false;
+
+  /** True once the analysis has run for the current function (kept in the job state) */
+  private get analysis_finished(): boolean { return this.local !== 0; }
+  private set analysis_finished(v: boolean) { this.local = v ? 1 : 0; }
 
   constructor(g: string, ss: AddrSpace | null) {
     super(0, "stackptrflow", g);
@@ -1188,7 +1191,9 @@ export class ActionLaneDivide extends Action {
 
 /** Make sure pointers into segmented spaces have the correct form. */
 export class ActionSegmentize extends Action {
-  private localcount: number = 0;
+  /** Number of passes performed for the current function (kept in the job state) */
+  private get localcount(): number { return this.local; }
+  private set localcount(v: number) { this.local = v; }
 
   constructor(g: string) {
     super(0, "segmentize", g);
@@ -1507,7 +1512,9 @@ export class ActionShadowVar extends Action {
 
 /** Check for constants, with pointer type, that correspond to global symbols. */
 export class ActionConstantPtr extends Action {
-  private localcount: number = 0;
+  /** Number of passes performed for the current function (kept in the job state) */
+  private get localcount(): number { return this.local; }
+  private set localcount(v: number) { this.local = v; }
 
   constructor(g: string) {
     super(0, "constantptr", g);
@@ -2902,7 +2909,9 @@ export class ActionLikelyTrash extends Action {
 // ------------------------
 
 export class ActionRestructureVarnode extends Action {
-  private numpass: number = 0;
+  /** Number of passes performed for the current function (kept in the job state) */
+  private get numpass(): number { return this.local; }
+  private set numpass(v: number) { this.local = v; }
 
   constructor(g: string) {
     super(0, "restructure_varnode", g);
@@ -3085,13 +3094,16 @@ export class ActionDefaultParams extends Action {
 // --------------
 
 export class ActionSetCasts extends Action {
-  constructor(g: string) {
+  private insertCasts: boolean;	// True if casts are inserted, false to only repair ops and resolve unions
+
+  constructor(g: string, insert: boolean = true) {
     super(Action.rule_onceperfunc, "setcasts", g);
+    this.insertCasts = insert;
   }
 
   clone(grouplist: ActionGroupList): Action | null {
     if (!grouplist.contains(this.getGroup())) return null;
-    return new ActionSetCasts(this.getGroup());
+    return new ActionSetCasts(this.getGroup(), this.insertCasts);
   }
 
   /// Check if the data-type of the given value being used as a pointer makes sense.
@@ -3422,7 +3434,8 @@ export class ActionSetCasts extends Action {
         // Do input casts first, as output may depend on input
         for (let i = 0; i < op.numInput(); ++i) {
           this.count += ActionSetCasts.resolveUnion(op, i, data, castStrategy);
-          this.count += ActionSetCasts.castInput(op, i, data, castStrategy);
+          if (this.insertCasts)
+            this.count += ActionSetCasts.castInput(op, i, data, castStrategy);
         }
         if (opc === OpCode.CPUI_LOAD) {
           ActionSetCasts.checkPointerIssues(op, op.getOut()!, data);
@@ -3430,7 +3443,7 @@ export class ActionSetCasts extends Action {
           ActionSetCasts.checkPointerIssues(op, op.getIn(2)!, data);
         }
         const vn: Varnode | null = op.getOut();
-        if (vn === null) continue;
+        if (vn === null || !this.insertCasts) continue;
         this.count += ActionSetCasts.castOutput(op, data, castStrategy);
       }
     }
@@ -5617,7 +5630,9 @@ export class PropagationState {
 // =====================================================================
 
 export class ActionInferTypes extends Action {
-  private localcount: number = 0;
+  /** Number of passes performed for the current function (kept in the job state) */
+  private get localcount(): number { return this.local; }
+  private set localcount(v: number) { this.local = v; }
 
   constructor(g: string) {
     super(0, "infertypes", g);
@@ -5919,7 +5934,7 @@ export function buildDefaultGroups(db: ActionDatabase): void {
     "base", "protorecovery", "protorecovery_a", "deindirect", "localrecovery",
     "deadcode", "typerecovery", "stackptrflow",
     "blockrecovery", "stackvars", "deadcontrolflow", "switchnorm",
-    "cleanup", "splitcopy", "splitpointer", "merge", "dynamic", "casts", "analysis",
+    "cleanup", "splitcopy", "splitpointer", "merge", "mergespec", "dynamic", "casts", "analysis",
     "fixateglobals", "fixateproto", "constsequence",
     "segment", "returnsplit", "nodejoin", "doubleload", "doubleprecis",
     "unreachable", "subvar", "floatprecision",
@@ -5956,6 +5971,22 @@ export function buildDefaultGroups(db: ActionDatabase): void {
 
   const firstmem: string[] = ["base"];
   db.setGroup("firstpass", firstmem);
+
+  // Bulk scanning: prototypes, call targets, strings and rough C. Only required merges run,
+  // casts are checked but not inserted, there is no conditional execution or double precision
+  // recovery, no restarts and at most two rounds of the full loop.
+  const triage: string[] = [
+    "base", "protorecovery", "protorecovery_a", "deindirect", "localrecovery",
+    "deadcode", "typerecovery", "stackptrflow",
+    "blockrecovery", "stackvars", "deadcontrolflow", "switchnorm",
+    "cleanup", "splitcopy", "splitpointer", "merge", "dynamic", "castcheck", "analysis",
+    "fixateglobals", "fixateproto", "constsequence",
+    "segment", "returnsplit", "nodejoin",
+    "unreachable", "subvar", "floatprecision"
+  ];
+  db.setGroup("triage", triage);
+  db.setLimit("triage", "universal", 0);
+  db.setLimit("triage", "fullloop", 2);
   (db as any).isDefaultGroups = true;
 }
 
@@ -6213,12 +6244,12 @@ export function universalAction(conf: Architecture, db: ActionDatabase): void {
   act.addAction(new ActionMarkExplicit("merge"));
   act.addAction(new ActionMarkImplied("merge"));	// This must come BEFORE general merging
   act.addAction(new ActionMergeMultiEntry("merge"));
-  act.addAction(new ActionMergeCopy("merge"));
-  act.addAction(new ActionDominantCopy("merge"));
+  act.addAction(new ActionMergeCopy("mergespec"));
+  act.addAction(new ActionDominantCopy("mergespec"));
   act.addAction(new ActionDynamicSymbols("dynamic"));
   act.addAction(new ActionMarkIndirectOnly("merge"));	// Must come after required merges but before speculative
-  act.addAction(new ActionMergeAdjacent("merge"));
-  act.addAction(new ActionMergeType("merge"));
+  act.addAction(new ActionMergeAdjacent("mergespec"));
+  act.addAction(new ActionMergeType("mergespec"));
   act.addAction(new ActionHideShadow("merge"));
   act.addAction(new ActionCopyMarker("merge"));
   act.addAction(new ActionOutputPrototype("localrecovery"));
@@ -6227,6 +6258,7 @@ export function universalAction(conf: Architecture, db: ActionDatabase): void {
   act.addAction(new ActionDynamicSymbols("dynamic"));
   act.addAction(new ActionNameVars("merge"));
   act.addAction(new ActionSetCasts("casts"));
+  act.addAction(new ActionSetCasts("castcheck", false));
   act.addAction(new ActionFinalStructure("blockrecovery"));
   act.addAction(new ActionPrototypeWarnings("protorecovery"));
   act.addAction(new ActionStop("base"));
@@ -456,12 +456,38 @@ export class CoverBlock {
  * holds different values at the same point in the function.
  *
  * Internally this is implemented as a map from basic block index to their non-empty CoverBlock.
+ *
+ * For intersection tests the Cover also keeps, built lazily after any change, two bitsets
+ * over block indices: the blocks it covers at all, and the blocks it covers through to
+ * their end (live-out).  Two Covers with no common block are rejected by ANDing words, and
+ * two Covers live out of a common block intersect on an interval without looking at the
+ * ops.  Only the remaining common blocks are compared CoverBlock by CoverBlock.
  */
 export class Cover {
   /** Sorted ascending block indices */
   private blockIndices: int4[] = [];
   /** CoverBlocks parallel to blockIndices */
   private blocks: CoverBlock[] = [];
+  /** Emptied CoverBlocks from earlier contents, reused by _getOrCreate() */
+  private spare: CoverBlock[] = [];
+
+  /**
+   * Use the block bitsets for intersect() and intersectList().
+   * Setting DEBUG_COVER_SPARSE=1 turns them off, to compare against the plain block walk.
+   */
+  static dense: boolean = process.env.DEBUG_COVER_SPARSE !== '1';
+  /** True while the bitsets match the blocks */
+  private denseValid: boolean = false;
+  /** Index of the first 32-block word in the bitsets */
+  private wordBase: int4 = 0;
+  /** Number of words in use in the bitsets */
+  private wordCount: int4 = 0;
+  /** Bitset of covered blocks, relative to wordBase */
+  private liveBits: Uint32Array = Cover.noBits;
+  /** Bitset of blocks covered to their end, relative to wordBase */
+  private outBits: Uint32Array = Cover.noBits;
+
+  private static readonly noBits: Uint32Array = new Uint32Array(0);
 
   /** Global empty CoverBlock for blocks not covered by this */
   private static readonly emptyBlock: CoverBlock = new CoverBlock();
@@ -478,13 +504,19 @@ export class Cover {
     return lo;
   }
 
-  /** Get or create a CoverBlock for the given block index */
+  /**
+   * Get or create a CoverBlock for the given block index, to be edited.
+   * Either way the bitsets go stale: an existing block may be extended to the end.
+   */
   private _getOrCreate(idx: int4): CoverBlock {
+    this.denseValid = false;
     const pos = this._lowerBound(idx);
     if (pos < this.blockIndices.length && this.blockIndices[pos] === idx) {
       return this.blocks[pos];
     }
-    const block = new CoverBlock();
+    let block = this.spare.pop();
+    if (block === undefined)
+      block = new CoverBlock();
     this.blockIndices.splice(pos, 0, idx);
     this.blocks.splice(pos, 0, block);
     return block;
@@ -492,8 +524,92 @@ export class Cover {
 
   /** Clear this to an empty Cover */
   clear(): void {
+    this.releaseBlocks();
+  }
+
+  /** Empty all blocks, keeping the CoverBlock objects for reuse */
+  private releaseBlocks(): void {
+    for (const block of this.blocks) {
+      block.clear();
+      this.spare.push(block);
+    }
     this.blockIndices.length = 0;
     this.blocks.length = 0;
+    this.denseValid = false;
+  }
+
+  /**
+   * Bring the block bitsets up to date.
+   * Every change to the blocks, new or existing (addDefPoint, addRefPoint, addRefRecurse,
+   * merge, rebuild), goes through _getOrCreate() or releaseBlocks(), which mark them stale,
+   * and the CoverBlock edits that follow finish before any intersection test.
+   */
+  private buildDense(): void {
+    if (this.denseValid) return;
+    this.denseValid = true;
+    const keys = this.blockIndices;
+    if (keys.length === 0) {
+      this.wordBase = 0;
+      this.wordCount = 0;
+      return;
+    }
+    const base = keys[0] >>> 5;
+    const count = (keys[keys.length - 1] >>> 5) - base + 1;
+    if (this.liveBits.length < count) {
+      this.liveBits = new Uint32Array(count);
+      this.outBits = new Uint32Array(count);
+    } else {
+      this.liveBits.fill(0, 0, count);
+      this.outBits.fill(0, 0, count);
+    }
+    this.wordBase = base;
+    this.wordCount = count;
+    for (let i = 0; i < keys.length; ++i) {
+      const w = (keys[i] >>> 5) - base;
+      const bit = 1 << (keys[i] & 31);
+      this.liveBits[w] |= bit;
+      if (this.blocks[i].getStop() === STOP_END)
+        this.outBits[w] |= bit;
+    }
+  }
+
+  /**
+   * Intersect using the bitsets: reject on no common block, accept on a common
+   * live-out block, and otherwise compare the CoverBlocks of the common blocks.
+   * @param op2 is the other Cover
+   * @param listout if not null receives the common blocks whose characterization reaches level
+   * @param level is the threshold for listout
+   * @returns the characterization, as for intersect(); with listout it is not meaningful
+   */
+  private intersectDense(op2: Cover, listout: int4[] | null, level: int4): int4 {
+    this.buildDense();
+    op2.buildDense();
+    const lo = Math.max(this.wordBase, op2.wordBase);
+    const hi = Math.min(this.wordBase + this.wordCount, op2.wordBase + op2.wordCount);
+    let res: int4 = 0;
+    for (let w = lo; w < hi; ++w) {
+      const w1 = w - this.wordBase;
+      const w2 = w - op2.wordBase;
+      let common = this.liveBits[w1] & op2.liveBits[w2];
+      if (common === 0) continue;
+      if (listout === null && (this.outBits[w1] & op2.outBits[w2]) !== 0)
+        return 2;     // Both hold a value at the end of some block
+      while (common !== 0) {
+        const bit = common & -common;
+        common ^= bit;
+        const blk = (w << 5) + (31 - Math.clz32(bit));
+        const val = this.blocks[this._lowerBound(blk)].intersect(op2.blocks[op2._lowerBound(blk)]);
+        if (listout !== null) {
+          if (val >= level)
+            listout.push(blk);
+        } else if (val === 2) {
+          return 2;
+        } else if (val === 1) {
+          res = 1;
+        }
+      }
+    }
+    return res;
   }
 
   /**
@@ -538,6 +654,7 @@ export class Cover {
    * @returns the intersection characterization
    */
   intersect(op2: Cover): int4 {
+    if (Cover.dense) return this.intersectDense(op2, null, 0);
     let res: int4 = 0;
     const keys1 = this.blockIndices;
     const keys2 = op2.blockIndices;
@@ -572,6 +689,10 @@ export class Cover {
    */
   intersectList(listout: int4[], op2: Cover, level: int4): void {
     listout.length = 0;
+    if (Cover.dense) {
+      this.intersectDense(op2, listout, level);
+      return;
+    }
     const keys1 = this.blockIndices;
     const keys2 = op2.blockIndices;
     let i1 = 0;
@@ -747,8 +868,7 @@ export class Cover {
    * @param vn is the Varnode
    */
   addDefPoint(vn: Varnode): void {
-    this.blockIndices.length = 0;
-    this.blocks.length = 0;
+    this.releaseBlocks();
 
     const def: PcodeOp | null = vn.getDef();
     if (def !== null) {
@@ -63,6 +63,7 @@ import {
   VN_PRECISHI,
 } from './varnode.js';
 import { SortedSet } from '../util/sorted-set.js';
+import { ActionProfiler } from './actionprofile.js';
 
 // ---------------------------------------------------------------------------
 // Forward type declarations
@@ -1395,31 +1396,48 @@ export function symbolCompareName(sym1: Symbol, sym2: Symbol): number {
 // EntryMap (typedef for rangemap<SymbolEntry>)
 // =========================================================================
 
+/** Order SymbolEntry objects by starting offset, then by subsort */
+function compareEntries(a: SymbolEntry, b: SymbolEntry): number {
+  const aOff = a.getFirst();
+  const bOff = b.getFirst();
+  if (aOff < bOff) return -1;
+  if (aOff > bOff) return 1;
+  const aSub = a.getSubsort();
+  const bSub = b.getSubsort();
+  if (aSub.lessThan(bSub)) return -1;
+  if (bSub.lessThan(aSub)) return 1;
+  return 0;
+}
+
 /**
  * A simple representation of a rangemap of SymbolEntry objects within a single
  * address space. Stores SymbolEntry objects sorted by their starting offset.
+ *
+ * Entries added out of order are appended, and the list is sorted the next time it is
+ * read. A bulk load such as readLoaderSymbols therefore pays for one stable sort, which
+ * gives the same order as inserting each entry in place. Every block of BLOCK entries
+ * also records the largest last offset in the block and in all blocks before it. That
+ * flat interval index lets findByOffset() and findOverlap() skip blocks that cannot
+ * hold a match, instead of testing every entry. It is rebuilt lazily after a change.
  */
 export class EntryMap {
+  /** Number of entries summarized by one slot of the interval index */
+  static readonly BLOCK = 32;
+
   private entries: SymbolEntry[] = [];
+  /** False if entries were appended out of order since the last sort */
+  private sorted: boolean = true;
+  /** Largest getLast() of each block, or null if the index must be rebuilt */
+  private blockLast: bigint[] | null = null;
+  /** Largest getLast() of each block and all blocks before it */
+  private prefixLast: bigint[] = [];
 
   /** Return the number of entries */
   get length(): number { return this.entries.length; }
 
   /** Add a SymbolEntry to the map */
   addEntry(entry: SymbolEntry): SymbolEntry {
-    this.entries.push(entry);
-    // Keep sorted by first offset
-    this.entries.sort((a, b) => {
-      const aOff = a.getFirst();
-      const bOff = b.getFirst();
-      if (aOff < bOff) return -1;
-      if (aOff > bOff) return 1;
-      const aSub = a.getSubsort();
-      const bSub = b.getSubsort();
-      if (aSub.lessThan(bSub)) return -1;
-      if (bSub.lessThan(aSub)) return 1;
-      return 0;
-    });
+    this.insertEntry(entry);
     return entry;
   }
 
@@ -1430,72 +1448,174 @@ export class EntryMap {
   end_list(): number { return this.entries.length; }
 
   /** Get entry by index */
-  getEntry(index: number): SymbolEntry { return this.entries[index]; }
+  getEntry(index: number): SymbolEntry {
+    if (!this.sorted) this.sortEntries();
+    return this.entries[index];
+  }
 
   /** Get all entries as an array */
-  getEntries(): SymbolEntry[] { return this.entries; }
+  getEntries(): SymbolEntry[] {
+    if (!this.sorted) this.sortEntries();
+    return this.entries;
+  }
 
   /** Alias for getEntries (C++ compatibility: list<SymbolEntry>::const_iterator) */
-  getList(): SymbolEntry[] { return this.entries; }
+  getList(): SymbolEntry[] { return this.getEntries(); }
 
   /** Remove a specific entry */
   removeEntry(entry: SymbolEntry): void {
-    const idx = this.entries.indexOf(entry);
-    if (idx >= 0) this.entries.splice(idx, 1);
+    this.eraseEntry(entry);
   }
 
   /** Clear all entries */
-  clear(): void { this.entries.length = 0; }
+  clear(): void {
+    this.entries.length = 0;
+    this.sorted = true;
+    this.blockLast = null;
+  }
 
   /** Return the number of entries (used by part 2 code) */
   size(): number { return this.entries.length; }
 
-  /** Insert a SymbolEntry (alias used by ScopeInternal), maintaining sorted order */
+  /** Insert a SymbolEntry (alias used by ScopeInternal), maintaining sorted order as seen by readers */
   insertEntry(entry: SymbolEntry): void {
-    this.entries.push(entry);
-    // Keep sorted by first offset, then subsort
-    this.entries.sort((a, b) => {
-      const aOff = a.getFirst();
-      const bOff = b.getFirst();
-      if (aOff < bOff) return -1;
-      if (aOff > bOff) return 1;
-      const aSub = a.getSubsort();
-      const bSub = b.getSubsort();
-      if (aSub.lessThan(bSub)) return -1;
-      if (bSub.lessThan(aSub)) return 1;
-      return 0;
-    });
+    const n = this.entries.length;
+    if (n === 0 || compareEntries(this.entries[n - 1], entry) <= 0) {
+      this.entries.push(entry);
+      if (this.sorted && this.blockLast !== null)
+        this.extendIndex(n);
+      return;
+    }
+    this.entries.push(entry);         // Sorted in bulk on the next read
+    this.sorted = false;
+    this.blockLast = null;
   }
 
   /** Erase (remove) a SymbolEntry (alias used by ScopeInternal) */
   eraseEntry(entry: SymbolEntry): void {
-    const idx = this.entries.indexOf(entry);
-    if (idx >= 0) this.entries.splice(idx, 1);
+    let idx = -1;
+    if (this.sorted) {
+      // Find the first entry with the same starting offset, then look for this one
+      const first = entry.getFirst();
+      let lo = 0;
+      let hi = this.entries.length;
+      while (lo < hi) {
+        const mid = (lo + hi) >> 1;
+        if (this.entries[mid].getFirst() < first) lo = mid + 1;
+        else hi = mid;
+      }
+      for (let i = lo; i < this.entries.length && this.entries[i].getFirst() === first; ++i) {
+        if (this.entries[i] === entry) {
+          idx = i;
+          break;
+        }
+      }
+    } else {
+      idx = this.entries.indexOf(entry);
+    }
+    if (idx < 0) return;
+    this.entries.splice(idx, 1);
+    this.blockLast = null;
   }
 
   /** Find all entries whose range contains the given offset */
   findByOffset(offset: bigint): SymbolEntry[] {
     const result: SymbolEntry[] = [];
-    for (const entry of this.entries) {
-      if (entry.getFirst() <= offset && entry.getLast() >= offset) {
-        result.push(entry);
+    this.buildIndex();
+    const blockLast = this.blockLast!;
+    const B = EntryMap.BLOCK;
+    // Entries are sorted by first offset, so only those before the upper bound can contain it
+    let i = this.upperBound(offset) - 1;
+    while (i >= 0) {
+      const b = Math.floor(i / B);
+      if (this.prefixLast[b] < offset) break;   // Nothing at or before this block reaches offset
+      if (blockLast[b] < offset) {
+        i = b * B - 1;
+        continue;
       }
+      const entry = this.entries[i];
+      if (entry.getLast() >= offset)
+        result.push(entry);
+      i -= 1;
     }
+    result.reverse();
     return result;
   }
 
   /** Find first entry whose range overlaps [first, last] */
   findOverlap(first: bigint, last: bigint): SymbolEntry | null {
-    for (const entry of this.entries) {
-      if (entry.getFirst() <= last && entry.getLast() >= first) {
-        return entry;
+    this.buildIndex();
+    const blockLast = this.blockLast!;
+    const B = EntryMap.BLOCK;
+    // The first block whose prefix reaches first; prefixLast is non-decreasing
+    let lo = 0;
+    let hi = this.prefixLast.length;
+    while (lo < hi) {
+      const mid = (lo + hi) >> 1;
+      if (this.prefixLast[mid] < first) lo = mid + 1;
+      else hi = mid;
+    }
+    let i = lo * B;
+    while (i < this.entries.length) {
+      const b = Math.floor(i / B);
+      if (blockLast[b] < first) {
+        i = (b + 1) * B;
+        continue;
       }
+      const entry = this.entries[i];
+      if (entry.getFirst() > last) break;
+      if (entry.getLast() >= first)
+        return entry;
+      i += 1;
     }
     return null;
   }
 
   /** Get all entries as an array (alias used by part 2 MapIterator) */
-  getAllEntries(): SymbolEntry[] { return this.entries; }
+  getAllEntries(): SymbolEntry[] { return this.getEntries(); }
+
+  /** Sort the entries and build the interval index now, rather than on the next query */
+  buildIndex(): void {
+    if (!this.sorted) this.sortEntries();
+    if (this.blockLast !== null) return;
+    this.blockLast = [];
+    this.prefixLast = [];
+    for (let i = 0; i < this.entries.length; i += EntryMap.BLOCK)
+      this.extendIndex(i);
+  }
+
+  private sortEntries(): void {
+    this.entries.sort(compareEntries);    // Stable, so equal entries keep insertion order
+    this.sorted = true;
+    this.blockLast = null;
+  }
+
+  /** Update the interval index for a new entry at the given index, at the end of the list */
+  private extendIndex(index: number): void {
+    const blockLast = this.blockLast!;
+    const b = Math.floor(index / EntryMap.BLOCK);
+    const end = Math.min(this.entries.length, (b + 1) * EntryMap.BLOCK);
+    let max = b < blockLast.length ? blockLast[b] : -1n;
+    for (let i = Math.max(index, b * EntryMap.BLOCK); i < end; ++i) {
+      const l = this.entries[i].getLast();
+      if (l > max) max = l;
+    }
+    blockLast[b] = max;
+    const prev = b > 0 ? this.prefixLast[b - 1] : -1n;
+    this.prefixLast[b] = max > prev ? max : prev;
+  }
+
+  /** Index of the first entry starting after the given offset */
+  private upperBound(offset: bigint): number {
+    let lo = 0;
+    let hi = this.entries.length;
+    while (lo < hi) {
+      const mid = (lo + hi) >> 1;
+      if (this.entries[mid].getFirst() <= offset) lo = mid + 1;
+      else hi = mid;
+    }
+    return lo;
+  }
 }
 
 // =========================================================================
@@ -2029,6 +2149,12 @@ abstract class Scope {
   abstract clearUnlockedCategory(cat: number): void;
   abstract adjustCaches(): void;
 
+  /**
+   * Sort and index the symbol maps now rather than on the next query, for instance
+   * after a bulk load of symbols. Scopes without lazy indexes do nothing.
+   */
+  buildIndexes(): void {}
+
   /**
    * Query if the given range is owned by this Scope.
    */
@@ -2565,6 +2691,8 @@ abstract class Scope {
  */
 export class ScopeInternal extends Scope {
   protected nametree: SortedSet<Symbol>;
+  /** Symbols of nametree by name, each list in nameDedup order */
+  protected nameindex: Map<string, Symbol[]>;
   protected maptable: Array<EntryMap | null>;
   protected category: Symbol[][];
   protected dynamicentry: SymbolEntry[];
@@ -2577,6 +2705,7 @@ export class ScopeInternal extends Scope {
     super(id, nm, g, own !== undefined ? own : null);
     this.nextUniqueId = 0n;
     this.nametree = new SortedSet<Symbol>(symbolCompareName);
+    this.nameindex = new Map();
     this.multiEntrySet = new SortedSet<Symbol>(symbolCompareName);
     this.category = [];
     this.dynamicentry = [];
@@ -2590,6 +2719,7 @@ export class ScopeInternal extends Scope {
     }
     // Symbols owned by nametree are garbage-collected
     this.nametree.clear();
+    this.nameindex.clear();
     this.multiEntrySet.clear();
     super.dispose();
   }
@@ -2837,6 +2967,13 @@ export class ScopeInternal extends Scope {
     }
   }
 
+  buildIndexes(): void {
+    for (const rangemap of this.maptable) {
+      if (rangemap !== null)
+        rangemap.buildIndex();
+    }
+  }
+
   // ------------------------------------------------------------------
   // Symbol/mapping removal
   // ------------------------------------------------------------------
@@ -2873,11 +3010,11 @@ export class ScopeInternal extends Scope {
       }
     }
     this.removeSymbolMappings(symbol);
-    this.nametree.eraseValue(symbol);
+    this.eraseNameTree(symbol);
   }
 
   renameSymbol(sym: Symbol, newname: string): void {
-    this.nametree.eraseValue(sym);
+    this.eraseNameTree(sym);
     if (sym.wholeCount > 1)
       this.multiEntrySet.eraseValue(sym);
     sym.name = newname;
@@ -2937,6 +3074,7 @@ export class ScopeInternal extends Scope {
   // ------------------------------------------------------------------
 
   findAddr(addr: any, usepoint: any): SymbolEntry | null {
+    ActionProfiler.active?.count('scope.findAddr');
     const spc = addr.getSpace();
     if (spc === null) return null;
     const rangemap = getMaptableEntry(this.maptable, spc);
@@ -2956,6 +3094,7 @@ export class ScopeInternal extends Scope {
   }
 
   findContainer(addr: any, size: number, usepoint: any): SymbolEntry | null {
+    ActionProfiler.active?.count('scope.findContainer');
     let bestentry: SymbolEntry | null = null;
     const spc = addr.getSpace();
     if (spc === null) return null;
@@ -2981,6 +3120,7 @@ export class ScopeInternal extends Scope {
   }
 
   findClosestFit(addr: any, size: number, usepoint: any): SymbolEntry | null {
+    ActionProfiler.active?.count('scope.findClosestFit');
     let bestentry: SymbolEntry | null = null;
     const spc = addr.getSpace();
     if (spc === null) return null;
@@ -3007,6 +3147,7 @@ export class ScopeInternal extends Scope {
   }
 
   findFunction(addr: any): Funcdata | null {
+    ActionProfiler.active?.count('scope.findFunction');
     const spc = addr.getSpace();
     if (spc === null) return null;
     const rangemap = getMaptableEntry(this.maptable, spc);
@@ -3025,6 +3166,7 @@ export class ScopeInternal extends Scope {
   }
 
   findExternalRef(addr: any): ExternRefSymbol | null {
+    ActionProfiler.active?.count('scope.findExternalRef');
     const spc = addr.getSpace();
     if (spc === null) return null;
     const rangemap = getMaptableEntry(this.maptable, spc);
@@ -3043,6 +3185,7 @@ export class ScopeInternal extends Scope {
   }
 
   findCodeLabel(addr: any): LabSymbol | null {
+    ActionProfiler.active?.count('scope.findCodeLabel');
     const spc = addr.getSpace();
     if (spc === null) return null;
     const rangemap = getMaptableEntry(this.maptable, spc);
@@ -3062,6 +3205,7 @@ export class ScopeInternal extends Scope {
   }
 
   findOverlap(addr: any, size: number): SymbolEntry | null {
+    ActionProfiler.active?.count('scope.findOverlap');
     const spc = addr.getSpace();
     if (spc === null) return null;
     const rangemap = getMaptableEntry(this.maptable, spc);
@@ -3072,25 +3216,14 @@ export class ScopeInternal extends Scope {
   }
 
   findByName(nm: string): Symbol[] {
-    const res: Symbol[] = [];
-    const iter = this.findFirstByName(nm);
-    if (iter.isEnd) return res;
-    let cur = iter.clone();
-    while (!cur.isEnd) {
-      const sym = cur.value;
-      if (sym.name !== nm) break;
-      res.push(sym);
-      cur.next();
-    }
-    return res;
+    ActionProfiler.active?.count('scope.findByName');
+    const list = this.nameindex.get(nm);
+    return list !== undefined ? list.slice() : [];
   }
 
   isNameUsed(nm: string, op2: Scope | null): boolean {
-    const testSym = new Symbol(null as any, nm, null);
-    const iter = this.nametree.lower_bound(testSym);
-    if (!iter.isEnd) {
-      if (iter.value.getName() === nm) return true;
-    }
+    ActionProfiler.active?.count('scope.isNameUsed');
+    if (this.nameindex.has(nm)) return true;
     const par = this.getParent();
     if (par === null || par === op2) return false;
     if (par.getParent() === null) return false; // Never recurse into global scope
@@ -3201,14 +3334,14 @@ export class ScopeInternal extends Scope {
       if (ct !== null) { s = this.enhancedVarPrefix(ct); }
       s += "Var" + index.val.toString();
       index.val++;
-      if (!this.findFirstByName(s).isEnd) {
+      if (this.nameindex.has(s)) {
         // If the name already exists, bump the index a few times
         for (let i = 0; i < 10; i++) {
           let s2 = "";
           if (ct !== null) { s2 = this.enhancedVarPrefix(ct); }
           s2 += "Var" + index.val.toString();
           index.val++;
-          if (this.findFirstByName(s2).isEnd) {
+          if (!this.nameindex.has(s2)) {
             return s2;
           }
         }
@@ -3259,8 +3392,8 @@ export class ScopeInternal extends Scope {
   }
 
   makeNameUnique(nm: string): string {
+    if (!this.nameindex.has(nm)) return nm; // nm is already unique
     const iter = this.findFirstByName(nm);
-    if (iter.isEnd) return nm; // nm is already unique
 
     const boundsym = new Symbol(null as any, nm + "_x99999", null);
     boundsym.nameDedup = 0xFFFFFFFF;
@@ -3310,7 +3443,7 @@ export class ScopeInternal extends Scope {
       }
     }
 
-    if (!this.findFirstByName(resString).isEnd) {
+    if (this.nameindex.has(resString)) {
       throw new Error("Unable to uniquify name: " + resString);
     }
     return resString;
@@ -3505,28 +3638,38 @@ export class ScopeInternal extends Scope {
     const elemId = decoder.openElementId(ELEM_COLLISION);
     const nm = decoder.readStringById(ATTRIB_NAME);
     decoder.closeElement(elemId);
-    const iter = this.findFirstByName(nm);
-    if (iter.isEnd) {
+    if (!this.nameindex.has(nm)) {
       const ct = this.getArch().types.getBase(1, type_metatype.TYPE_INT);
       this.addSymbol(nm, ct);
     }
   }
 
   private insertNameTree(sym: Symbol): void {
-    sym.nameDedup = 0;
+    // Take 0 if it is free, otherwise one more than the largest in use, as C++ does
+    const list = this.nameindex.get(sym.name);
+    sym.nameDedup = (list === undefined || list[0].nameDedup !== 0) ? 0 : list[list.length - 1].nameDedup + 1;
     const [, inserted] = this.nametree.insert(sym);
     if (!inserted) {
-      sym.nameDedup = 0xFFFFFFFF;
-      const iter = this.nametree.upper_bound(sym);
-      const prev = iter.clone().prev();
-      if (!prev.isEnd) {
-        sym.nameDedup = prev.value.nameDedup + 1;
-      }
-      const [, inserted2] = this.nametree.insert(sym);
-      if (!inserted2) {
-        throw new Error("Could not deduplicate symbol: " + sym.name);
-      }
+      throw new Error("Could not deduplicate symbol: " + sym.name);
     }
+    if (list === undefined)
+      this.nameindex.set(sym.name, [sym]);
+    else if (sym.nameDedup === 0)
+      list.unshift(sym);
+    else
+      list.push(sym);
+  }
+
+  private eraseNameTree(sym: Symbol): void {
+    this.nametree.eraseValue(sym);
+    const list = this.nameindex.get(sym.name);
+    if (list === undefined) return;
+    const i = list.indexOf(sym);
+    if (i < 0) return;
+    if (list.length === 1)
+      this.nameindex.delete(sym.name);
+    else
+      list.splice(i, 1);
   }
 
   private findFirstByName(nm: string): any {
@@ -3587,13 +3730,7 @@ export class Database {
     this.resolvemap = [];
     this.idmap = new Map();
     this.idByNameHash = idByName;
-    this.flagbase = new PartMap<Address, number>(
-      0,
-      (a: Address, b: Address) => {
-        if (a.equals(b)) return 0;
-        return a.lessThan(b) ? -1 : 1;
-      }
-    );
+    this.flagbase = new PartMap<Address, number>(0, Address.compare);
   }
 
   dispose(): void {
@@ -3697,6 +3834,15 @@ export class Database {
     }
   }
 
+  /**
+   * Build the lazy symbol indexes of every scope, after a bulk load of symbols.
+   */
+  buildIndexes(): void {
+    for (const [, scope] of this.idmap) {
+      scope.buildIndexes();
+    }
+  }
+
   /**
    * Register a new Scope.
    * If parent is null, the scope becomes the global scope.
@@ -6,7 +6,7 @@
 import type { int4, uint4, uintb, uintm } from '../core/types.js';
 import { LowlevelError } from '../core/error.js';
 import { Address } from '../core/address.js';
-import { AddrSpace } from '../core/space.js';
+import { AddrSpace, spacetype } from '../core/space.js';
 import { OpCode } from '../core/opcodes.js';
 import { OpBehavior } from '../core/opbehavior.js';
 import {
@@ -15,6 +15,7 @@ import {
   Address as PcodeRawAddress,
 } from '../core/pcoderaw.js';
 import { PcodeEmit, Translate } from '../core/translate.js';
+import { MemoryPageOverlay } from './memstate.js';
 
 // Forward-declare types not yet available
 type MemoryState = any;
@@ -29,13 +30,17 @@ function toAddress(raw: PcodeRawAddress): Address {
 
 /**
  * Emulate VarnodeData.getSpaceFromConst().
- * In C++ this casts the offset field to an AddrSpace pointer.
- * In the TS translation, the space is encoded in the varnode's space field
- * (for LOAD/STORE the first input is a constant whose offset encodes a space index).
- * We rely on the MemoryState / caller to resolve this; here we use the space field directly.
+ * In C++ the constant's offset is a pointer to the AddrSpace.  In the TS translation,
+ * SLEIGH encodes the space index as the offset (for LOAD/STORE the first input), so the
+ * space is looked up through the translator.
+ * @param trans is the translator owning the address spaces
+ * @param vn is the constant varnode encoding the space
  */
-function getSpaceFromConst(vn: VarnodeData): AddrSpace {
-  return (vn as any).getSpaceFromConst?.() ?? (vn.space as any);
+function getSpaceFromConst(trans: Translate, vn: VarnodeData): AddrSpace {
+  const spc = trans.getSpace(Number(vn.offset));
+  if (spc === null)
+    throw new LowlevelError('Constant does not encode an address space: ' + vn.offset.toString());
+  return spc;
 }
 
 // ---------------------------------------------------------------------------
@@ -271,6 +276,11 @@ export class BreakTableCallBack extends BreakTable {
     return cb.addressCallback(addr);
   }
 
+  /** Return true if any address based breakpoint is registered */
+  hasAddressCallbacks(): boolean {
+    return this.addresscallback.size !== 0;
+  }
+
   /**
    * Create a string key from an Address for use in the address callback map.
    * Since we cannot use Address objects directly as Map keys, we create a unique
@@ -504,43 +514,43 @@ export abstract class EmulateMemory extends Emulate {
   }
 
   protected executeUnary(): void {
-    const in1: bigint = this.memstate.getValue(this.currentOp!.getInput(0));
-    const out: bigint = this.currentBehave!.evaluateUnary(
+    const in1: bigint = this.memstate.getValueVarnode(this.currentOp!.getInput(0));
+    const out: bigint = this.currentBehave!.evaluateUnarySized(
       this.currentOp!.getOutput()!.size,
       this.currentOp!.getInput(0).size,
       in1
     );
-    this.memstate.setValue(this.currentOp!.getOutput()!, out);
+    this.memstate.setValueVarnode(this.currentOp!.getOutput()!, out);
   }
 
   protected executeBinary(): void {
-    const in1: bigint = this.memstate.getValue(this.currentOp!.getInput(0));
-    const in2: bigint = this.memstate.getValue(this.currentOp!.getInput(1));
-    const out: bigint = this.currentBehave!.evaluateBinary(
+    const in1: bigint = this.memstate.getValueVarnode(this.currentOp!.getInput(0));
+    const in2: bigint = this.memstate.getValueVarnode(this.currentOp!.getInput(1));
+    const out: bigint = this.currentBehave!.evaluateBinarySized(
       this.currentOp!.getOutput()!.size,
       this.currentOp!.getInput(0).size,
       in1,
       in2
     );
-    this.memstate.setValue(this.currentOp!.getOutput()!, out);
+    this.memstate.setValueVarnode(this.currentOp!.getOutput()!, out);
   }
 
   protected executeLoad(): void {
-    let off: bigint = this.memstate.getValue(this.currentOp!.getInput(1));
-    const spc: AddrSpace = getSpaceFromConst(this.currentOp!.getInput(0));
+    let off: bigint = this.memstate.getValueVarnode(this.currentOp!.getInput(1));
+    const spc: AddrSpace = getSpaceFromConst(this.memstate.getTranslate(), this.currentOp!.getInput(0));
 
     off = AddrSpace.addressToByte(off, spc.getWordSize());
-    const res: bigint = this.memstate.getValue(spc, off, this.currentOp!.getOutput()!.size);
-    this.memstate.setValue(this.currentOp!.getOutput()!, res);
+    const res: bigint = this.memstate.getValueSpace(spc, off, this.currentOp!.getOutput()!.size);
+    this.memstate.setValueVarnode(this.currentOp!.getOutput()!, res);
   }
 
   protected executeStore(): void {
-    const val: bigint = this.memstate.getValue(this.currentOp!.getInput(2)); // Value being stored
-    let off: bigint = this.memstate.getValue(this.currentOp!.getInput(1)); // Offset to store at
-    const spc: AddrSpace = getSpaceFromConst(this.currentOp!.getInput(0)); // Space to store in
+    const val: bigint = this.memstate.getValueVarnode(this.currentOp!.getInput(2)); // Value being stored
+    let off: bigint = this.memstate.getValueVarnode(this.currentOp!.getInput(1)); // Offset to store at
+    const spc: AddrSpace = getSpaceFromConst(this.memstate.getTranslate(), this.currentOp!.getInput(0)); // Space to store in
 
     off = AddrSpace.addressToByte(off, spc.getWordSize());
-    this.memstate.setValue(spc, off, this.currentOp!.getInput(2).size, val);
+    this.memstate.setValueSpace(spc, off, this.currentOp!.getInput(2).size, val);
   }
 
   protected executeBranch(): void {
@@ -548,12 +558,12 @@ export abstract class EmulateMemory extends Emulate {
   }
 
   protected executeCbranch(): boolean {
-    const cond: bigint = this.memstate.getValue(this.currentOp!.getInput(1));
+    const cond: bigint = this.memstate.getValueVarnode(this.currentOp!.getInput(1));
     return (cond !== 0n);
   }
 
   protected executeBranchind(): void {
-    const off: bigint = this.memstate.getValue(this.currentOp!.getInput(0));
+    const off: bigint = this.memstate.getValueVarnode(this.currentOp!.getInput(0));
     const rawAddr = this.currentOp!.getAddr();
     this.setExecuteAddress(new Address(rawAddr.getSpace() as any as AddrSpace, off));
   }
@@ -563,7 +573,7 @@ export abstract class EmulateMemory extends Emulate {
   }
 
   protected executeCallind(): void {
-    const off: bigint = this.memstate.getValue(this.currentOp!.getInput(0));
+    const off: bigint = this.memstate.getValueVarnode(this.currentOp!.getInput(0));
     const rawAddr = this.currentOp!.getAddr();
     this.setExecuteAddress(new Address(rawAddr.getSpace() as any as AddrSpace, off));
   }
@@ -893,3 +903,621 @@ export class EmulatePcodeCache extends EmulateMemory {
     } while (!this.instruction_start);
   }
 }
+
+// ---------------------------------------------------------------------------
+// EmulateCompiled
+// ---------------------------------------------------------------------------
+
+/**
+ * A compiled p-code op. Running it performs the op and returns the index of the next op
+ * to run within the instruction, or one of the STEP_ codes.
+ */
+type CompiledStep = () => int4;
+
+/** Step result: control falls through to the next instruction */
+const STEP_FALLTHRU = -1;
+/** Step result: control has already been moved to a new execution address */
+const STEP_JUMP = -2;
+
+/**
+ * The p-code translation of one machine instruction, compiled into closures.
+ */
+class CompiledInstruction {
+  /** Address of the instruction */
+  addr: Address;
+  /** Length of the instruction in bytes */
+  length: int4;
+  /** The raw p-code ops, as breakpoints see them */
+  ops: PcodeOpRaw[];
+  /** One compiled step per op (a single fallthru step if there are no ops) */
+  steps: CompiledStep[] = [];
+  /** The instruction this one falls through to, once it has been looked up */
+  fallthru: CompiledInstruction | null = null;
+
+  constructor(addr: Address, length: int4, ops: PcodeOpRaw[]) {
+    this.addr = addr;
+    this.length = length;
+    this.ops = ops;
+  }
+}
+
+/**
+ * An emulator that compiles the p-code of each machine instruction into closures.
+ *
+ * Each instruction is translated once, the first time it is reached, and each of its
+ * p-code ops becomes a closure specialized for the op's opcode, sizes and storage.
+ * Constants are folded into the closure. Varnodes in a space backed by a MemoryPageOverlay
+ * are read and written directly through a DataView of their page, and ops on values of
+ * at most 4 bytes are computed as uint32 numbers instead of bigints. Varnodes in other
+ * banks go through the MemoryState as usual, which costs most when the unique space sits in
+ * a MemoryHashOverlay: on x86-64 code, putting it in a MemoryPageOverlay as well makes
+ * runs several times faster (see --emulate in test/benchmark.ts).
+ *
+ * The Emulate interface behaves as for EmulatePcodeCache, including single stepping by
+ * p-code op, so BreakTableCallBack breakpoints work unchanged: CALLOTHER ops invoke
+ * doPcodeOpBreak() and each instruction start invokes doAddressBreak(). Breakpoints may
+ * change the memory state, as the compiled ops read the same pages.
+ *
+ * Instructions are cached by address, so code that changes the load image, or a context
+ * that changes how an instruction decodes, needs a call to clearCache().
+ */
+export class EmulateCompiled extends EmulateMemory {
+  /** The SLEIGH translator */
+  private trans: Translate;
+  /** Map from OpCode to OpBehavior */
+  private inst: (OpBehavior | null)[];
+  /** The table of breakpoints */
+  private breaktable: BreakTable;
+  /** The compiled instructions, by space and offset */
+  private cache: Map<AddrSpace, Map<bigint, CompiledInstruction>> = new Map();
+  /** The instruction being executed */
+  private cur: CompiledInstruction | null = null;
+  /** Index of current pcode op within machine instruction */
+  private current_op: int4 = 0;
+  /** true if next pcode op is start of instruction */
+  private instruction_start: boolean = false;
+
+  /**
+   * @param t is the SLEIGH translator
+   * @param s is the MemoryState the emulator should manipulate
+   * @param b is the table of breakpoints the emulator should invoke
+   */
+  constructor(t: Translate, s: MemoryState, b: BreakTable) {
+    super(s);
+    this.trans = t;
+    this.inst = OpBehavior.registerInstructions(t);
+    this.breaktable = b;
+    this.breaktable.setEmulate(this);
+  }
+
+  /** Drop all compiled instructions, so they are translated again when reached */
+  clearCache(): void {
+    this.cache.clear();
+    if (this.cur !== null)
+      this.cur = this.lookup(this.cur.addr);
+  }
+
+  /** Get the compiled instruction at the given address, compiling it if necessary */
+  private lookup(addr: Address): CompiledInstruction {
+    const spc = addr.getSpace()!;
+    let map = this.cache.get(spc);
+    if (map === undefined) {
+      map = new Map();
+      this.cache.set(spc, map);
+    }
+    let res = map.get(addr.getOffset());
+    if (res === undefined) {
+      res = this.compileInstruction(new Address(addr));
+      map.set(addr.getOffset(), res);
+    }
+    return res;
+  }
+
+  /** Start executing the given instruction from its first op */
+  private enter(ins: CompiledInstruction): void {
+    this.cur = ins;
+    this.current_op = 0;
+    this.instruction_start = true;
+    this.currentOp = ins.ops.length > 0 ? ins.ops[0] : null;
+    this.currentBehave = this.currentOp !== null ? this.currentOp.getBehavior() : null;
+  }
+
+  /** Move to the instruction following the current one */
+  private enterFallthru(): void {
+    const ins = this.cur!;
+    if (ins.fallthru === null)
+      ins.fallthru = this.lookup(ins.addr.add(BigInt(ins.length)));
+    this.enter(ins.fallthru);
+  }
+
+  /** Act on the result of a step */
+  private advance(next: int4): void {
+    if (next >= 0) {
+      const ins = this.cur!;
+      if (next >= ins.ops.length) {
+        this.enterFallthru();
+        return;
+      }
+      this.current_op = next;
+      this.instruction_start = false;
+      this.currentOp = ins.ops[next];
+      this.currentBehave = this.currentOp.getBehavior();
+    } else if (next === STEP_FALLTHRU) {
+      this.enterFallthru();
+    }
+  }
+
+  /** Translate and compile the instruction at the given address */
+  private compileInstruction(addr: Address): CompiledInstruction {
+    const ops: PcodeOpRaw[] = [];
+    const emit = new PcodeEmitCache(ops, [], this.inst, 0n);
+    const length = this.trans.oneInstruction(emit, addr);
+    const ins = new CompiledInstruction(addr, length, ops);
+    if (ops.length === 0)
+      ins.steps.push(() => STEP_FALLTHRU);
+    for (let i = 0; i < ops.length; ++i)
+      ins.steps.push(this.compileOp(ops[i], i, ops.length));
+    return ins;
+  }
+
+  // -- Varnode access --
+
+  /** Get a view of the page holding the given bytes, if they can be accessed directly */
+  private pageOf(spc: AddrSpace, off: bigint, size: int4): { view: DataView, pos: int4 } | null {
+    const bank = this.memstate.getMemoryBank(spc);
+    if (!(bank instanceof MemoryPageOverlay)) return null;
+    const pagesize = BigInt(bank.getPageSize());
+    const pageaddr = off & ~(pagesize - 1n);
+    const pos = Number(off - pageaddr);
+    if (pos + size > bank.getPageSize()) return null;
+    return { view: bank.getPageView(pageaddr), pos };
+  }
+
+  /** Build a reader of the given varnode as a uint32 number (its size must be at most 4) */
+  private reader32(vn: VarnodeData): () => number {
+    const spc = vn.space as any as AddrSpace;
+    const off = vn.offset;
+    const size = vn.size;
+    if (spc.getType() === spacetype.IPTR_CONSTANT) {
+      const val = Number(off);
+      return () => val;
+    }
+    const page = this.pageOf(spc, off, size);
+    if (page !== null) {
+      const { view, pos } = page;
+      const le = !spc.isBigEndian();
+      if (size === 4) return () => view.getUint32(pos, le);
+      if (size === 2) return () => view.getUint16(pos, le);
+      if (size === 1) return () => view.getUint8(pos);
+    }
+    const mem = this.memstate;
+    return () => Number(mem.getValueSpace(spc, off, size));
+  }
+
+  /** Build a writer of the given varnode from a uint32 number (its size must be at most 4) */
+  private writer32(vn: VarnodeData): (val: number) => void {
+    const spc = vn.space as any as AddrSpace;
+    const off = vn.offset;
+    const size = vn.size;
+    const page = this.pageOf(spc, off, size);
+    if (page !== null) {
+      const { view, pos } = page;
+      const le = !spc.isBigEndian();
+      if (size === 4) return (val: number) => view.setUint32(pos, val, le);
+      if (size === 2) return (val: number) => view.setUint16(pos, val, le);
+      if (size === 1) return (val: number) => view.setUint8(pos, val);
+    }
+    const mem = this.memstate;
+    return (val: number) => mem.setValueSpace(spc, off, size, BigInt(val));
+  }
+
+  /** Build a reader of the given varnode as a bigint */
+  private reader(vn: VarnodeData): () => bigint {
+    const spc = vn.space as any as AddrSpace;
+    const off = vn.offset;
+    const size = vn.size;
+    if (spc.getType() === spacetype.IPTR_CONSTANT)
+      return () => off;
+    const page = this.pageOf(spc, off, size);
+    if (page !== null) {
+      const { view, pos } = page;
+      const le = !spc.isBigEndian();
+      if (size === 8) return () => view.getBigUint64(pos, le);
+      if (size === 4) return () => BigInt(view.getUint32(pos, le));
+      if (size === 2) return () => BigInt(view.getUint16(pos, le));
+      if (size === 1) return () => BigInt(view.getUint8(pos));
+    }
+    const mem = this.memstate;
+    return () => mem.getValueSpace(spc, off, size);
+  }
+
+  /** Build a writer of the given varnode from a bigint */
+  private writer(vn: VarnodeData): (val: bigint) => void {
+    const spc = vn.space as any as AddrSpace;
+    const off = vn.offset;
+    const size = vn.size;
+    const page = this.pageOf(spc, off, size);
+    if (page !== null) {
+      const { view, pos } = page;
+      const le = !spc.isBigEndian();
+      if (size === 8) return (val: bigint) => view.setBigUint64(pos, BigInt.asUintN(64, val), le);
+      if (size === 4) return (val: bigint) => view.setUint32(pos, Number(val & 0xFFFFFFFFn), le);
+      if (size === 2) return (val: bigint) => view.setUint16(pos, Number(val & 0xFFFFn), le);
+      if (size === 1) return (val: bigint) => view.setUint8(pos, Number(val & 0xFFn));
+    }
+    const mem = this.memstate;
+    return (val: bigint) => mem.setValueSpace(spc, off, size, val);
+  }
+
+  /**
+   * Build a reader of memory at a dynamic offset, as used by LOAD and STORE.
+   * The page most recently used is remembered, as consecutive accesses usually share it.
+   */
+  private dynamicAccess(spc: AddrSpace, size: int4): { get: (off: bigint) => bigint, set: (off: bigint, val: bigint) => void } {
+    const mem = this.memstate;
+    const bank = mem.getMemoryBank(spc);
+    if (!(bank instanceof MemoryPageOverlay) || (size !== 1 && size !== 2 && size !== 4 && size !== 8)) {
+      return {
+        get: (off: bigint) => mem.getValueSpace(spc, off, size),
+        set: (off: bigint, val: bigint) => mem.setValueSpace(spc, off, size, val),
+      };
+    }
+    const pagesize = bank.getPageSize();
+    const pagemask = BigInt(pagesize - 1);
+    const le = !spc.isBigEndian();
+    let lastaddr = -1n;
+    let lastview: DataView | null = null;
+    const locate = (off: bigint): int4 => {
+      const pageaddr = off & ~pagemask;
+      if (pageaddr !== lastaddr) {
+        lastview = bank.getPageView(pageaddr);
+        lastaddr = pageaddr;
+      }
+      return Number(off - pageaddr);
+    };
+    return {
+      get: (off: bigint): bigint => {
+        const pos = locate(off);
+        if (pos + size > pagesize) return mem.getValueSpace(spc, off, size);
+        const view = lastview!;
+        switch (size) {
+          case 8: return view.getBigUint64(pos, le);
+          case 4: return BigInt(view.getUint32(pos, le));
+          case 2: return BigInt(view.getUint16(pos, le));
+          default: return BigInt(view.getUint8(pos));
+        }
+      },
+      set: (off: bigint, val: bigint): void => {
+        const pos = locate(off);
+        if (pos + size > pagesize) {
+          mem.setValueSpace(spc, off, size, val);
+          return;
+        }
+        const view = lastview!;
+        switch (size) {
+          case 8: view.setBigUint64(pos, BigInt.asUintN(64, val), le); break;
+          case 4: view.setUint32(pos, Number(val & 0xFFFFFFFFn), le); break;
+          case 2: view.setUint16(pos, Number(val & 0xFFFFn), le); break;
+          default: view.setUint8(pos, Number(val & 0xFFn)); break;
+        }
+      },
+    };
+  }
+
+  // -- Op compilation --
+
+  /** Can the op be computed on uint32 numbers */
+  private static isUint32(op: PcodeOpRaw, behave: OpBehavior): boolean {
+    if (!behave.hasUint32()) return false;
+    const out = op.getOutput();
+    if (out === null || out.size > 4 || out.size <= 0) return false;
+    for (let i = 0; i < op.numInput(); ++i) {
+      const vn = op.getInput(i);
+      if (vn.size > 4 || vn.size <= 0) return false;
+      if ((vn.space as any).getType() === spacetype.IPTR_CONSTANT && vn.offset > 0xFFFFFFFFn) return false;
+    }
+    return true;
+  }
+
+  /**
+   * Build the step for a branch to the given destination.
+   * @param dest is the destination of the BRANCH, CBRANCH or CALL
+   * @param index is the index of the branching op
+   * @param numops is the number of ops in the instruction
+   */
+  private branchTo(dest: PcodeRawAddress, index: int4, numops: int4): CompiledStep {
+    if (dest.isConstant()) {
+      // Relative branch within the instruction
+      const id = index + Number(BigInt.asIntN(64, dest.getOffset()));
+      if (id === numops) return () => STEP_FALLTHRU;
+      if (id < 0 || id > numops)
+        return () => { throw new LowlevelError('Bad intra-instruction branch'); };
+      return () => id;
+    }
+    const addr = toAddress(dest);
+    let target: CompiledInstruction | null = null;
+    return () => {
+      if (target === null) target = this.lookup(addr);
+      this.enter(target);
+      return STEP_JUMP;
+    };
+  }
+
+  /**
+   * Compile a single p-code op into a step.
+   * @param op is the op
+   * @param index is its index within the instruction
+   * @param numops is the number of ops in the instruction
+   */
+  private compileOp(op: PcodeOpRaw, index: int4, numops: int4): CompiledStep {
+    const behave = op.getBehavior();
+    const next = index + 1;
+    if (behave === null) return () => next;   // Presumably a NO-OP
+    const opc = behave.getOpcode();
+    if (behave.isSpecial()) {
+      switch (opc) {
+        case OpCode.CPUI_LOAD: {
+          const spc = getSpaceFromConst(this.trans, op.getInput(0));
+          const ws = spc.getWordSize();
+          const getoff = this.reader(op.getInput(1));
+          const access = this.dynamicAccess(spc, op.getOutput()!.size);
+          const write = this.writer(op.getOutput()!);
+          return () => {
+            write(access.get(AddrSpace.addressToByte(getoff(), ws)));
+            return next;
+          };
+        }
+        case OpCode.CPUI_STORE: {
+          const spc = getSpaceFromConst(this.trans, op.getInput(0));
+          const ws = spc.getWordSize();
+          const getoff = this.reader(op.getInput(1));
+          const getval = this.reader(op.getInput(2));
+          const access = this.dynamicAccess(spc, op.getInput(2).size);
+          return () => {
+            const val = getval();
+            access.set(AddrSpace.addressToByte(getoff(), ws), val);
+            return next;
+          };
+        }
+        case OpCode.CPUI_BRANCH:
+        case OpCode.CPUI_CALL:
+          return this.branchTo(op.getInput(0).getAddr(), index, numops);
+        case OpCode.CPUI_CBRANCH: {
+          const branch = this.branchTo(op.getInput(0).getAddr(), index, numops);
+          const vn = op.getInput(1);
+          if (vn.size <= 4) {
+            const cond = this.reader32(vn);
+            return () => (cond() !== 0) ? branch() : next;
+          }
+          const cond = this.reader(vn);
+          return () => (cond() !== 0n) ? branch() : next;
+        }
+        case OpCode.CPUI_BRANCHIND:
+        case OpCode.CPUI_CALLIND:
+        case OpCode.CPUI_RETURN: {
+          const getoff = this.reader(op.getInput(0));
+          const spc = op.getAddr().getSpace() as any as AddrSpace;
+          return () => {
+            this.setExecuteAddress(new Address(spc, getoff()));
+            return STEP_JUMP;
+          };
+        }
+        case OpCode.CPUI_CALLOTHER:
+          return () => {
+            this.currentOp = op;
+            this.currentBehave = behave;
+            if (!this.breaktable.doPcodeOpBreak(op))
+              throw new LowlevelError('Userop not hooked');
+            // As for EmulatePcodeCache, fall through from wherever the breakpoint left us
+            return this.current_op + 1;
+          };
+        case OpCode.CPUI_MULTIEQUAL:
+          return () => { throw new LowlevelError('MULTIEQUAL appearing in unheritaged code?'); };
+        case OpCode.CPUI_INDIRECT:
+          return () => { throw new LowlevelError('INDIRECT appearing in unheritaged code?'); };
+        case OpCode.CPUI_SEGMENTOP:
+          return () => { throw new LowlevelError('SEGMENTOP emulation not currently supported'); };
+        case OpCode.CPUI_CPOOLREF:
+          return () => { throw new LowlevelError('Cannot currently emulate cpool operator'); };
+        case OpCode.CPUI_NEW:
+          return () => { throw new LowlevelError('Cannot currently emulate new operator'); };
+        default:
+          return () => { throw new LowlevelError('Bad special op'); };
+      }
+    }
+    const out = op.getOutput()!;
+    const sizeout = out.size;
+    const sizein = op.getInput(0).size;
+    if (EmulateCompiled.isUint32(op, behave))
+      return behave.isUnary() ? this.compileUnary32(opc, behave, op, next) : this.compileBinary32(opc, behave, op, next);
+    const write = this.writer(out);
+    const in1 = this.reader(op.getInput(0));
+    if (behave.isUnary()) {
+      return () => {
+        write(behave.evaluateUnarySized(sizeout, sizein, in1()));
+        return next;
+      };
+    }
+    const in2 = this.reader(op.getInput(1));
+    return () => {
+      write(behave.evaluateBinarySized(sizeout, sizein, in1(), in2()));
+      return next;
+    };
+  }
+
+  /** Compile a unary op on values of at most 4 bytes */
+  private compileUnary32(opc: OpCode, behave: OpBehavior, op: PcodeOpRaw, next: int4): CompiledStep {
+    const sizeout = op.getOutput()!.size;
+    const sizein = op.getInput(0).size;
+    const write = this.writer32(op.getOutput()!);
+    const in1 = this.reader32(op.getInput(0));
+    if (opc === OpCode.CPUI_COPY || opc === OpCode.CPUI_INT_ZEXT) {
+      return () => {
+        write(in1());
+        return next;
+      };
+    }
+    return () => {
+      const a = in1();
+      let res = behave.evaluateUnary32(sizeout, sizein, a);
+      if (res < 0) res = Number(behave.evaluateUnary(sizeout, sizein, BigInt(a)));
+      write(res);
+      return next;
+    };
+  }
+
+  /** Compile a binary op on values of at most 4 bytes */
+  private compileBinary32(opc: OpCode, behave: OpBehavior, op: PcodeOpRaw, next: int4): CompiledStep {
+    const sizeout = op.getOutput()!.size;
+    const sizein = op.getInput(0).size;
+    const mask = sizeout === 4 ? 0xFFFFFFFF : (1 << (8 * sizeout)) - 1;
+    const write = this.writer32(op.getOutput()!);
+    const in1 = this.reader32(op.getInput(0));
+    const in2 = this.reader32(op.getInput(1));
+    switch (opc) {
+      case OpCode.CPUI_INT_ADD:
+        return () => { write(((in1() + in2()) & mask) >>> 0); return next; };
+      case OpCode.CPUI_INT_SUB:
+        return () => { write(((in1() - in2()) & mask) >>> 0); return next; };
+      case OpCode.CPUI_INT_AND:
+        return () => { write((in1() & in2()) >>> 0); return next; };
+      case OpCode.CPUI_INT_OR:
+        return () => { write((in1() | in2()) >>> 0); return next; };
+      case OpCode.CPUI_INT_XOR:
+        return () => { write((in1() ^ in2()) >>> 0); return next; };
+      case OpCode.CPUI_INT_EQUAL:
+        return () => { write(in1() === in2() ? 1 : 0); return next; };
+      case OpCode.CPUI_INT_NOTEQUAL:
+        return () => { write(in1() !== in2() ? 1 : 0); return next; };
+      case OpCode.CPUI_INT_LESS:
+        return () => { write(in1() < in2() ? 1 : 0); return next; };
+      default:
+        return () => {
+          const a = in1();
+          const b = in2();
+          let res = behave.evaluateBinary32(sizeout, sizein, a, b);
+          if (res < 0) res = Number(behave.evaluateBinary(sizeout, sizein, BigInt(a), BigInt(b)));
+          write(res);
+          return next;
+        };
+    }
+  }
+
+  // -- Emulate interface --
+
+  protected fallthruOp(): void {
+    this.advance(this.current_op + 1);
+  }
+
+  executeCurrentOp(): void {
+    if (this.cur === null)
+      throw new LowlevelError('Execution address not set');
+    this.advance(this.cur.steps[this.current_op]());
+  }
+
+  /**
+   * Return true if we are at an instruction start.
+   * @returns true if the next pcode operation is at the start of the instruction translation
+   */
+  isInstructionStart(): boolean {
+    return this.instruction_start;
+  }
+
+  /** Return number of pcode ops in translation of current instruction */
+  numCurrentOps(): int4 {
+    return this.cur !== null ? this.cur.ops.length : 0;
+  }
+
+  /** Get the index of current pcode op within current instruction */
+  getCurrentOpIndex(): int4 {
+    return this.current_op;
+  }
+
+  /** Get pcode op in current instruction translation by index */
+  getOpByIndex(i: int4): PcodeOpRaw {
+    return this.cur!.ops[i];
+  }
+
+  /**
+   * Set current execution address.
+   * The instruction at the address is compiled if this is the first time it is reached.
+   * @param addr is the address where execution should continue
+   */
+  setExecuteAddress(addr: Address): void {
+    this.enter(this.lookup(addr));
+  }
+
+  /** Get current execution address */
+  getExecuteAddress(): Address {
+    return this.cur !== null ? this.cur.addr : new Address();
+  }
+
+  /**
+   * Execute (the rest of) a single machine instruction.
+   *
+   * If execution is at the start of an instruction, the breakpoints are checked and invoked
+   * as needed for the current address.
+   */
+  executeInstruction(): void {
+    if (this.cur === null)
+      throw new LowlevelError('Execution address not set');
+    if (this.instruction_start) {
+      if (this.breaktable.doAddressBreak(this.cur.addr))
+        return;
+    }
+    let ins = this.cur;
+    let i = this.current_op;
+    for (;;) {
+      const next = ins.steps[i]();
+      if (next >= 0 && next < ins.ops.length && this.cur === ins) {
+        i = next;
+        this.current_op = i;
+        this.instruction_start = false;
+        continue;
+      }
+      this.advance(next);
+      if (this.instruction_start) break;
+      ins = this.cur!;
+      i = this.current_op;
+    }
+    this.currentOp = this.cur!.ops.length > 0 ? this.cur!.ops[this.current_op] : null;
+    this.currentBehave = this.currentOp !== null ? this.currentOp.getBehavior() : null;
+  }
+
+  /**
+   * Execute machine instructions until the emulator is halted.
+   *
+   * Address breakpoints are only looked up when the BreakTableCallBack has any, so a run
+   * without them stays in compiled code.
+   * @param maxInstructions is the maximum number of instructions to execute
+   * @returns the number of instructions executed
+   */
+  run(maxInstructions: number = Infinity): number {
+    const table = this.breaktable;
+    const checkAddress = !(table instanceof BreakTableCallBack) || table.hasAddressCallbacks();
+    let count = 0;
+    this.setHalt(false);
+    while (!this.emu_halted && count < maxInstructions) {
+      if (checkAddress || !this.instruction_start) {
+        this.executeInstruction();
+      } else {
+        let ins = this.cur!;
+        let i = 0;
+        for (;;) {
+          this.current_op = i;
+          const next = ins.steps[i]();
+          if (next >= 0 && next < ins.ops.length && this.cur === ins) {
+            i = next;
+            continue;
+          }
+          this.advance(next);
+          if (this.instruction_start) break;
+          ins = this.cur!;
+          i = this.current_op;
+        }
+      }
+      count += 1;
+    }
+    return count;
+  }
+}
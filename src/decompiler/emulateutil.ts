@@ -231,6 +231,20 @@ export abstract class EmulatePcodeOp extends Emulate {
     this.lastOp = null;
   }
 
+  /**
+   * Read the 8 bytes of the load-image at the given address.
+   *
+   * This is the only place getLoadImageValue() touches the LoadImage, so derived emulators
+   * can serve repeated reads from a cache.
+   * @param buf receives the bytes
+   * @param spc is the address space to read from
+   * @param offset is the starting offset of the bytes
+   */
+  protected fillLoadImage(buf: Uint8Array, spc: AddrSpace, offset: uintb): void {
+    const loadimage: LoadImage = this.glb.loader;
+    loadimage.loadFill(buf, 8, new Address(spc, offset));
+  }
+
   /**
    * Pull a value from the load-image given a specific address.
    *
@@ -244,9 +258,8 @@ export abstract class EmulatePcodeOp extends Emulate {
    * @returns indicated bytes arranged as a constant value
    */
   protected getLoadImageValue(spc: AddrSpace, offset: uintb, sz: int4): uintb {
-    const loadimage: LoadImage = this.glb.loader;
     const buf = new Uint8Array(8);
-    loadimage.loadFill(buf, 8, new Address(spc, offset));
+    this.fillLoadImage(buf, spc, offset);
 
     // Read as a 64-bit value from the buffer
     let res: bigint = 0n;
@@ -272,7 +285,7 @@ export abstract class EmulatePcodeOp extends Emulate {
 
   protected executeUnary(): void {
     const in1: uintb = this.getVarnodeValue(this.currentOp!.getIn(0));
-    const out: uintb = this.currentBehave!.evaluateUnary(
+    const out: uintb = this.currentBehave!.evaluateUnarySized(
       this.currentOp!.getOut().getSize(),
       this.currentOp!.getIn(0).getSize(),
       in1
@@ -283,7 +296,7 @@ export abstract class EmulatePcodeOp extends Emulate {
   protected executeBinary(): void {
     const in1: uintb = this.getVarnodeValue(this.currentOp!.getIn(0));
     const in2: uintb = this.getVarnodeValue(this.currentOp!.getIn(1));
-    const out: uintb = this.currentBehave!.evaluateBinary(
+    const out: uintb = this.currentBehave!.evaluateBinarySized(
       this.currentOp!.getOut().getSize(),
       this.currentOp!.getIn(0).getSize(),
       in1,
@@ -631,7 +644,7 @@ export class EmulateSnippet extends Emulate {
 
   protected executeUnary(): void {
     const in1: uintb = this.getVarnodeValue(this.currentOp!.getInput(0));
-    const out: uintb = this.currentBehave!.evaluateUnary(
+    const out: uintb = this.currentBehave!.evaluateUnarySized(
       this.currentOp!.getOutput()!.size,
       this.currentOp!.getInput(0).size,
       in1
@@ -642,7 +655,7 @@ export class EmulateSnippet extends Emulate {
   protected executeBinary(): void {
     const in1: uintb = this.getVarnodeValue(this.currentOp!.getInput(0));
     const in2: uintb = this.getVarnodeValue(this.currentOp!.getInput(1));
-    const out: uintb = this.currentBehave!.evaluateBinary(
+    const out: uintb = this.currentBehave!.evaluateBinarySized(
       this.currentOp!.getOutput()!.size,
       this.currentOp!.getInput(0).size,
       in1,
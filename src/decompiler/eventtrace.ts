@@ -0,0 +1,193 @@
+/**
+ * @file eventtrace.ts
+ * @description Optional timeline tracing in the Chrome trace-event format.
+ *
+ * Where ActionProfiler aggregates, EventTracer records when things happen: worker start-up,
+ * snapshot restore, waits on IPC, each function, the phases of the action tree, restarts of
+ * an ActionRestartGroup and GC pauses. Action.perform, lifting and printing report to the
+ * EventTracer installed as EventTracer.active; with none installed the cost is one null check.
+ *
+ * Timestamps are microseconds since the epoch (performance.timeOrigin based), so the events
+ * of different processes line up once merged. Each process reports under its own pid, with
+ * a process_name metadata event naming it. Events are plain objects, so workers send them to
+ * the parent over IPC, where merge() collects them and write() produces a file that loads in
+ * chrome://tracing and Perfetto.
+ */
+
+import * as fs from 'fs';
+import { PerformanceObserver } from 'perf_hooks';
+
+// Forward types
+type Funcdata = any;
+
+/** One event of the Chrome trace-event format */
+export interface TraceEvent {
+  name: string;
+  /** Category */
+  cat: string;
+  /** Phase: 'X' complete, 'i' instant, 'M' metadata */
+  ph: 'X' | 'i' | 'M';
+  /** Start in microseconds */
+  ts: number;
+  /** Duration in microseconds, for complete events */
+  dur?: number;
+  pid: number;
+  tid: number;
+  /** Instant event scope ('t' thread, 'p' process) */
+  s?: 't' | 'p';
+  args?: Record<string, any>;
+}
+
+/**
+ * Collects trace events for one process while installed as EventTracer.active, or when
+ * called directly, as the parallel scheduler does.
+ */
+export class EventTracer {
+  /** The installed tracer, or null when tracing is off */
+  static active: EventTracer | null = null;
+
+  /** Events kept before further ones are dropped, bounding memory on long runs */
+  static readonly MAX_EVENTS = 1 << 20;
+
+  private events: TraceEvent[] = [];
+  private dropped = 0;
+  private pid: number;
+  /** Current depth in the action tree */
+  private actionDepth = 0;
+  /** Actions nested deeper than this are not reported (1 is the root action only) */
+  maxActionDepth: number;
+  private gcObserver: PerformanceObserver | null = null;
+
+  /**
+   * @param processName names this process in the trace viewer
+   * @param maxActionDepth is how deep in the action tree to report actions (default 2, the
+   * root action and its children)
+   */
+  constructor(processName: string, maxActionDepth: number = 2) {
+    this.pid = process.pid;
+    this.maxActionDepth = maxActionDepth;
+    this.push({ name: 'process_name', cat: '__metadata', ph: 'M', ts: 0, pid: this.pid, tid: 0,
+                args: { name: processName } });
+  }
+
+  /** The current time in trace microseconds */
+  static now(): number {
+    return (performance.timeOrigin + performance.now()) * 1000;
+  }
+
+  /** Convert a performance.now() reading to trace microseconds */
+  static fromPerformance(ms: number): number {
+    return (performance.timeOrigin + ms) * 1000;
+  }
+
+  private push(ev: TraceEvent): void {
+    if (this.events.length >= EventTracer.MAX_EVENTS) {
+      this.dropped += 1;
+      return;
+    }
+    this.events.push(ev);
+  }
+
+  /**
+   * Record a span that has finished.
+   * @param name is the span name
+   * @param cat is its category
+   * @param start is its start, from EventTracer.now()
+   * @param args are extra details shown by the viewer
+   * @param tid is the lane within this process (default 0)
+   */
+  complete(name: string, cat: string, start: number, args?: Record<string, any>, tid: number = 0): void {
+    const ev: TraceEvent = { name, cat, ph: 'X', ts: start, dur: EventTracer.now() - start, pid: this.pid, tid };
+    if (args !== undefined) ev.args = args;
+    this.push(ev);
+  }
+
+  /** Record a point event */
+  instant(name: string, cat: string, args?: Record<string, any>, tid: number = 0): void {
+    const ev: TraceEvent = { name, cat, ph: 'i', ts: EventTracer.now(), pid: this.pid, tid, s: 't' };
+    if (args !== undefined) ev.args = args;
+    this.push(ev);
+  }
+
+  /** Name a lane within this process */
+  nameThread(tid: number, name: string): void {
+    this.push({ name: 'thread_name', cat: '__metadata', ph: 'M', ts: 0, pid: this.pid, tid, args: { name } });
+  }
+
+  /**
+   * Run the apply() of an Action, reporting it as a span if it is shallow enough.
+   * @param name is the name of the Action
+   * @param data is the function being transformed
+   * @param apply runs the Action
+   */
+  traceAction(name: string, data: Funcdata, apply: () => number): number {
+    this.actionDepth += 1;
+    if (this.actionDepth > this.maxActionDepth) {
+      try {
+        return apply();
+      } finally {
+        this.actionDepth -= 1;
+      }
+    }
+    const start = EventTracer.now();
+    try {
+      return apply();
+    } finally {
+      this.actionDepth -= 1;
+      this.complete(name, 'action', start, { function: data?.getName?.() ?? '' });
+    }
+  }
+
+  /** Report GC pauses of this process as spans in lane 0 */
+  observeGc(): void {
+    if (this.gcObserver !== null) return;
+    this.gcObserver = new PerformanceObserver(list => this.recordGc(list.getEntries()));
+    this.gcObserver.observe({ entryTypes: ['gc'] });
+  }
+
+  private recordGc(entries: readonly any[]): void {
+    for (const e of entries) {
+      this.push({ name: 'GC', cat: 'gc', ph: 'X', ts: EventTracer.fromPerformance(e.startTime),
+                  dur: e.duration * 1000, pid: this.pid, tid: 0,
+                  args: { kind: e.detail?.kind ?? e.kind } });
+    }
+  }
+
+  /** Stop reporting GC pauses, keeping those already observed */
+  stopGc(): void {
+    if (this.gcObserver === null) return;
+    this.recordGc(this.gcObserver.takeRecords());
+    this.gcObserver.disconnect();
+    this.gcObserver = null;
+  }
+
+  /** Fold in the events of another tracer, e.g. from a worker process */
+  merge(events: TraceEvent[]): void {
+    for (const ev of events) this.push(ev);
+  }
+
+  /** Get the events, including GC pauses observed so far */
+  getEvents(): TraceEvent[] {
+    if (this.gcObserver !== null) this.recordGc(this.gcObserver.takeRecords());
+    return this.events;
+  }
+
+  /** Number of events dropped beyond MAX_EVENTS */
+  getDropped(): number {
+    return this.dropped;
+  }
+
+  /** Discard all events except the process name */
+  reset(): void {
+    this.events.length = 1;
+    this.dropped = 0;
+  }
+
+  /** Write the events as a JSON trace file, sorted by time */
+  write(path: string): void {
+    const events = [...this.getEvents()].sort((a, b) => a.ts - b.ts);
+    const trace: Record<string, any> = { traceEvents: events, displayTimeUnit: 'ms' };
+    if (this.dropped > 0) trace.otherData = { droppedEvents: this.dropped };
+    fs.writeFileSync(path, JSON.stringify(trace));
+  }
+}
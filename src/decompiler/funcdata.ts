@@ -37,7 +37,7 @@ import {
 import { HighVariable } from '../decompiler/variable.js';
 import { Cover } from '../decompiler/cover.js';
 import { Override } from '../decompiler/override.js';
-import { Heritage, LoadGuard } from '../decompiler/heritage.js';
+import { Heritage, LoadGuard, type HeritageStats } from '../decompiler/heritage.js';
 import { Merge } from '../decompiler/merge.js';
 import { DynamicHash } from '../decompiler/dynamic.js';
 import { ResolveEdge, ResolvedUnion } from '../decompiler/unionresolve.js';
@@ -76,6 +76,8 @@ type ScopeMap = any;
 type Database = any;
 type UnionFacetSymbol = any;
 import { PcodeEmit } from '../core/translate.js';
+import { ActionProfiler } from './actionprofile.js';
+import { EventTracer } from './eventtrace.js';
 
 // Classes/constructors that need both type and value identity
 import { ScopeLocal as ScopeLocalImpl } from './varmap.js';
@@ -137,6 +139,9 @@ const IPTR_IOP = spacetype.IPTR_IOP;
 
 type OStream = { write(s: string): void };
 
+/// Callback receiving a PcodeOp being edited and the Varnode attached or detached, if any
+export type OpWatcher = (op: PcodeOp, vn: Varnode | null) => void;
+
 // Import and re-export ListIter from utility module
 import { ListIter } from '../util/listiter.js';
 export { ListIter } from '../util/listiter.js';
@@ -238,6 +243,7 @@ export class Funcdata {
   private localoverride: Override;            ///< Overrides of data-flow, prototypes, etc. that are local to this function
   private lanedMap: Map<string, LanedRegister>; ///< Current storage locations which may be laned registers (keyed by VarnodeData key)
   private unionMap: Map<string, ResolvedUnion>; ///< A map from data-flow edges to the resolved field of TypeUnion being accessed
+  private opWatcher: OpWatcher | null = null; ///< Told about PcodeOps whose opcode, operands or position change
 
   // ============================================================
   // Constructor
@@ -270,6 +276,8 @@ export class Funcdata {
     this.high_level_index = 0;
     this.cast_phase_index = 0;
     this.glb = scope.getArch();
+    this.vbank.setPool(this.glb.irpool ?? null);
+    this.obank.setPool(this.glb.irpool ?? null);
     this.minLanedSize = this.glb.getMinimumLanedRegisterSize();
     this.name = nm;
     this.displayName = disp;
@@ -442,6 +450,9 @@ export class Funcdata {
   /// Get overall count of heritage passes
   getHeritagePass(): number { return this.heritage.getPass(); }
 
+  /// Get the counts of heritage work done and skipped for this function
+  getHeritageStats(): HeritageStats { return this.heritage.getStats(); }
+
   /// Get the number of heritage passes performed for the given address space
   numHeritagePasses(spc: AddrSpace): number { return this.heritage.numHeritagePasses(spc); }
 
@@ -846,6 +857,16 @@ export class Funcdata {
     this.covermerge.clear();
   }
 
+  /// Clear the analysis and give up the storage kept for analyzing this function again.
+  /// Used by batch runs once the output of the function has been produced: otherwise the
+  /// banks keep their tree nodes for every function (see IrPool). The symbols and prototype
+  /// facts kept by clear() remain for the callers of this function.
+  release(): void {
+    this.clear();
+    this.vbank.releaseStorage();
+    this.obank.releaseStorage();
+  }
+
   /// Add a warning comment in the function body.
   /// The comment is added to the global database, indexed via its placement address and
   /// the entry address of the function.
@@ -1529,6 +1550,14 @@ export class Funcdata {
   }
 
   clearBlocks(): void {
+    const pool: IrPool | null = this.glb?.irpool ?? null;
+    if (pool !== null) {
+      // The basic block graph holds nothing but BlockBasic
+      for (const bl of this.bblocks.getList()) {
+        (bl as BlockBasic).recycle();
+        pool.blocks.give(bl, pool.poison);
+      }
+    }
     this.bblocks.clear();
     this.sblocks.clear();
   }
@@ -2312,9 +2341,20 @@ export class Funcdata {
   // funcdata_op.cc — PcodeOp manipulation methods
   // =====================================================================
 
+  /// Install a watcher for PcodeOp edits, returning the previous one.
+  /// The watcher is called with each PcodeOp whose opcode, operands or basic block position
+  /// changes, along with the Varnode being attached or detached (if any). Used by ActionPool
+  /// to find the ops that need to be retested after a Rule applies.
+  setOpWatcher(watcher: OpWatcher | null): OpWatcher | null {
+    const prev = this.opWatcher;
+    this.opWatcher = watcher;
+    return prev;
+  }
+
   /// Set the op-code for a specific PcodeOp
   opSetOpcode(op: PcodeOp, opc: OpCode): void {
     this.obank.changeOpcode(op, this.glb.inst[opc]);
+    if (this.opWatcher !== null) this.opWatcher(op, null);
   }
 
   /// Mark given OpCode.CPUI_RETURN op as a special halt
@@ -2336,6 +2376,7 @@ export class Funcdata {
   opUnsetOutput(op: PcodeOp): void {
     const vn = op.getOut();
     if (vn === null) return;
+    if (this.opWatcher !== null) this.opWatcher(op, vn);
     op.setOutput(null);  // This must come before makeFree
     this.vbank.makeFree(vn);
     vn.clearCover();
@@ -2355,12 +2396,14 @@ export class Funcdata {
     vn = this.vbank.setDef(vn, op);
     this.setVarnodeProperties(vn);
     op.setOutput(vn);
+    if (this.opWatcher !== null) this.opWatcher(op, vn);
   }
 
   /// Clear an input operand slot for the given PcodeOp.
   /// The input Varnode is unlinked from the op.
   opUnsetInput(op: PcodeOp, slot: number): void {
     const vn = op.getIn(slot)!;
+    if (this.opWatcher !== null) this.opWatcher(op, vn);
     vn.eraseDescend(op);
     op.clearInput(slot);  // Must be called AFTER descend_erase
   }
@@ -2384,6 +2427,7 @@ export class Funcdata {
 
     vn.addDescend(op);       // Add this op to list of vn's descendants
     op.setInput(vn, slot);   // op must be up to date AFTER calling descend_add
+    if (this.opWatcher !== null) this.opWatcher(op, vn);
   }
 
 
@@ -2393,12 +2437,14 @@ export class Funcdata {
   opInsert(op: PcodeOp, bl: BlockBasic, iter: IteratorPosition): void {
     this.obank.markAlive(op);
     bl.insert(iter, op);
+    if (this.opWatcher !== null) this.opWatcher(op, null);
   }
 
   /// Remove the given PcodeOp from its basic block.
   /// The op is taken out of its basic block and put into the dead list.
   /// If the removal is permanent the input and output Varnodes should be unset.
   opUninsert(op: PcodeOp): void {
+    if (this.opWatcher !== null) this.opWatcher(op, null);
     this.obank.markDead(op);
     op.getParent()!.removeOp(op);
   }
@@ -2436,6 +2482,7 @@ export class Funcdata {
       }
     }
     if (op.getParent() !== null) {
+      if (this.opWatcher !== null) this.opWatcher(op, null);
       this.obank.markDead(op);
       op.getParent()!.removeOp(op);
     }
@@ -2867,6 +2914,10 @@ export class Funcdata {
       }
     }
 
+    const prof = ActionProfiler.active;
+    const start = prof !== null ? performance.now() : 0;
+    const tracer = EventTracer.active;
+    const traceStart = tracer !== null ? EventTracer.now() : 0;
     let fl: number = 0;
     fl |= this.glb.flowoptions;  // Global flow options
     const flow = new FlowInfo(this, this.obank, this.bblocks, this.qlst);
@@ -2885,6 +2936,10 @@ export class Funcdata {
     if (flow.hasBadData()) {
       this.flags |= Funcdata.baddata_present;
     }
+    if (prof !== null)
+      prof.addPhase('lift', performance.now() - start, this);
+    if (tracer !== null)
+      tracer.complete('lift', 'phase', traceStart, { function: this.name });
   }
 
   /// Generate a clone with truncated control-flow given a partial function.
@@ -3680,6 +3735,7 @@ export class Funcdata {
     const ct: Datatype = this.glb.types.getBase(s, type_metatype.TYPE_UNKNOWN);
     const vn: Varnode = this.vbank.createDef(s, m, ct, op);
     op.setOutput(vn);
+    if (this.opWatcher !== null) this.opWatcher(op, vn);
     this.assignHigh(vn);
 
     if (s >= this.minLanedSize) {
@@ -3704,6 +3760,7 @@ export class Funcdata {
     const ct: Datatype = this.glb.types.getBase(s, type_metatype.TYPE_UNKNOWN);
     const vn: Varnode = this.vbank.createDefUnique(s, ct, op);
     op.setOutput(vn);
+    if (this.opWatcher !== null) this.opWatcher(op, vn);
     this.assignHigh(vn);
     if (s >= this.minLanedSize) {
       this.checkForLanedRegister(s, vn.getAddr());
@@ -5430,6 +5487,7 @@ export class Funcdata {
     const tmp: Varnode = op.getIn(slot1)!;
     op.setInput(op.getIn(slot2)!, slot1);
     op.setInput(tmp, slot2);
+    if (this.opWatcher !== null) this.opWatcher(op, null);
   }
 
   /// Set a Varnode as the mapping for a SymbolEntry
@@ -598,6 +598,68 @@ const heritage_merged_node = 4;
 //  Heritage  class
 // ============================================================================
 
+// ============================================================================
+//  HeritageStats
+// ============================================================================
+
+/**
+ * Work done and skipped by the heritage passes of one function, summed over the
+ * life of its Heritage object.
+ *
+ * Each pass only places phi-nodes and renames for the address ranges that changed
+ * since the previous pass, so these counts show how much of the function a pass
+ * actually had to look at.
+ */
+export interface HeritageStats {
+  /** Heritage passes run */
+  passes: number;
+  /** Rebuilds of the dominator tree and its augmentation */
+  adtBuilds: number;
+  /** Varnodes examined while collecting the ranges of a pass */
+  varnodesScanned: number;
+  /** Of those, Varnodes known to be settled in an earlier pass, skipped without a lookup */
+  varnodesSkipped: number;
+  /** Address ranges handed to phi-node placement */
+  rangesPlaced: number;
+  /** Blocks marked while placing phi-nodes, summed over ranges */
+  placeBlocksMarked: number;
+  /** Blocks whose marks did not need clearing after a range, summed over ranges */
+  placeBlocksSkipped: number;
+  /** Blocks whose ops were visited while renaming */
+  renameBlocksVisited: number;
+  /** Blocks walked through while renaming without visiting their ops */
+  renameBlocksSkipped: number;
+}
+
+/** Create a HeritageStats with every count at zero */
+export function createEmptyHeritageStats(): HeritageStats {
+  return {
+    passes: 0,
+    adtBuilds: 0,
+    varnodesScanned: 0,
+    varnodesSkipped: 0,
+    rangesPlaced: 0,
+    placeBlocksMarked: 0,
+    placeBlocksSkipped: 0,
+    renameBlocksVisited: 0,
+    renameBlocksSkipped: 0,
+  };
+}
+
+/** Format heritage statistics as a short report */
+export function formatHeritageStats(stats: HeritageStats): string {
+  const pct = (part: number, whole: number) => (whole === 0 ? 0 : (100 * part) / whole).toFixed(1) + '%';
+  const marked = stats.placeBlocksMarked + stats.placeBlocksSkipped;
+  const walked = stats.renameBlocksVisited + stats.renameBlocksSkipped;
+  return `Heritage: ${stats.passes} passes, ${stats.adtBuilds} dominator rebuilds\n` +
+    `  collect: ${stats.varnodesScanned} varnodes scanned, ${stats.varnodesSkipped} settled (` +
+    pct(stats.varnodesSkipped, stats.varnodesScanned) + ' skipped)\n' +
+    `  place:   ${stats.rangesPlaced} ranges, ${stats.placeBlocksMarked} blocks marked (` +
+    pct(stats.placeBlocksSkipped, marked) + ' of block clears skipped)\n' +
+    `  rename:  ${stats.renameBlocksVisited} blocks visited, ${stats.renameBlocksSkipped} passed through (` +
+    pct(stats.renameBlocksSkipped, walked) + ' skipped)\n';
+}
+
 /**
  * Manage the construction of Static Single Assignment (SSA) form.
  *
@@ -623,6 +685,18 @@ export class Heritage {
   private storeGuard_list: LoadGuard[] = [];
   private loadCopyOps: PcodeOp[] = [];
 
+  /** Blocks marked by the current calcMultiequals(), so only they are cleared */
+  private marked: number[] = [];
+  /**
+   * Varnodes found heritaged and inside a range from an earlier pass. The global
+   * ranges only grow, so these stay settled while they remain heritaged, and later
+   * passes skip them without a LocationMap lookup. Emptied when refinement splits a range.
+   */
+  private settled: Set<Varnode> = new Set();
+  /** False to walk every block when renaming, for checking the incremental walk (DEBUG_HERITAGE_FULL=1) */
+  private incremental: boolean = process.env.DEBUG_HERITAGE_FULL !== '1';
+  private stats: HeritageStats = createEmptyHeritageStats();
+
   constructor(data: Funcdata) {
     this.fd = data;
     this.pass = 0;
@@ -634,6 +708,9 @@ export class Heritage {
   /** Get overall count of heritage passes */
   getPass(): number { return this.pass; }
 
+  /** Get the counts of work done and skipped since this was created */
+  getStats(): HeritageStats { return { ...this.stats }; }
+
   /** Get the pass number when the given address was heritaged (-1 if not) */
   heritagePass(addr: Address): number { return this.globaldisjoint.findPass(addr); }
 
@@ -778,18 +855,7 @@ export class Heritage {
     input.length = 0;
     remove.length = 0;
 
-    const start: bigint = memrange.addr.getOffset();
-    const endaddr: Address = memrange.addr.add(BigInt(memrange.size));
-
-    let enditer: number;
-    if (endaddr.getOffset() < start) {
-      // Wraparound
-      const tmp = new Address(endaddr.getSpace()!, endaddr.getSpace()!.getHighest());
-      enditer = this.fd.endLoc(tmp);
-    } else {
-      enditer = this.fd.beginLoc(endaddr);
-    }
-
+    const enditer = this.rangeEnd(memrange);
     let maxsize = 0;
     for (let viter = this.fd.beginLoc(memrange.addr); !viter.equals(enditer); viter.next()) {
       const vn: Varnode = viter.get();
@@ -815,6 +881,18 @@ export class Heritage {
     return maxsize;
   }
 
+  /** Get the iterator just past the Varnodes of the given range, in location order */
+  private rangeEnd(memrange: MemRange): any {
+    const start: bigint = memrange.addr.getOffset();
+    const endaddr: Address = memrange.addr.add(BigInt(memrange.size));
+    if (endaddr.getOffset() < start) {
+      // Wraparound
+      const tmp = new Address(endaddr.getSpace()!, endaddr.getSpace()!.getHighest());
+      return this.fd.endLoc(tmp);
+    }
+    return this.fd.beginLoc(endaddr);
+  }
+
   /**
    * Determine if the address range is affected by the given call p-code op.
    */
@@ -1717,6 +1795,7 @@ export class Heritage {
 
     bblocks.buildDomTree(this.domchild);
     this.maxdepth = bblocks.buildDomDepth(this.depth);
+    this.stats.adtBuilds += 1;
     for (i = 0; i < size; ++i) {
       x = bblocks.getBlock(i);
       for (j = 0; j < this.domchild[i].length; ++j) {
@@ -1785,6 +1864,8 @@ export class Heritage {
       v = aug[idx];
       if (v.getImmedDom().getIndex() < j) { // If idom(v) is strict ancestor of qnode
         k = v.getIndex();
+        if ((this.flags[k] & (heritage_merged_node | heritage_mark_node)) === 0)
+          this.marked.push(k);
         if ((this.flags[k] & heritage_merged_node) === 0) {
           this.merge.push(v);
           this.flags[k] |= heritage_merged_node;
@@ -1820,6 +1901,7 @@ export class Heritage {
   private calcMultiequals(write: Varnode[]): void {
     this.pq.reset(this.maxdepth);
     this.merge.length = 0;
+    this.marked.length = 0;
 
     let i: number, j: number;
     let bl: FlowBlock;
@@ -1830,18 +1912,24 @@ export class Heritage {
       if ((this.flags[j] & heritage_mark_node) !== 0) continue; // Already put in
       this.pq.insert(bl, this.depth[j]); // Insert input node into priority queue
       this.flags[j] |= heritage_mark_node; // mark input node
+      this.marked.push(j);
     }
     if ((this.flags[0] & heritage_mark_node) === 0) { // Make sure start node is in input
       this.pq.insert(this.fd.getBasicBlocks().getBlock(0), this.depth[0]);
       this.flags[0] |= heritage_mark_node;
+      this.marked.push(0);
     }
 
     while (!this.pq.empty()) {
       bl = this.pq.extract(); // Extract the next block
       this.visitIncr(bl, bl);
     }
-    for (i = 0; i < this.flags.length; ++i)
-      this.flags[i] &= ~(heritage_mark_node | heritage_merged_node); // Clear marks from nodes
+    // Clear marks from the nodes that have them, rather than from every block
+    for (i = 0; i < this.marked.length; ++i)
+      this.flags[this.marked[i]] &= ~(heritage_mark_node | heritage_merged_node);
+    this.stats.placeBlocksMarked += this.marked.length;
+    this.stats.placeBlocksSkipped += this.flags.length - this.marked.length;
+    this.marked.length = 0;
   }
 
   // ---- Part 2: Full method implementations ----
@@ -2550,6 +2638,7 @@ export class Heritage {
     const giter = this.globaldisjoint.find(addr);
     const curPass: number = giter!.value.pass;
     this.globaldisjoint.erase(giter!.key);
+    this.settled.clear();        // Varnodes of the old range may no longer fit in one piece
     let cut = 0;
     let sz: number = refine[cut];
     let curAddr: Address = addr;
@@ -2575,8 +2664,9 @@ export class Heritage {
    * need to be renamed.
    * @param bl - current basic block in the dominance tree walk
    * @param varstack - system of stacks, organized by address
+   * @param active - if given, a flag per block index; the ops of unflagged blocks are not visited
    */
-  renameRecurse(startbl: BlockBasic, varstack: VariableStack): void {
+  renameRecurse(startbl: BlockBasic, varstack: VariableStack, active: Uint8Array | null = null): void {
     // Iterative DFS through dominator tree using explicit stack.
     // Each frame: [block, childIndex, writelist]
     //   - When childIndex === -1, we process the block (pre-visit)
@@ -2598,7 +2688,12 @@ export class Heritage {
         let vnnew: Varnode;
         let slot: number;
 
-        for (let oiter = bl.beginOp(); !oiter.equals(bl.endOp()); oiter.next()) {
+        const visitOps = active === null || active[bl.getIndex()] !== 0;
+        if (visitOps)
+          this.stats.renameBlocksVisited += 1;
+        else
+          this.stats.renameBlocksSkipped += 1;
+        for (let oiter = bl.beginOp(); visitOps && !oiter.equals(bl.endOp()); oiter.next()) {
           op = oiter.get();
           if (op.code() !== CPUI_MULTIEQUAL) {
             for (slot = 0; slot < op.numInput(); ++slot) {
@@ -2651,6 +2746,7 @@ export class Heritage {
         // Process MULTIEQUAL inputs in successor blocks
         for (let i = 0; i < bl.sizeOut(); ++i) {
           const subbl = bl.getOut(i) as BlockBasic;
+          if (active !== null && active[subbl.getIndex()] === 0) continue;
           slot = bl.getOutRevIndex(i);
           for (let suboiter = subbl.beginOp(); !suboiter.equals(subbl.endOp()); suboiter.next()) {
             const multiop = suboiter.get();
@@ -2750,6 +2846,7 @@ export class Heritage {
       this.guardInput(memrange.addr, size, inputvars);
       this.guard(memrange.addr, size, memrange.newAddresses(), readvars, writevars, inputvars);
       this.calcMultiequals(writevars); // Calculate where MULTIEQUALs go
+      this.stats.rangesPlaced += 1;
       for (let i = 0; i < this.merge.length; ++i) {
         const mbl: BlockBasic = this.merge[i] as BlockBasic;
         const multiop: PcodeOp = this.fd.newOp(mbl.sizeIn(), mbl.getStart());
@@ -2773,10 +2870,59 @@ export class Heritage {
    */
   rename(): void {
     const varstack: VariableStack = new Map<bigint, Varnode[]>();
-    this.renameRecurse(this.fd.getBasicBlocks().getBlock(0) as BlockBasic, varstack);
+    const active = this.incremental ? this.markRenameBlocks() : null;
+    this.renameRecurse(this.fd.getBasicBlocks().getBlock(0) as BlockBasic, varstack, active);
     this.disjoint.clear();
   }
 
+  /**
+   * Find the blocks whose ops the renaming algorithm has to visit.
+   *
+   * renameRecurse() only acts on Varnodes marked for active heritage (all inside the
+   * ranges of the current pass) and on free inputs of MULTIEQUALs. It still walks the
+   * whole dominator tree, to carry the stacks of writes, but the ops of any other
+   * block can be passed over without changing the result.
+   * @returns a flag per block index, set for blocks that must be visited
+   */
+  private markRenameBlocks(): Uint8Array {
+    const bblocks = this.fd.getBasicBlocks();
+    const active = new Uint8Array(bblocks.getSize());
+    const markOp = (op: PcodeOp): void => {
+      const bl = op.getParent();
+      if (bl !== null) active[bl.getIndex()] = 1;
+    };
+    for (let iter = 0; iter < this.disjoint.length; ++iter) {
+      const memrange: MemRange = this.disjoint.get(iter);
+      const enditer = this.rangeEnd(memrange);
+      for (let viter = this.fd.beginLoc(memrange.addr); !viter.equals(enditer); viter.next()) {
+        const vn: Varnode = viter.get();
+        const isactive = vn.isActiveHeritage();
+        if (isactive && vn.isWritten())
+          markOp(vn.getDef());
+        if (isactive || !vn.isHeritageKnown()) {
+          for (let i = 0; i < vn.descend.length; ++i)
+            markOp(vn.descend[i]);
+        }
+      }
+    }
+    // Free MULTIEQUAL inputs are renamed wherever they are
+    for (let i = 0; i < bblocks.getSize(); ++i) {
+      if (active[i] !== 0) continue;
+      const bl = bblocks.getBlock(i) as BlockBasic;
+      for (let oiter = bl.beginOp(); !oiter.equals(bl.endOp()); oiter.next()) {
+        const op: PcodeOp = oiter.get();
+        if (op.code() !== CPUI_MULTIEQUAL) break;
+        let j = 0;
+        while (j < op.numInput() && op.getIn(j)!.isHeritageKnown()) ++j;
+        if (j < op.numInput()) {
+          active[i] = 1;
+          break;
+        }
+      }
+    }
+    return active;
+  }
+
   /**
    * Perform one pass of heritage.
    *
@@ -2822,6 +2968,11 @@ export class Heritage {
       while (!iter.equals(enditer)) {
         vn = iter.get();
         iter.next();
+        this.stats.varnodesScanned += 1;
+        if (vn.isHeritageKnown() && this.settled.has(vn)) {
+          this.stats.varnodesSkipped += 1;
+          continue;
+        }
         if (!vn.isWritten() && vn.hasNoDescend() && !vn.isUnaffected() && !vn.isInput())
           continue;
         if (vn.isWriteMask()) continue;
@@ -2832,7 +2983,10 @@ export class Heritage {
         if (prev === 0) // All new location being heritaged, or intersecting with something new
           this.disjoint.add(liter.key, literSize, MemRange.new_addresses);
         else if (prev === 2) { // If completely contained in range from previous pass
-          if (vn.isHeritageKnown()) continue; // Don't heritage if we don't have to
+          if (vn.isHeritageKnown()) { // Don't heritage if we don't have to
+            this.settled.add(vn);
+            continue;
+          }
           if (vn.hasNoDescend()) continue;
           if (!needwarning && info.deadremoved > 0 && !this.fd.isJumptableRecoveryOn()) {
             needwarning = true;
@@ -2878,6 +3032,7 @@ export class Heritage {
     if (this.pass === 0)
       splitmanage.splitAdditional();
     this.pass += 1;
+    this.stats.passes += 1;
   }
 
   /**
@@ -2901,6 +3056,8 @@ export class Heritage {
     this.flags.length = 0;
     this.depth.length = 0;
     this.merge.length = 0;
+    this.marked.length = 0;
+    this.settled.clear();
     this.clearInfoList();
     this.loadGuard_list.length = 0;
     this.storeGuard_list.length = 0;
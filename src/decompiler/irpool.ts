@@ -0,0 +1,203 @@
+/**
+ * @file irpool.ts
+ * @description Free lists that recycle the core IR objects of functions across functions.
+ *
+ * Decompiling a function allocates huge numbers of Varnode, PcodeOp and BlockBasic objects,
+ * and Funcdata.clear() used to drop them all for the garbage collector. In batch runs the
+ * collector then spends a large share of the wall time tracing and freeing them, and the heap
+ * grows between collections. C++ deletes these objects in Funcdata::clear(), so nothing may
+ * refer to them afterward; the pool relies on the same rule and hands them to the next
+ * function instead.
+ *
+ * Each Architecture owns one IrPool (Architecture.irpool). VarnodeBank, PcodeOpBank and
+ * BlockGraph take objects from it when the function is built and give them back when it is
+ * cleared. Returned objects drop every reference they hold, so the rest of the old function
+ * is still collected. The SortedSet trees of the banks keep their nodes across a clear in
+ * the same spirit (SortedSet.clear(true)).
+ *
+ * The pool is off unless the irpool option is set. V8's young-generation collector already
+ * frees short-lived IR objects cheaply, while pooled objects survive into the old generation
+ * and are traced by every major collection, so in measured batch runs the pool did not lower
+ * the time spent in garbage collection. Cover and CoverBlock objects, and the SortedSet nodes
+ * that erase() drops (beyond the spare list kept by clear(true)), are not pooled: they are
+ * replaced one at a time while variables are merged, not released together by
+ * Funcdata.clear(), so there is no single point where they could be given back.
+ *
+ * With poisoning on (IrPool.poison, or the DEBUG_IRPOOL=1 environment variable), returned
+ * objects are not reused. Instead every property read or write on them throws, so a stale
+ * reference into a cleared function fails at the point of use instead of silently reading
+ * the next function's data.
+ */
+
+import { LowlevelError } from '../core/error.js';
+
+// ---------------------------------------------------------------------------
+// Poisoning
+// ---------------------------------------------------------------------------
+
+/** One poisoned prototype per kind of object, so the error names what was recycled */
+const poisonPrototypes = new Map<string, object>();
+
+function poisonPrototype(what: string): object {
+  let proto = poisonPrototypes.get(what);
+  if (proto === undefined) {
+    const fail = (prop: string | symbol): never => {
+      throw new LowlevelError('Use of recycled ' + what + ' (' + String(prop) + ')');
+    };
+    proto = new Proxy(Object.create(null), {
+      get: (_target, prop) => fail(prop),
+      set: (_target, prop) => fail(prop),
+      has: (_target, prop) => fail(prop),
+    });
+    poisonPrototypes.set(what, proto);
+  }
+  return proto;
+}
+
+/**
+ * Make every later use of an object throw.
+ * All own properties are removed, so reads and writes reach the poisoned prototype.
+ * Identity comparisons and Set/Map membership keep working.
+ * @param obj is the object to poison
+ * @param what names the kind of object in the error message
+ */
+export function poisonObject(obj: object, what: string): void {
+  for (const key of Reflect.ownKeys(obj))
+    delete (obj as any)[key];
+  Object.setPrototypeOf(obj, poisonPrototype(what));
+}
+
+// ---------------------------------------------------------------------------
+// FreeList
+// ---------------------------------------------------------------------------
+
+/** Counts for one FreeList */
+export interface FreeListStats {
+  /** Objects handed out again instead of being allocated */
+  reused: number;
+  /** Requests that found the list empty, so the caller allocated */
+  allocated: number;
+  /** Objects given back */
+  released: number;
+  /** Objects currently held */
+  held: number;
+}
+
+/**
+ * A bounded stack of objects of one kind, waiting to be reinitialized and reused.
+ * The list does not reset objects itself: the owner takes an object, reinitializes it
+ * (for instance Varnode.init()), and recycles it before giving it back.
+ */
+export class FreeList<T extends object> {
+  private items: T[] = [];
+  private what: string;
+  private limit: number;
+  private stats: FreeListStats = { reused: 0, allocated: 0, released: 0, held: 0 };
+
+  /**
+   * @param what names the kind of object, for poisoning
+   * @param limit is the most objects held at once; further ones are left to the collector
+   */
+  constructor(what: string, limit: number) {
+    this.what = what;
+    this.limit = limit;
+  }
+
+  /** Get a recycled object, or undefined if the caller must allocate one */
+  take(): T | undefined {
+    const obj = this.items.pop();
+    if (obj === undefined)
+      this.stats.allocated += 1;
+    else
+      this.stats.reused += 1;
+    return obj;
+  }
+
+  /**
+   * Give back an object that no longer belongs to any function.
+   * @param obj is the object, already recycled by its owner
+   * @param poison is true to poison the object instead of keeping it
+   */
+  give(obj: T, poison: boolean): void {
+    this.stats.released += 1;
+    if (poison)
+      poisonObject(obj, this.what);
+    else if (this.items.length < this.limit)
+      this.items.push(obj);
+  }
+
+  /** Change the most objects held at once, dropping any excess */
+  setLimit(limit: number): void {
+    this.limit = limit;
+    if (this.items.length > limit)
+      this.items.length = limit;
+  }
+
+  /** Drop every held object */
+  drain(): void {
+    this.items.length = 0;
+  }
+
+  getStats(): FreeListStats {
+    return { ...this.stats, held: this.items.length };
+  }
+}
+
+// ---------------------------------------------------------------------------
+// IrPool
+// ---------------------------------------------------------------------------
+
+/**
+ * The free lists of one Architecture.
+ *
+ * Typed loosely so this module does not depend on the IR classes; each list only ever
+ * holds objects of the one class named by its field.
+ */
+export class IrPool {
+  /** Default number of objects of each kind held at once */
+  static readonly DEFAULT_LIMIT = 1 << 17;
+
+  /** If true, returned objects are poisoned instead of reused */
+  poison: boolean;
+  /** Free Varnode objects */
+  readonly varnodes: FreeList<any>;
+  /** Free PcodeOp objects */
+  readonly ops: FreeList<any>;
+  /** Free BlockBasic objects */
+  readonly blocks: FreeList<any>;
+
+  /**
+   * @param limit is the most objects of each kind held at once
+   * @param poison is true to poison returned objects (defaults to DEBUG_IRPOOL=1)
+   */
+  constructor(limit: number = IrPool.DEFAULT_LIMIT, poison: boolean = process.env.DEBUG_IRPOOL === '1') {
+    this.poison = poison;
+    this.varnodes = new FreeList('Varnode', limit);
+    this.ops = new FreeList('PcodeOp', limit);
+    this.blocks = new FreeList('BlockBasic', limit);
+  }
+
+  /** Change the most objects of each kind held at once */
+  setLimit(limit: number): void {
+    this.varnodes.setLimit(limit);
+    this.ops.setLimit(limit);
+    this.blocks.setLimit(limit);
+  }
+
+  /** Drop every held object, for instance before a long idle period */
+  drain(): void {
+    this.varnodes.drain();
+    this.ops.drain();
+    this.blocks.drain();
+  }
+
+  /** Format the statistics of all lists as a one line summary */
+  formatStats(): string {
+    const part = (name: string, l: FreeList<any>): string => {
+      const s = l.getStats();
+      return `${name} ${s.reused} reused/${s.allocated} new (${s.held} held)`;
+    };
+    return 'IR pool: ' + part('varnodes', this.varnodes) + ', ' + part('ops', this.ops) + ', ' +
+      part('blocks', this.blocks) + (this.poison ? ' [poison]' : '');
+  }
+}
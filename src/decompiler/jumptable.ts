@@ -31,6 +31,7 @@ type Varnode = any;
 
 import { CircleRange } from './rangeutil.js';
 import { MemoryImage } from './memstate.js';
+import { ActionProfiler } from './actionprofile.js';
 import { VarnodeData } from '../core/pcoderaw.js';
 
 // ---------------------------------------------------------------------------
@@ -179,6 +180,108 @@ export class LoadTable {
   }
 }
 
+// ---------------------------------------------------------------------------
+// LoadTableCache
+// ---------------------------------------------------------------------------
+
+/**
+ * Bytes of the load image read while emulating jump-table calculations.
+ *
+ * Every read made by EmulateFunction is 8 bytes at some address. The same table entries
+ * are read again by each model that is tried, by sanity checks, by the partial function
+ * used during flow and by the full function after every restart, so the result of each
+ * read is kept in one typed-array slab, indexed by address. Reads that failed are kept
+ * as well, so they fail the same way again. The load image is read-only for the life of
+ * the Architecture, so one cache is shared by all functions using it.
+ */
+export class LoadTableCache {
+  /** Maximum number of reads held before the cache starts over */
+  static readonly MAX_READS = 1 << 16;
+  private static caches: WeakMap<object, LoadTableCache> = new WeakMap();
+  private loader: any;
+  private slab: Uint8Array = new Uint8Array(8 * 64);
+  private count: int4 = 0;
+  private misses: int4 = 0;
+  private index: Map<AddrSpace, Map<bigint, int4>> = new Map();
+  private failures: Map<AddrSpace, Map<bigint, string>> = new Map();
+
+  private constructor(loader: any) {
+    this.loader = loader;
+  }
+
+  /** Get the cache shared by every emulation reading from the given load image */
+  static forLoader(loader: any): LoadTableCache {
+    let res = LoadTableCache.caches.get(loader);
+    if (res === undefined) {
+      res = new LoadTableCache(loader);
+      LoadTableCache.caches.set(loader, res);
+    }
+    return res;
+  }
+
+  /**
+   * Fill the buffer with the 8 bytes at the given address.
+   * @param buf receives the bytes
+   * @param spc is the address space to read from
+   * @param offset is the starting offset of the bytes
+   * @throws DataUnavailError if the load image cannot provide the bytes
+   */
+  fill(buf: Uint8Array, spc: AddrSpace, offset: uintb): void {
+    const profiler = ActionProfiler.active;
+    const spcindex = this.index.get(spc);
+    const slot = spcindex !== undefined ? spcindex.get(offset) : undefined;
+    if (slot !== undefined) {
+      profiler?.count('jumptable.load.cached');
+      buf.set(this.slab.subarray(slot, slot + 8));
+      return;
+    }
+    const failed = this.failures.get(spc)?.get(offset);
+    if (failed !== undefined) {
+      profiler?.count('jumptable.load.cached');
+      throw new DataUnavailError(failed);
+    }
+    profiler?.count('jumptable.load');
+    if (this.count + this.misses >= LoadTableCache.MAX_READS)
+      this.clear();
+    try {
+      this.loader.loadFill(buf, 8, new Address(spc, offset));
+    } catch (err: unknown) {
+      if (err instanceof DataUnavailError) {
+        let map = this.failures.get(spc);
+        if (map === undefined) {
+          map = new Map();
+          this.failures.set(spc, map);
+        }
+        map.set(offset, err.explain);
+        this.misses += 1;
+      }
+      throw err;
+    }
+    const pos = 8 * this.count;
+    if (pos + 8 > this.slab.length) {
+      const newslab = new Uint8Array(this.slab.length * 2);
+      newslab.set(this.slab);
+      this.slab = newslab;
+    }
+    this.slab.set(buf.subarray(0, 8), pos);
+    let map = spcindex;
+    if (map === undefined) {
+      map = new Map();
+      this.index.set(spc, map);
+    }
+    map.set(offset, pos);
+    this.count += 1;
+  }
+
+  /** Forget every read */
+  clear(): void {
+    this.index.clear();
+    this.failures.clear();
+    this.count = 0;
+    this.misses = 0;
+  }
+}
+
 // ---------------------------------------------------------------------------
 // EmulateFunction
 // ---------------------------------------------------------------------------
@@ -213,6 +316,10 @@ export class EmulateFunction extends EmulatePcodeOp {
     this.loadpoints = val;
   }
 
+  protected fillLoadImage(buf: Uint8Array, spc: AddrSpace, offset: uintb): void {
+    LoadTableCache.forLoader(this.glb.loader).fill(buf, spc, offset);
+  }
+
   protected executeLoad(): void {
     if (this.loadpoints !== null) {
       const off: uintb = this.getVarnodeValue(this.currentOp!.getIn(1));
@@ -3034,8 +3141,10 @@ export class JumpTable {
    * Attempt recovery of the jump-table model.
    */
   private recoverModel(fd: any): void {
+    const profiler = ActionProfiler.active;
     if (this.jmodel !== null) {
       if (this.jmodel.isOverride()) {
+        profiler?.count('jumptable.model.override');
         this.jmodel.recoverModel(fd, this.indirect, 0, this.glb.max_jumptable_size);
         return;
       }
@@ -3047,18 +3156,22 @@ export class JumpTable {
       if ((op as any).code() === OpCode.CPUI_CALLOTHER) {
         const jassisted = new JumpAssisted(this);
         this.jmodel = jassisted;
+        profiler?.count('jumptable.model.assisted');
         if (this.jmodel.recoverModel(fd, this.indirect, this.addresstable.length, this.glb.max_jumptable_size))
           return;
       }
     }
     const jbasic = new JumpBasic(this);
     this.jmodel = jbasic;
+    profiler?.count('jumptable.model.basic');
     if (this.jmodel.recoverModel(fd, this.indirect, this.addresstable.length, this.glb.max_jumptable_size))
       return;
     this.jmodel = new JumpBasic2(this);
     (this.jmodel as JumpBasic2).initializeStart(jbasic.getPathMeld());
+    profiler?.count('jumptable.model.basic2');
     if (this.jmodel.recoverModel(fd, this.indirect, this.addresstable.length, this.glb.max_jumptable_size))
       return;
+    profiler?.count('jumptable.model.failed');
     this.jmodel = null;
   }
 
@@ -3234,6 +3347,7 @@ export class JumpTable {
       }
     } else {
       this.jmodel = new JumpModelTrivial(this);
+      ActionProfiler.active?.count('jumptable.model.trivial');
       this.jmodel.recoverModel(fd, this.indirect, this.addresstable.length, this.glb.max_jumptable_size);
       this.jmodel.buildAddresses(fd, this.indirect, this.addresstable, null, null);
       this.trivialSwitchOver();
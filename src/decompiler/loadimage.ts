@@ -13,6 +13,8 @@ import {
   Encoder,
   Decoder,
   XmlDecode,
+  PackedEncode,
+  PackedDecode,
   AttributeId,
   ElementId,
   ATTRIB_CONTENT,
@@ -21,6 +23,7 @@ import {
   ATTRIB_SPACE,
   ELEM_SYMBOL,
 } from '../core/marshal.js';
+import { BinaryContentElement } from '../core/xml.js';
 import type { Element } from '../core/xml.js';
 import { SortedMap, SortedSet, SortedMapIterator } from '../util/sorted-set.js';
 
@@ -301,6 +304,7 @@ export class RawLoadImage extends LoadImage {
  */
 export class LoadImageXml extends LoadImage {
   private rootel: Element | null;
+  private snapshot: Uint8Array | null = null;   ///< Packed image produced by encodeSnapshot(), if not from XML
   private archtype: string;
   private manage: AddrSpaceManager | null = null;
   private readonlyset: SortedSet<Address>;
@@ -311,22 +315,49 @@ export class LoadImageXml extends LoadImage {
   /**
    * Constructor.
    * @param f - the path to the underlying XML file
-   * @param el - the parsed form of the file (root Element)
+   * @param el - the parsed form of the file (root Element), or null if restoring from a snapshot
+   * @param snapshot - packed image from encodeSnapshot(), used when el is null
    */
-  constructor(f: string, el: Element) {
+  constructor(f: string, el: Element | null, snapshot: Uint8Array | null = null) {
     super(f);
     this.rootel = el;
+    this.snapshot = snapshot;
     this.readonlyset = new SortedSet<Address>(addressCompare);
     this.chunk = new SortedMap<Address, Uint8Array>(addressCompare);
     this.addrtosymbol = new SortedMap<Address, string>(addressCompare);
 
     // Extract architecture information
+    if (el === null) {
+      if (snapshot === null) {
+        throw new LowlevelError('Missing binaryimage for ' + this.filename);
+      }
+      const decoder = new PackedDecode(null);
+      decoder.ingestBytes(snapshot);
+      const elemId: number = decoder.openElementId(ELEM_BINARYIMAGE);
+      this.archtype = decoder.readStringById(ATTRIB_ARCH);
+      decoder.closeElementSkipping(elemId);
+      return;
+    }
     if (el.getName() !== 'binaryimage') {
       throw new LowlevelError('Missing binaryimage tag in ' + this.filename);
     }
     this.archtype = el.getAttributeValue('arch');
   }
 
+  /**
+   * Build a load image from a packed snapshot produced by encodeSnapshot().
+   *
+   * No XML is parsed. The snapshot holds the padded chunks of an image that was already
+   * opened, so open() must be given the address spaces of an Architecture built from
+   * the same language as the one that produced the snapshot.
+   * @param f - the path to the original XML file
+   * @param data - the packed snapshot bytes
+   * @returns the new (unopened) load image
+   */
+  static fromSnapshot(f: string, data: Uint8Array): LoadImageXml {
+    return new LoadImageXml(f, null, data);
+  }
+
   /**
    * Read XML tags into the containers.
    * @param m - address space manager for looking up address spaces
@@ -335,8 +366,16 @@ export class LoadImageXml extends LoadImage {
     this.manage = m;
     const sizeRef = { val: 0 as uint4 };
 
-    // Read parsed xml file
-    const decoder: Decoder = new XmlDecode(m, this.rootel);
+    // Read parsed xml file, or the packed snapshot
+    let decoder: Decoder;
+    let packed: PackedDecode | null = null;
+    if (this.snapshot !== null) {
+      packed = new PackedDecode(m);
+      packed.ingestBytes(this.snapshot);
+      decoder = packed;
+    } else {
+      decoder = new XmlDecode(m, this.rootel);
+    }
     const elemId: number = decoder.openElementId(ELEM_BINARYIMAGE);
     for (;;) {
       const subId: number = decoder.openElement();
@@ -351,8 +390,6 @@ export class LoadImageXml extends LoadImage {
         const base = decoder.readSpaceById(ATTRIB_SPACE) as unknown as AddrSpace;
         const off: bigint = (base as any).decodeAttributes_sized(decoder, sizeRef);
         const addr = new Address(base, off);
-        const vec: number[] = [];
-
         decoder.rewindAttributes();
         for (;;) {
           const attribId: number = decoder.getNextAttributeId();
@@ -363,23 +400,42 @@ export class LoadImageXml extends LoadImage {
             }
           }
         }
-        const content: string = decoder.readStringById(ATTRIB_CONTENT);
-        // Parse hex string content
-        const trimmed = content.replace(/\s+/g, '');
+        if (packed !== null) {
+          // Snapshot content is the raw bytes
+          this.chunk.set(addr, packed.readBytesById(ATTRIB_CONTENT));
+          decoder.closeElement(subId);
+          continue;
+        }
+        if (decoder instanceof XmlDecode) {
+          // Content already decoded to bytes by a streaming parse (DocumentStorage.openDocumentStream)
+          const cur = decoder.getCurrentXmlElement();
+          if (cur instanceof BinaryContentElement) {
+            this.chunk.set(addr, cur.getBytes());
+            decoder.closeElement(subId);
+            continue;
+          }
+        }
+        // Parse hex string content straight into the chunk
+        const trimmed = decoder.readStringById(ATTRIB_CONTENT).replace(/\s+/g, '');
+        const vec = new Uint8Array(trimmed.length >> 1);
+        let len = 0;
         for (let i = 0; i + 1 < trimmed.length; i += 2) {
           const byte = parseInt(trimmed.substring(i, i + 2), 16);
           if (!isNaN(byte)) {
-            vec.push(byte);
+            vec[len++] = byte;
           }
         }
-        this.chunk.set(addr, new Uint8Array(vec));
+        this.chunk.set(addr, len === vec.length ? vec : vec.slice(0, len));
       } else {
         throw new LowlevelError('Unknown LoadImageXml tag');
       }
       decoder.closeElement(subId);
     }
     decoder.closeElement(elemId);
-    this.pad();
+    if (this.snapshot === null) {
+      this.pad();       // Snapshot chunks were padded by the image that produced them
+    }
+    this.snapshot = null;
   }
 
   /** Clear out all the caches */
@@ -427,6 +483,38 @@ export class LoadImageXml extends LoadImage {
     encoder.closeElement(ELEM_BINARYIMAGE);
   }
 
+  /**
+   * Encode the opened image as a compact packed snapshot.
+   *
+   * The layout matches encode(), but the chunk content is written as raw bytes instead of
+   * hex text, and chunks are written after padding, so fromSnapshot() can rebuild an
+   * identical image without any XML or hex parsing.
+   * @returns the packed snapshot bytes
+   */
+  encodeSnapshot(): Uint8Array {
+    const encoder = new PackedEncode();
+    encoder.openElement(ELEM_BINARYIMAGE);
+    encoder.writeString(ATTRIB_ARCH, this.archtype);
+    for (const [addr, vec] of this.chunk.entries()) {
+      if (vec.length === 0) continue;
+      encoder.openElement(ELEM_BYTECHUNK);
+      addr.getSpace()!.encodeAttributes(encoder, addr.getOffset());
+      if (this.readonlyset.has(addr)) {
+        encoder.writeBool(ATTRIB_READONLY, true);
+      }
+      encoder.writeBytes(ATTRIB_CONTENT, vec);
+      encoder.closeElement(ELEM_BYTECHUNK);
+    }
+    for (const [addr, name] of this.addrtosymbol.entries()) {
+      encoder.openElement(ELEM_SYMBOL);
+      addr.getSpace()!.encodeAttributes(encoder, addr.getOffset());
+      encoder.writeString(ATTRIB_NAME, name);
+      encoder.closeElement(ELEM_SYMBOL);
+    }
+    encoder.closeElement(ELEM_BINARYIMAGE);
+    return encoder.toBytes();
+  }
+
   loadFill(ptr: Uint8Array, size: number, addr: Address): void {
     let curaddr = new Address(addr);
     let emptyhit = false;
@@ -251,18 +251,20 @@ export abstract class MemoryBank {
 
     const skipBits = skip * 8;
     const gapBits = gap * 8;
+    // On spill over, the skip bytes before the value and the gap bytes after it are kept
+    const wordmask = calc_mask(this.wordsize);
     if (this.space.isBigEndian()) {
       if (size2 === 0) {
         val1 &= ~(calc_mask(size1) << BigInt(gapBits));
         val1 |= val << BigInt(gapBits);
         this.insert(ind, val1);
       } else {
-        val1 &= (~0n & 0xFFFFFFFFFFFFFFFFn) << BigInt(8 * size1);
+        val1 &= wordmask & ~calc_mask(size1);
         val1 |= val >> BigInt(8 * size2);
-        this.insert(ind, val1);
-        val2 &= (~0n & 0xFFFFFFFFFFFFFFFFn) >> BigInt(8 * size2);
+        this.insert(ind, val1 & wordmask);
+        val2 &= calc_mask(gap);
         val2 |= val << BigInt(gapBits);
-        this.insert(ind + BigInt(this.wordsize), val2);
+        this.insert(ind + BigInt(this.wordsize), val2 & wordmask);
       }
     } else {
       if (size2 === 0) {
@@ -270,12 +272,12 @@ export abstract class MemoryBank {
         val1 |= val << BigInt(skipBits);
         this.insert(ind, val1);
       } else {
-        val1 &= (~0n & 0xFFFFFFFFFFFFFFFFn) >> BigInt(8 * size1);
+        val1 &= calc_mask(skip);
         val1 |= val << BigInt(skipBits);
-        this.insert(ind, val1);
-        val2 &= (~0n & 0xFFFFFFFFFFFFFFFFn) << BigInt(8 * size2);
+        this.insert(ind, val1 & wordmask);
+        val2 &= wordmask & ~calc_mask(size2);
         val2 |= val >> BigInt(8 * size1);
-        this.insert(ind + BigInt(this.wordsize), val2);
+        this.insert(ind + BigInt(this.wordsize), val2 & wordmask);
       }
     }
   }
@@ -572,6 +574,7 @@ export class MemoryImage extends MemoryBank {
 export class MemoryPageOverlay extends MemoryBank {
   private underlie: MemoryBank | null;            // Underlying memory object
   private page: Map<bigint, Uint8Array> = new Map(); // Overlayed pages
+  private views: Map<bigint, DataView> = new Map();  // Views of pages handed out by getPageView()
 
   /**
    * Constructor for page overlay.
@@ -704,6 +707,31 @@ export class MemoryPageOverlay extends MemoryBank {
 
     pageptr.set(val.subarray(0, size), skip);
   }
+
+  /**
+   * Get a view of the page at the given aligned offset, for direct access by an emulator.
+   *
+   * The page is cached by this bank if it isn't already, as if it had been written, so
+   * reads and writes through the view and through the bank see the same bytes. Bytes of
+   * the underlying bank are copied at this point, so later changes to it are not seen.
+   * @param addr is the aligned offset of the page
+   * @returns the view of the page's bytes
+   */
+  getPageView(addr: bigint): DataView {
+    let pageptr = this.page.get(addr);
+    if (pageptr === undefined) {
+      pageptr = new Uint8Array(this.getPageSize());
+      this.page.set(addr, pageptr);
+      if (this.underlie !== null)
+        (this.underlie as any).getPage(addr, pageptr, 0, this.getPageSize());
+    }
+    let view = this.views.get(addr);
+    if (view === undefined) {
+      view = new DataView(pageptr.buffer, pageptr.byteOffset, pageptr.byteLength);
+      this.views.set(addr, view);
+    }
+    return view;
+  }
 }
 
 // ---------------------------------------------------------------------------
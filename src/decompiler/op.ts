@@ -29,6 +29,7 @@ import { ELEM_ADDR } from '../decompiler/varnode.js';
 import type { Writer } from '../util/writer.js';
 import { SortedSet, SortedSetIterator } from '../util/sorted-set.js';
 import { Varnode } from './varnode.js';
+import type { IrPool } from './irpool.js';
 
 // ---------------------------------------------------------------------------
 // Forward type declarations for types from modules not yet written
@@ -274,27 +275,27 @@ export class PcodeOp {
   // ---- Fields (public for friend class access) ----
 
   /** @internal Pointer to class providing behavioral details of the operation */
-  public opcode: TypeOp | null;
+  public opcode!: TypeOp | null;
   /** @internal Collection of boolean attributes on this op */
-  public flags: number;
+  public flags!: number;
   /** @internal Additional boolean attributes for this op */
-  public addlflags: number;
+  public addlflags!: number;
   /** @internal What instruction address is this attached to */
-  public start: SeqNum;
+  public start!: SeqNum;
   /** @internal Basic block in which this op is contained */
-  public parent: BlockBasic | null;
+  public parent!: BlockBasic | null;
   /** @internal Index within basic block's op list */
-  public basiciter: number;
+  public basiciter!: number;
   /** @internal Position in dead list (only used when dead) */
-  public insertiter: number;
+  public insertiter!: number;
   /** @internal Position in opcode list */
-  public codeiter: number;
+  public codeiter!: number;
   /** @internal Previous op in alive linked list */
-  public _prevAlive: PcodeOp | null;
+  public _prevAlive!: PcodeOp | null;
   /** @internal Next op in alive linked list */
-  public _nextAlive: PcodeOp | null;
+  public _nextAlive!: PcodeOp | null;
   /** @internal The one possible output Varnode of this op */
-  public output: Varnode | null;
+  public output!: Varnode | null;
   /** @internal The ordered list of input Varnodes for this op */
   public inrefs: (Varnode | null)[];
 
@@ -304,6 +305,15 @@ export class PcodeOp {
    * @param sq is the sequence number to associate with the new PcodeOp
    */
   constructor(s: number, sq: SeqNum) {
+    this.inrefs = [];
+    this.init(s, sq);
+  }
+
+  /**
+   * @internal (Re)initialize as an unattached PcodeOp, as the constructor does.
+   * Used on objects taken from the IrPool, after recycle() has emptied them.
+   */
+  init(s: number, sq: SeqNum): void {
     this.start = sq;
     this.flags = 0;
     this.addlflags = 0;
@@ -315,12 +325,25 @@ export class PcodeOp {
     this.codeiter = -1;
     this._prevAlive = null;
     this._nextAlive = null;
-    this.inrefs = new Array<Varnode | null>(s);
+    this.inrefs.length = s;
     for (let i = 0; i < s; ++i) {
       this.inrefs[i] = null;
     }
   }
 
+  /**
+   * @internal Drop every reference into the function, before this goes back to the IrPool.
+   * The input list is emptied and kept for reuse.
+   */
+  recycle(): void {
+    this.opcode = null;
+    this.parent = null;
+    this.output = null;
+    this._prevAlive = null;
+    this._nextAlive = null;
+    this.inrefs.length = 0;
+  }
+
   // ---- Methods used by friend classes (Funcdata, BlockBasic, etc.) ----
 
   /** @internal Set the opcode for this PcodeOp */
@@ -1400,13 +1423,14 @@ export function seqNumCompare(a: PcodeOp, b: PcodeOp): number {
  *
  * The PcodeOp objects are maintained under multiple different sorting criteria to
  * facilitate quick access in various situations. The main sort is by
- * sequence number (SeqNum) using a red-black tree (SortedSet) for O(log n) operations.
+ * sequence number (SeqNum) using a SortedSet for O(log n) operations, in the layout chosen
+ * by SORTED_SET_LAYOUT (a red-black tree by default).
  * PcodeOps are also grouped into alive and dead lists
  * to distinguish between raw p-code ops and those that are fully linked into control-flow.
  */
 export class PcodeOpBank {
   /** The main sequence number sort: SortedSet<PcodeOp> with seqNumCompare */
-  private optree: SortedSet<PcodeOp> = new SortedSet<PcodeOp>(seqNumCompare);
+  private optree: SortedSet<PcodeOp> = SortedSet.create<PcodeOp>(seqNumCompare);
   /** Reusable probe PcodeOp for SortedSet lookups (avoids allocation) */
   private _probe: PcodeOp = new PcodeOp(0, new SeqNum(new Address(null as any, 0n), 0));
   /** List of dead PcodeOps */
@@ -1431,6 +1455,8 @@ export class PcodeOpBank {
   private deadandgone: PcodeOp[] = [];
   /** Counter for producing unique id's for each op */
   private uniqid: number = 0;
+  /** Where cleared PcodeOps go for reuse, or null */
+  private pool: IrPool | null = null;
 
   constructor() {
     this.uniqid = 0;
@@ -1514,9 +1540,43 @@ export class PcodeOpBank {
 
   // ---- Public methods ----
 
+  /**
+   * Recycle PcodeOps through the given pool when this is cleared.
+   * @param pool is the Architecture's IrPool, or null to leave them to the collector
+   */
+  setPool(pool: IrPool | null): void {
+    this.pool = pool;
+  }
+
+  /** @internal Get an unattached PcodeOp object, recycled from the pool if possible */
+  private allocate(inputs: number, sq: SeqNum): PcodeOp {
+    const op: PcodeOp | undefined = this.pool !== null ? this.pool.ops.take() : undefined;
+    if (op === undefined)
+      return new PcodeOp(inputs, sq);
+    op.init(inputs, sq);
+    return op;
+  }
+
+  /** Drop the tree nodes kept by clear() for the next analysis, once the bank is empty */
+  releaseStorage(): void {
+    this.optree.clear();
+  }
+
   /** Clear all PcodeOps from this container */
   clear(): void {
-    this.optree.clear();
+    const pool = this.pool;
+    if (pool !== null) {
+      // Every op is either in the tree or retired, never both
+      for (const op of this.optree) {
+        op.recycle();
+        pool.ops.give(op, pool.poison);
+      }
+      for (const op of new Set(this.deadandgone)) {
+        op.recycle();
+        pool.ops.give(op, pool.poison);
+      }
+    }
+    this.optree.clear(pool !== null && !pool.poison);
     this._aliveHead = null;
     this._aliveTail = null;
     this._aliveCount = 0;
@@ -1539,7 +1599,7 @@ export class PcodeOpBank {
    * A sequence number is assigned, and the op is added to the end of the dead list.
    */
   createFromAddr(inputs: number, pc: Address): PcodeOp {
-    const op = new PcodeOp(inputs, new SeqNum(pc, this.uniqid++));
+    const op = this.allocate(inputs, new SeqNum(pc, this.uniqid++));
     this.optree.insert(op);
     op.setFlag(PcodeOp.dead);
     op.insertiter = this.deadlist.length;
@@ -1552,7 +1612,7 @@ export class PcodeOpBank {
    * A new PcodeOp is allocated, suitable for cloning and restoring from XML.
    */
   createFromSeq(inputs: number, sq: SeqNum): PcodeOp {
-    const op = new PcodeOp(inputs, sq);
+    const op = this.allocate(inputs, sq);
     if (sq.getTime() >= this.uniqid)
       this.uniqid = sq.getTime() + 1;
 
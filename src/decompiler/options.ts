@@ -12,6 +12,7 @@ import {
 } from '../core/marshal.js';
 import type { Decoder } from '../core/marshal.js';
 import { ParseError, LowlevelError, RecovError } from '../core/error.js';
+import { IrPool } from './irpool.js';
 
 // ---------------------------------------------------------------------------
 // Forward type declarations for not-yet-written modules
@@ -110,6 +111,7 @@ export const ELEM_WARNING                  = new ElementId("warning", 210);
 export const ELEM_JUMPTABLEMAX             = new ElementId("jumptablemax", 271);
 export const ELEM_NANIGNORE                = new ElementId("nanignore", 272);
 export const ELEM_BRACEFORMAT              = new ElementId("braceformat", 284);
+export const ELEM_ACTIONWORKLIST           = new ElementId("actionworklist", 301);
 
 // ---------------------------------------------------------------------------
 // Utility: parse an integer from a string, allowing hex/oct/dec prefixes
@@ -201,6 +203,7 @@ export abstract class ArchOption {
 export class OptionDatabase {
   private glb: Architecture;
   private optionmap: Map<uint4, ArchOption> = new Map();
+  private history: string[] = [];       // Every option command issued, in order
 
   /**
    * Map from ArchOption name to its class instance.
@@ -255,6 +258,8 @@ export class OptionDatabase {
     this.registerOption(new OptionNamespaceStrategy());
     this.registerOption(new OptionSplitDatatypes());
     this.registerOption(new OptionNanIgnore());
+    this.registerOption(new OptionActionWorklist());
+    this.registerOption(new OptionIrPool());
   }
 
   /**
@@ -270,9 +275,19 @@ export class OptionDatabase {
     const opt = this.optionmap.get(nameId);
     if (opt === undefined)
       throw new ParseError("Unknown option");
+    this.history.push(opt.getName() + '(' + p1 + ',' + p2 + ',' + p3 + ')');
     return opt.apply(this.glb, p1, p2, p3);
   }
 
+  /**
+   * Get every option command issued so far, in order.
+   * Together with the specification files this determines the option state of the
+   * Architecture, so it can stand in for that state when fingerprinting results.
+   */
+  getHistory(): readonly string[] {
+    return this.history;
+  }
+
   /**
    * Parse and execute a single option element.
    * Scan the name and optional parameters and call method set().
@@ -461,6 +476,55 @@ export class OptionForLoops extends ArchOption {
   }
 }
 
+/**
+ * Toggle whether rule pools retest only the ops affected by earlier changes.
+ *
+ * Setting the first parameter to "on" causes each ActionPool, after its first full sweep,
+ * to apply its Rules only to PcodeOps whose operands or neighbors changed. A full sweep is
+ * still made before the pool finishes to confirm that no Rule applies anywhere. Rules that
+ * look past an op's immediate neighbors can apply in a different order, so the option is
+ * off by default.
+ */
+export class OptionActionWorklist extends ArchOption {
+  constructor() {
+    super();
+    this.name = "actionworklist";
+  }
+
+  apply(glb: Architecture, p1: string, p2: string, p3: string): string {
+    (glb as any).action_worklist = ArchOption.onOrOff(p1);
+
+    const res: string = "Rule worklist is " + p1;
+    return res;
+  }
+}
+
+/**
+ * Toggle whether Varnode, PcodeOp and BlockBasic objects are recycled between functions.
+ *
+ * Setting the first parameter to "on" gives the Architecture an IrPool, which functions
+ * created from then on take their IR objects from and return them to when cleared. Setting
+ * it to "off" drops the pool and leaves the objects to the garbage collector, which is the
+ * default because the pool does not reduce collection time (see irpool.ts).
+ */
+export class OptionIrPool extends ArchOption {
+  constructor() {
+    super();
+    this.name = "irpool";
+  }
+
+  apply(glb: Architecture, p1: string, p2: string, p3: string): string {
+    const val = ArchOption.onOrOff(p1);
+    if (!val)
+      (glb as any).irpool = null;
+    else if ((glb as any).irpool === null)
+      (glb as any).irpool = new IrPool();
+
+    const res: string = "IR object recycling is " + p1;
+    return res;
+  }
+}
+
 /**
  * Mark/unmark a specific function as inline.
  *
@@ -649,7 +713,8 @@ export class OptionHideExtensions extends ArchOption {
  * Set the maximum number of characters per decompiled line.
  *
  * The first parameter is an integer value passed to the pretty printer as the maximum
- * number of characters to emit in a single line before wrapping.
+ * number of characters to emit in a single line before wrapping. A value of 0 turns off
+ * wrapping, so only explicit line breaks are emitted.
  */
 export class OptionMaxLineWidth extends ArchOption {
   constructor() {
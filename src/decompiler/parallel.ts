@@ -2,12 +2,12 @@
  * @file parallel.ts
  * @description Parallel decompilation infrastructure.
  *
- * Provides multi-function parallel decompilation by cloning the action tree
- * per-job and buffering shared CommentDB writes.
+ * Provides multi-function parallel decompilation by giving each job its own progress state
+ * (ActionJobState) over the shared root Action and buffering shared CommentDB writes.
  *
  * Components:
  * - BufferedCommentDB: wraps a CommentDatabase, buffering mutations per-job
- * - DecompileJob: decompiles a single function with an independent action tree
+ * - DecompileJob: decompiles a single function with an independent action state
  * - ParallelDecompiler: orchestrates concurrent DecompileJobs
  */
 
@@ -19,8 +19,11 @@ import {
   CommentDatabase,
   type CommentSetIterator,
 } from './comment.js';
-import type { Action } from './action.js';
+import {
+  type Action, type ActionJobState, ActionBudget, ActionBudgetExceeded, type ActionBudgetLimits,
+} from './action.js';
 import type { Writer } from '../util/writer.js';
+import { type CallGraph, capturePrototype, applyPrototype } from './callgraph.js';
 
 // ---------------------------------------------------------------------------
 // Forward type declarations (avoid circular import issues)
@@ -169,32 +172,50 @@ export interface DecompileResult {
   error?: string;
   /** Number of changes made by the action pipeline */
   actionCount: number;
+  /** Set if the job was stopped by its time or memory budget */
+  budgetExceeded?: {
+    reason: 'time' | 'memory';
+    /** The Action that was running when the budget ran out */
+    action: string;
+    elapsedMs: number;
+  };
 }
 
 /**
  * A single decompilation job that operates on one function.
  *
- * Each job owns an independent clone of the action tree, so its mutable
- * execution state (status, count, stateIndex) does not interfere with
- * other concurrent jobs. The Funcdata is per-function and already isolated.
+ * Jobs share the root Action but each owns an ActionJobState holding the mutable
+ * execution state of the tree (status, count, stateIndex, pool traversal), bound for
+ * the duration of run(), so jobs do not interfere with each other. run() is synchronous,
+ * so two jobs never interleave inside the tree. The Funcdata is per-function and already
+ * isolated. Rule and Action statistics stay shared and accumulate across jobs. A job given
+ * a BufferedCommentDB installs it as the Architecture's comment database for the duration
+ * of run(), so its comment writes reach the shared database only when flushComments() is
+ * called.
  */
 export class DecompileJob {
   private arch: Architecture;
   private actionTree: Action;
+  private state: ActionJobState;
   private fd: Funcdata;
   private bufferedComments: BufferedCommentDB | null;
+  private limits: ActionBudgetLimits | null;
 
   /**
    * @param arch the shared Architecture (read-only during decompilation)
-   * @param actionTree a cloned, independent action tree for this job
+   * @param actionTree the root Action, usually the shared allacts.getCurrent()
    * @param fd the Funcdata for the function to decompile
    * @param bufferedComments optional buffered comment DB for this job
+   * @param limits optional time and memory budget for this job
    */
-  constructor(arch: Architecture, actionTree: Action, fd: Funcdata, bufferedComments?: BufferedCommentDB) {
+  constructor(arch: Architecture, actionTree: Action, fd: Funcdata, bufferedComments?: BufferedCommentDB,
+              limits?: ActionBudgetLimits) {
     this.arch = arch;
     this.actionTree = actionTree;
+    this.state = actionTree.newJobState();
     this.fd = fd;
     this.bufferedComments = bufferedComments ?? null;
+    this.limits = ActionBudget.isLimited(limits) ? limits! : null;
   }
 
   /**
@@ -208,12 +229,24 @@ export class DecompileJob {
         return { funcdata: this.fd, name, success: true, actionCount: 0 };
       }
 
-      // Clear previous analysis
-      this.clearAnalysis();
-
-      // Reset and run the action pipeline
-      this.actionTree.reset(this.fd);
-      const res = this.actionTree.perform(this.fd);
+      // Comment writes, including the warnings Funcdata issues, go to this job's buffer
+      const prevComments = this.arch.commentdb;
+      if (this.bufferedComments !== null) this.arch.commentdb = this.bufferedComments;
+      const prev = this.actionTree.bindJobState(this.state);
+      let res: number;
+      try {
+        // Clear previous analysis
+        this.clearAnalysis();
+
+        // Reset and run the action pipeline against this job's state
+        this.actionTree.reset(this.fd);
+        res = this.limits === null
+          ? this.actionTree.perform(this.fd)
+          : ActionBudget.run(new ActionBudget(this.limits), () => this.actionTree.perform(this.fd));
+      } finally {
+        this.actionTree.bindJobState(prev);
+        this.arch.commentdb = prevComments;
+      }
 
       return {
         funcdata: this.fd,
@@ -222,35 +255,32 @@ export class DecompileJob {
         actionCount: res >= 0 ? res : 0,
       };
     } catch (err: any) {
+      // On a budget overrun the Funcdata holds the partial analysis up to the safe point
       return {
         funcdata: this.fd,
         name,
         success: false,
         error: err.explain ?? err.message ?? String(err),
         actionCount: 0,
+        budgetExceeded: err instanceof ActionBudgetExceeded
+          ? { reason: err.reason, action: err.actionName, elapsedMs: err.elapsedMs }
+          : undefined,
       };
     }
   }
 
   /**
    * Clear analysis for this function.
-   * If a buffered comment DB is in use, mutations are buffered.
+   * If a buffered comment DB is in use, it is installed by run() and mutations are buffered.
    */
   private clearAnalysis(): void {
     const Comment_warning = 16;       // Comment.warning
     const Comment_warningheader = 32; // Comment.warningheader
     this.fd.clear();
-    if (this.bufferedComments !== null) {
-      this.bufferedComments.clearType(
-        this.fd.getAddress(),
-        Comment_warning | Comment_warningheader
-      );
-    } else {
-      this.arch.commentdb?.clearType(
-        this.fd.getAddress(),
-        Comment_warning | Comment_warningheader
-      );
-    }
+    this.arch.commentdb?.clearType(
+      this.fd.getAddress(),
+      Comment_warning | Comment_warningheader
+    );
   }
 
   /** Flush any buffered comment writes to the real DB. */
@@ -273,7 +303,7 @@ export class DecompileJob {
 /**
  * Orchestrates parallel decompilation of multiple functions.
  *
- * Each function gets its own DecompileJob with a cloned action tree.
+ * Each function gets its own DecompileJob with its own state over the shared action tree.
  * Jobs are run concurrently (up to a configurable concurrency limit)
  * using Promise.all with a semaphore pattern.
  *
@@ -286,23 +316,26 @@ export class ParallelDecompiler {
   private arch: Architecture;
   private concurrency: number;
   private writer: Writer | null;
+  private limits: ActionBudgetLimits | undefined;
 
   /**
    * @param arch the Architecture to decompile within
    * @param concurrency maximum number of concurrent jobs (default 1)
    * @param writer optional writer for status messages
+   * @param limits optional per-function time and memory budget
    */
-  constructor(arch: Architecture, concurrency: number = 1, writer?: Writer) {
+  constructor(arch: Architecture, concurrency: number = 1, writer?: Writer, limits?: ActionBudgetLimits) {
     this.arch = arch;
     this.concurrency = Math.max(1, concurrency);
     this.writer = writer ?? null;
+    this.limits = limits;
   }
 
   /**
    * Decompile a list of functions concurrently.
    *
    * Each function gets:
-   * - A fresh clone of the action tree (independent mutable state)
+   * - A fresh ActionJobState over the shared action tree (independent mutable state)
    * - A BufferedCommentDB wrapper (when concurrency > 1)
    *
    * Results are returned in the same order as the input list.
@@ -320,11 +353,11 @@ export class ParallelDecompiler {
     const jobs: Array<{ index: number; job: DecompileJob }> = [];
     for (let i = 0; i < funcdataList.length; i++) {
       const fd = funcdataList[i];
-      const clonedAction = this.arch.allacts.cloneCurrentAction();
+      const root = this.arch.allacts.getCurrent();
       const buffered = useBuffering
         ? new BufferedCommentDB(this.arch.commentdb!)
         : undefined;
-      const job = new DecompileJob(this.arch, clonedAction, fd, buffered);
+      const job = new DecompileJob(this.arch, root, fd, buffered, this.limits);
       jobs.push({ index: i, job });
     }
 
@@ -386,7 +419,95 @@ export class ParallelDecompiler {
   }
 
   /**
-   * Decompile a single function using a cloned action tree.
+   * Decompile functions in input order, yielding each result once it is ready.
+   *
+   * Unlike decompileAll(), the job state is created when each job starts and nothing is
+   * retained after a result is yielded. With a concurrency of 1 each function is decompiled
+   * just before its result is yielded. With a concurrency of N, up to N jobs are in flight:
+   * the next functions are decompiled ahead, each writing comments to its own
+   * BufferedCommentDB, and a job's comments are flushed just before its result is yielded.
+   * A caller that prints and releases each function (Architecture.clearAnalysis) before
+   * pulling the next keeps memory bounded by N functions regardless of their number.
+   *
+   * @param funcdataList the functions to decompile; it is read lazily, at most N ahead
+   */
+  *decompileIter(funcdataList: Iterable<Funcdata>): Generator<DecompileResult> {
+    const useBuffering = this.concurrency > 1;
+    const inflight: Array<{ job: DecompileJob; res: DecompileResult }> = [];
+    for (const fd of funcdataList) {
+      if (this.writer) {
+        this.writer.write(`Decompiling ${fd.getName()}\n`);
+      }
+      const buffered = useBuffering ? new BufferedCommentDB(this.arch.commentdb!) : undefined;
+      const job = new DecompileJob(this.arch, this.arch.allacts.getCurrent(), fd, buffered,
+                                   this.limits);
+      inflight.push({ job, res: job.run() });
+      if (inflight.length < this.concurrency) continue;
+      const done = inflight.shift()!;
+      done.job.flushComments();
+      yield done.res;
+    }
+    while (inflight.length > 0) {
+      const done = inflight.shift()!;
+      done.job.flushComments();
+      yield done.res;
+    }
+  }
+
+  /**
+   * Decompile every function of a call graph bottom-up, callees before their callers.
+   *
+   * Functions are taken component by component in CallGraph.getComponents() order. With
+   * feedForward, the prototype recovered for each function is locked onto it once the
+   * consumer has taken the result, so every later caller is decompiled against the
+   * callee's real parameters and return value instead of guessing them per call site.
+   * As with decompileIter(), the consumer may print and release each result before the
+   * next is produced.
+   *
+   * @param graph is a call graph of the program, with edges built
+   * @param feedForward locks recovered prototypes for the callers (default true)
+   */
+  *decompileBottomUp(graph: CallGraph, feedForward: boolean = true): Generator<DecompileResult> {
+    for (const comp of graph.getComponents()) {
+      for (const node of comp.nodes) {
+        const fd = node.getFuncdata();
+        if (fd === null || fd.hasNoCode()) continue;
+        if (this.writer) {
+          this.writer.write(`Decompiling ${fd.getName()}\n`);
+        }
+        const job = new DecompileJob(this.arch, this.arch.allacts.getCurrent(), fd, undefined,
+                                     this.limits);
+        const res = job.run();
+        job.flushComments();
+        // Captured before the consumer releases the analysis
+        const proto = feedForward && res.success ? capturePrototype(fd) : null;
+        yield res;
+        if (proto !== null) {
+          try {
+            applyPrototype(this.arch, fd, proto);
+          } catch {
+            // Callers recover the prototype themselves
+          }
+        }
+      }
+    }
+  }
+
+  /**
+   * Async form of decompileIter(); yields to the event loop between functions so that
+   * output streams can drain.
+   *
+   * @param funcdataList array of Funcdata objects to decompile
+   */
+  async *decompileStream(funcdataList: Funcdata[]): AsyncGenerator<DecompileResult> {
+    for (const res of this.decompileIter(funcdataList)) {
+      yield res;
+      await new Promise<void>(resolve => setImmediate(resolve));
+    }
+  }
+
+  /**
+   * Decompile a single function with its own action state.
    * Convenience method equivalent to decompileAll([fd])[0].
    *
    * @param fd the function to decompile
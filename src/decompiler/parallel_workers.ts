@@ -3,12 +3,22 @@
  * @description Child-process based parallel decompilation orchestrator.
  *
  * Spawns N child processes via fork(), each with its own Architecture instance.
- * Functions are dispatched one at a time (work-stealing pattern):
- * when a child finishes, it gets the next function from the queue.
+ * The parent parses the XML and builds the Architecture once, then hands the
+ * children a packed snapshot of the load image so they skip the XML entirely.
+ * Functions are scheduled by estimated cost, most expensive first, so a large
+ * function found late in the XML cannot leave one child running alone at the end.
+ * Cheap functions are grouped into batches to amortize the IPC round trip.
+ * When a child finishes its batch it gets the next one from the queue.
+ * Children release each function once its result is sent and report their resident set
+ * size, and with recycleRssMb a child that grows past the limit anyway is replaced by a
+ * fresh one, its unfinished functions going back on the queue.
  *
- * Uses child_process.fork() instead of worker_threads because Node.js v23's
- * native type stripping doesn't handle .js→.ts import resolution in workers.
- * fork() inherits tsx's ESM loader hooks, giving full module resolution.
+ * The export is read once, by the parent, through the streaming XML path: bytechunks
+ * are decoded straight into byte buffers, and function names and sizes come from the
+ * parsed scripts.  Children get the packed snapshot path instead of the XML, and only
+ * when no snapshot can be made does the parent read the raw XML text to send them.
+ * Children are separate processes (fork()) rather than worker threads, so each has its
+ * own heap to grow, release and be recycled by RSS.
  *
  * This gives true multi-core parallelism for CPU-bound decompilation.
  */
@@ -19,6 +29,20 @@ import * as os from 'os';
 import { fileURLToPath } from 'url';
 import { dirname, resolve } from 'path';
 import type { Writer } from '../util/writer.js';
+import { ActionProfiler } from './actionprofile.js';
+import { EventTracer, type TraceEvent } from './eventtrace.js';
+import { DocumentStorage } from '../core/xml.js';
+import type { ResultCache } from './resultcache.js';
+import type { CoreTypeTable } from './type.js';
+import { CallGraph, CallGraphNode } from './callgraph.js';
+import type { Document, Element } from '../core/xml.js';
+import {
+  buildDocumentArchitecture,
+  encodeArchitectureSnapshot,
+  encodeCoreTypeTable,
+  writeSnapshotFile,
+  removeSnapshotFile,
+} from './worker_arch.js';
 
 const __filename = fileURLToPath(import.meta.url);
 const __dirname = dirname(__filename);
@@ -38,8 +62,277 @@ export interface WorkerDecompileResult {
   success: boolean;
   /** Error message if decompilation failed */
   error?: string;
-  /** Which worker processed this function */
+  /** Set if the function was stopped by its time or memory budget */
+  budgetExceeded?: { reason: 'time' | 'memory'; action: string; elapsedMs: number };
+  /** Which worker processed this function (-1 if it was not sent to one) */
   workerId: number;
+  /** Set if the output came from the result cache */
+  cached?: boolean;
+}
+
+/** Per-worker accounting for one decompileAll() run */
+export interface WorkerUtilization {
+  workerId: number;
+  /** Number of functions this worker decompiled */
+  functions: number;
+  /** Number of batches dispatched to this worker */
+  batches: number;
+  /** Time spent decompiling, as reported by the worker */
+  busyMs: number;
+  /** Time from the start of dispatch until this worker's last result */
+  finishMs: number;
+  /** busyMs divided by the wall time of the whole run */
+  utilization: number;
+  /** Largest resident set size reported by this worker, in megabytes */
+  peakRssMb: number;
+  /** Number of times this worker was replaced by a fresh process */
+  recycled: number;
+}
+
+/** Delivery options for WorkerParallelDecompiler.decompileStream() */
+export interface WorkerStreamOptions {
+  /** Yield results in XML order instead of completion order (default false) */
+  ordered?: boolean;
+  /** Maximum results held in the parent waiting to be consumed (default 256) */
+  maxPending?: number;
+}
+
+/** Scheduling options for WorkerParallelDecompiler */
+export interface WorkerScheduleOptions {
+  /** Decompile times (ms) from an earlier run, keyed by function name */
+  costHints?: Map<string, number>;
+  /** Maximum number of functions in one batch (default 16) */
+  maxBatchSize?: number;
+  /**
+   * Functions cheaper than this fraction of the average per-worker cost are batched
+   * (default 1/64)
+   */
+  batchFraction?: number;
+  /** Per-function wall-clock limit in milliseconds (default none) */
+  timeLimitMs?: number;
+  /** Per-function limit on heap growth in megabytes (default none) */
+  heapGrowthMb?: number;
+  /** Time Actions and Rules in the workers and merge the results (see getProfile) */
+  profile?: boolean;
+  /**
+   * Write a timeline of the run to this file, in the Chrome trace-event format. The parent
+   * records the snapshot, scheduling, each worker's start-up and batches; each worker records
+   * its initialization, functions, action phases, restarts, GC pauses and idle time.
+   */
+  trace?: string;
+  /**
+   * Return results of earlier runs from this cache, and store new ones in it. The output
+   * is that of the `print C` command (`print C packed` with tokenStream), which the cache's
+   * salt should reflect. The other commands of the script holding each function are part
+   * of its key. The cache is not used with callGraphOrder, since a cached function would
+   * not hand its recovered prototype on to its callers.
+   */
+  resultCache?: ResultCache;
+  /**
+   * Dispatch in call graph order: each strongly connected component of the call graph is
+   * one batch, sent only after the components it calls have finished, and the prototype
+   * recovered for each function is locked in every worker before its callers are sent.
+   * The call graph is built in the parent by running flow on every function.
+   */
+  callGraphOrder?: boolean;
+  /**
+   * The root Action the workers decompile with (default "decompile"), e.g. "triage" for
+   * bulk scanning. It must be one of the ActionDatabase's grouplists.
+   */
+  root?: string;
+  /**
+   * Recycle a worker once its resident set size passes this many megabytes (default none).
+   * The worker is stopped and replaced by a fresh one, and the functions of its batch that
+   * had not finished are queued again, so the results are as if it had kept running. With
+   * this set, a worker that exits unexpectedly is replaced too; the function it was running
+   * is queued again once, and fails if it brings down a second worker. A recycled worker's
+   * profile and trace are not collected.
+   */
+  recycleRssMb?: number;
+  /**
+   * Return each function's markup as a packed token stream (`print C packed`, one base64
+   * line that decodeTokenStream() reads) instead of its C text.
+   */
+  tokenStream?: boolean;
+}
+
+/** A dependency-ordered schedule, as built from the call graph */
+interface CallGraphSchedule {
+  /** Function indices of each batch, most expensive first */
+  batches: number[][];
+  /** Number of unfinished callee batches of each batch */
+  waiting: number[];
+  /** The batches that call each batch */
+  dependents: number[][];
+}
+
+// ---------------------------------------------------------------------------
+// Cost estimation and scheduling
+// ---------------------------------------------------------------------------
+
+/** Yield the space, offset and name attributes of every `<symbol>` tag */
+function* collectSymbolAttributes(xml: string | Element): Generator<[string, string, string]> {
+  if (typeof xml !== 'string') {
+    const image = xml.getName() === 'binaryimage'
+      ? xml
+      : xml.getChildren().find(el => el.getName() === 'binaryimage');
+    if (image === undefined) return;
+    for (const el of image.getChildren()) {
+      if (el.getName() !== 'symbol') continue;
+      let space = '', offset = '', name = '';
+      for (let i = 0; i < el.getNumAttributes(); ++i) {
+        const attr = el.getAttributeName(i);
+        if (attr === 'space') space = el.getAttributeValue(i);
+        else if (attr === 'offset') offset = el.getAttributeValue(i);
+        else if (attr === 'name') name = el.getAttributeValue(i);
+      }
+      yield [space, offset, name];
+    }
+    return;
+  }
+  const tagRegex = /<symbol\b([^>]*)>/g;
+  const attrRegex = /(\w+)="([^"]*)"/g;
+  let match;
+  while ((match = tagRegex.exec(xml)) !== null) {
+    let space = '', offset = '', name = '';
+    let attr;
+    attrRegex.lastIndex = 0;
+    while ((attr = attrRegex.exec(match[1])) !== null) {
+      if (attr[1] === 'space') space = attr[2];
+      else if (attr[1] === 'offset') offset = attr[2];
+      else if (attr[1] === 'name') name = attr[2];
+    }
+    yield [space, offset, name];
+  }
+}
+
+/**
+ * Estimate the byte size of each function as the distance to the next symbol in the
+ * same space, using the `<symbol>` tags of the binaryimage. Given the raw XML this is a
+ * lightweight regex scan; given a parsed document element, its symbol children are read.
+ * Functions with no symbol, or the last symbol of a space, get no entry.
+ */
+export function estimateFunctionSizes(xml: string | Element): Map<string, number> {
+  const bySpace = new Map<string, { name: string; off: bigint }[]>();
+  for (const [space, offset, name] of collectSymbolAttributes(xml)) {
+    if (space.length === 0 || offset.length === 0 || name.length === 0) continue;
+    let off: bigint;
+    try {
+      off = BigInt(offset);
+    } catch {
+      continue;
+    }
+    let list = bySpace.get(space);
+    if (list === undefined) {
+      list = [];
+      bySpace.set(space, list);
+    }
+    list.push({ name, off });
+  }
+  const sizes = new Map<string, number>();
+  for (const list of bySpace.values()) {
+    list.sort((a, b) => (a.off < b.off ? -1 : a.off > b.off ? 1 : 0));
+    for (let i = 0; i + 1 < list.length; ++i) {
+      const gap = list[i + 1].off - list[i].off;
+      if (gap > 0n) sizes.set(list[i].name, Number(gap));
+    }
+  }
+  return sizes;
+}
+
+/**
+ * Assign a relative cost to each function.
+ *
+ * Timings from an earlier run are used where available. Other functions are costed
+ * by byte size, scaled into milliseconds by the ratio observed on the hinted ones.
+ * Functions without any estimate get the median cost.
+ */
+export function estimateFunctionCosts(
+  names: string[],
+  sizes: Map<string, number>,
+  hints?: Map<string, number>,
+): number[] {
+  let hintedMs = 0;
+  let hintedBytes = 0;
+  if (hints !== undefined) {
+    for (const name of names) {
+      const ms = hints.get(name);
+      const sz = sizes.get(name);
+      if (ms !== undefined && sz !== undefined) {
+        hintedMs += ms;
+        hintedBytes += sz;
+      }
+    }
+  }
+  const scale = (hintedMs > 0 && hintedBytes > 0) ? hintedMs / hintedBytes : 1;
+  const costs: number[] = names.map(name => {
+    const ms = hints?.get(name);
+    if (ms !== undefined) return ms;
+    const sz = sizes.get(name);
+    return sz !== undefined ? sz * scale : -1;
+  });
+  const known = costs.filter(c => c >= 0).sort((a, b) => a - b);
+  const median = known.length > 0 ? known[known.length >> 1] : 1;
+  return costs.map(c => (c >= 0 ? c : median));
+}
+
+/**
+ * Order functions into dispatch batches: most expensive first, one per batch, followed by
+ * the cheap functions grouped until a batch reaches the cost threshold or maxBatchSize.
+ * @returns batches of indices into the cost array
+ */
+export function planBatches(
+  costs: number[],
+  workerCount: number,
+  maxBatchSize: number = 16,
+  batchFraction: number = 1 / 64,
+): number[][] {
+  const order = costs.map((_c, i) => i).sort((a, b) => costs[b] - costs[a] || a - b);
+  let total = 0;
+  for (const c of costs) total += c;
+  const threshold = (total / Math.max(1, workerCount)) * batchFraction;
+  const batches: number[][] = [];
+  let cur: number[] = [];
+  let curCost = 0;
+  for (const idx of order) {
+    const c = costs[idx];
+    if (c >= threshold || maxBatchSize <= 1) {
+      batches.push([idx]);
+      continue;
+    }
+    cur.push(idx);
+    curCost += c;
+    if (cur.length >= maxBatchSize || curCost >= threshold) {
+      batches.push(cur);
+      cur = [];
+      curCost = 0;
+    }
+  }
+  if (cur.length > 0) batches.push(cur);
+  return batches;
+}
+
+/**
+ * Read decompile timings saved by saveTimings(), for use as costHints.
+ * Returns an empty map if the file does not exist or cannot be parsed.
+ */
+export function loadTimings(path: string): Map<string, number> {
+  try {
+    const obj = JSON.parse(fs.readFileSync(path, 'utf-8'));
+    return new Map<string, number>(Object.entries(obj).filter(([, v]) => typeof v === 'number') as [string, number][]);
+  } catch {
+    return new Map<string, number>();
+  }
+}
+
+/** Save the decompile time of every successful result as a JSON object keyed by name */
+export function saveTimings(path: string, results: WorkerDecompileResult[]): void {
+  const obj: Record<string, number> = {};
+  for (const r of results) {
+    // A function stopped by its budget is at least that expensive; keep it first next time
+    if (r.success || r.budgetExceeded !== undefined) obj[r.name] = Math.round(r.timeMs * 10) / 10;
+  }
+  fs.writeFileSync(path, JSON.stringify(obj));
 }
 
 // ---------------------------------------------------------------------------
@@ -48,46 +341,85 @@ export interface WorkerDecompileResult {
 
 export class WorkerParallelDecompiler {
   private xmlPath: string;
-  private xmlString: string;
+  private storage: DocumentStorage;
+  private document: Document;
+  private functionSizes: Map<string, number>;
   private workerCount: number;
   private writer: Writer | null;
   private functionNames: string[];
+  private functionCommands: string[][];
   private enhancedDisplay: boolean;
+  private options: WorkerScheduleOptions;
+  private utilization: WorkerUtilization[] = [];
+  private profile: ActionProfiler | null;
 
   /**
    * @param xmlPath path to the XML file containing the binary image and scripts
    * @param workerCount number of child processes (default: cpu count - 1)
    * @param writer optional writer for progress messages
    * @param enhancedDisplay use standard C types and Ghidra GUI-style globals
+   * @param options cost hints and batching parameters for the scheduler
    */
   constructor(
     xmlPath: string,
     workerCount?: number,
     writer?: Writer,
     enhancedDisplay?: boolean,
+    options?: WorkerScheduleOptions,
   ) {
     this.xmlPath = xmlPath;
     this.workerCount = workerCount ?? Math.max(1, os.cpus().length - 1);
     this.writer = writer ?? null;
     this.enhancedDisplay = enhancedDisplay ?? false;
-    this.xmlString = fs.readFileSync(xmlPath, 'utf-8');
-    this.functionNames = WorkerParallelDecompiler.extractFunctionNames(this.xmlString);
+    this.options = options ?? {};
+    this.profile = this.options.profile ? new ActionProfiler() : null;
+    // Parsed incrementally: bytechunk content goes straight into buffers, no full string or hex DOM
+    this.storage = new DocumentStorage();
+    this.document = this.storage.openDocumentStream(xmlPath);
+    this.functionNames = WorkerParallelDecompiler.collectFunctionNames(this.document.getRoot());
+    this.functionCommands = WorkerParallelDecompiler.collectScriptCommands(this.document.getRoot());
+    this.functionSizes = estimateFunctionSizes(this.document.getRoot());
   }
 
   /**
-   * Extract function names from `<com>lo fu NAME</com>` tags in the XML.
-   * This is a lightweight scan — no full XML parse needed.
+   * Collect function names from the `<com>lo fu NAME</com>` commands of the `<script>`
+   * tags under a parsed `<decompilertest>` element.
    */
-  static extractFunctionNames(xml: string): string[] {
+  static collectFunctionNames(root: Element): string[] {
     const names: string[] = [];
-    const regex = /<com>\s*(?:lo(?:ad)?\s+fu(?:nction)?)\s+(\S+)\s*<\/com>/g;
-    let match;
-    while ((match = regex.exec(xml)) !== null) {
-      names.push(match[1]);
+    const regex = /^\s*(?:lo(?:ad)?\s+fu(?:nction)?)\s+(\S+)\s*$/;
+    for (const script of root.getChildren()) {
+      if (script.getName() !== 'script') continue;
+      for (const com of script.getChildren()) {
+        if (com.getName() !== 'com') continue;
+        const match = regex.exec(com.getContent());
+        if (match !== null) names.push(match[1]);
+      }
     }
     return names;
   }
 
+  /**
+   * Collect, for each function of collectFunctionNames(), the other commands of the
+   * `<script>` it is loaded in: the options, prototypes and edits that script applies.
+   */
+  static collectScriptCommands(root: Element): string[][] {
+    const res: string[][] = [];
+    const regex = /^\s*(?:lo(?:ad)?\s+fu(?:nction)?)\s+(\S+)\s*$/;
+    for (const script of root.getChildren()) {
+      if (script.getName() !== 'script') continue;
+      const others: string[] = [];
+      let count = 0;
+      for (const com of script.getChildren()) {
+        if (com.getName() !== 'com') continue;
+        if (regex.test(com.getContent())) count += 1;
+        else others.push(com.getContent().trim());
+      }
+      for (let i = 0; i < count; ++i) res.push(others);
+    }
+    return res;
+  }
+
   /** Number of functions found in the XML. */
   getFunctionCount(): number {
     return this.functionNames.length;
@@ -98,162 +430,600 @@ export class WorkerParallelDecompiler {
     return [...this.functionNames];
   }
 
+  /** Per-worker utilization of the most recent decompileAll() run. */
+  getUtilization(): WorkerUtilization[] {
+    return this.utilization.map(u => ({ ...u }));
+  }
+
+  /** Action and Rule timing merged from all workers, if the profile option is set */
+  getProfile(): ActionProfiler | null {
+    return this.profile;
+  }
+
+  /**
+   * Build the dispatch batches (as indices into functionNames) for the given number of
+   * workers, leaving out the functions already done.
+   */
+  private buildSchedule(workerCount: number, done: boolean[]): number[][] {
+    const indices = this.functionNames.map((_n, i) => i).filter(i => !done[i]);
+    const names = indices.map(i => this.functionNames[i]);
+    const costs = estimateFunctionCosts(names, this.functionSizes, this.options.costHints);
+    const batches = planBatches(costs, workerCount, this.options.maxBatchSize, this.options.batchFraction);
+    return batches.map(b => b.map(j => indices[j]));
+  }
+
+  /**
+   * Build one batch per call graph component that has functions left to do, with the
+   * dependencies between them. Each batch lists its functions in address order.
+   */
+  private buildCallGraphSchedule(conf: any, done: boolean[]): CallGraphSchedule {
+    const start = performance.now();
+    const graph = new CallGraph(conf);
+    graph.buildFromFlow();
+    const components = graph.getComponents();
+    const compOf = new Map<CallGraphNode, number>();
+    components.forEach((c, ci) => { for (const n of c.nodes) compOf.set(n, ci); });
+
+    const members: number[][] = components.map(() => []);
+    const unplaced: number[] = [];            // Functions not in the graph run unconstrained
+    const scope = conf.symboltab.getGlobalScope();
+    this.functionNames.forEach((name, idx) => {
+      if (done[idx]) return;
+      const fd = scope.queryFunction(name);
+      const node = fd !== null ? graph.findNode(fd.getAddress()) : null;
+      if (node === null) unplaced.push(idx);
+      else members[compOf.get(node)!].push(idx);
+    });
+
+    // Components without scheduled functions are skipped; their callees are not waited on
+    const batchOfComp = new Array<number>(components.length).fill(-1);
+    const batches: number[][] = [];
+    members.forEach((m, ci) => {
+      if (m.length === 0) return;
+      batchOfComp[ci] = batches.length;
+      batches.push(m);
+    });
+    for (const idx of unplaced) batches.push([idx]);
+
+    const deps: number[][] = batches.map(() => []);
+    components.forEach((c, ci) => {
+      const bi = batchOfComp[ci];
+      if (bi < 0) return;
+      for (const callee of c.callees) {
+        if (batchOfComp[callee] >= 0) deps[bi].push(batchOfComp[callee]);
+      }
+    });
+
+    // Most expensive first, so the longest components start as early as they can
+    const costs = estimateFunctionCosts(this.functionNames, this.functionSizes, this.options.costHints);
+    const batchCost = batches.map(b => b.reduce((sum, idx) => sum + costs[idx], 0));
+    const order = batches.map((_b, i) => i).sort((a, b) => batchCost[b] - batchCost[a] || a - b);
+    const position = new Array<number>(batches.length);
+    order.forEach((bi, pos) => { position[bi] = pos; });
+    const dependents: number[][] = batches.map(() => []);
+    const waiting = new Array<number>(batches.length).fill(0);
+    deps.forEach((list, bi) => {
+      waiting[position[bi]] = list.length;
+      for (const d of list) dependents[position[d]].push(position[bi]);
+    });
+    this.log(`Call graph: ${graph.numNodes()} functions in ${components.length} components` +
+             ` (${(performance.now() - start).toFixed(0)}ms)\n`);
+    return { batches: order.map(bi => batches[bi]), waiting, dependents };
+  }
+
+  /**
+   * Answer what can be answered from the result cache, using the parent's Architecture.
+   * @returns the cache key of each function (null if it was a hit or cannot be cached)
+   */
+  private lookupCached(conf: any, deliver: (index: number, result: WorkerDecompileResult) => void): (string | null)[] {
+    const cache = this.options.resultCache!;
+    const scope = conf.symboltab.getGlobalScope();
+    return this.functionNames.map((name, idx) => {
+      const fd = scope.queryFunction(name);
+      if (fd === null) return null;
+      const key = cache.keyOf(conf, fd, this.functionCommands[idx]);
+      const output = cache.lookup(conf, key);
+      if (output === null) return key;
+      deliver(idx, { name, output, timeMs: 0, success: true, workerId: -1, cached: true });
+      return null;
+    });
+  }
+
+  /**
+   * Build the Architecture once and write its load image snapshot to a shared file.
+   * The core data-types travel with the snapshot in the init message.
+   * Returns a null path (children fall back to parsing the XML) if the snapshot cannot be
+   * built. The Architecture itself is returned for result cache lookups.
+   */
+  private prepareSnapshot(): { path: string | null; conf: any; coreTypes: CoreTypeTable | null } {
+    let conf: any = null;
+    try {
+      const start = performance.now();
+      conf = buildDocumentArchitecture(this.storage, this.document, { write: () => {} });
+      const snapshot = encodeArchitectureSnapshot(conf);
+      const coreTypes = encodeCoreTypeTable(conf);
+      const path = writeSnapshotFile(snapshot);
+      this.log(
+        `Architecture snapshot: ${(snapshot.length / 1024).toFixed(0)} KB` +
+        ` (${(performance.now() - start).toFixed(0)}ms)\n`
+      );
+      // Cache keys must see the Architecture as the workers will have it
+      if (this.enhancedDisplay) conf.applyEnhancedDisplay();
+      if (this.options.root !== undefined) conf.allacts.setCurrent(this.options.root);
+      return { path, conf, coreTypes };
+    } catch (err: any) {
+      this.log(`Architecture snapshot failed, workers will parse XML: ${err.explain ?? err.message ?? String(err)}\n`);
+      return { path: null, conf, coreTypes: null };
+    }
+  }
+
   /**
    * Decompile all functions using child processes.
    *
    * Returns results in the same order as the functions appear in the XML.
-   * Work is distributed via a work-stealing queue: when a child finishes,
-   * it gets the next unprocessed function.
+   * This collects decompileStream(); prefer the stream for large binaries.
    */
   async decompileAll(): Promise<WorkerDecompileResult[]> {
-    if (this.functionNames.length === 0) return [];
+    const ordered: WorkerDecompileResult[] = [];
+    for await (const r of this.decompileStream({ ordered: true, maxPending: Infinity })) {
+      ordered.push(r);
+    }
+    return ordered;
+  }
+
+  /**
+   * Decompile all functions using child processes, yielding results as they finish.
+   *
+   * Batches are handed out most expensive first; when a child finishes its batch, it gets
+   * the next one from the queue. No new batch is dispatched while maxPending results are
+   * waiting to be consumed, so the parent's memory is bounded by how fast the consumer
+   * drains the stream. With ordered set, results are yielded in XML order through a reorder
+   * buffer; when that buffer is full, only the batch holding the next result in order may
+   * still be dispatched, which guarantees progress.
+   */
+  async *decompileStream(opts: WorkerStreamOptions = {}): AsyncGenerator<WorkerDecompileResult> {
+    if (this.functionNames.length === 0) return;
+    const ordered = opts.ordered ?? false;
+    const maxPending = opts.maxPending ?? 256;
 
     const workerEntryPath = resolve(__dirname, 'worker_entry.ts');
-    const actualWorkerCount = Math.min(this.workerCount, this.functionNames.length);
+    const total = this.functionNames.length;
+    const actualWorkerCount = Math.min(this.workerCount, total);
     const children: ChildProcess[] = [];
+    // Lane 0 of the parent is the scheduler, lane i+1 follows worker i
+    const tracer = this.options.trace !== undefined ? new EventTracer('parent') : null;
+    if (tracer !== null) {
+      tracer.nameThread(0, 'scheduler');
+      for (let i = 0; i < actualWorkerCount; i++) tracer.nameThread(i + 1, `worker ${i}`);
+      tracer.observeGc();
+    }
+    let traceStart = EventTracer.now();
+    const { path: snapshotPath, conf, coreTypes } = this.prepareSnapshot();
+    tracer?.complete('snapshot', 'scheduler', traceStart);
 
-    return new Promise<WorkerDecompileResult[]>((resolve, reject) => {
-      const results = new Map<string, WorkerDecompileResult>();
-      const queue = [...this.functionNames];
-      let completed = 0;
-      let initErrors = 0;
-      let resolved = false;
-      const inFlight = new Map<number, string>(); // workerId → functionName
-
-      const assignNext = (workerId: number): void => {
-        if (queue.length === 0) return;
-        const funcName = queue.shift()!;
-        inFlight.set(workerId, funcName);
-        children[workerId].send({
-          type: 'assign',
-          functionName: funcName,
-        });
-      };
+    this.utilization = [];
+    for (let i = 0; i < actualWorkerCount; i++) {
+      this.utilization.push({ workerId: i, functions: 0, batches: 0, busyMs: 0, finishMs: 0, utilization: 0,
+                              peakRssMb: 0, recycled: 0 });
+    }
 
-      const finish = (): void => {
-        if (resolved) return;
-        resolved = true;
-        // Shut down all children
-        for (const child of children) {
-          try { child.send({ type: 'shutdown' }); } catch {}
-        }
-        // Return results in original order
-        const ordered = this.functionNames.map(name =>
-          results.get(name) ?? {
-            name,
-            output: '',
-            timeMs: 0,
-            success: false,
-            error: 'No result received',
-            workerId: -1,
-          }
-        );
-        resolve(ordered);
-      };
+    const done = new Array<boolean>(total).fill(false);
+    const reorder = new Map<number, WorkerDecompileResult>();
+    let nextOrdered = 0;                                   // Next index to release in ordered mode
+    const ready: WorkerDecompileResult[] = [];             // Released, not yet consumed
+    let completed = 0;
+    let initErrors = 0;
+    let failure: Error | null = null;
+    let alive = actualWorkerCount;
+    let dispatchStart = -1;
+    const inFlight = new Map<number, { batch: number[]; pos: number; start: number }>();
+    const spawnStart: number[] = [];                       // Trace time each worker was forked
+    const idleStart: number[] = [];                        // Trace time each worker went idle, or 0
+    const idle = new Set<number>();
+    let graphSchedule: CallGraphSchedule | null = null;  // Set in call graph order
+    let left: number[] = [];                               // Unfinished functions of each batch
+    const requeued: number[][] = [];                       // Functions taken back from stopped workers
+    const crashes = new Array<number>(total).fill(0);     // Workers lost while running each function
+    const protos: { name: string; proto: any }[] = [];     // Forwarded prototypes, replayed to new workers
+    const recycleRss = this.options.recycleRssMb ?? 0;
+    let closing = false;                                   // Set once the children are being shut down
+    let wake: (() => void) | null = null;
 
-      const checkDone = (): void => {
-        if (completed >= this.functionNames.length) {
-          finish();
+    const notify = (): void => {
+      if (wake !== null) {
+        const w = wake;
+        wake = null;
+        w();
+      }
+    };
+
+    /** Get the first batch in schedule order whose callees are all done, or -1 */
+    const nextReady = (): number => {
+      while (nextBatch < schedule.length && dispatched[nextBatch]) nextBatch++;
+      if (waiting === null) return nextBatch < schedule.length ? nextBatch : -1;
+      for (let bi = nextBatch; bi < schedule.length; ++bi) {
+        if (!dispatched[bi] && waiting[bi] === 0) return bi;
+      }
+      return -1;
+    };
+
+    /** Pick the batch a worker should run next, or -1 to leave it idle */
+    const chooseBatch = (): number => {
+      if (ready.length + reorder.size < maxPending) return nextReady();
+      // Backpressure: only the batch that unblocks the reorder buffer may go
+      if (ordered && nextOrdered < total && !dispatched[batchOf[nextOrdered]] &&
+          (waiting === null || waiting[batchOf[nextOrdered]] === 0)) {
+        return batchOf[nextOrdered];
+      }
+      // That batch may itself wait on callees; let those run once nothing else is
+      if (waiting !== null && inFlight.size === 0) return nextReady();
+      return -1;
+    };
+
+    const assignNext = (workerId: number): void => {
+      // Functions taken back from a stopped worker were admitted already, so they go first
+      const bi = requeued.length > 0 ? -1 : chooseBatch();
+      if (bi < 0 && requeued.length === 0) {
+        if (tracer !== null && !idle.has(workerId)) idleStart[workerId] = EventTracer.now();
+        idle.add(workerId);
+        return;
+      }
+      idle.delete(workerId);
+      if (tracer !== null && idleStart[workerId] > 0) {
+        tracer.complete('starved', 'scheduler', idleStart[workerId], undefined, workerId + 1);
+        idleStart[workerId] = 0;
+      }
+      let batch: number[];
+      if (bi >= 0) {
+        dispatched[bi] = true;
+        batch = schedule[bi];
+      } else {
+        batch = requeued.shift()!;
+      }
+      if (dispatchStart < 0) dispatchStart = performance.now();
+      inFlight.set(workerId, { batch, pos: 0, start: tracer !== null ? EventTracer.now() : 0 });
+      this.utilization[workerId].batches++;
+      children[workerId].send({
+        type: 'assign',
+        functionNames: batch.map(idx => this.functionNames[idx]),
+      });
+    };
+
+    const pump = (): void => {
+      for (const workerId of [...idle]) assignNext(workerId);
+    };
+
+    const deliver = (index: number, result: WorkerDecompileResult): void => {
+      if (done[index]) return;
+      done[index] = true;
+      completed++;
+      if (graphSchedule !== null) {
+        // Once a whole component is done, its callers may go
+        const bi = batchOf[index];
+        if (--left[bi] === 0) {
+          for (const d of graphSchedule.dependents[bi]) graphSchedule.waiting[d]--;
         }
-      };
+      }
+      if (!ordered) {
+        ready.push(result);
+      } else {
+        reorder.set(index, result);
+        while (reorder.has(nextOrdered)) {
+          ready.push(reorder.get(nextOrdered)!);
+          reorder.delete(nextOrdered);
+          nextOrdered++;
+        }
+      }
+      notify();
+    };
 
-      for (let i = 0; i < actualWorkerCount; i++) {
-        const child = fork(workerEntryPath, [], {
-          stdio: ['pipe', 'pipe', 'pipe', 'ipc'],
-        });
+    // Cache hits are delivered up front and never scheduled
+    traceStart = EventTracer.now();
+    let cache = this.options.resultCache ?? null;
+    if (cache !== null && this.options.callGraphOrder) {
+      this.log('Result cache not used: cached functions cannot feed their prototypes forward\n');
+      cache = null;
+    }
+    const cacheKeys = cache !== null && conf !== null ? this.lookupCached(conf, deliver) : null;
+    if (this.options.callGraphOrder && conf !== null)
+      graphSchedule = this.buildCallGraphSchedule(conf, done);
+    const schedule = graphSchedule !== null ? graphSchedule.batches : this.buildSchedule(actualWorkerCount, done);
+    const waiting = graphSchedule !== null ? graphSchedule.waiting : null;
+    left = schedule.map(b => b.length);
+    // Only read the XML text when the workers cannot start from a snapshot
+    const fallbackXml = snapshotPath === null && schedule.length > 0
+      ? fs.readFileSync(this.xmlPath, 'utf-8') : undefined;
+    this.log(`Scheduled ${total - completed} functions in ${schedule.length} batches` +
+             (cache !== null ? ` (${completed} from cache)` : '') + '\n');
 
-        // Suppress child stdout/stderr (or pipe to writer)
-        child.stdout?.on('data', () => {});
-        child.stderr?.on('data', (data: Buffer) => {
-          // Log stderr from children for debugging
-          const msg = data.toString().trim();
-          if (msg && !msg.includes('ExperimentalWarning')) {
-            this.log(`Worker ${i} stderr: ${msg}\n`);
-          }
-        });
+    const batchOf = new Array<number>(total);             // function index → batch index
+    schedule.forEach((batch, bi) => { for (const idx of batch) batchOf[idx] = bi; });
+    const dispatched = new Array<boolean>(schedule.length).fill(false);
+    let nextBatch = 0;                                     // Next batch in schedule order
+    tracer?.complete('schedule', 'scheduler', traceStart, { batches: schedule.length, cached: completed });
 
-        child.on('message', (msg: any) => {
-          if (msg.type === 'ready') {
-            this.log(`Worker ${i} ready\n`);
-            assignNext(i);
-          } else if (msg.type === 'result') {
-            inFlight.delete(i);
-            results.set(msg.name, {
-              name: msg.name,
-              output: msg.output,
-              timeMs: msg.timeMs,
-              success: msg.success,
-              error: msg.error,
-              workerId: msg.workerId,
-            });
-            completed++;
-            this.log(
-              `[${completed}/${this.functionNames.length}] ${msg.name}` +
-              ` (${msg.timeMs.toFixed(0)}ms, w${msg.workerId})` +
-              (msg.success ? '' : ` FAILED: ${msg.error}`) + '\n'
-            );
-            assignNext(i);
-            checkDone();
-          } else if (msg.type === 'init_error') {
-            initErrors++;
-            this.log(`Worker ${i} init failed: ${msg.error}\n`);
-            if (initErrors >= actualWorkerCount && !resolved) {
-              resolved = true;
-              reject(new Error(`All ${actualWorkerCount} workers failed to initialize`));
-            }
-          }
+    /** Fail every unfinished function of the worker's current batch */
+    const failInFlight = (workerId: number, error: string): void => {
+      const cur = inFlight.get(workerId);
+      if (cur === undefined) return;
+      inFlight.delete(workerId);
+      for (let k = cur.pos; k < cur.batch.length; k++) {
+        const idx = cur.batch[k];
+        deliver(idx, {
+          name: this.functionNames[idx],
+          output: '',
+          timeMs: 0,
+          success: false,
+          error,
+          workerId,
         });
+      }
+    };
 
-        child.on('error', (err: Error) => {
-          this.log(`Worker ${i} error: ${err.message}\n`);
-          const funcName = inFlight.get(i);
-          if (funcName) {
+    /**
+     * Take back the unfinished functions of the worker's current batch, for the next worker.
+     * After a crash, the function that was running is charged with it, and fails instead if
+     * it already brought down another worker.
+     */
+    const requeueInFlight = (workerId: number, crashed: string | null): void => {
+      const cur = inFlight.get(workerId);
+      if (cur === undefined) return;
+      inFlight.delete(workerId);
+      const rest: number[] = [];
+      for (let k = cur.pos; k < cur.batch.length; k++) {
+        const idx = cur.batch[k];
+        if (crashed !== null && k === cur.pos && crashes[idx]++ > 0) {
+          deliver(idx, { name: this.functionNames[idx], output: '', timeMs: 0, success: false,
+                         error: crashed, workerId });
+        } else {
+          rest.push(idx);
+        }
+      }
+      if (rest.length > 0) requeued.push(rest);
+    };
+
+    /** Start worker i, replacing the process it had before if any */
+    const spawnWorker = (i: number): void => {
+      spawnStart[i] = EventTracer.now();
+      idleStart[i] = 0;
+      let started = false;                                 // Set once this process is ready
+      const child = fork(workerEntryPath, [], {
+        stdio: ['pipe', 'pipe', 'pipe', 'ipc'],
+      });
+
+      // Suppress child stdout/stderr (or pipe to writer)
+      child.stdout?.on('data', () => {});
+      child.stderr?.on('data', (data: Buffer) => {
+        // Log stderr from children for debugging
+        const msg = data.toString().trim();
+        if (msg && !msg.includes('ExperimentalWarning')) {
+          this.log(`Worker ${i} stderr: ${msg}\n`);
+        }
+      });
+
+      child.on('message', (msg: any) => {
+        if (children[i] !== child) return;               // Recycled; its work went to another
+        if (msg.type === 'ready') {
+          started = true;
+          this.log(`Worker ${i} ready\n`);
+          tracer?.complete('spawn', 'scheduler', spawnStart[i], undefined, i + 1);
+          assignNext(i);
+        } else if (msg.type === 'result') {
+          const cur = inFlight.get(i);
+          if (cur === undefined) return;
+          const idx = cur.batch[cur.pos++];
+          const util = this.utilization[i];
+          util.functions++;
+          util.busyMs += msg.timeMs;
+          util.finishMs = performance.now() - dispatchStart;
+          util.peakRssMb = Math.max(util.peakRssMb, msg.rssMb ?? 0);
+          this.log(
+            `[${completed + 1}/${total}] ${msg.name}` +
+            ` (${msg.timeMs.toFixed(0)}ms, w${msg.workerId})` +
+            (msg.success ? '' : ` FAILED: ${msg.error}`) + '\n'
+          );
+          if (cur.pos >= cur.batch.length) {
             inFlight.delete(i);
-            if (!results.has(funcName)) {
-              results.set(funcName, {
-                name: funcName,
-                output: '',
-                timeMs: 0,
-                success: false,
-                error: `Worker crashed: ${err.message}`,
-                workerId: i,
-              });
-              completed++;
+            tracer?.complete('batch', 'scheduler', cur.start, { functions: cur.batch.length }, i + 1);
+          }
+          if (cacheKeys !== null && msg.success && cacheKeys[idx] !== null) {
+            cache!.store(cacheKeys[idx]!, msg.deps ?? null, msg.output);
+          }
+          if (msg.proto !== undefined) {
+            // Every worker locks the prototype before it can be sent any caller
+            protos.push({ name: msg.name, proto: msg.proto });
+            for (const other of children) {
+              if (other.connected) other.send({ type: 'proto', name: msg.name, proto: msg.proto });
             }
-            checkDone();
           }
-        });
+          deliver(idx, {
+            name: msg.name,
+            output: msg.output,
+            timeMs: msg.timeMs,
+            success: msg.success,
+            error: msg.error,
+            budgetExceeded: msg.budgetExceeded,
+            workerId: msg.workerId,
+          });
+          if (recycleRss > 0 && msg.rssMb > recycleRss && completed < total) recycle(i, msg.rssMb);
+          else if (!inFlight.has(i)) assignNext(i);
+          if (waiting !== null || requeued.length > 0) pump();   // Callers or taken back functions may go
+        } else if (msg.type === 'init_error') {
+          initErrors++;
+          this.log(`Worker ${i} init failed: ${msg.error}\n`);
+          if (initErrors >= actualWorkerCount && failure === null) {
+            failure = new Error(`All ${actualWorkerCount} workers failed to initialize`);
+            notify();
+          }
+        }
+      });
 
-        child.on('exit', (_code) => {
-          const funcName = inFlight.get(i);
-          if (funcName) {
-            inFlight.delete(i);
-            if (!results.has(funcName)) {
-              results.set(funcName, {
-                name: funcName,
+      child.on('error', (err: Error) => {
+        if (children[i] !== child) return;
+        this.log(`Worker ${i} error: ${err.message}\n`);
+        failInFlight(i, `Worker crashed: ${err.message}`);
+      });
+
+      child.on('exit', (_code) => {
+        if (children[i] !== child) return;
+        idle.delete(i);
+        if (recycleRss > 0 && started && !closing && completed < total) {
+          // Most likely out of memory: replace it, and give its work to the next worker
+          this.log(`Worker ${i} exited unexpectedly, restarting\n`);
+          this.utilization[i].recycled++;
+          requeueInFlight(i, 'Worker exited unexpectedly');
+          spawnWorker(i);
+          pump();
+          return;
+        }
+        alive--;
+        failInFlight(i, 'Worker exited unexpectedly');
+        if (alive === 0) {
+          // Nobody is left to run the remaining batches
+          for (let idx = 0; idx < total; idx++) {
+            if (!done[idx]) {
+              deliver(idx, {
+                name: this.functionNames[idx],
                 output: '',
                 timeMs: 0,
                 success: false,
-                error: 'Worker exited unexpectedly',
-                workerId: i,
+                error: 'No result received',
+                workerId: -1,
               });
-              completed++;
             }
-            checkDone();
           }
-        });
+        }
+      });
 
-        children.push(child);
+      children[i] = child;
 
-        // Send init message with XML data
-        child.send({
-          type: 'init',
-          xmlString: this.xmlString,
-          workerId: i,
-          enhancedDisplay: this.enhancedDisplay,
-        });
+      // Send init message with the snapshot location (or the XML data as a fallback)
+      child.send({
+        type: 'init',
+        snapshotPath: snapshotPath ?? undefined,
+        coreTypes: snapshotPath !== null ? coreTypes ?? undefined : undefined,
+        xmlString: fallbackXml,
+        workerId: i,
+        enhancedDisplay: this.enhancedDisplay,
+        root: this.options.root,
+        budget: { timeMs: this.options.timeLimitMs, heapGrowthMb: this.options.heapGrowthMb },
+        profile: this.profile !== null,
+        trace: tracer !== null,
+        cacheDeps: cacheKeys !== null,
+        feedForward: waiting !== null,
+        tokenStream: this.options.tokenStream === true,
+      });
+      // A replacement must know the prototypes locked so far before it is sent any caller
+      for (const p of protos) child.send({ type: 'proto', name: p.name, proto: p.proto });
+    };
+
+    /** Replace a worker that has grown past recycleRssMb, taking back its unfinished work */
+    const recycle = (workerId: number, rssMb: number): void => {
+      this.log(`Worker ${workerId} at ${rssMb.toFixed(0)} MB RSS, recycling\n`);
+      tracer?.instant('recycle', 'scheduler', { rssMb: Math.round(rssMb) }, workerId + 1);
+      this.utilization[workerId].recycled++;
+      requeueInFlight(workerId, null);
+      const old = children[workerId];
+      spawnWorker(workerId);
+      old.kill();
+    };
+
+    // No workers are needed if every function came from the cache
+    const workersToStart = schedule.length > 0 ? actualWorkerCount : 0;
+    for (let i = 0; i < workersToStart; i++) spawnWorker(i);
+
+    let yielded = 0;
+    try {
+      while (yielded < total) {
+        if (failure !== null) throw failure;
+        if (ready.length === 0) {
+          await new Promise<void>(res => { wake = res; });
+          continue;
+        }
+        const r = ready.shift()!;
+        yielded++;
+        yield r;
+        pump();     // The consumer made room; restart idle workers
       }
-    });
+    } finally {
+      if (snapshotPath !== null) removeSnapshotFile(snapshotPath);
+      if (this.profile !== null) {
+        await this.collectFromChildren(children, 'profile', (data: any) => this.profile!.merge(data));
+      }
+      if (tracer !== null) {
+        await this.collectFromChildren(children, 'trace', (events: TraceEvent[]) => tracer.merge(events));
+        tracer.stopGc();
+        tracer.write(this.options.trace!);
+        this.log(`Trace written to ${this.options.trace}\n`);
+      }
+      // Shut down all children
+      closing = true;
+      for (const child of children) {
+        try { child.send({ type: 'shutdown' }); } catch {}
+      }
+      this.reportUtilization(dispatchStart < 0 ? 0 : performance.now() - dispatchStart);
+      if (cache !== null) this.log(cache.formatStats() + '\n');
+    }
+  }
+
+  /**
+   * Callback form of decompileStream(). The next result is not delivered until the
+   * promise returned by onResult settles, which carries backpressure to the workers.
+   */
+  async decompileEach(
+    onResult: (r: WorkerDecompileResult) => void | Promise<void>,
+    opts?: WorkerStreamOptions,
+  ): Promise<void> {
+    for await (const r of this.decompileStream(opts)) {
+      await onResult(r);
+    }
+  }
+
+  /**
+   * Ask every live child for its profile or trace, and hand each non-null answer to onData.
+   * @param type is the request, answered by a message of the same type
+   */
+  private async collectFromChildren(children: ChildProcess[], type: 'profile' | 'trace',
+                                    onData: (data: any) => void): Promise<void> {
+    await Promise.all(children.map(child => new Promise<void>(resolve => {
+      if (child.exitCode !== null || !child.connected) {
+        resolve();
+        return;
+      }
+      const timer = setTimeout(done, 5000);
+      function done(): void {
+        clearTimeout(timer);
+        child.off('message', onMessage);
+        child.off('exit', done);
+        resolve();
+      }
+      const onMessage = (msg: any): void => {
+        if (msg.type !== type) return;
+        const data = type === 'profile' ? msg.data : msg.events;
+        if (data !== null) onData(data);
+        done();
+      };
+      child.on('message', onMessage);
+      child.once('exit', done);
+      try {
+        child.send({ type });
+      } catch {
+        done();
+      }
+    })));
+  }
+
+  /** Fill in utilization ratios and log a one-line summary per worker. */
+  private reportUtilization(wallMs: number): void {
+    for (const u of this.utilization) {
+      u.utilization = wallMs > 0 ? u.busyMs / wallMs : 0;
+      this.log(
+        `Worker ${u.workerId}: ${u.functions} functions in ${u.batches} batches,` +
+        ` busy ${u.busyMs.toFixed(0)}ms, done at ${u.finishMs.toFixed(0)}ms,` +
+        ` utilization ${(u.utilization * 100).toFixed(1)}%, peak RSS ${u.peakRssMb.toFixed(0)} MB` +
+        (u.recycled > 0 ? `, recycled ${u.recycled}x` : '') + '\n'
+      );
+    }
   }
 
   private log(msg: string): void {
@@ -12,6 +12,8 @@ import {
   AttributeId,
   ElementId,
   Encoder,
+  PackedEncode,
+  XmlEncode,
   ATTRIB_CONTENT,
   ATTRIB_ID,
   ATTRIB_NAME,
@@ -281,6 +283,8 @@ export abstract class Emit {
 
   setMarkup(_val: boolean): void {}
   setPackedOutput(_val: boolean): void {}
+  /** Replace the back-end emitter, for emitters that pass tokens on to one */
+  setLowlevel(_low: Emit): void {}
 
   spaces(num: int4, bump: int4 = 0): void {
     const spacearray = ["", " ", "  ", "   ", "    ", "     ", "      ", "       ",
@@ -580,15 +584,19 @@ export class EmitMarkup extends Emit {
     this.parenlevel -= 1;
   }
 
+  /** The encoders buffer their output, so hand what they hold to the stream */
+  flush(): void {
+    if (this.s === null) return;
+    if (this.encoder instanceof XmlEncode || this.encoder instanceof PackedEncode) {
+      this.s.write(this.encoder.toString());
+      this.encoder.clear();
+    }
+  }
+
   setOutputStream(t: Writer | null): void {
     this.s = t;
-    if (t !== null) {
-      // By default create a PackedEncode; we can't import it directly without
-      // circular deps, so we use the encoder factory pattern here.
-      // For now, encoder must be set separately or via setPackedOutput/setMarkup.
-      // The C++ code does: encoder = new PackedEncode(*s);
-      // We leave encoder as-is since the caller is expected to set it.
-    }
+    if (t !== null && this.encoder === null)
+      this.encoder = new PackedEncode();
   }
 
   getOutputStream(): Writer | null { return this.s; }
@@ -601,9 +609,11 @@ export class EmitMarkup extends Emit {
     return this.encoder;
   }
 
-  setPackedOutput(_val: boolean): void {
-    // In the C++ code this switches between PackedEncode and XmlEncode.
-    // The caller should set the encoder directly via setEncoder().
+  setPackedOutput(val: boolean): void {
+    if (val)
+      this.encoder = new PackedEncode();
+    else
+      this.encoder = new XmlEncode(false);
   }
 
   emitsMarkup(): boolean { return true; }
@@ -1216,9 +1226,6 @@ export class circularqueue<T> {
    */
   expand(amount: int4): void {
     const newcache = new Array<T>(this.max + amount);
-    for (let k = 0; k < this.max + amount; k++) {
-      newcache[k] = this.factory();
-    }
 
     let i = this.left;
     let j = 0;
@@ -1233,6 +1240,15 @@ export class circularqueue<T> {
     this.left = 0;
     this.right = j;
 
+    // Slots outside the queue keep their pooled objects, so only amount new ones are made
+    let k = j + 1;
+    while (k < this.max) {
+      i = (i + 1) % this.max;
+      newcache[k++] = this.cache[i];
+    }
+    while (k < this.max + amount)
+      newcache[k++] = this.factory();
+
     this.cache = newcache;
     this.max += amount;
   }
@@ -1471,6 +1487,63 @@ export class EmitPrettyPrint extends Emit {
     }
   }
 
+  /**
+   * Output the given token to the low-level emitter, when there is no maximum line size.
+   *
+   * Only explicit line breaks end a line, so there is nothing to measure and each token is
+   * printed as soon as it is issued. Indent levels are kept in the same form as printToken(),
+   * as space remaining, counting down from a line size of 0.
+   */
+  private printUnbounded(tok: TokenSplit): void {
+    switch (tok.getClass()) {
+      case printclass.ignore:
+        tok.printToEmit(this.lowlevel);
+        break;
+      case printclass.begin_indent:
+        this.indentstack.push(this.indentstack[this.indentstack.length - 1] - tok.getIndentBump());
+        break;
+      case printclass.begin_comment:
+        this.commentmode = true;
+        // falls through
+      case printclass.begin:
+        tok.printToEmit(this.lowlevel);
+        this.indentstack.push(this.spaceremain);
+        break;
+      case printclass.end_indent:
+        if (this.indentstack.length === 0)
+          throw new LowlevelError("indent error");
+        this.indentstack.pop();
+        break;
+      case printclass.end_comment:
+        this.commentmode = false;
+        // falls through
+      case printclass.end:
+        tok.printToEmit(this.lowlevel);
+        this.indentstack.pop();
+        break;
+      case printclass.tokenstring:
+        tok.printToEmit(this.lowlevel);
+        this.spaceremain -= tok.getSize();
+        break;
+      case printclass.tokenbreak:
+        if (tok.getTag() === tag_type.spac_t) {
+          this.lowlevel.spaces(tok.getNumSpaces());
+          this.spaceremain -= tok.getNumSpaces();
+          break;
+        }
+        if (tok.getTag() === tag_type.line_t)
+          this.spaceremain = -tok.getIndentBump();
+        else
+          this.spaceremain = this.indentstack[this.indentstack.length - 1] - tok.getIndentBump();
+        this.lowlevel.tagLineWithIndent(-this.spaceremain);
+        if (this.commentmode && (this.commentfill.length !== 0)) {
+          this.lowlevel.print(this.commentfill, syntax_highlight.comment_color);
+          this.spaceremain -= this.commentfill.length;
+        }
+        break;
+    }
+  }
+
   /**
    * Emit tokens that have been fully committed.
    */
@@ -1499,6 +1572,10 @@ export class EmitPrettyPrint extends Emit {
    * Process a new token. This is the heart of the pretty printing algorithm.
    */
   private scan(): void {
+    if (this.maxlinesize === 0) {   // No line breaking, the token is the only one queued
+      this.printUnbounded(this.tokqueue.popbottom());
+      return;
+    }
     if (this.tokqueue.empty())   // If we managed to overflow queue
       this.expand();             // Expand it
     // Delay creating reference until after the possible expansion
@@ -1903,12 +1980,28 @@ export class EmitPrettyPrint extends Emit {
     this.lowlevel.setOutputStream(t);
   }
 
+  /** Replace the low-level emitter with the given one, which takes over the output stream */
+  setLowlevel(low: Emit): void {
+    const t = this.lowlevel.getOutputStream();
+    this.lowlevel = low;
+    this.lowlevel.setOutputStream(t);
+  }
+
+  /**
+   * Set the maximum number of characters per line.
+   *
+   * A size of 0 means lines are never broken, except where the language asks for it.
+   * Tokens then go straight to the low-level emitter, bypassing the token queue.
+   * @param val is the number of characters, or 0
+   */
   setMaxLineSize(val: int4): void {
-    if ((val < 20) || (val > 10000))
+    if ((val !== 0) && ((val < 20) || (val > 10000)))
       throw new LowlevelError("Bad maximum line size");
     this.maxlinesize = val;
-    this.scanqueue.setMax(3 * val);
-    this.tokqueue.setMax(3 * val);
+    if (val !== 0) {
+      this.scanqueue.setMax(3 * val);
+      this.tokqueue.setMax(3 * val);
+    }
     this.spaceremain = this.maxlinesize;
     this.clear();
   }
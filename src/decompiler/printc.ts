@@ -34,6 +34,8 @@ import {
   namespace_strategy,
 } from './printlanguage.js';
 import { type_metatype } from './type.js';
+import { ActionProfiler } from './actionprofile.js';
+import { EventTracer } from './eventtrace.js';
 
 // =========================================================================
 // Forward type declarations for types not yet translated
@@ -3035,6 +3037,10 @@ export class PrintC extends PrintLanguage {
       throw new LowlevelError("Function not decompiled");
     if (!this.isSet(modifiers.flat) && fd.hasNoStructBlocks())
       throw new LowlevelError("Function not fully decompiled. No structure present.");
+    const prof = ActionProfiler.active;
+    const start = prof !== null ? performance.now() : 0;
+    const tracer = EventTracer.active;
+    const traceStart = tracer !== null ? EventTracer.now() : 0;
     try {
       this.convertedGotoTargets.clear();
       this.gotoTargetRefCount.clear();
@@ -3059,6 +3065,10 @@ export class PrintC extends PrintLanguage {
       this.emit.endFunction(id1);
       this.emit.flush();
       this.mods = modsave;
+      if (prof !== null)
+        prof.addPhase('print', performance.now() - start, fd);
+      if (tracer !== null)
+        tracer.complete('print', 'phase', traceStart, { function: fd.getName() });
     } catch (err) {
       this.clear();
       throw err;
@@ -16,6 +16,7 @@ import {
   syntax_highlight,
   type Writer,
 } from './prettyprint.js';
+import { EmitPackedTokens } from './tokenstream.js';
 
 // =========================================================================
 // Forward type declarations (types not yet available from other modules)
@@ -1161,7 +1162,8 @@ export abstract class PrintLanguage {
    * @param val is the number of characters
    */
   setLineCommentIndent(val: int4): void {
-    if ((val < 0) || (val >= this.emit.getMaxLineSize()))
+    const mls = this.emit.getMaxLineSize();
+    if ((val < 0) || ((mls > 0) && (val >= mls)))
       throw new LowlevelError("Bad comment indent value");
     this.line_commentindent = val;
   }
@@ -1219,6 +1221,19 @@ export abstract class PrintLanguage {
     this.emit.setPackedOutput(val);
   }
 
+  /**
+   * Turn on/off the packed token stream.
+   *
+   * The stream carries the same markup as setMarkup(true), as a binary encoding with
+   * interned strings and addresses (see EmitPackedTokens). Turning it off also turns off markup.
+   */
+  setTokenOutput(val: boolean): void {
+    if (val)
+      this.emit.setLowlevel(new EmitPackedTokens());
+    else
+      this.emit.setMarkup(false);
+  }
+
   /**
    * Set whether nesting code structure should be emitted.
    *
@@ -0,0 +1,290 @@
+/**
+ * @file resultcache.ts
+ * @description Persistent, content-addressed cache of decompiler output across runs.
+ *
+ * Re-running the decompiler over a lightly patched binary redoes every function, although
+ * nearly all of them are byte-identical to the previous run. ResultCache stores the printed
+ * C of each function in a directory, and a later run returns it without running the action
+ * tree when nothing the result depends on has changed.
+ *
+ * An entry is found by a key computed before decompilation, from:
+ * - the cache format and decompiler version
+ * - the language id, the current root Action, the option commands issued
+ *   (OptionDatabase.getHistory()) and whether enhanced display is on
+ * - the salt given to the cache, which names the form of the output (console command,
+ *   markup and so on), so caches for different printers can share a directory
+ * - the function's entry point, name and local overrides (override.ts)
+ * - the user comments attached to the function
+ * - the console commands applied before the decompilation, as given by the caller, since
+ *   prototype, type and symbol commands change the result without changing the function
+ *
+ * The entry then records what the decompilation actually read, and is only returned if all
+ * of it is unchanged:
+ * - the address ranges of the function's instructions (the basic block covers) and a
+ *   SHA-256 of their bytes
+ * - for each direct callee, its name and the locked parts of its prototype
+ *
+ * So a patched function misses even though its entry point is unchanged, and a function
+ * whose callee was renamed or retyped is redone. Changes elsewhere in the program that can
+ * still affect the output, such as new global data symbols, are not tracked; use a fresh
+ * cache directory (or the salt) when those change.
+ *
+ * Entry files are written to a temporary name and renamed, as in SlaCache, so concurrent
+ * processes can share a directory. Any read or write failure is treated as a miss.
+ */
+
+import * as fs from 'fs';
+import { createHash } from 'crypto';
+import { join, dirname } from 'path';
+import { fileURLToPath } from 'url';
+import { Address } from '../core/address.js';
+import { XmlEncode } from '../core/marshal.js';
+import { Comment } from './comment.js';
+
+// Forward type declarations
+type Architecture = any;
+type Funcdata = any;
+
+/** Read the decompiler version from package.json, so an upgrade invalidates old entries */
+function readDecompilerVersion(): string {
+  try {
+    const pkg = join(dirname(fileURLToPath(import.meta.url)), '..', '..', 'package.json');
+    return JSON.parse(fs.readFileSync(pkg, 'utf-8')).version ?? 'unknown';
+  } catch {
+    return 'unknown';
+  }
+}
+
+const DECOMPILER_VERSION = readDecompilerVersion();
+
+/**
+ * What a decompilation result depends on, beyond its key.
+ * Plain data, so worker processes can send it to the parent over IPC.
+ */
+export interface ResultDependencies {
+  /** Instruction ranges as [space name, first offset (hex), size in bytes] */
+  ranges: [string, string, number][];
+  /** SHA-256 of the bytes of all ranges, in order */
+  bytes: string;
+  /** Direct callees as [entry point (space:hex), prototype digest] */
+  callees: [string, string][];
+}
+
+/** Contents of one cache file */
+interface ResultEntry {
+  key: string;
+  deps: ResultDependencies;
+  output: string;
+}
+
+/** Hit and miss counts for a ResultCache */
+export interface ResultCacheStats {
+  /** Lookups answered from the cache */
+  hits: number;
+  /** Lookups with no entry for the key */
+  misses: number;
+  /** Lookups whose entry was found but whose bytes or callees had changed */
+  stale: number;
+  /** Entries written */
+  stores: number;
+}
+
+/**
+ * Directory of cached decompiler output, one file per function key.
+ */
+export class ResultCache {
+  /** Bump when the entry layout or the key ingredients change */
+  static readonly FORMAT = 2;
+
+  private directory: string;
+  private salt: string;
+  private stats: ResultCacheStats = { hits: 0, misses: 0, stale: 0, stores: 0 };
+
+  /**
+   * @param directory holds the cache files; it is created on the first store
+   * @param salt is extra text mixed into every key, to separate otherwise identical runs
+   */
+  constructor(directory: string, salt: string = '') {
+    this.directory = directory;
+    this.salt = salt;
+  }
+
+  /**
+   * Compute the lookup key of a function before it is decompiled.
+   * @param arch is the Architecture holding the function
+   * @param fd is the function
+   * @param commands are the console commands applied to the Architecture before decompiling
+   */
+  keyOf(arch: Architecture, fd: Funcdata, commands: readonly string[] = []): string {
+    const hash = createHash('sha256');
+    hash.update('format=' + ResultCache.FORMAT + '\0version=' + DECOMPILER_VERSION + '\0salt=' + this.salt + '\0');
+    hash.update('arch=' + arch.getDescription() + '\0enhanced=' + (arch.enhancedDisplay ? 1 : 0) + '\0');
+    hash.update('root=' + arch.allacts.getCurrentName() + '\0');
+    for (const opt of arch.options.getHistory())
+      hash.update('option=' + opt + '\0');
+    for (const com of commands)
+      hash.update('command=' + com + '\0');
+    const entry: Address = fd.getAddress();
+    hash.update('entry=' + ResultCache.addressKey(entry) + '\0name=' + fd.getName() + '\0');
+    const encoder = new XmlEncode(false);
+    fd.getOverride().encode(encoder, arch);
+    hash.update('override=' + encoder.toString() + '\0');
+    if (arch.commentdb) {
+      const iter = arch.commentdb.beginComment(entry);
+      const last = arch.commentdb.endComment(entry);
+      while (!iter.equals(last)) {
+        const com = iter.value;
+        // Warnings are produced by the decompilation itself
+        if ((com.getType() & (Comment.warning | Comment.warningheader)) === 0)
+          hash.update('comment=' + com.getType() + '@' + ResultCache.addressKey(com.getAddr()) + ':' + com.getText() + '\0');
+        iter.next();
+      }
+    }
+    return hash.digest('hex');
+  }
+
+  /**
+   * Record what a finished decompilation depended on.
+   * @param arch is the Architecture holding the function
+   * @param fd is the decompiled function, before its analysis is cleared
+   * @returns the dependencies, or null if they cannot be read back (so the result is not cached)
+   */
+  static describe(arch: Architecture, fd: Funcdata): ResultDependencies | null {
+    const ranges: [string, string, number][] = [];
+    const bblocks = fd.getBasicBlocks();
+    for (let i = 0; i < bblocks.getSize(); ++i) {
+      const cover = (bblocks.getBlock(i) as any).cover;
+      if (cover === undefined) continue;
+      for (const range of cover.getRanges())
+        ranges.push([range.getSpace().getName(), range.getFirst().toString(16),
+                     Number(range.getLast() - range.getFirst() + 1n)]);
+    }
+    if (ranges.length === 0) return null;
+    ranges.sort((a, b) => a[0] < b[0] ? -1 : a[0] > b[0] ? 1 : BigInt('0x' + a[1]) < BigInt('0x' + b[1]) ? -1 : 1);
+    const bytes = ResultCache.hashRanges(arch, ranges);
+    if (bytes === null) return null;
+    const callees = new Map<string, string>();
+    for (let i = 0; i < fd.numCalls(); ++i) {
+      const addr: Address = fd.getCallSpecs_byIndex(i).getEntryAddress();
+      if (addr.isInvalid()) continue;
+      const key = ResultCache.addressKey(addr);
+      if (!callees.has(key)) callees.set(key, ResultCache.calleeDigest(arch, addr));
+    }
+    return { ranges, bytes, callees: [...callees.entries()].sort((a, b) => a[0] < b[0] ? -1 : 1) };
+  }
+
+  /**
+   * Look up the cached output of a function.
+   * @param arch is the Architecture holding the function, in its current state
+   * @param key is the key from keyOf()
+   * @returns the cached C output, or null on a miss
+   */
+  lookup(arch: Architecture, key: string): string | null {
+    let entry: ResultEntry;
+    try {
+      entry = JSON.parse(fs.readFileSync(this.pathOf(key), 'utf-8'));
+    } catch {
+      this.stats.misses += 1;
+      return null;
+    }
+    if (entry.key !== key || !this.isCurrent(arch, entry.deps)) {
+      this.stats.stale += 1;
+      return null;
+    }
+    this.stats.hits += 1;
+    return entry.output;
+  }
+
+  /**
+   * Save the output of a function.
+   * @param key is the key from keyOf(), computed before decompilation
+   * @param deps are the dependencies from describe(), or null to skip caching
+   * @param output is the printed C
+   */
+  store(key: string, deps: ResultDependencies | null, output: string): void {
+    if (deps === null) return;
+    const entry: ResultEntry = { key, deps, output };
+    const path = this.pathOf(key);
+    const tmp = path + '.' + process.pid + '.tmp';
+    try {
+      fs.mkdirSync(dirname(path), { recursive: true });
+      fs.writeFileSync(tmp, JSON.stringify(entry));
+      fs.renameSync(tmp, path);
+      this.stats.stores += 1;
+    } catch {
+      // Best-effort: the cache is only an optimization
+      try { fs.rmSync(tmp, { force: true }); } catch { /* ignore */ }
+    }
+  }
+
+  /** Get the hit and miss counts since construction */
+  getStats(): ResultCacheStats {
+    return { ...this.stats };
+  }
+
+  /** Format the statistics as a one line summary */
+  formatStats(): string {
+    const s = this.stats;
+    const lookups = s.hits + s.misses + s.stale;
+    const rate = lookups === 0 ? 0 : (100 * s.hits) / lookups;
+    return `Result cache: ${s.hits} hits, ${s.misses} misses, ${s.stale} stale, ${s.stores} stored` +
+      ` (${rate.toFixed(1)}% hit rate)`;
+  }
+
+  /** Check that the bytes and callees an entry depended on are unchanged */
+  private isCurrent(arch: Architecture, deps: ResultDependencies): boolean {
+    if (ResultCache.hashRanges(arch, deps.ranges) !== deps.bytes) return false;
+    for (const [key, digest] of deps.callees) {
+      const sep = key.lastIndexOf(':');
+      const spc = arch.getSpaceByName(key.substring(0, sep));
+      if (spc === null) return false;
+      const addr = new Address(spc, BigInt('0x' + key.substring(sep + 1)));
+      if (ResultCache.calleeDigest(arch, addr) !== digest) return false;
+    }
+    return true;
+  }
+
+  /** Spread entries over 256 subdirectories so no single directory gets too large */
+  private pathOf(key: string): string {
+    return join(this.directory, key.substring(0, 2), key + '.json');
+  }
+
+  private static addressKey(addr: Address): string {
+    return addr.getSpace()!.getName() + ':' + addr.getOffset().toString(16);
+  }
+
+  /** Hash the current load image bytes of a list of ranges, or null if any are unavailable */
+  private static hashRanges(arch: Architecture, ranges: [string, string, number][]): string | null {
+    const hash = createHash('sha256');
+    try {
+      for (const [name, first, size] of ranges) {
+        const spc = arch.getSpaceByName(name);
+        if (spc === null) return null;
+        hash.update(arch.loader.load(size, new Address(spc, BigInt('0x' + first))));
+      }
+    } catch {
+      return null;
+    }
+    return hash.digest('hex');
+  }
+
+  /**
+   * Digest the parts of a callee that a caller's decompilation can depend on: its name and
+   * its prototype if locked. Unlocked prototypes are recovered per call site, so only the
+   * model and the no-return property are included for those.
+   */
+  private static calleeDigest(arch: Architecture, addr: Address): string {
+    const callee = arch.symboltab.getGlobalScope().queryFunction(addr);
+    if (callee === null) return '';
+    const proto = callee.getFuncProto();
+    let res = callee.getName() + '|' + (proto.isNoReturn() ? 'noreturn|' : '');
+    if (proto.isInputLocked() || proto.isOutputLocked()) {
+      const parts: string[] = [];
+      proto.printRaw(callee.getName(), { write: (s: string) => { parts.push(s); } });
+      res += parts.join('');
+    } else {
+      res += proto.getModelName();
+    }
+    return res;
+  }
+}
@@ -0,0 +1,348 @@
+/**
+ * @file tokenstream.ts
+ * @description Compact binary token stream for decompiled output, and its decoder.
+ *
+ * EmitPackedTokens writes the same markup as EmitMarkup (`print C xml`): the same elements,
+ * attributes and nesting, but in the PackedEncode byte format rather than XML. On top of the
+ * packed format two tables keep the stream small:
+ *
+ *   - Strings: the content, name and space attributes of a token are interned. The first
+ *     time a string of INTERN_MIN_LENGTH or more characters appears it is written as a string
+ *     attribute and appended to the string table; each later use is written as an unsigned
+ *     integer attribute (of the same attribute id) holding its table index.
+ *   - Addresses: a comment or label address is written as its space name and offset the first
+ *     time and appended to the address table; later uses are a single `addrref` attribute
+ *     holding the table index.
+ *
+ * Address spaces are written by name, so decoding does not need the Architecture. Strings are
+ * written as UTF-8. Both tables start empty with each flush(), so each flushed chunk (one
+ * function with `print C packed`) decodes on its own. On text channels (the console, the
+ * worker protocol and the service) a chunk is carried base64 encoded.
+ *
+ * decodeTokenStream() turns a chunk back into a tree of TokenNode, and tokenStreamToXml()
+ * renders that tree as the XML that EmitMarkup would have written.
+ */
+
+import type { uintb } from '../core/types.js';
+import { DecoderError } from '../core/error.js';
+import {
+  AttributeId,
+  PackedDecode,
+  PackedEncode,
+  PackedFormat,
+  xml_escape,
+  ATTRIB_CONTENT,
+  ATTRIB_ID,
+  ATTRIB_NAME,
+  ATTRIB_SPACE,
+  type AddrSpace,
+  type ElementId,
+} from '../core/marshal.js';
+import {
+  EmitMarkup,
+  syntax_highlight,
+  type Writer,
+  ATTRIB_BLOCKREF,
+  ATTRIB_CLOSE,
+  ATTRIB_COLOR,
+  ATTRIB_INDENT,
+  ATTRIB_OFF,
+  ATTRIB_OPEN,
+  ATTRIB_OPREF,
+  ATTRIB_VARREF,
+  ATTRIB_SYMREF,
+  ELEM_BREAK,
+  ELEM_CLANG_DOCUMENT,
+  ELEM_FUNCNAME,
+  ELEM_FUNCPROTO,
+  ELEM_LABEL,
+  ELEM_RETURN_TYPE,
+  ELEM_STATEMENT,
+  ELEM_SYNTAX,
+  ELEM_VARDECL,
+  ELEM_VARIABLE,
+  ELEM_FUNCTION,
+  ELEM_BLOCK,
+  ELEM_OP,
+  ELEM_TYPE,
+  ELEM_FIELD,
+  ELEM_COMMENT,
+  ELEM_PP_VALUE,
+} from './prettyprint.js';
+
+/** Reference to an entry of the address table */
+export const ATTRIB_ADDRREF = new AttributeId('addrref', 160);
+
+/** Strings shorter than this are always written in place; a table reference would not be smaller */
+const INTERN_MIN_LENGTH = 2;
+
+/** Attributes whose string values are interned */
+const INTERNED = new Set<number>([ATTRIB_CONTENT.getId(), ATTRIB_NAME.getId(), ATTRIB_SPACE.getId()]);
+
+/** Elements of the markup, by id */
+const ELEMENT_NAMES = new Map<number, string>(
+  [
+    ELEM_BREAK, ELEM_CLANG_DOCUMENT, ELEM_FUNCNAME, ELEM_FUNCPROTO, ELEM_LABEL, ELEM_RETURN_TYPE,
+    ELEM_STATEMENT, ELEM_SYNTAX, ELEM_VARDECL, ELEM_VARIABLE, ELEM_FUNCTION, ELEM_BLOCK, ELEM_OP,
+    ELEM_TYPE, ELEM_FIELD, ELEM_COMMENT, ELEM_PP_VALUE,
+  ].map((el: ElementId) => [el.getId(), el.getName()]),
+);
+
+/** Attributes of the markup, by id (the content attribute is TokenNode.content instead) */
+const ATTRIBUTE_NAMES = new Map<number, string>(
+  [
+    ATTRIB_ID, ATTRIB_NAME, ATTRIB_SPACE, ATTRIB_BLOCKREF, ATTRIB_CLOSE, ATTRIB_COLOR, ATTRIB_INDENT,
+    ATTRIB_OFF, ATTRIB_OPEN, ATTRIB_OPREF, ATTRIB_VARREF, ATTRIB_SYMREF,
+  ].map((at: AttributeId) => [at.getId(), at.getName()]),
+);
+
+const utf8Encoder = new TextEncoder();
+const utf8Decoder = new TextDecoder('utf-8');
+
+/** Re-express a string as its UTF-8 bytes, one latin1 character per byte */
+function toWire(val: string): string {
+  if (!/[^\x00-\x7f]/.test(val)) return val;
+  const bytes = utf8Encoder.encode(val);
+  let res = '';
+  for (let i = 0; i < bytes.length; ++i) res += String.fromCharCode(bytes[i]);
+  return res;
+}
+
+/** Inverse of toWire() */
+function fromWire(val: string): string {
+  if (!/[^\x00-\x7f]/.test(val)) return val;
+  const bytes = new Uint8Array(val.length);
+  for (let i = 0; i < val.length; ++i) bytes[i] = val.charCodeAt(i);
+  return utf8Decoder.decode(bytes);
+}
+
+// ---------------------------------------------------------------------------
+// TokenEncode
+// ---------------------------------------------------------------------------
+
+/**
+ * A PackedEncode that interns strings and addresses.
+ *
+ * The tables grow with the output and are dropped by clear(), which starts a new chunk.
+ */
+export class TokenEncode extends PackedEncode {
+  private strings = new Map<string, number>();
+  private addresses = new Map<string, number>();
+
+  writeString(attribId: AttributeId, val: string): void {
+    if (!INTERNED.has(attribId.getId()) || val.length < INTERN_MIN_LENGTH) {
+      super.writeString(attribId, toWire(val));
+      return;
+    }
+    const index = this.strings.get(val);
+    if (index !== undefined) {
+      super.writeUnsignedInteger(attribId, BigInt(index));
+      return;
+    }
+    this.strings.set(val, this.strings.size);
+    super.writeString(attribId, toWire(val));
+  }
+
+  /** Spaces are written by name, so the stream decodes without the Architecture */
+  writeSpace(attribId: AttributeId, spc: AddrSpace): void {
+    this.writeString(attribId, spc.getName());
+  }
+
+  /** Write the space and offset attributes of an address, or a reference to an earlier one */
+  writeAddress(spc: AddrSpace, off: uintb): void {
+    const key = spc.getName() + ':' + off.toString(16);
+    const index = this.addresses.get(key);
+    if (index !== undefined) {
+      this.writeUnsignedInteger(ATTRIB_ADDRREF, BigInt(index));
+      return;
+    }
+    this.addresses.set(key, this.addresses.size);
+    this.writeSpace(ATTRIB_SPACE, spc);
+    this.writeUnsignedInteger(ATTRIB_OFF, off);
+  }
+
+  clear(): void {
+    super.clear();
+    this.strings.clear();
+    this.addresses.clear();
+  }
+}
+
+// ---------------------------------------------------------------------------
+// EmitPackedTokens
+// ---------------------------------------------------------------------------
+
+/**
+ * Emitter that writes the markup of EmitMarkup as a packed binary token stream.
+ *
+ * Each flush() writes the chunk built so far to the output stream, base64 encoded, and
+ * starts a new one.
+ */
+export class EmitPackedTokens extends EmitMarkup {
+  private tokens: TokenEncode;
+
+  constructor() {
+    super();
+    this.tokens = new TokenEncode();
+    this.encoder = this.tokens;
+  }
+
+  tagComment(name: string, hl: syntax_highlight, spc: AddrSpace, off: uintb): void {
+    this.tokens.openElement(ELEM_COMMENT);
+    if (hl !== syntax_highlight.no_color)
+      this.tokens.writeUnsignedInteger(ATTRIB_COLOR, BigInt(hl));
+    this.tokens.writeAddress(spc, off);
+    this.tokens.writeString(ATTRIB_CONTENT, name);
+    this.tokens.closeElement(ELEM_COMMENT);
+  }
+
+  tagLabel(name: string, hl: syntax_highlight, spc: AddrSpace, off: uintb): void {
+    this.tokens.openElement(ELEM_LABEL);
+    if (hl !== syntax_highlight.no_color)
+      this.tokens.writeUnsignedInteger(ATTRIB_COLOR, BigInt(hl));
+    this.tokens.writeAddress(spc, off);
+    this.tokens.writeString(ATTRIB_CONTENT, name);
+    this.tokens.closeElement(ELEM_LABEL);
+  }
+
+  flush(): void {
+    if (this.s === null || this.tokens.size() === 0) return;
+    this.s.write(Buffer.from(this.tokens.toBytes()).toString('base64'));
+    this.tokens.clear();
+  }
+
+  /** The stream keeps its TokenEncode; the base class would start a PackedEncode */
+  setOutputStream(t: Writer | null): void {
+    this.s = t;
+  }
+
+  /** Always packed */
+  setPackedOutput(_val: boolean): void {}
+
+  /** Size in bytes of the chunk built since the last flush */
+  size(): number {
+    return this.tokens.size();
+  }
+}
+
+// ---------------------------------------------------------------------------
+// Decoder
+// ---------------------------------------------------------------------------
+
+/** An attribute value, typed as it was written: signed integers are numbers, unsigned bigints */
+export type TokenValue = string | number | bigint | boolean;
+
+/** One decoded markup element */
+export interface TokenNode {
+  /** Element name, as in the XML markup */
+  tag: string;
+  /** Attributes other than the content, in the order written */
+  attributes: [string, TokenValue][];
+  /** The token text, if the element carries any */
+  content?: string;
+  /** Nested elements */
+  children: TokenNode[];
+}
+
+/** String and address tables, rebuilt while decoding */
+interface DecodeTables {
+  strings: string[];
+  addresses: [string, bigint][];
+}
+
+/** Decode one element, and its children, at the current position */
+function decodeElement(dec: PackedDecode, tables: DecodeTables): TokenNode {
+  const id = dec.openElement();
+  const tag = ELEMENT_NAMES.get(id);
+  if (tag === undefined) throw new DecoderError('Unknown element in token stream: ' + id);
+  const node: TokenNode = { tag, attributes: [], children: [] };
+  let space: string | null = null;
+  let off: bigint | null = null;
+  for (;;) {
+    const attribId = dec.getNextAttributeId();
+    if (attribId === 0) break;
+    if (attribId === ATTRIB_ADDRREF.getId()) {
+      const addr = tables.addresses[Number(dec.readUnsignedInteger())];
+      if (addr === undefined) throw new DecoderError('Bad address reference in token stream');
+      node.attributes.push(['space', addr[0]], ['off', addr[1]]);
+      continue;
+    }
+    const interned = INTERNED.has(attribId);
+    let val: TokenValue;
+    switch (dec.getAttributeType()) {
+      case PackedFormat.TYPECODE_STRING:
+        val = fromWire(dec.readString());
+        if (interned && val.length >= INTERN_MIN_LENGTH) tables.strings.push(val);
+        break;
+      case PackedFormat.TYPECODE_UNSIGNEDINT:
+        val = dec.readUnsignedInteger();
+        if (interned) {
+          const str = tables.strings[Number(val)];
+          if (str === undefined) throw new DecoderError('Bad string reference in token stream');
+          val = str;
+        }
+        break;
+      case PackedFormat.TYPECODE_SIGNEDINT_POSITIVE:
+      case PackedFormat.TYPECODE_SIGNEDINT_NEGATIVE:
+        val = dec.readSignedInteger();
+        break;
+      case PackedFormat.TYPECODE_BOOLEAN:
+        val = dec.readBool();
+        break;
+      default:
+        throw new DecoderError('Unexpected attribute type in token stream');
+    }
+    if (attribId === ATTRIB_CONTENT.getId()) {
+      node.content = val as string;
+      continue;
+    }
+    const name = ATTRIBUTE_NAMES.get(attribId);
+    if (name === undefined) throw new DecoderError('Unknown attribute in token stream: ' + attribId);
+    if (attribId === ATTRIB_SPACE.getId()) space = val as string;
+    else if (attribId === ATTRIB_OFF.getId() && typeof val === 'bigint') off = val;
+    node.attributes.push([name, val]);
+  }
+  // A space written in place defines the next address table entry
+  if (space !== null && off !== null) tables.addresses.push([space, off]);
+  while (dec.peekElement() !== 0) node.children.push(decodeElement(dec, tables));
+  dec.closeElement(id);
+  return node;
+}
+
+/**
+ * Decode one chunk of a token stream, as raw bytes or base64 text.
+ * @returns the top-level elements of the chunk
+ */
+export function decodeTokenStream(data: Uint8Array | string): TokenNode[] {
+  const bytes = typeof data === 'string' ? new Uint8Array(Buffer.from(data.trim(), 'base64')) : data;
+  const dec = new PackedDecode(null);
+  dec.ingestBytes(bytes);
+  const tables: DecodeTables = { strings: [], addresses: [] };
+  const res: TokenNode[] = [];
+  while (dec.peekElement() !== 0) res.push(decodeElement(dec, tables));
+  return res;
+}
+
+/** Render decoded tokens as the XML markup that EmitMarkup writes for them */
+export function tokenStreamToXml(nodes: TokenNode[]): string {
+  const parts: string[] = [];
+  const render = (node: TokenNode): void => {
+    parts.push('<', node.tag);
+    for (const [name, val] of node.attributes) {
+      const text = typeof val === 'bigint' ? '0x' + val.toString(16)
+        : typeof val === 'string' ? xml_escape(val) : String(val);
+      parts.push(' ', name, '="', text, '"');
+    }
+    if (node.content !== undefined) {
+      parts.push('>', xml_escape(node.content), '</', node.tag, '>');
+    } else if (node.children.length > 0) {
+      parts.push('>');
+      for (const child of node.children) render(child);
+      parts.push('</', node.tag, '>');
+    } else {
+      parts.push('/>');
+    }
+  };
+  for (const node of nodes) render(node);
+  return parts.join('');
+}
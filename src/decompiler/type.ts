@@ -27,7 +27,7 @@ import {
 } from '../core/marshal.js';
 import { Address, calc_mask, sign_extend, coveringmask } from '../core/address.js';
 import { AddrSpace } from '../core/space.js';
-import { SortedSet } from '../util/sorted-set.js';
+import { SortedSet, type SortedSetIterator } from '../util/sorted-set.js';
 
 // ---------------------------------------------------------------------------
 // Forward type declarations for types not defined in this file
@@ -478,6 +478,15 @@ export function hashSize(id: bigint, size: number): bigint {
   return (id ^ sizeHash) & 0xFFFFFFFFFFFFFFFFn;
 }
 
+/**
+ * Order two data-types by object identity.
+ * C++ compares the pointers themselves; here each Datatype carries a creation serial (uid)
+ * that gives the same kind of arbitrary but stable order.
+ */
+function compareIdentity(a: Datatype, b: Datatype): number {
+  return a.uid - b.uid;
+}
+
 // =========================================================================
 // Datatype base class
 // =========================================================================
@@ -499,6 +508,11 @@ export abstract class Datatype {
   /** @internal */ typedefImm: Datatype | null;
   /** @internal */ alignment: number;
   /** @internal */ alignSize: number;
+  /** @internal Creation serial, unique to this object and never copied (see compareIdentity) */
+  readonly uid: number;
+
+  /** Source of uid values */
+  private static nextUid = 1;
 
   /**
    * Construct the base data-type providing size, alignment, and meta-type.
@@ -509,6 +523,7 @@ export abstract class Datatype {
    */
   constructor(op: Datatype);
   constructor(sOrOp: number | Datatype, align?: number, m?: type_metatype) {
+    this.uid = Datatype.nextUid++;
     if (typeof sOrOp === 'number') {
       this.size = sOrOp;
       this.metatype = m!;
@@ -743,6 +758,17 @@ export abstract class Datatype {
     return 0;
   }
 
+  /**
+   * Get a key for hash-consing an unnamed data-type inside TypeFactory.
+   * The key covers the fields compared by compareDependency, so equal keys should mean
+   * equal data-types; the factory still verifies every hit. Data-types whose comparison
+   * covers more than a few fields return null and are only found through the tree.
+   * @returns the key, or null if this kind of data-type is not hashed
+   */
+  hashConsKey(): string | null {
+    return null;
+  }
+
   /**
    * Encode a formal description of the data-type as a <type> element.
    * For composite data-types, the description goes down one level,
@@ -1183,6 +1209,10 @@ export class TypeBase extends Datatype {
   clone(): Datatype {
     return new TypeBase(this);
   }
+
+  hashConsKey(): string | null {
+    return 'b' + this.submeta + ':' + this.size;
+  }
 }
 
 // =========================================================================
@@ -1518,7 +1548,7 @@ class TypePointer extends Datatype {
   compareDependency(op: Datatype): number {
     if (this.submeta !== op.getSubMeta()) return (this.submeta < op.getSubMeta()) ? -1 : 1;
     const tp = op as TypePointer;
-    if (this.ptrto !== tp.ptrto) return (this.ptrto < tp.ptrto) ? -1 : 1; // Compare absolute pointers (reference identity)
+    if (this.ptrto !== tp.ptrto) return compareIdentity(this.ptrto, tp.ptrto); // Compare absolute pointers
     if (this.wordsize !== tp.wordsize) return (this.wordsize < tp.wordsize) ? -1 : 1;
     if (this.spaceid !== tp.spaceid) {
       if (this.spaceid === null) return 1;
@@ -1528,6 +1558,11 @@ class TypePointer extends Datatype {
     return (op.getSize() - this.size);
   }
 
+  hashConsKey(): string | null {
+    return 'p' + this.submeta + ':' + this.size + ':' + this.wordsize + ':' + this.ptrto.uid + ':' +
+      (this.spaceid !== null ? this.spaceid.getIndex() : -1);
+  }
+
   clone(): Datatype { return new TypePointer(this); }
 
   encode(encoder: Encoder): void {
@@ -1787,10 +1822,14 @@ class TypeArray extends Datatype {
   compareDependency(op: Datatype): number {
     if (this.submeta !== op.getSubMeta()) return (this.submeta < op.getSubMeta()) ? -1 : 1;
     const ta = op as TypeArray;
-    if (this.arrayof !== ta.arrayof) return (this.arrayof < ta.arrayof) ? -1 : 1; // Compare absolute pointers
+    if (this.arrayof !== ta.arrayof) return compareIdentity(this.arrayof, ta.arrayof); // Compare absolute pointers
     return (op.getSize() - this.size);
   }
 
+  hashConsKey(): string | null {
+    return 'a' + this.submeta + ':' + this.size + ':' + this.arrayof.uid;
+  }
+
   clone(): Datatype { return new TypeArray(this); }
 
   encode(encoder: Encoder): void {
@@ -1998,6 +2037,10 @@ class TypeEnum extends TypeBase {
     return 0;
   }
 
+  hashConsKey(): string | null {
+    return null;  // The name map is compared too
+  }
+
   clone(): Datatype { return new TypeEnum(this); }
 
   encode(encoder: Encoder): void {
@@ -2326,7 +2369,7 @@ export class TypeStruct extends Datatype {
       const fld1 = this.field[i].type;
       const fld2 = ts.field[i].type;
       if (fld1 !== fld2)
-        return (fld1 < fld2) ? -1 : 1;  // Compare the pointers directly (reference identity)
+        return compareIdentity(fld1, fld2);  // Compare the pointers directly
     }
     return 0;
   }
@@ -2599,7 +2642,7 @@ export class TypeUnion extends Datatype {
       const fld1 = this.field[i].type;
       const fld2 = tu.field[i].type;
       if (fld1 !== fld2)
-        return (fld1 < fld2) ? -1 : 1;  // Compare the pointers directly (reference identity)
+        return compareIdentity(fld1, fld2);  // Compare the pointers directly
     }
     return 0;
   }
@@ -2780,11 +2823,15 @@ class TypePartialEnum extends TypeEnum {
   compareDependency(op: Datatype): number {
     if (this.submeta !== op.getSubMeta()) return (this.submeta < op.getSubMeta()) ? -1 : 1;
     const tp = op as TypePartialEnum;
-    if (this.parent !== tp.parent) return (this.parent < tp.parent) ? -1 : 1;  // Compare absolute pointers
+    if (this.parent !== tp.parent) return compareIdentity(this.parent, tp.parent);  // Compare absolute pointers
     if (this.offset !== tp.offset) return (this.offset < tp.offset) ? -1 : 1;
     return (op.getSize() - this.size);
   }
 
+  hashConsKey(): string | null {
+    return 'e' + this.submeta + ':' + this.size + ':' + this.parent.uid + ':' + this.offset;
+  }
+
   clone(): Datatype { return new TypePartialEnum(this); }
 
   encode(encoder: Encoder): void {
@@ -2887,11 +2934,15 @@ class TypePartialStruct extends Datatype {
   compareDependency(op: Datatype): number {
     if (this.submeta !== op.getSubMeta()) return (this.submeta < op.getSubMeta()) ? -1 : 1;
     const tp = op as TypePartialStruct;
-    if (this.container !== tp.container) return (this.container < tp.container) ? -1 : 1;  // Compare absolute pointers
+    if (this.container !== tp.container) return compareIdentity(this.container, tp.container);  // Compare absolute pointers
     if (this.offset !== tp.offset) return (this.offset < tp.offset) ? -1 : 1;
     return (op.getSize() - this.size);
   }
 
+  hashConsKey(): string | null {
+    return 's' + this.submeta + ':' + this.size + ':' + this.container.uid + ':' + this.offset;
+  }
+
   clone(): Datatype { return new TypePartialStruct(this); }
 
   getStripped(): Datatype | null { return this.stripped; }
@@ -2972,11 +3023,15 @@ class TypePartialUnion extends Datatype {
   compareDependency(op: Datatype): number {
     if (this.submeta !== op.getSubMeta()) return (this.submeta < op.getSubMeta()) ? -1 : 1;
     const tp = op as TypePartialUnion;
-    if (this.container !== tp.container) return (this.container < tp.container) ? -1 : 1;  // Compare absolute pointers
+    if (this.container !== tp.container) return compareIdentity(this.container, tp.container);  // Compare absolute pointers
     if (this.offset !== tp.offset) return (this.offset < tp.offset) ? -1 : 1;
     return (op.getSize() - this.size);
   }
 
+  hashConsKey(): string | null {
+    return 'u' + this.submeta + ':' + this.size + ':' + this.container.uid + ':' + this.offset;
+  }
+
   clone(): Datatype { return new TypePartialUnion(this); }
 
   encode(encoder: Encoder): void {
@@ -3129,13 +3184,18 @@ export class TypePointerRel extends TypePointer {
   compareDependency(op: Datatype): number {
     if (this.submeta !== op.getSubMeta()) return (this.submeta < op.getSubMeta()) ? -1 : 1;
     const tp = op as TypePointerRel;
-    if (this.ptrto !== tp.ptrto) return (this.ptrto < tp.ptrto) ? -1 : 1;  // Compare absolute pointers
+    if (this.ptrto !== tp.ptrto) return compareIdentity(this.ptrto, tp.ptrto);  // Compare absolute pointers
     if (this.offset !== tp.offset) return (this.offset < tp.offset) ? -1 : 1;
-    if (this.parent !== tp.parent) return (this.parent < tp.parent) ? -1 : 1;
+    if (this.parent !== tp.parent) return compareIdentity(this.parent, tp.parent);
     if (this.wordsize !== tp.wordsize) return (this.wordsize < tp.wordsize) ? -1 : 1;
     return (op.getSize() - this.size);
   }
 
+  hashConsKey(): string | null {
+    return 'r' + this.submeta + ':' + this.size + ':' + this.wordsize + ':' + this.ptrto.uid + ':' +
+      this.parent.uid + ':' + this.offset;
+  }
+
   clone(): Datatype { return new TypePointerRel(this); }
 
   encode(encoder: Encoder): void {
@@ -3384,7 +3444,7 @@ class TypeCode extends Datatype {
       const param: Datatype = this.proto!.getParam(i).getType();
       const opparam: Datatype = tc.proto!.getParam(i).getType();
       if (param !== opparam)
-        return (param < opparam) ? -1 : 1; // Compare references directly
+        return compareIdentity(param, opparam); // Compare references directly
     }
     const otype: Datatype | null = this.proto!.getOutputType();
     const opotype: Datatype | null = tc.proto!.getOutputType();
@@ -3394,7 +3454,7 @@ class TypeCode extends Datatype {
     }
     if (opotype === null) return -1;
     if (otype !== opotype)
-      return (otype < opotype) ? -1 : 1;
+      return compareIdentity(otype, opotype);
     return 0;
   }
 
@@ -3633,7 +3693,7 @@ class TypeSpacebase extends Datatype {
     let res = super.compareDependency(op);
     if (res !== 0) return res;
     const tsb = op as TypeSpacebase;
-    if (this.spaceid !== tsb.spaceid) return (this.spaceid! < tsb.spaceid!) ? -1 : 1;
+    if (this.spaceid !== tsb.spaceid) return (this.spaceid!.getIndex() < tsb.spaceid!.getIndex()) ? -1 : 1;
     if (this.localframe.isInvalid()) return 0; // Global space base
     if (!this.localframe.equals(tsb.localframe)) return (this.localframe.lessThan(tsb.localframe)) ? -1 : 1;
     return 0;
@@ -3690,6 +3750,80 @@ class DatatypeWarning {
   }
 }
 
+// =========================================================================
+// Core type tables
+// =========================================================================
+
+/**
+ * One core data-type, given by the arguments of TypeFactory.setCoreType().
+ * A typedef names its immediate target instead, which must come earlier in the table.
+ */
+export interface CoreTypeEntry {
+  readonly name: string;
+  readonly size: number;
+  readonly metatype: type_metatype;
+  readonly chartp: boolean;
+  /** Forced display format of constants (Datatype.getDisplayFormat()), if any */
+  readonly format?: number;
+  /** For a typedef, the name of the core data-type it is defined as */
+  readonly typedef?: string;
+  /** For a typedef, its id as a hex string */
+  readonly id?: string;
+}
+
+/**
+ * A frozen list of core data-types.
+ * It is plain data, so it survives JSON and IPC, and one table can be loaded by any number
+ * of TypeFactory objects (TypeFactory.loadCoreTable()) without decoding XML.
+ */
+export type CoreTypeTable = readonly CoreTypeEntry[];
+
+/**
+ * Freeze a list of core data-types into a table.
+ * @param entries are the core data-types, for instance as received from another process
+ * @returns the frozen table
+ */
+export function freezeCoreTypeTable(entries: readonly CoreTypeEntry[]): CoreTypeTable {
+  if (Object.isFrozen(entries)) return entries;
+  return Object.freeze(entries.map(e => {
+    const res: { -readonly [K in keyof CoreTypeEntry]: CoreTypeEntry[K] } = {
+      name: e.name, size: e.size, metatype: e.metatype, chartp: e.chartp,
+    };
+    if (e.format !== undefined && e.format !== 0) res.format = e.format;
+    if (e.typedef !== undefined) {
+      res.typedef = e.typedef;
+      if (e.id !== undefined) res.id = e.id;
+    }
+    return Object.freeze(res);
+  }));
+}
+
+/** The core data-types of an architecture that does not describe its own */
+export const DEFAULT_CORE_TYPES: CoreTypeTable = freezeCoreTypeTable([
+  { name: 'void', size: 1, metatype: type_metatype.TYPE_VOID, chartp: false },
+  { name: 'bool', size: 1, metatype: type_metatype.TYPE_BOOL, chartp: false },
+  { name: 'uint1', size: 1, metatype: type_metatype.TYPE_UINT, chartp: false },
+  { name: 'uint2', size: 2, metatype: type_metatype.TYPE_UINT, chartp: false },
+  { name: 'uint4', size: 4, metatype: type_metatype.TYPE_UINT, chartp: false },
+  { name: 'uint8', size: 8, metatype: type_metatype.TYPE_UINT, chartp: false },
+  { name: 'int1', size: 1, metatype: type_metatype.TYPE_INT, chartp: false },
+  { name: 'int2', size: 2, metatype: type_metatype.TYPE_INT, chartp: false },
+  { name: 'int4', size: 4, metatype: type_metatype.TYPE_INT, chartp: false },
+  { name: 'int8', size: 8, metatype: type_metatype.TYPE_INT, chartp: false },
+  { name: 'float4', size: 4, metatype: type_metatype.TYPE_FLOAT, chartp: false },
+  { name: 'float8', size: 8, metatype: type_metatype.TYPE_FLOAT, chartp: false },
+  { name: 'float10', size: 10, metatype: type_metatype.TYPE_FLOAT, chartp: false },
+  { name: 'float16', size: 16, metatype: type_metatype.TYPE_FLOAT, chartp: false },
+  { name: 'xunknown1', size: 1, metatype: type_metatype.TYPE_UNKNOWN, chartp: false },
+  { name: 'xunknown2', size: 2, metatype: type_metatype.TYPE_UNKNOWN, chartp: false },
+  { name: 'xunknown4', size: 4, metatype: type_metatype.TYPE_UNKNOWN, chartp: false },
+  { name: 'xunknown8', size: 8, metatype: type_metatype.TYPE_UNKNOWN, chartp: false },
+  { name: 'code', size: 1, metatype: type_metatype.TYPE_CODE, chartp: false },
+  { name: 'char', size: 1, metatype: type_metatype.TYPE_INT, chartp: true },
+  { name: 'wchar2', size: 2, metatype: type_metatype.TYPE_INT, chartp: true },
+  { name: 'wchar4', size: 4, metatype: type_metatype.TYPE_INT, chartp: true },
+]);
+
 // =========================================================================
 // TypeFactory
 // =========================================================================
@@ -3709,6 +3843,9 @@ export class TypeFactory {
   private alignMap: number[];
   private tree: SortedSet<Datatype>;
   private nametree: SortedSet<Datatype>;
+  private idindex: Map<bigint, Datatype[]>;     // Data-types of nametree, by id
+  private hashindex: Map<string, Datatype>;     // Unnamed data-types of tree, by Datatype.hashConsKey()
+  private hashkeys: Map<Datatype, string>;      // The key each data-type of hashindex was stored under
   private typecache: (Datatype | null)[][];
   private typecache10: Datatype | null;
   private typecache16: Datatype | null;
@@ -3734,6 +3871,9 @@ export class TypeFactory {
     this.alignMap = [];
     this.tree = new SortedSet<Datatype>(DatatypeCompare);
     this.nametree = new SortedSet<Datatype>(DatatypeNameCompare);
+    this.idindex = new Map();
+    this.hashindex = new Map();
+    this.hashkeys = new Map();
     this.typecache = [];
     this.typecache10 = null;
     this.typecache16 = null;
@@ -3802,8 +3942,9 @@ export class TypeFactory {
 
   /**
    * Manually create a "base" core type.
+   * @returns the core data-type
    */
-  setCoreType(name: string, size: number, meta: type_metatype, chartp: boolean): void {
+  setCoreType(name: string, size: number, meta: type_metatype, chartp: boolean): Datatype {
     let ct: Datatype;
     if (chartp) {
       if (size === 1)
@@ -3818,6 +3959,7 @@ export class TypeFactory {
       ct = this.getBaseNamed(size, meta, name);
     }
     ct.flags |= DT_coretype;
+    return ct;
   }
 
   /**
@@ -3871,6 +4013,79 @@ export class TypeFactory {
     }
   }
 
+  /**
+   * Create each core data-type of a table, as setCoreType() would, and cache them.
+   * Unlike decodeCoreTypes(), this does not flush the container first.
+   * @param table is the list of core data-types
+   */
+  loadCoreTable(table: CoreTypeTable): void {
+    for (const e of table) {
+      if (e.typedef !== undefined) {
+        const target = this.findByName(e.typedef);
+        if (target === null)
+          throw new LowlevelError("Core typedef " + e.name + " of unknown data-type " + e.typedef);
+        const id = e.id !== undefined ? BigInt('0x' + e.id) : 0n;
+        this.getTypedef(target, e.name, id, e.format ?? 0).flags |= DT_coretype;
+        continue;
+      }
+      const ct = this.setCoreType(e.name, e.size, e.metatype, e.chartp);
+      if (e.format !== undefined)
+        ct.setDisplayFormat(e.format);
+    }
+    this.cacheCoreTypes();
+  }
+
+  /**
+   * Describe the core data-types of this container as a table for loadCoreTable().
+   * Only core data-types that setCoreType() or getTypedef() can recreate exactly are
+   * expressible; pointers, arrays and structures are skipped, as in encodeCoreTypes().
+   * Typedefs follow every other entry, each after the entry it is defined as.
+   * @returns the frozen table
+   * @throws LowlevelError naming the first core data-type that cannot be expressed
+   */
+  exportCoreTable(): CoreTypeTable {
+    const res: CoreTypeEntry[] = [];
+    const typedefs: { ct: Datatype; depth: number }[] = [];
+    for (const ct of this.tree) {
+      if (!ct.isCoreType()) continue;
+      const meta = ct.getMetatype();
+      if (meta === type_metatype.TYPE_PTR || meta === type_metatype.TYPE_ARRAY ||
+          meta === type_metatype.TYPE_STRUCT || meta === type_metatype.TYPE_UNION)
+        continue;
+      if (ct.typedefImm !== null) {
+        let depth = 0;
+        for (let cur = ct; cur.typedefImm !== null; cur = cur.typedefImm) depth += 1;
+        typedefs.push({ ct, depth });
+        continue;
+      }
+      let chartp = false;
+      if (ct.constructor === TypeChar || ct.constructor === TypeUnicode)
+        chartp = true;
+      else if (ct.constructor === TypeCode) {
+        if ((ct as TypeCode).proto !== null)
+          throw new LowlevelError("Core data-type " + ct.getName() + " has a prototype");
+      } else if (ct.constructor !== TypeBase && ct.constructor !== TypeVoid)
+        throw new LowlevelError("Core data-type " + ct.getName() + " is not a base type");
+      const format = ct.getDisplayFormat();
+      res.push(format !== 0
+        ? { name: ct.getName(), size: ct.getSize(), metatype: meta, chartp, format }
+        : { name: ct.getName(), size: ct.getSize(), metatype: meta, chartp });
+    }
+    typedefs.sort((a, b) => a.depth - b.depth);
+    const names = new Set(res.map(e => e.name));
+    for (const { ct } of typedefs) {
+      const target: Datatype = ct.typedefImm!;
+      if (!target.isCoreType() || !names.has(target.getName()))
+        throw new LowlevelError("Core typedef " + ct.getName() + " is of non-core data-type " + target.getName());
+      names.add(ct.getName());
+      res.push({
+        name: ct.getName(), size: ct.getSize(), metatype: ct.getMetatype(), chartp: false,
+        format: ct.getDisplayFormat(), typedef: target.getName(), id: ct.getId().toString(16),
+      });
+    }
+    return freezeCoreTypeTable(res);
+  }
+
   /**
    * Set display names on core types to use standard C / Ghidra GUI conventions.
    * Only modifies displayName (not name), so internal logic is unaffected.
@@ -3910,6 +4125,9 @@ export class TypeFactory {
   clear(): void {
     this.tree.clear();
     this.nametree.clear();
+    this.idindex.clear();
+    this.hashindex.clear();
+    this.hashkeys.clear();
     this.clearCache();
     this.warnings = [];
     this.incompleteTypedef = [];
@@ -3926,8 +4144,8 @@ export class TypeFactory {
       }
     }
     for (const ct of toRemove) {
-      this.nametree.eraseValue(ct);
-      this.tree.eraseValue(ct);
+      this.nameErase(ct);
+      this.treeErase(ct);
     }
     this.warnings = [];
     this.incompleteTypedef = [];
@@ -3972,15 +4190,16 @@ export class TypeFactory {
    * Looking just within this container, find a Datatype by name and/or id.
    */
   protected findByIdLocal(nm: string, id: bigint): Datatype | null {
-    const ct = new TypeBase(1, type_metatype.TYPE_UNKNOWN, nm);
     if (id !== 0n) {
       // Search for an exact type
-      ct.id = id;
-      const iter = this.nametree.find(ct);
-      if (iter.isEnd) return null;
-      return iter.value;
+      const bucket = this.idindex.get(id);
+      if (bucket === undefined) return null;
+      for (const ct of bucket)
+        if (ct.name === nm) return ct;
+      return null;
     } else {
       // Allow for the fact that the name may not be unique
+      const ct = new TypeBase(1, type_metatype.TYPE_UNKNOWN, nm);
       ct.id = 0n;
       const iter = this.nametree.lower_bound(ct);
       if (iter.isEnd) return null;
@@ -4012,6 +4231,14 @@ export class TypeFactory {
    * Find data-type without reference to name, using the functional comparators.
    */
   private findNoName(ct: Datatype): Datatype | null {
+    if (ct.id === 0n) {
+      const key = ct.hashConsKey();
+      if (key !== null) {
+        const res = this.hashindex.get(key);
+        if (res !== undefined && DatatypeCompare(ct, res) === 0)
+          return res;
+      }
+    }
     const iter = this.tree.find(ct);
     if (!iter.isEnd)
       return iter.value;
@@ -4022,7 +4249,7 @@ export class TypeFactory {
    * Internal method for finally inserting a new Datatype pointer.
    */
   private insert(newtype: Datatype): void {
-    const [iter, inserted] = this.tree.insert(newtype);
+    const [iter, inserted] = this.treeInsert(newtype);
     if (!inserted) {
       const s = new StringWriter();
       s.write("Shared type id: ");
@@ -4034,7 +4261,58 @@ export class TypeFactory {
       throw new LowlevelError(s.toString());
     }
     if (newtype.id !== 0n)
-      this.nametree.insert(newtype);
+      this.nameInsert(newtype);
+  }
+
+  /**
+   * Add a data-type to the main tree, and to the hash index if it is unnamed.
+   * Every change to a data-type that affects its position happens between a treeErase()
+   * and a treeInsert(), so the index follows the tree.
+   */
+  private treeInsert(ct: Datatype): [SortedSetIterator<Datatype>, boolean] {
+    const res = this.tree.insert(ct);
+    if (res[1] && ct.id === 0n) {
+      const key = ct.hashConsKey();
+      if (key !== null && !this.hashindex.has(key)) {
+        this.hashindex.set(key, ct);
+        this.hashkeys.set(ct, key);
+      }
+    }
+    return res;
+  }
+
+  /** Remove a data-type from the main tree and the hash index */
+  private treeErase(ct: Datatype): void {
+    this.tree.eraseValue(ct);
+    const key = this.hashkeys.get(ct);
+    if (key !== undefined) {
+      this.hashindex.delete(key);
+      this.hashkeys.delete(ct);
+    }
+  }
+
+  /** Add a data-type to the name tree and the id index */
+  private nameInsert(ct: Datatype): void {
+    const [, inserted] = this.nametree.insert(ct);
+    if (!inserted) return;
+    const bucket = this.idindex.get(ct.id);
+    if (bucket === undefined)
+      this.idindex.set(ct.id, [ct]);
+    else
+      bucket.push(ct);
+  }
+
+  /** Remove a data-type from the name tree and the id index */
+  private nameErase(ct: Datatype): void {
+    this.nametree.eraseValue(ct);
+    const bucket = this.idindex.get(ct.id);
+    if (bucket === undefined) return;
+    const i = bucket.indexOf(ct);
+    if (i < 0) return;
+    if (bucket.length === 1)
+      this.idindex.delete(ct.id);
+    else
+      bucket.splice(i, 1);
   }
 
   /**
@@ -4073,14 +4351,14 @@ export class TypeFactory {
    */
   setName(ct: Datatype, n: string): Datatype {
     if (ct.id !== 0n)
-      this.nametree.eraseValue(ct);
-    this.tree.eraseValue(ct);
+      this.nameErase(ct);
+    this.treeErase(ct);
     ct.name = n;
     ct.displayName = n;
     if (ct.id === 0n)
       ct.id = Datatype.hashName(n);
-    this.tree.insert(ct);
-    this.nametree.insert(ct);
+    this.treeInsert(ct);
+    this.nameInsert(ct);
     return ct;
   }
 
@@ -4103,17 +4381,17 @@ export class TypeFactory {
     if (!ot.isIncomplete())
       throw new LowlevelError("Can only set fields on an incomplete " + (ot instanceof TypeStruct ? "structure" : "union"));
 
-    this.tree.eraseValue(ot);
+    this.treeErase(ot);
     (ot as any).setFields(fd, newSize, newAlign);
     ot.flags &= ~DT_type_incomplete;
     if (ot instanceof TypeStruct) {
       ot.flags |= (flags & (DT_opaque_string | DT_variable_length | DT_type_incomplete));
-      this.tree.insert(ot);
+      this.treeInsert(ot);
       this.recalcPointerSubmeta(ot, sub_metatype.SUB_PTR);
       this.recalcPointerSubmeta(ot, sub_metatype.SUB_PTR_STRUCT);
     } else {
       ot.flags |= (flags & (DT_variable_length | DT_type_incomplete));
-      this.tree.insert(ot);
+      this.treeInsert(ot);
     }
   }
 
@@ -4123,20 +4401,20 @@ export class TypeFactory {
   setPrototype(fp: FuncProto | null, newCode: TypeCode, flags: number): void {
     if (!newCode.isIncomplete())
       throw new LowlevelError("Can only set prototype on incomplete data-type");
-    this.tree.eraseValue(newCode);
+    this.treeErase(newCode);
     newCode.setPrototypeCopy(this, fp);
     newCode.flags &= ~DT_type_incomplete;
     newCode.flags |= (flags & (DT_variable_length | DT_type_incomplete));
-    this.tree.insert(newCode);
+    this.treeInsert(newCode);
   }
 
   /**
    * Set named values for an enumeration.
    */
   setEnumValues(nmap: Map<bigint, string>, te: TypeEnum): void {
-    this.tree.eraseValue(te);
+    this.treeErase(te);
     (te as any).setNameMap(nmap);
-    this.tree.insert(te);
+    this.treeInsert(te);
   }
 
   /**
@@ -4218,8 +4496,8 @@ export class TypeFactory {
     const tv = new TypeVoid();
     tv.id = Datatype.hashName(tv.name);
     ct = tv.clone() as TypeVoid;
-    this.tree.insert(ct);
-    this.nametree.insert(ct);
+    this.treeInsert(ct);
+    this.nameInsert(ct);
     this.typecache[0][type_metatype.TYPE_VOID - type_metatype.TYPE_FLOAT] = ct;
     return ct;
   }
@@ -4367,9 +4645,9 @@ export class TypeFactory {
       iterClone.next();
     }
     for (const ptr of toFix) {
-      this.tree.eraseValue(ptr);
+      this.treeErase(ptr);
       ptr.submeta = curSub;
-      this.tree.insert(ptr);
+      this.treeInsert(ptr);
     }
   }
 
@@ -4675,8 +4953,8 @@ export class TypeFactory {
       throw new LowlevelError("Cannot destroy core type");
     if (ct.hasWarning())
       this.removeWarning(ct);
-    this.nametree.eraseValue(ct);
-    this.tree.eraseValue(ct);
+    this.nameErase(ct);
+    this.treeErase(ct);
   }
 
   /**
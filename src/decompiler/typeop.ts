@@ -160,11 +160,11 @@ export abstract class TypeOp {
   getBehavior(): OpBehavior | null { return this.behave; }
 
   evaluateUnary(sizeout: int4, sizein: int4, in1: uintb): uintb {
-    return this.behave!.evaluateUnary(sizeout, sizein, in1);
+    return this.behave!.evaluateUnarySized(sizeout, sizein, in1);
   }
 
   evaluateBinary(sizeout: int4, sizein: int4, in1: uintb, in2: uintb): uintb {
-    return this.behave!.evaluateBinary(sizeout, sizein, in1, in2);
+    return this.behave!.evaluateBinarySized(sizeout, sizein, in1, in2);
   }
 
   evaluateTernary(sizeout: int4, sizein: int4, in1: uintb, in2: uintb, in3: uintb): uintb {
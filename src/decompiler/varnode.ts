@@ -19,6 +19,7 @@ import { OpCode } from '../core/opcodes.js';
 import { SortedSet, type SortedSetIterator } from '../util/sorted-set.js';
 import type { Writer } from '../util/writer.js';
 import { Cover } from './cover.js';
+import type { IrPool } from './irpool.js';
 import {
   AttributeId,
   ElementId,
@@ -175,30 +176,33 @@ export class Varnode {
   static readonly has_implied_field       = VN_HAS_IMPLIED_FIELD;
 
   // ---- Private fields ----
-  /** @internal */ public flags: number;
-  /** @internal */ public size: number;
-  /** @internal */ public create_index: number;
-  /** @internal */ public mergegroup: number;
-  /** @internal */ public addlflags: number;
-  /** @internal */ public loc: Address;
+  /** @internal */ public flags!: number;
+  /** @internal */ public size!: number;
+  /** @internal */ public create_index!: number;
+  /** @internal */ public mergegroup!: number;
+  /** @internal */ public addlflags!: number;
+  /** @internal */ public loc!: Address;
 
   // Heritage fields
-  /** @internal */ public def: PcodeOp | null;
-  /** @internal */ public high: HighVariable | null;
-  /** @internal */ public mapentry: SymbolEntry | null;
-  /** @internal */ public type: Datatype | null;
-  /** @internal */ public lociter: SortedSetIterator<Varnode> | null;
-  /** @internal */ public defiter: SortedSetIterator<Varnode> | null;
+  /** @internal */ public def!: PcodeOp | null;
+  /** @internal */ public high!: HighVariable | null;
+  /** @internal */ public mapentry!: SymbolEntry | null;
+  /** @internal */ public type!: Datatype | null;
+  /** @internal */ public lociter!: SortedSetIterator<Varnode> | null;
+  /** @internal */ public defiter!: SortedSetIterator<Varnode> | null;
   /** @internal */ public descend: PcodeOp[];
-  /** @internal */ public cover: Cover | null;
+  /** @internal */ public cover!: Cover | null;
 
   /** @internal Temporary data-type or ValueSet */
   public temp: { dataType: Datatype | null; valueSet: ValueSet | null };
 
   /** @internal Consumed bits mask */
-  public consumed: bigint;
+  public consumed!: bigint;
   /** @internal Known zero bits mask */
-  public nzm: bigint;
+  public nzm!: bigint;
+
+  /** @internal Cover kept from before this was recycled, reused by calcCover() */
+  private spareCover: Cover | null = null;
 
   /**
    * Construct a free Varnode with possibly a Datatype attribute.
@@ -207,6 +211,16 @@ export class Varnode {
    * @param dt is the Datatype
    */
   constructor(s: number, m: Address, dt: Datatype | null) {
+    this.descend = [];
+    this.temp = { dataType: null, valueSet: null };
+    this.init(s, m, dt);
+  }
+
+  /**
+   * @internal (Re)initialize as a free Varnode, as the constructor does.
+   * Used on objects taken from the IrPool, after recycle() has emptied them.
+   */
+  init(s: number, m: Address, dt: Datatype | null): void {
     this.loc = new Address(m);
     this.size = s;
     this.def = null;
@@ -220,8 +234,6 @@ export class Varnode {
     this.create_index = 0;
     this.lociter = null;
     this.defiter = null;
-    this.descend = [];
-    this.temp = { dataType: null, valueSet: null };
     this.nzm = 0xFFFFFFFFFFFFFFFFn;
 
     if (m.getSpace() === null) {
@@ -814,11 +826,37 @@ export class Varnode {
   /** @internal Initialize a new Cover and set dirty bit */
   calcCover(): void {
     if (this.hasCover()) {
-      this.cover = new Cover();
+      if (this.spareCover !== null) {
+        this.cover = this.spareCover;
+        this.spareCover = null;
+      } else {
+        this.cover = new Cover();
+      }
       this.setFlags(Varnode.coverdirty);
     }
   }
 
+  /**
+   * @internal Drop every reference into the function, before this goes back to the IrPool.
+   * The descendant list and Cover objects are emptied and kept for reuse.
+   */
+  recycle(): void {
+    this.def = null;
+    this.high = null;
+    this.mapentry = null;
+    this.type = null;
+    this.lociter = null;
+    this.defiter = null;
+    this.descend.length = 0;
+    this.temp.dataType = null;
+    this.temp.valueSet = null;
+    if (this.cover !== null) {
+      this.cover.clear();
+      this.spareCover = this.cover;
+      this.cover = null;
+    }
+  }
+
   // ---- Set the Datatype ----
 
   /**
@@ -1516,9 +1554,8 @@ export class Varnode {
  */
 export function varnodeCompareLocDef(a: Varnode, b: Varnode): number {
   // Compare by address first
-  if (!a.getAddr().equals(b.getAddr())) {
-    return a.getAddr().lessThan(b.getAddr()) ? -1 : 1;
-  }
+  const c = Address.compare(a.loc, b.loc);
+  if (c !== 0) return c;
   // Then by size
   if (a.getSize() !== b.getSize()) return a.getSize() - b.getSize();
 
@@ -1529,11 +1566,8 @@ export function varnodeCompareLocDef(a: Varnode, b: Varnode): number {
     return (((f1 - 1) >>> 0) < ((f2 - 1) >>> 0)) ? -1 : 1;
   }
   if (f1 === Varnode.written) {
-    const seq1 = (a.getDef() as PcodeOp).getSeqNum();
-    const seq2 = (b.getDef() as PcodeOp).getSeqNum();
-    if (!seq1.equals(seq2)) {
-      return seq1.lessThan(seq2) ? -1 : 1;
-    }
+    const c = SeqNum.compare((a.getDef() as PcodeOp).getSeqNum(), (b.getDef() as PcodeOp).getSeqNum());
+    if (c !== 0) return c;
   } else if (f1 === 0) {
     // Both are free, compare by create_index
     if (a.getCreateIndex() !== b.getCreateIndex())
@@ -1554,16 +1588,12 @@ export function varnodeCompareDefLoc(a: Varnode, b: Varnode): number {
     return (((f1 - 1) >>> 0) < ((f2 - 1) >>> 0)) ? -1 : 1;
   }
   if (f1 === Varnode.written) {
-    const seq1 = (a.getDef() as PcodeOp).getSeqNum();
-    const seq2 = (b.getDef() as PcodeOp).getSeqNum();
-    if (!seq1.equals(seq2)) {
-      return seq1.lessThan(seq2) ? -1 : 1;
-    }
+    const c = SeqNum.compare((a.getDef() as PcodeOp).getSeqNum(), (b.getDef() as PcodeOp).getSeqNum());
+    if (c !== 0) return c;
   }
   // Then by address
-  if (!a.getAddr().equals(b.getAddr())) {
-    return a.getAddr().lessThan(b.getAddr()) ? -1 : 1;
-  }
+  const c = Address.compare(a.loc, b.loc);
+  if (c !== 0) return c;
   // Then by size
   if (a.getSize() !== b.getSize()) return a.getSize() - b.getSize();
 
@@ -1607,6 +1637,10 @@ export class VarnodeBank {
   /** @internal */ public loc_tree: VarnodeLocSet;
   /** @internal */ public def_tree: VarnodeDefSet;
   /** @internal */ private searchvn: Varnode;
+  /** @internal Where cleared Varnodes go for reuse, or null */
+  private pool: IrPool | null = null;
+  /** @internal Varnodes destroyed since the last clear, recycled then */
+  private retired: Set<Varnode> = new Set();
 
   /**
    * Construct the container.
@@ -1631,14 +1665,43 @@ export class VarnodeBank {
     }
     this.uniqid = this.uniqbase;
     this.create_index = 0;
-    this.loc_tree = new SortedSet<Varnode>(varnodeCompareLocDef);
-    this.def_tree = new SortedSet<Varnode>(varnodeCompareDefLoc);
+    // Layout chosen by SORTED_SET_LAYOUT (see sorted-set.ts)
+    this.loc_tree = SortedSet.create<Varnode>(varnodeCompareLocDef);
+    this.def_tree = SortedSet.create<Varnode>(varnodeCompareDefLoc);
   }
 
-  /** Clear out all Varnodes and reset counters */
-  clear(): void {
+  /**
+   * Recycle Varnodes through the given pool when this is cleared.
+   * @param pool is the Architecture's IrPool, or null to leave them to the collector
+   */
+  setPool(pool: IrPool | null): void {
+    this.pool = pool;
+  }
+
+  /** Drop the tree nodes kept by clear() for the next analysis, once the bank is empty */
+  releaseStorage(): void {
     this.loc_tree.clear();
     this.def_tree.clear();
+  }
+
+  /** Clear out all Varnodes and reset counters */
+  clear(): void {
+    const pool = this.pool;
+    if (pool !== null) {
+      const list = pool.varnodes;
+      for (const vn of this.loc_tree) {
+        this.retired.delete(vn);
+        vn.recycle();
+        list.give(vn, pool.poison);
+      }
+      for (const vn of this.retired) {
+        vn.recycle();
+        list.give(vn, pool.poison);
+      }
+      this.retired.clear();
+    }
+    this.loc_tree.clear(pool !== null && !pool.poison);
+    this.def_tree.clear(pool !== null && !pool.poison);
     this.uniqid = this.uniqbase;
     this.create_index = 0;
   }
@@ -1657,7 +1720,7 @@ export class VarnodeBank {
    * @return the newly allocated Varnode object
    */
   create(s: number, m: Address, ct: Datatype): Varnode {
-    const vn = new Varnode(s, m, ct);
+    const vn = this.allocate(s, m, ct);
     vn.create_index = this.create_index++;
     const [locIt] = this.loc_tree.insert(vn);
     vn.lociter = locIt;
@@ -1666,6 +1729,15 @@ export class VarnodeBank {
     return vn;
   }
 
+  /** @internal Get a free Varnode object, recycled from the pool if possible */
+  private allocate(s: number, m: Address, ct: Datatype): Varnode {
+    const vn: Varnode | undefined = this.pool !== null ? this.pool.varnodes.take() : undefined;
+    if (vn === undefined)
+      return new Varnode(s, m, ct);
+    vn.init(s, m, ct);
+    return vn;
+  }
+
   /**
    * Create a temporary varnode.
    * @param s is the size of the Varnode in bytes
@@ -1689,7 +1761,9 @@ export class VarnodeBank {
       this.loc_tree.erase(vn.lociter);
     if (vn.defiter !== null)
       this.def_tree.erase(vn.defiter);
-    // GC handles the rest
+    // Rules may still hold it until they finish, so it is only recycled by clear()
+    if (this.pool !== null)
+      this.retired.add(vn);
   }
 
   /**
@@ -1807,7 +1881,7 @@ export class VarnodeBank {
    * Create a Varnode as the output of a PcodeOp.
    */
   createDef(s: number, m: Address, ct: Datatype, op: PcodeOp): Varnode {
-    const vn = new Varnode(s, m, ct);
+    const vn = this.allocate(s, m, ct);
     vn.create_index = this.create_index++;
     vn.setDef(op);
     return this.xref(vn);
@@ -0,0 +1,188 @@
+/**
+ * @file worker_arch.ts
+ * @description Architecture construction shared by the parallel orchestrator and its workers.
+ *
+ * The parent builds the Architecture once from the XML and serializes the opened load image
+ * to a packed snapshot (LoadImageXml.encodeSnapshot), along with its core data-types. Each
+ * worker then restores from the snapshot, which skips XML parsing, the DOM and hex decoding
+ * of the byte chunks.
+ */
+
+// Register XmlArchitectureCapability singleton (side-effect import)
+import '../console/xml_arch.js';
+
+import * as fs from 'fs';
+import * as os from 'os';
+import { join } from 'path';
+import { LowlevelError } from '../core/error.js';
+import { DocumentStorage } from '../core/xml.js';
+import type { Document } from '../core/xml.js';
+import { ArchitectureCapability } from './architecture.js';
+import { freezeCoreTypeTable, type CoreTypeEntry, type CoreTypeTable } from './type.js';
+import type { Writer } from '../util/writer.js';
+
+// Forward type declarations
+type Architecture = any;
+
+// ---------------------------------------------------------------------------
+// Construction
+// ---------------------------------------------------------------------------
+
+function newXmlArchitecture(errstream: Writer): Architecture {
+  const capa = ArchitectureCapability.getCapability('xml');
+  if (!capa) throw new LowlevelError('Missing XML architecture capability');
+  return capa.buildArchitecture('test', '', errstream);
+}
+
+/**
+ * Cut the first element with the given tag name out of an XML document.
+ * @param xmlString is the full XML document
+ * @param tag is the element name
+ * @returns the text of the element, or null if it is not present
+ */
+function extractElement(xmlString: string, tag: string): string | null {
+  const match = new RegExp(`<${tag}[\\s/>]`).exec(xmlString);
+  if (match === null) return null;
+  const start = match.index;
+  const openEnd = xmlString.indexOf('>', start);
+  if (openEnd < 0) return null;
+  if (xmlString[openEnd - 1] === '/') return xmlString.substring(start, openEnd + 1);
+  const close = `</${tag}>`;
+  const end = xmlString.indexOf(close, openEnd);
+  if (end < 0) return null;
+  return xmlString.substring(start, end + close.length);
+}
+
+/**
+ * Build an Architecture from an XML document containing a binaryimage tag.
+ * Same pattern as FunctionTestCollection.buildProgram, but only the binaryimage and
+ * coretypes elements are parsed; the scripts and the rest of the document are never
+ * turned into a DOM.
+ * @param xmlString is the full XML document
+ * @param errstream receives architecture warnings
+ * @returns the initialized Architecture with loader symbols read
+ */
+export function buildXmlArchitecture(xmlString: string, errstream: Writer): Architecture {
+  const docStorage = new DocumentStorage();
+  const image = extractElement(xmlString, 'binaryimage');
+  if (image === null) throw new LowlevelError('Missing binaryimage tag');
+  const doc = docStorage.parseDocument(image);
+  const coreTypes = extractElement(xmlString, 'coretypes');
+  if (coreTypes !== null) {
+    docStorage.registerTag(docStorage.parseDocument(coreTypes).getRoot());
+  }
+  return buildDocumentArchitecture(docStorage, doc, errstream);
+}
+
+/**
+ * Build an Architecture from an XML file, parsing it incrementally.
+ * The file is never read into a single string, and the bytechunk content is decoded
+ * straight into the load image buffers (DocumentStorage.openDocumentStream).
+ * @param path is the XML file containing a binaryimage tag
+ * @param errstream receives architecture warnings
+ * @returns the initialized Architecture with loader symbols read
+ */
+export function buildXmlArchitectureFromFile(path: string, errstream: Writer): Architecture {
+  const docStorage = new DocumentStorage();
+  const doc = docStorage.openDocumentStream(path);
+  return buildDocumentArchitecture(docStorage, doc, errstream);
+}
+
+/**
+ * Build an Architecture from an already parsed document.
+ * @param docStorage is the storage holding the document
+ * @param doc is a document whose root is, or contains, a binaryimage tag (and optionally coretypes)
+ * @param errstream receives architecture warnings
+ * @returns the initialized Architecture with loader symbols read
+ */
+export function buildDocumentArchitecture(docStorage: DocumentStorage, doc: Document, errstream: Writer): Architecture {
+  const el = doc.getRoot();
+  if (el.getName() === 'binaryimage') {
+    docStorage.registerTag(el);
+  } else {
+    for (const child of el.getChildren()) {
+      const nm = child.getName();
+      if ((nm === 'binaryimage' || nm === 'coretypes') && docStorage.getTag(nm) === null) {
+        docStorage.registerTag(child);
+      }
+    }
+  }
+  const conf = newXmlArchitecture(errstream);
+  conf.init(docStorage);
+  conf.readLoaderSymbols('::');
+  return conf;
+}
+
+/**
+ * Build an Architecture from a packed load image snapshot, without any XML.
+ * @param snapshot is the output of encodeArchitectureSnapshot()
+ * @param errstream receives architecture warnings
+ * @param coreTypes are the core data-types of the parent (encodeCoreTypeTable()), or null
+ *   for the defaults; the snapshot itself does not carry them
+ * @returns the initialized Architecture with loader symbols read
+ */
+export function buildSnapshotArchitecture(
+  snapshot: Uint8Array, errstream: Writer, coreTypes: readonly CoreTypeEntry[] | null = null,
+): Architecture {
+  const conf = newXmlArchitecture(errstream);
+  conf.setLoaderSnapshot(snapshot);
+  if (coreTypes !== null)
+    conf.setCoreTypeTable(freezeCoreTypeTable(coreTypes));
+  conf.init(new DocumentStorage());
+  conf.readLoaderSymbols('::');
+  return conf;
+}
+
+/**
+ * Serialize the load image of an initialized XML Architecture.
+ * @param conf is an Architecture built by buildXmlArchitecture()
+ * @returns the packed snapshot bytes
+ */
+export function encodeArchitectureSnapshot(conf: Architecture): Uint8Array {
+  if (conf.loader === null || typeof conf.loader.encodeSnapshot !== 'function') {
+    throw new LowlevelError('Architecture does not have a snapshot-capable load image');
+  }
+  return conf.loader.encodeSnapshot();
+}
+
+/**
+ * Describe the core data-types of an initialized Architecture for its workers.
+ * @param conf is an Architecture built by buildXmlArchitecture()
+ * @returns the table, or null if the Architecture has no types
+ * @throws LowlevelError if a core data-type cannot be expressed in a table, in which case
+ *   workers must parse the XML to get the same core types
+ */
+export function encodeCoreTypeTable(conf: Architecture): CoreTypeTable | null {
+  return conf.types !== null ? conf.types.exportCoreTable() : null;
+}
+
+// ---------------------------------------------------------------------------
+// Shared snapshot file
+// ---------------------------------------------------------------------------
+
+/**
+ * Write a snapshot to a private temporary file that workers can read.
+ * @param snapshot is the packed snapshot bytes
+ * @returns the path of the file; remove it with removeSnapshotFile()
+ */
+export function writeSnapshotFile(snapshot: Uint8Array): string {
+  const dir = fs.mkdtempSync(join(os.tmpdir(), 'decomp-snapshot-'));
+  const path = join(dir, 'image.bin');
+  fs.writeFileSync(path, snapshot);
+  return path;
+}
+
+/** Read a snapshot written by writeSnapshotFile() */
+export function readSnapshotFile(path: string): Uint8Array {
+  const buf = fs.readFileSync(path);
+  return new Uint8Array(buf.buffer, buf.byteOffset, buf.byteLength);
+}
+
+/** Remove a snapshot file and its temporary directory */
+export function removeSnapshotFile(path: string): void {
+  try {
+    fs.rmSync(join(path, '..'), { recursive: true, force: true });
+  } catch {
+    // Best-effort cleanup
+  }
+}
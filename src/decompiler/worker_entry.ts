@@ -2,31 +2,62 @@
  * @file worker_entry.ts
  * @description Child process entry point for parallel decompilation.
  *
- * Each child process independently loads the XML, initializes its own Architecture,
- * and decompiles functions assigned by the parent process via IPC.
+ * Each child process restores its own Architecture, normally from the packed load
+ * image snapshot built once by the parent, and decompiles functions assigned by
+ * the parent process via IPC.
  *
- * Uses child_process.fork() (not worker_threads) because Node.js v23's native
- * type stripping doesn't handle .js→.ts import resolution in worker threads.
- * fork() inherits tsx's ESM loader hooks, giving full module resolution.
+ * The child never reads the export itself: the parent streams it once and sends the
+ * path of the packed snapshot, and only when no snapshot could be made does it send
+ * the XML text for the child to parse.  Children are separate processes (fork()) so
+ * each has its own heap, which the parent can recycle once its RSS grows too large.
  *
  * Protocol (IPC messages):
- *   Parent → Child:  {type:'init', xmlString, workerId}
+ *   Parent → Child:  {type:'init', snapshotPath + coreTypes? | xmlString, workerId, root?, budget?, cacheDeps?, feedForward?, tokenStream?}
  *   Child  → Parent: {type:'ready', workerId}
- *   Parent → Child:  {type:'assign', functionName}
- *   Child  → Parent: {type:'result', name, output, timeMs, success, error?, workerId}
+ *   Parent → Child:  {type:'assign', functionNames}
+ *   Child  → Parent: {type:'result', name, output, timeMs, success, error?, budgetExceeded?, deps?, proto?, rssMb, workerId}
+ *   Parent → Child:  {type:'proto', name, proto}
+ *   Parent → Child:  {type:'run', id, commands}
+ *   Child  → Parent: {type:'output', id, output, messages, timeMs, success, error?, workerId}
+ *   Parent → Child:  {type:'profile'}
+ *   Child  → Parent: {type:'profile', data, workerId}   (data is null unless init set profile)
+ *   Parent → Child:  {type:'trace'}
+ *   Child  → Parent: {type:'trace', events, workerId}   (events is null unless init set trace)
  *   Parent → Child:  {type:'shutdown'}
  *   Child  → Parent: {type:'init_error', error, workerId}  (if init fails)
+ *
+ * The optional init root names the root Action to decompile with (the ActionDatabase default
+ * "decompile" if absent), e.g. "triage".
+ * The optional init budget ({timeMs, heapGrowthMb}) is applied to each function of an
+ * assign batch. An overrun aborts only that function; the worker stays up for the rest.
+ * With cacheDeps set, each successful result carries the ResultDependencies of the
+ * function, which the parent needs to store the output in its ResultCache.
+ * With a snapshot, coreTypes carries the parent's core data-types (TypeFactory.exportCoreTable()),
+ * which the snapshot does not hold; without it the worker builds the default core types.
+ * With feedForward set, each result carries the PrototypeRecord recovered for the function
+ * (if any), and the parent forwards it to every worker in a proto message, which locks it
+ * onto that function so later callers are decompiled against it.
+ * With tokenStream set, each result's output is the packed token stream of `print C packed`
+ * (one base64 line, see tokenstream.ts) instead of the C text.
+ * With trace set, the child installs an EventTracer and records its start-up, each function,
+ * the actions within it, GC pauses and the idle time between messages from the parent.
+ *
+ * Each function of an assign batch is released (Architecture.releaseAnalysis) once its
+ * result is built, so the child's memory does not grow with the functions it has done. Only
+ * the symbol and prototype facts remain. Each result reports the child's resident set size,
+ * which the parent uses to recycle a child that has grown too large anyway.
  */
 
-// Register XmlArchitectureCapability singleton (side-effect import)
-import '../console/xml_arch.js';
-
 import { startDecompilerLibrary } from '../console/libdecomp.js';
-import { DocumentStorage } from '../core/xml.js';
-import { ArchitectureCapability } from './architecture.js';
+import { buildSnapshotArchitecture, buildXmlArchitecture, readSnapshotFile } from './worker_arch.js';
 import { ConsoleCommands } from '../console/testfunction.js';
 import { StringWriter } from '../util/writer.js';
 import { mainloop } from '../console/ifacedecomp.js';
+import { ActionBudget, type ActionBudgetLimits } from './action.js';
+import { ActionProfiler } from './actionprofile.js';
+import { EventTracer } from './eventtrace.js';
+import { ResultCache } from './resultcache.js';
+import { capturePrototype, applyPrototype } from './callgraph.js';
 import type { Writer } from '../util/writer.js';
 
 // Wait for init message from parent
@@ -36,14 +67,45 @@ let initialized = false;
 let con: InstanceType<typeof ConsoleCommands>;
 let commands: string[];
 let workerId: number;
+let budgetLimits: ActionBudgetLimits | null = null;
+let cacheDeps = false;
+let feedForward = false;
+let printCommand = 'print C';
+let tracer: EventTracer | null = null;
+/** When the child last went idle waiting for the parent (trace time) */
+let idleSince = 0;
+
+/** Send a message to the parent, after which the child waits for the next one */
+function reply(msg: any): void {
+  process.send!(msg);
+  if (tracer !== null) idleSince = EventTracer.now();
+}
 
 function handleMessage(msg: any): void {
+  if (tracer !== null && idleSince > 0 && (msg.type === 'assign' || msg.type === 'run')) {
+    tracer.complete('idle', 'ipc', idleSince);
+    idleSince = 0;
+  }
   if (msg.type === 'init') {
     if (initialized) return;
     workerId = msg.workerId;
+    budgetLimits = ActionBudget.isLimited(msg.budget) ? msg.budget : null;
+    cacheDeps = msg.cacheDeps === true;
+    feedForward = msg.feedForward === true;
+    printCommand = msg.tokenStream === true ? 'print C packed' : 'print C';
+    if (msg.trace) {
+      tracer = new EventTracer(`worker ${workerId}`);
+      tracer.observeGc();
+      // From process start to the init message: module loading and the fork itself
+      tracer.complete('startup', 'worker', EventTracer.fromPerformance(0));
+      EventTracer.active = tracer;
+    }
+    const initStart = EventTracer.now();
     try {
       // Initialize decompiler library (each child has its own module scope)
+      let phaseStart = EventTracer.now();
       startDecompilerLibrary();
+      tracer?.complete('start library', 'worker', phaseStart);
 
       // Create console infrastructure — ConsoleCommands registers all decompiler
       // commands (load function, decompile, print C, etc.) via IfaceCapability
@@ -53,28 +115,29 @@ function handleMessage(msg: any): void {
       con.setErrorIsDone(true);
       const dcp = con.getData('decompile') as any;
 
-      // Parse XML and build Architecture (same pattern as FunctionTestCollection.buildProgram)
-      const docStorage = new DocumentStorage();
-      const doc = docStorage.parseDocument(msg.xmlString);
-      const el = doc.getRoot();
-      for (const child of el.getChildren()) {
-        if (child.getName() === 'binaryimage') {
-          docStorage.registerTag(child);
-          break;
-        }
+      // Restore the Architecture from the parent's snapshot, or parse the XML as a fallback
+      phaseStart = EventTracer.now();
+      if (msg.snapshotPath) {
+        dcp.conf = buildSnapshotArchitecture(readSnapshotFile(msg.snapshotPath), nullWriter, msg.coreTypes ?? null);
+        tracer?.complete('restore snapshot', 'worker', phaseStart);
+      } else {
+        dcp.conf = buildXmlArchitecture(msg.xmlString, nullWriter);
+        tracer?.complete('parse XML', 'worker', phaseStart);
       }
-      const capa = ArchitectureCapability.getCapability('xml');
-      if (!capa) throw new Error('Missing XML architecture capability');
-      dcp.conf = capa.buildArchitecture('test', '', nullWriter);
-      dcp.conf.init(docStorage);
-      dcp.conf.readLoaderSymbols('::');
 
       if (msg.enhancedDisplay) {
         dcp.conf.applyEnhancedDisplay();
       }
+      if (msg.root) {
+        dcp.conf.allacts.setCurrent(msg.root);
+      }
+      if (msg.profile) {
+        ActionProfiler.active = new ActionProfiler();
+      }
 
       initialized = true;
-      process.send!({ type: 'ready', workerId });
+      tracer?.complete('init', 'worker', initStart);
+      reply({ type: 'ready', workerId });
     } catch (err: any) {
       process.send!({
         type: 'init_error',
@@ -85,47 +148,148 @@ function handleMessage(msg: any): void {
     }
   } else if (msg.type === 'assign') {
     if (!initialized) return;
-    const start = performance.now();
-    try {
-      // Set up commands for this function
-      commands.length = 0;
-      commands.push(`load function ${msg.functionName}`);
-      commands.push('decompile');
-      commands.push('print C');
-
-      // Capture output — optr gets console messages, fileoptr gets C output
-      const midBuf = new StringWriter();
-      const outBuf = new StringWriter();
-      con.optr = midBuf;
-      con.fileoptr = outBuf;
-      con.reset();
-
-      mainloop(con);
-
-      const output = outBuf.toString();
-      const timeMs = performance.now() - start;
-
-      process.send!({
-        type: 'result',
-        name: msg.functionName,
-        output,
-        timeMs,
-        success: !con.isInError(),
-        error: con.isInError() ? midBuf.toString().trim() : undefined,
-        workerId,
-      });
-    } catch (err: any) {
-      process.send!({
+    // A batch of functions, answered with one result message per function
+    const names: string[] = msg.functionNames ?? [msg.functionName];
+    for (const name of names) {
+      const funcStart = tracer !== null ? EventTracer.now() : 0;
+      const lines = [
+        `load function ${name}`,
+        'decompile',
+        printCommand,
+      ];
+      const budget = budgetLimits !== null ? new ActionBudget(budgetLimits) : null;
+      const res = budget !== null
+        ? ActionBudget.run(budget, () => runCommands(lines))
+        : runCommands(lines);
+      const over = budget?.exceeded ?? null;
+      let deps = undefined;
+      if (cacheDeps && res.success && over === null) {
+        const dcp = con.getData('decompile') as any;
+        try {
+          deps = dcp.fd !== null ? ResultCache.describe(dcp.conf, dcp.fd) ?? undefined : undefined;
+        } catch {
+          // Not cacheable; the result is still delivered
+        }
+      }
+      let proto = undefined;
+      if (feedForward && res.success && over === null) {
+        const dcp = con.getData('decompile') as any;
+        try {
+          proto = dcp.fd !== null ? capturePrototype(dcp.fd) ?? undefined : undefined;
+        } catch {
+          // Callers recover the prototype themselves
+        }
+      }
+      releaseFunction();
+      tracer?.complete(name, 'function', funcStart, { success: res.success });
+      reply({
         type: 'result',
-        name: msg.functionName,
-        output: '',
-        timeMs: performance.now() - start,
-        success: false,
-        error: err.explain ?? err.message ?? String(err),
+        name,
+        output: res.output,
+        timeMs: res.timeMs,
+        success: res.success,
+        error: over !== null ? over.explain : res.error,
+        budgetExceeded: over !== null
+          ? { reason: over.reason, action: over.actionName, elapsedMs: over.elapsedMs }
+          : undefined,
+        deps,
+        proto,
+        rssMb: process.memoryUsage.rss() / (1024 * 1024),
         workerId,
       });
     }
+  } else if (msg.type === 'proto') {
+    if (!initialized) return;
+    const dcp = con.getData('decompile') as any;
+    try {
+      const fd = dcp.conf.symboltab.getGlobalScope().queryFunction(msg.name);
+      if (fd !== null) applyPrototype(dcp.conf, fd, msg.proto);
+    } catch {
+      // A prototype that does not fit is left unlocked
+    }
+  } else if (msg.type === 'run') {
+    if (!initialized) return;
+    const runStart = tracer !== null ? EventTracer.now() : 0;
+    const res = runCommands(msg.commands);
+    tracer?.complete('run', 'function', runStart, { commands: msg.commands.length });
+    reply({
+      type: 'output',
+      id: msg.id,
+      output: res.output,
+      messages: res.messages,
+      timeMs: res.timeMs,
+      success: res.success,
+      error: res.error,
+      workerId,
+    });
+  } else if (msg.type === 'profile') {
+    process.send!({
+      type: 'profile',
+      data: ActionProfiler.active?.toData() ?? null,
+      workerId,
+    });
+  } else if (msg.type === 'trace') {
+    process.send!({
+      type: 'trace',
+      events: tracer !== null ? tracer.getEvents() : null,
+      workerId,
+    });
   } else if (msg.type === 'shutdown') {
     process.exit(0);
   }
 }
+
+/** Release the analysis of the function the console last decompiled, after its output */
+function releaseFunction(): void {
+  const dcp = con.getData('decompile') as any;
+  if (dcp.fd === null) return;
+  try {
+    dcp.conf.releaseAnalysis(dcp.fd);
+  } catch {
+    // Best-effort cleanup
+  }
+}
+
+interface RunResult {
+  output: string;
+  messages: string;
+  timeMs: number;
+  success: boolean;
+  error?: string;
+}
+
+/**
+ * Execute a sequence of console commands against the warm Architecture.
+ * optr collects console messages, fileoptr collects the C output.
+ */
+function runCommands(lines: string[]): RunResult {
+  const start = performance.now();
+  const midBuf = new StringWriter();
+  const outBuf = new StringWriter();
+  try {
+    commands.length = 0;
+    commands.push(...lines);
+    con.optr = midBuf;
+    con.fileoptr = outBuf;
+    con.reset();
+
+    mainloop(con);
+
+    const messages = midBuf.toString();
+    return {
+      output: outBuf.toString(),
+      messages,
+      timeMs: performance.now() - start,
+      success: !con.isInError(),
+      error: con.isInError() ? messages.trim() : undefined,
+    };
+  } catch (err: any) {
+    return {
+      output: '',
+      messages: midBuf.toString(),
+      timeMs: performance.now() - start,
+      success: false,
+      error: err.explain ?? err.message ?? String(err),
+    };
+  }
+}
@@ -0,0 +1,111 @@
+/**
+ * @file slacache.ts
+ * @description Optional on-disk cache of inflated .sla payloads.
+ *
+ * Loading a processor spec inflates the whole .sla file and then scans the symbol table to
+ * find the symbol bodies. The cache saves the inflated payload together with the symbol
+ * table index that FormatDecode recorded (see SymbolTable.decode), keyed by the SHA-256 of
+ * the original .sla file. A cache hit skips both the inflate and the scan. Combined with the
+ * lazy decoding of SubtableSymbol bodies, only the headers and the small symbols are decoded
+ * at load time.
+ *
+ * Cache files are written to a temporary name and renamed, so concurrent processes sharing a
+ * directory never see a partial file. Any read or write failure falls back to the normal path.
+ */
+
+import * as fs from 'fs';
+import { createHash } from 'crypto';
+import { join } from 'path';
+import type { FormatDecode } from './slaformat.js';
+
+/** Contents of a cache hit */
+export interface SlaCacheEntry {
+  /** The inflated payload, without the .sla header */
+  payload: Uint8Array;
+  /** The symbol table index; see FormatDecode.getSymbolIndex() */
+  index: Int32Array;
+}
+
+/**
+ * Disk cache of inflated .sla payloads, enabled by setting SlaCache.directory.
+ *
+ * File layout (little-endian): magic, version, payload length, index count,
+ * index words, payload bytes.
+ */
+export class SlaCache {
+  /** Directory holding the cache files, or null to disable caching */
+  static directory: string | null = null;
+
+  private static readonly MAGIC = 0x43414c53;      // "SLAC"
+  private static readonly VERSION = 1;
+  private static readonly HEADER_SIZE = 16;
+
+  /** Get the cache key for the raw contents of a .sla file */
+  static keyOf(data: Uint8Array): string {
+    return createHash('sha256').update(data).digest('hex');
+  }
+
+  private static pathOf(data: Uint8Array): string {
+    return join(SlaCache.directory!, SlaCache.keyOf(data) + '.slac');
+  }
+
+  /**
+   * Look up the cached payload for a .sla file.
+   * @param data is the raw .sla file contents
+   * @returns the cached entry, or null on a miss or if caching is disabled
+   */
+  static load(data: Uint8Array): SlaCacheEntry | null {
+    if (SlaCache.directory === null) return null;
+    let buf: Buffer;
+    try {
+      buf = fs.readFileSync(SlaCache.pathOf(data));
+    } catch {
+      return null;
+    }
+    if (buf.length < SlaCache.HEADER_SIZE) return null;
+    const view = new DataView(buf.buffer, buf.byteOffset, buf.byteLength);
+    if (view.getUint32(0, true) !== SlaCache.MAGIC || view.getUint32(4, true) !== SlaCache.VERSION)
+      return null;
+    const payloadLen = view.getUint32(8, true);
+    const count = view.getUint32(12, true);
+    const payloadStart = SlaCache.HEADER_SIZE + 4 * count;
+    if (count === 0 || payloadStart + payloadLen !== buf.length) return null;
+    const index = new Int32Array(count);
+    for (let i = 0; i < count; ++i)
+      index[i] = view.getInt32(SlaCache.HEADER_SIZE + 4 * i, true);
+    const payload = new Uint8Array(buf.buffer, buf.byteOffset + payloadStart, payloadLen);
+    return { payload, index };
+  }
+
+  /**
+   * Save the payload and symbol index of a fully decoded .sla file. Does nothing if caching
+   * is disabled or the decoder did not record an index.
+   * @param data is the raw .sla file contents
+   * @param decoder is the FormatDecode that decoded it
+   */
+  static store(data: Uint8Array, decoder: FormatDecode): void {
+    if (SlaCache.directory === null) return;
+    const payload = decoder.getPayload();
+    const index = decoder.getSymbolIndex();
+    if (payload === null || index === null) return;
+    const out = new Uint8Array(SlaCache.HEADER_SIZE + 4 * index.length + payload.length);
+    const view = new DataView(out.buffer);
+    view.setUint32(0, SlaCache.MAGIC, true);
+    view.setUint32(4, SlaCache.VERSION, true);
+    view.setUint32(8, payload.length, true);
+    view.setUint32(12, index.length, true);
+    for (let i = 0; i < index.length; ++i)
+      view.setInt32(SlaCache.HEADER_SIZE + 4 * i, index[i], true);
+    out.set(payload, SlaCache.HEADER_SIZE + 4 * index.length);
+    const path = SlaCache.pathOf(data);
+    const tmp = path + '.' + process.pid + '.tmp';
+    try {
+      fs.mkdirSync(SlaCache.directory, { recursive: true });
+      fs.writeFileSync(tmp, out);
+      fs.renameSync(tmp, path);
+    } catch {
+      // Best-effort: the cache is only an optimization
+      try { fs.rmSync(tmp, { force: true }); } catch { /* ignore */ }
+    }
+  }
+}
@@ -281,6 +281,11 @@ export class FormatDecode extends PackedDecode {
   /** The size of the input buffer */
   private static readonly IN_BUFFER_SIZE: number = 4096;
 
+  /** The inflated payload, kept so that it can be written to the SlaCache */
+  private payload: Uint8Array | null = null;
+  /** Stream positions of the symbol table: [end, body0, body1, ...], or null if not known yet */
+  private symbolIndex: Int32Array | null = null;
+
   /**
    * Initialize the decoder.
    * @param spcManager - The (uninitialized) manager that will hold decoded address spaces
@@ -289,6 +294,26 @@ export class FormatDecode extends PackedDecode {
     super(spcManager);
   }
 
+  /** Get the inflated payload, or null if the input came from ingestStream() */
+  getPayload(): Uint8Array | null { return this.payload; }
+
+  /** Get the symbol table index recorded by SymbolTable.decode, or supplied by ingestPayload() */
+  getSymbolIndex(): Int32Array | null { return this.symbolIndex; }
+
+  /** Record the positions of the symbol table bodies, filled in by SymbolTable.decode */
+  setSymbolIndex(index: Int32Array): void { this.symbolIndex = index; }
+
+  /**
+   * Ingest a payload that has already been inflated, typically from the SlaCache.
+   * @param payload - The decompressed .sla data, without the header
+   * @param index - The symbol table index recorded when the payload was first decoded, if known
+   */
+  ingestPayload(payload: Uint8Array, index: Int32Array | null): void {
+    this.payload = payload;
+    this.symbolIndex = index;
+    super.ingestBytes(payload);
+  }
+
   /**
    * Ingest a raw .sla file from a Uint8Array (synchronous).
    *
@@ -313,6 +338,8 @@ export class FormatDecode extends PackedDecode {
 
     // Use ingestBytes to avoid lossy TextDecoder('latin1') round-trip
     // TextDecoder('latin1') actually uses Windows-1252 which corrupts bytes 0x80-0x9F
+    this.payload = decompressed;
+    this.symbolIndex = null;
     super.ingestBytes(decompressed);
   }
 
@@ -11,6 +11,7 @@ import { ConstTpl, VarnodeTpl, OpTpl, HandleTpl, ConstructTpl, PcodeBuilder } fr
 import { ParserContext, ParserWalker, ParserWalkerChange, FixedHandle } from './context.js';
 import { SleighBase } from './sleighbase.js';
 import { FormatDecode } from './slaformat.js';
+import { SlaCache } from './slacache.js';
 import { Writer, StringWriter } from '../util/writer.js';
 import * as fs from 'fs';
 
@@ -98,6 +99,155 @@ export class PcodeCacher {
       emt.dump(addr, op.opc, op.outvar, op.invar, op.isize);
     }
   }
+
+  /** Copy the issued p-code, with relatives resolved, for storage in a LiftCache */
+  snapshot(): PcodeData[] {
+    return this.issued.map(copyPcodeData);
+  }
+}
+
+function copyVarnodeData(vn: VarnodeData): VarnodeData {
+  return new VarnodeData(vn.space, vn.offset, vn.size);
+}
+
+function copyPcodeData(op: PcodeData): PcodeData {
+  return {
+    opc: op.opc,
+    outvar: op.outvar === null ? null : copyVarnodeData(op.outvar),
+    invar: op.invar.map(copyVarnodeData),
+    isize: op.isize,
+  };
+}
+
+/** A lifted instruction stored by LiftCache */
+interface LiftEntry {
+  /** Instruction bytes the entry was built from */
+  bytes: Uint8Array;
+  /** Length of the instruction in bytes */
+  length: number;
+  /** Raw p-code, or null if only the length is known */
+  ops: PcodeData[] | null;
+}
+
+/**
+ * Program-wide cache of decoded instructions, keyed by address plus the context register state.
+ *
+ * DisassemblyCache only holds the last few parses, so an address lifted again later (shared
+ * tails, inlined callees, restarted functions, whole-binary runs) goes through the decision
+ * tree and p-code template build again. This cache keeps the instruction length and the raw
+ * p-code output instead. Changes to context are covered by the key, and changes to memory by
+ * comparing the instruction bytes on each hit. Only instructions whose p-code depends on nothing
+ * else are stored: no context commits, delay slots, crossbuilds or inst_next2. The oldest
+ * entries are evicted once the cache is full.
+ */
+export class LiftCache {
+  private entries: Map<string, LiftEntry> = new Map();
+  private maxEntries: number;
+  private disabled: boolean = false;
+  private scratch: Uint8Array = new Uint8Array(16);
+  private ctxbuf: number[] = [];
+  hits: number = 0;
+  misses: number = 0;
+
+  /** @param maxEntries is the capacity; 0 disables the cache */
+  constructor(maxEntries: number) {
+    this.maxEntries = maxEntries;
+  }
+
+  isEnabled(): boolean {
+    return this.maxEntries > 0 && !this.disabled;
+  }
+
+  /** Change the capacity, evicting entries as necessary */
+  setCapacity(maxEntries: number): void {
+    this.maxEntries = maxEntries;
+    this.evict();
+  }
+
+  /** Drop all entries and stop caching until reset(), keeping the configured capacity */
+  disable(): void {
+    this.disabled = true;
+    this.entries.clear();
+  }
+
+  clear(): void {
+    this.entries.clear();
+  }
+
+  /** Drop all entries and counts, and enable the cache again at its configured capacity */
+  reset(): void {
+    this.entries.clear();
+    this.disabled = false;
+    this.hits = 0;
+    this.misses = 0;
+  }
+
+  size(): number {
+    return this.entries.size;
+  }
+
+  /** Build the key for an address under its current context */
+  makeKey(addr: Address, ctx: ContextCache, contextsize: number): string {
+    const buf = this.ctxbuf;
+    ctx.getContext(addr, buf);
+    let key = addr.getSpace()!.getIndex() + ':' + addr.getOffset().toString(16);
+    for (let i = 0; i < contextsize; ++i)
+      key += ':' + buf[i];
+    return key;
+  }
+
+  /**
+   * Look up an instruction, checking that memory still holds the same bytes.
+   * @param key is from makeKey()
+   * @param addr is the address of the instruction
+   * @param loader is the LoadImage to read the current bytes from
+   * @returns the entry or null
+   */
+  lookup(key: string, addr: Address, loader: LoadImage): LiftEntry | null {
+    const ent = this.entries.get(key);
+    if (ent === undefined) {
+      this.misses += 1;
+      return null;
+    }
+    loader.loadFill(this.scratch, 16, addr);
+    for (let i = 0; i < ent.length; ++i) {
+      if (this.scratch[i] !== ent.bytes[i]) {
+        this.entries.delete(key);
+        this.misses += 1;
+        return null;
+      }
+    }
+    this.hits += 1;
+    return ent;
+  }
+
+  /** Store an instruction decoded from the given buffer */
+  store(key: string, buf: Uint8Array, length: number, ops: PcodeData[] | null): void {
+    if (length <= 0 || length > buf.length) return;
+    const old = this.entries.get(key);
+    if (old !== undefined) {
+      if (ops === null) return;       // Keep the p-code already stored
+      this.entries.delete(key);
+    }
+    this.entries.set(key, { bytes: buf.slice(0, length), length, ops });
+    this.evict();
+  }
+
+  private evict(): void {
+    while (this.entries.size > this.maxEntries) {
+      const first = this.entries.keys().next();
+      if (first.done) break;
+      this.entries.delete(first.value);
+    }
+  }
+
+  /** Send the stored p-code of an entry to an emitter */
+  static emit(ent: LiftEntry, addr: Address, emt: PcodeEmit): void {
+    for (const op of ent.ops!) {
+      emt.dump(addr, op.opc, op.outvar === null ? null : copyVarnodeData(op.outvar),
+               op.invar.map(copyVarnodeData), op.isize);
+    }
+  }
 }
 
 export class DisassemblyCache {
@@ -160,6 +310,8 @@ export class SleighBuilder extends PcodeBuilder {
   private uniqueoffset: bigint;
   private discache: DisassemblyCache;
   private cache: PcodeCacher;
+  private delayslots: boolean = false;  // Set if p-code was built from a delay slot instruction
+  private crossbuilt: boolean = false;  // Set if p-code was built by a crossbuild directive
 
   constructor(
     w: ParserWalker,
@@ -183,6 +335,16 @@ export class SleighBuilder extends PcodeBuilder {
     this.uniqueoffset = (addr.getOffset() & this.uniquemask) << 8n;
   }
 
+  /** Return true if a delay slot or crossbuild pulled in p-code from another instruction */
+  usedOtherInstructions(): boolean {
+    return this.delayslots || this.crossbuilt;
+  }
+
+  /** Return true if a crossbuild directive was executed */
+  usedCrossBuild(): boolean {
+    return this.crossbuilt;
+  }
+
   private generateLocation(vntpl: VarnodeTpl, vn: VarnodeData): void {
     vn.space = vntpl.getSpace().fixSpace(this.walker!);
     vn.size = Number(vntpl.getSize().fix(this.walker!));
@@ -337,6 +499,7 @@ export class SleighBuilder extends PcodeBuilder {
   }
 
   delaySlot(op: OpTpl): void {
+    this.delayslots = true;
     const tmp = this.walker!;
     const olduniqueoffset = this.uniqueoffset;
 
@@ -369,6 +532,7 @@ export class SleighBuilder extends PcodeBuilder {
   appendCrossBuild(bld: OpTpl, secnum: number): void {
     if (secnum >= 0)
       throw new LowlevelError('CROSSBUILD directive within a named section');
+    this.crossbuilt = true;
     secnum = Number(bld.getIn(1).getOffset().getReal());
     const vn: VarnodeTpl = bld.getIn(0);
     const spc: AddrSpace = vn.getSpace().fixSpace(this.walker!);
@@ -404,6 +568,10 @@ export class Sleigh extends SleighBase {
   private cache_ctx: ContextCache;
   private discache: DisassemblyCache | null = null;
   private pcode_cache: PcodeCacher = new PcodeCacher();
+  private lift_cache: LiftCache = new LiftCache(Sleigh.DEFAULT_LIFT_CACHE_SIZE);
+
+  /** Default capacity of the program-wide lifted instruction cache */
+  static DEFAULT_LIFT_CACHE_SIZE = 1 << 16;
 
   constructor(ld: LoadImage, c_db: ContextDatabase) {
     super();
@@ -420,6 +588,7 @@ export class Sleigh extends SleighBase {
   reset(ld: LoadImage, c_db: ContextDatabase): void {
     this.clearForDelete();
     this.pcode_cache.clear();
+    this.lift_cache.reset();
     this.loader = ld;
     this.context_db = c_db;
     this.cache_ctx = new ContextCache(c_db);
@@ -435,8 +604,14 @@ export class Sleigh extends SleighBase {
       // Read the binary .sla file and feed it to FormatDecode
       const slaData = fs.readFileSync(slafile);
       const decoder = new FormatDecode(this as any);
-      decoder.ingestStreamFromBytes(slaData);
+      const cached = SlaCache.load(slaData);
+      if (cached !== null)
+        decoder.ingestPayload(cached.payload, cached.index);
+      else
+        decoder.ingestStreamFromBytes(slaData);
       this.decodeSleigh(decoder);
+      if (cached === null)
+        SlaCache.store(slaData, decoder);
     } else {
       this.reregisterContext();
     }
@@ -564,8 +739,38 @@ export class Sleigh extends SleighBase {
     pos.setParserState(ParserContext.pcode);
   }
 
+  /** Get the program-wide lifted instruction cache */
+  getLiftCache(): LiftCache {
+    return this.lift_cache;
+  }
+
+  /**
+   * Drop all cached lifts, for callers that change the image in ways the byte check
+   * cannot see (such as replacing the Translate's view of a whole space).
+   */
+  clearLiftCache(): void {
+    this.lift_cache.clear();
+  }
+
+  private liftKey(baseaddr: Address): string | null {
+    if (!this.lift_cache.isEnabled()) return null;
+    return this.lift_cache.makeKey(baseaddr, this.cache_ctx, this.context_db.getContextSize());
+  }
+
+  /** Return true if the parsed instruction depends only on its own bytes and context */
+  private isSelfContained(pos: ParserContext): boolean {
+    return pos.getDelaySlot() === 0 && pos._contextcommit.length === 0 && pos._n2addr.isInvalid();
+  }
+
   instructionLength(baseaddr: Address): number {
+    const key = this.liftKey(baseaddr);
+    if (key !== null) {
+      const ent = this.lift_cache.lookup(key, baseaddr, this.loader);
+      if (ent !== null) return ent.length;
+    }
     const pos = this.obtainContext(baseaddr, ParserContext.disassembly);
+    if (key !== null && this.isSelfContained(pos))
+      this.lift_cache.store(key, pos.getBuffer(), pos.getLength(), null);
     return pos.getLength();
   }
 
@@ -577,6 +782,15 @@ export class Sleigh extends SleighBase {
       }
     }
 
+    const key = this.liftKey(baseaddr);
+    if (key !== null) {
+      const ent = this.lift_cache.lookup(key, baseaddr, this.loader);
+      if (ent !== null && ent.ops !== null) {
+        LiftCache.emit(ent, baseaddr, emit);
+        return ent.length;
+      }
+    }
+
     const pos = this.obtainContext(baseaddr, ParserContext.pcode);
     pos.applyCommits();
     fallOffset = pos.getLength();
@@ -606,6 +820,12 @@ export class Sleigh extends SleighBase {
     try {
       builder.build(walker.getConstructor().getTempl(), -1);
       this.pcode_cache.resolveRelatives();
+      if (builder.usedCrossBuild()) {
+        // Crossbuild targets must be in the DisassemblyCache, which cache hits bypass
+        this.lift_cache.disable();
+      } else if (key !== null && !builder.usedOtherInstructions() && this.isSelfContained(pos)) {
+        this.lift_cache.store(key, pos.getBuffer(), fallOffset, this.pcode_cache.snapshot());
+      }
       this.pcode_cache.emit(baseaddr, emit);
     } catch (err) {
       if (err instanceof UnimplError) {
@@ -50,6 +50,7 @@ import {
   SLA_ATTRIB_PIECE, SLA_ATTRIB_I, SLA_ATTRIB_SHIFT, SLA_ATTRIB_MASK,
   SLA_ATTRIB_NUMBER, SLA_ATTRIB_CONTEXT, SLA_ATTRIB_STARTBIT,
   SLA_ATTRIB_NUMCT,
+  FormatDecode,
 } from './slaformat.js';
 
 // Forward type declarations for not-yet-wired modules
@@ -188,6 +189,13 @@ export class SymbolScope {
 // =========================================================================
 
 export class SymbolTable {
+  /**
+   * Defer decoding of SubtableSymbol bodies read by a FormatDecode until the table is first
+   * used. Subtables hold the constructors, templates and decision trees, which are the bulk
+   * of a .sla file.
+   */
+  static lazyDecode: boolean = true;
+
   private symbollist: (SleighSymbol | null)[] = [];
   private table: (SymbolScope | null)[] = [];
   private curscope: SymbolScope | null = null;
@@ -314,15 +322,49 @@ export class SymbolTable {
     this.curscope = this.table[0]!;
     for (let i = 0; i < symbolsize; ++i)
       this.decodeSymbolHeader(decoder);
-    while (decoder.peekElement() !== 0) {
-      decoder.openElement();
-      const id = Number(decoder.readUnsignedIntegerById(SLA_ATTRIB_ID));
-      const sym = this.findSymbol(id)!;
-      sym.decode(decoder, trans);
+    const fmt = decoder instanceof FormatDecode ? decoder : null;
+    const index = fmt !== null ? fmt.getSymbolIndex() : null;
+    if (index !== null) {
+      // Positions are known from a previous decode of the same payload, so skip the scan
+      for (let i = 1; i < index.length; ++i) {
+        fmt!.seek(index[i]);
+        this.decodeSymbolBody(decoder, trans, fmt, false);
+      }
+      fmt!.seek(index[0]);
+    } else {
+      const positions: number[] = [0];
+      while (decoder.peekElement() !== 0) {
+        if (fmt !== null) positions.push(fmt.getPosition());
+        this.decodeSymbolBody(decoder, trans, fmt, true);
+      }
+      if (fmt !== null) {
+        positions[0] = fmt.getPosition();
+        fmt.setSymbolIndex(Int32Array.from(positions));
+      }
     }
     decoder.closeElement(el);
   }
 
+  /**
+   * Decode the body of one symbol, or defer it if it is a SubtableSymbol and lazy decoding
+   * is enabled.
+   * @param fmt is the decoder, if it supports seeking
+   * @param skip is true if a deferred body must be skipped to reach the next symbol
+   */
+  private decodeSymbolBody(decoder: Decoder, trans: SleighBase, fmt: FormatDecode | null, skip: boolean): void {
+    const pos = fmt !== null ? fmt.getPosition() : 0;
+    const subel = decoder.openElement();
+    const id = Number(decoder.readUnsignedIntegerById(SLA_ATTRIB_ID));
+    const sym = this.findSymbol(id)!;
+    if (fmt !== null && SymbolTable.lazyDecode && sym.getType() === SymbolType.subtable_symbol) {
+      (sym as SubtableSymbol).deferDecode(fmt, pos, trans);
+      if (skip)
+        decoder.closeElementSkipping(subel);
+      return;
+    }
+    sym.decode(decoder, trans);
+  }
+
   decodeSymbolHeader(decoder: Decoder): void {
     let sym: SleighSymbol;
     const el = decoder.peekElement();
@@ -2232,6 +2274,118 @@ export class DecisionProperties {
   getConflictErrors(): [Constructor, Constructor][] { return this.conflicterrors; }
 }
 
+// =========================================================================
+// DecisionTable
+// =========================================================================
+
+/**
+ * Flattened, table-driven form of a DecisionNode tree.
+ *
+ * Every node of the tree is one row in a set of parallel typed arrays. A branch row holds
+ * the bit-field extractor for its decision, precomputed from startbit and bitsize, together
+ * with the row index of its first child; the children of a row are consecutive. Instruction
+ * fields store the byte offset, byte count and the two shifts that ParserContext would
+ * otherwise recompute on every call. Context fields store the word index and shifts, plus
+ * a second shift when the field straddles two words. A leaf row indexes the ordered pattern
+ * list of its DecisionNode, which is still tested with DisjointPattern.isMatch.
+ *
+ * resolve() walks the rows in a single loop and reads the instruction buffer and context
+ * words directly, so no DecisionNode objects are touched until a leaf is reached.
+ */
+export class DecisionTable {
+  static readonly LEAF = 0;
+  static readonly INSTRUCTION = 1;
+  static readonly CONTEXT = 2;
+
+  private kind: Uint8Array;           // LEAF, INSTRUCTION or CONTEXT
+  private offset: Int32Array;         // Byte offset (instruction) or word index (context)
+  private bytesize: Uint8Array;       // Number of instruction bytes to read
+  private lshift: Uint8Array;         // Shift moving the field's first bit to the top
+  private rshift: Uint8Array;         // Shift moving the field to the bottom
+  private rshift2: Uint8Array;        // Shift of the second context word, 0 if not needed
+  private first: Int32Array;          // Row of the first child, or index into leaves
+  private leaves: [DisjointPattern, Constructor][][] = [];
+
+  constructor(rows: number) {
+    this.kind = new Uint8Array(rows);
+    this.offset = new Int32Array(rows);
+    this.bytesize = new Uint8Array(rows);
+    this.lshift = new Uint8Array(rows);
+    this.rshift = new Uint8Array(rows);
+    this.rshift2 = new Uint8Array(rows);
+    this.first = new Int32Array(rows);
+  }
+
+  /** Number of rows (nodes) in the table */
+  numRows(): number { return this.kind.length; }
+
+  /** Number of leaf rows in the table */
+  numLeaves(): number { return this.leaves.length; }
+
+  setLeaf(row: number, list: [DisjointPattern, Constructor][]): void {
+    this.kind[row] = DecisionTable.LEAF;
+    this.first[row] = this.leaves.length;
+    this.leaves.push(list);
+  }
+
+  setBranch(row: number, context: boolean, startbit: number, bitsize: number, firstchild: number): void {
+    this.first[row] = firstchild;
+    const wordbits = 8 * SIZEOF_UINTM;
+    if (context) {
+      const bitOffset = startbit % wordbits;
+      const remaining = bitsize - wordbits + bitOffset;
+      this.kind[row] = DecisionTable.CONTEXT;
+      this.offset[row] = Math.floor(startbit / wordbits);
+      this.lshift[row] = bitOffset;
+      this.rshift[row] = wordbits - bitsize;
+      this.rshift2[row] = remaining > 0 ? wordbits - remaining : 0;
+    } else {
+      const bitOffset = startbit % 8;
+      const bytesize = Math.floor((bitOffset + bitsize - 1) / 8) + 1;
+      this.kind[row] = DecisionTable.INSTRUCTION;
+      this.offset[row] = Math.floor(startbit / 8);
+      this.bytesize[row] = bytesize;
+      this.lshift[row] = 8 * (SIZEOF_UINTM - bytesize) + bitOffset;
+      this.rshift[row] = wordbits - bitsize;
+    }
+  }
+
+  /** Same contract as DecisionNode.resolve */
+  resolve(walker: ParserWalker): Constructor {
+    const ctx = walker.getParserContext();
+    let row = 0;
+    for (;;) {
+      const kind = this.kind[row];
+      let val: number;
+      if (kind === DecisionTable.INSTRUCTION) {
+        const off = walker._point!.offset + this.offset[row];
+        if (off >= 16)
+          throw new BadDataError('Instruction is using more than 16 bytes');
+        const buf = ctx._buf;
+        let res = 0;
+        for (let i = 0, n = this.bytesize[row]; i < n; ++i)
+          res = ((res << 8) | buf[off + i]) >>> 0;
+        val = ((res << this.lshift[row]) >>> 0) >>> this.rshift[row];
+      } else if (kind === DecisionTable.CONTEXT) {
+        const word = this.offset[row];
+        val = ((ctx._context[word] << this.lshift[row]) >>> 0) >>> this.rshift[row];
+        const shift2 = this.rshift2[row];
+        if (shift2 !== 0 && word + 1 < ctx._contextsize)
+          val = (val | ((ctx._context[word + 1] >>> 0) >>> shift2)) >>> 0;
+      } else {
+        const list = this.leaves[this.first[row]];
+        for (let i = 0; i < list.length; ++i) {
+          if (list[i][0].isMatch(walker))
+            return list[i][1];
+        }
+        const addr = walker.getAddr();
+        throw new BadDataError(addr.getShortcut() + addr.printRaw() + ': Unable to resolve constructor');
+      }
+      row = this.first[row] + val;
+    }
+  }
+}
+
 // =========================================================================
 // DecisionNode
 // =========================================================================
@@ -2274,6 +2428,33 @@ export class DecisionNode {
     return this.children[val].resolve(walker);
   }
 
+  /**
+   * Flatten this tree into a DecisionTable.
+   * Rows are assigned breadth-first, so the root is always row 0.
+   */
+  compile(): DecisionTable {
+    const nodes: DecisionNode[] = [this];
+    for (let i = 0; i < nodes.length; ++i) {
+      const node = nodes[i];
+      if (node.bitsize !== 0) {
+        for (const child of node.children)
+          nodes.push(child);
+      }
+    }
+    const table = new DecisionTable(nodes.length);
+    let nextchild = 1;
+    for (let row = 0; row < nodes.length; ++row) {
+      const node = nodes[row];
+      if (node.bitsize === 0) {
+        table.setLeaf(row, node.list);
+        continue;
+      }
+      table.setBranch(row, node.contextdecision, node.startbit, node.bitsize, nextchild);
+      nextchild += node.children.length;
+    }
+    return table;
+  }
+
   addConstructorPair(pat: DisjointPattern, ct: Constructor): void {
     const clone = pat.simplifyClone() as DisjointPattern;
     this.list.push([clone, ct]);
@@ -2518,6 +2699,11 @@ export class SubtableSymbol extends TripleSymbol {
   private errors: boolean = false;
   private construct: Constructor[] = [];
   private decisiontree: DecisionNode | null = null;
+  private decisiontable: DecisionTable | null = null;   // Flattened decisiontree used by resolve
+  private lazybody: { decoder: FormatDecode; pos: number; trans: SleighBase } | null = null;
+
+  /** Resolve through the flattened DecisionTable; clear to walk the DecisionNode tree instead */
+  static useDecisionTable: boolean = true;
 
   constructor();
   constructor(nm: string);
@@ -2527,6 +2713,7 @@ export class SubtableSymbol extends TripleSymbol {
       this.beingbuilt = false;
       this.pattern = null;
       this.decisiontree = null;
+      this.decisiontable = null;
       this.errors = false;
     }
   }
@@ -2535,14 +2722,63 @@ export class SubtableSymbol extends TripleSymbol {
   isError(): boolean { return this.errors; }
   addConstructor(ct: Constructor): void { ct.setId(this.construct.length); this.construct.push(ct); }
   getPattern(): TokenPattern | null { return this.pattern; }
-  getNumConstructors(): number { return this.construct.length; }
-  getConstructor(id: number): Constructor { return this.construct[id]; }
+  getNumConstructors(): number {
+    if (this.lazybody !== null) this.materialize();
+    return this.construct.length;
+  }
+  getConstructor(id: number): Constructor {
+    if (this.lazybody !== null) this.materialize();
+    return this.construct[id];
+  }
   override getSize(): number { return -1; }
 
+  /**
+   * Record where the body of this table is in the stream, instead of decoding it now.
+   * The body is decoded by materialize() the first time the table is used.
+   */
+  deferDecode(decoder: FormatDecode, pos: number, trans: SleighBase): void {
+    this.lazybody = { decoder, pos, trans };
+  }
+
+  /** Return true if the body of this table has not been decoded yet */
+  isDeferred(): boolean { return this.lazybody !== null; }
+
+  /**
+   * Decode the deferred body. The decoder may be in the middle of another element, so its
+   * read state is saved and restored around the seek.
+   */
+  private materialize(): void {
+    const body = this.lazybody!;
+    this.lazybody = null;      // Cleared first, so references back into this table don't recurse
+    const state = body.decoder.saveState();
+    try {
+      body.decoder.seek(body.pos);
+      body.decoder.openElement();
+      this.decode(body.decoder, body.trans);
+    } finally {
+      body.decoder.restoreState(state);
+    }
+  }
+
   override resolve(walker: ParserWalker): Constructor | null {
+    if (this.lazybody !== null) this.materialize();
+    if (this.decisiontable !== null && SubtableSymbol.useDecisionTable)
+      return this.decisiontable.resolve(walker);
     return this.decisiontree!.resolve(walker);
   }
 
+  /** Get the object form of the decision tree, for debugging */
+  getDecisionTree(): DecisionNode | null {
+    if (this.lazybody !== null) this.materialize();
+    return this.decisiontree;
+  }
+
+  /** Get the flattened decision tree, or null if no tree has been built */
+  getDecisionTable(): DecisionTable | null {
+    if (this.lazybody !== null) this.materialize();
+    return this.decisiontable;
+  }
+
   override getPatternExpression(): PatternExpression {
     throw new SleighError('Cannot use subtable in expression');
   }
@@ -2556,6 +2792,7 @@ export class SubtableSymbol extends TripleSymbol {
   }
 
   override collectLocalValues(results: bigint[]): void {
+    if (this.lazybody !== null) this.materialize();
     for (let i = 0; i < this.construct.length; ++i)
       this.construct[i].collectLocalExports(results);
   }
@@ -2574,6 +2811,7 @@ export class SubtableSymbol extends TripleSymbol {
           this.decisiontree.addConstructorPair(pat.getDisjoint(j)!, this.construct[i]);
     }
     this.decisiontree.split(props);
+    this.decisiontable = this.decisiontree.compile();
   }
 
   buildPattern(s: Writer): TokenPattern {
@@ -2612,6 +2850,7 @@ export class SubtableSymbol extends TripleSymbol {
   }
 
   override encode(encoder: Encoder): void {
+    if (this.lazybody !== null) this.materialize();
     if (this.decisiontree === null) return;
     encoder.openElement(SLA_ELEM_SUBTABLE_SYM);
     encoder.writeUnsignedInteger(SLA_ATTRIB_ID, BigInt(this.getId()));
@@ -2641,6 +2880,7 @@ export class SubtableSymbol extends TripleSymbol {
       } else if (subel === SLA_ELEM_DECISION.id) {
         this.decisiontree = new DecisionNode();
         this.decisiontree.decode(decoder, null, this);
+        this.decisiontable = this.decisiontree.compile();
       }
       subel = decoder.peekElement();
     }
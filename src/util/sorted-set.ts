@@ -1,7 +1,8 @@
 /**
  * @file sorted-set.ts
  * @description Red-black tree based SortedSet<T> and SortedMap<K,V> that replace
- * C++ std::set / std::map with custom comparators.
+ * C++ std::set / std::map with custom comparators, plus a chunked sorted-array
+ * layout (ChunkedSortedSet) behind the same iterator API.
  *
  * Design goals:
  *   - O(log n) insert, delete, find, lower_bound, upper_bound
@@ -16,6 +17,14 @@
  *   3. Every leaf (NIL sentinel) is black.
  *   4. If a node is red, both children are black.
  *   5. Every simple path from a node to a descendant leaf has the same black-height.
+ *
+ * The red-black tree allocates one node of five fields per element, and every
+ * search and step chases pointers between them. ChunkedSortedSet keeps the
+ * elements in order in a list of short arrays instead, so searches and in-order
+ * walks touch a few contiguous arrays. Each element keeps a small node that tracks
+ * the chunk holding it, and iterators hold that node, so after the set changes they
+ * find their element again without comparing it. The layout is chosen per container, with
+ * SortedSet.create() or the layout argument of SortedMap.
  */
 
 // ---------------------------------------------------------------------------
@@ -54,67 +63,87 @@ class RBNode<T> {
 /**
  * Bidirectional iterator over a SortedSet, modeled after C++ std::set::iterator.
  *
- * An iterator either points to a real node or to the *end sentinel*.  Calling
+ * An iterator either points to an element or to the *end sentinel*.  Calling
  * `next()` on the last element yields the end sentinel; calling `prev()` on
  * the end sentinel yields the last element.
  *
  * Iterator stability: iterators remain valid across insertions and deletions
  * of *other* elements.  Erasing the element an iterator points to invalidates
  * that iterator (and only that iterator).
+ *
+ * Each layout of SortedSet provides its own subclass.
  */
-export class SortedSetIterator<T> {
+export abstract class SortedSetIterator<T> {
+  /** The element this iterator points to.  Undefined behavior if `isEnd`. */
+  abstract get value(): T;
+
+  /** True when this iterator is past-the-end (the end sentinel). */
+  abstract get isEnd(): boolean;
+
+  /**
+   * Advance to the next element in sorted order (in-order successor).
+   * If already at end, this is a no-op.
+   * @returns this iterator (mutated) for chaining
+   */
+  abstract next(): this;
+
+  /**
+   * Retreat to the previous element in sorted order (in-order predecessor).
+   * If at the end sentinel, moves to the maximum element.
+   * @returns this iterator (mutated) for chaining
+   */
+  abstract prev(): this;
+
+  /** Two iterators are equal iff they point to the same element (or are both at the end). */
+  abstract equals(other: SortedSetIterator<T>): boolean;
+
+  /** Return an independent copy of this iterator. */
+  abstract clone(): SortedSetIterator<T>;
+
+  /** Get current element (alias for .value, for C++ iterator compatibility) */
+  get(): T { return this.value; }
+}
+
+/** Iterator over the red-black tree layout: a pointer to a tree node. */
+class RBTreeIterator<T> extends SortedSetIterator<T> {
   /** @internal */ _node: RBNode<T>;
   /** @internal */ _nil: RBNode<T>;
   /** @internal */ _root: () => RBNode<T>;
 
   /** @internal */
   constructor(node: RBNode<T>, nil: RBNode<T>, root: () => RBNode<T>) {
+    super();
     this._node = node;
     this._nil = nil;
     this._root = root;
   }
 
-  /** The element this iterator points to.  Undefined behavior if `isEnd`. */
   get value(): T {
     return this._node.value;
   }
 
-  /** True when this iterator is past-the-end (the end sentinel). */
   get isEnd(): boolean {
     return this._node === this._nil;
   }
 
-  /**
-   * Advance to the next element in sorted order (in-order successor).
-   * If already at end, this is a no-op.
-   * @returns this iterator (mutated) for chaining
-   */
   next(): this {
     this._node = successor(this._node, this._nil, this._root);
     return this;
   }
 
-  /**
-   * Retreat to the previous element in sorted order (in-order predecessor).
-   * If at the end sentinel, moves to the maximum element.
-   * @returns this iterator (mutated) for chaining
-   */
   prev(): this {
     this._node = predecessor(this._node, this._nil, this._root);
     return this;
   }
 
-  /** Two iterators are equal iff they point to the same node. */
   equals(other: SortedSetIterator<T>): boolean {
-    return this._node === other._node;
+    return this._node === (other as RBTreeIterator<T>)._node;
   }
 
-  /** Get current element (alias for .value, for C++ iterator compatibility) */
   get(): T { return this._node.value; }
 
-  /** Return an independent copy of this iterator. */
   clone(): SortedSetIterator<T> {
-    return new SortedSetIterator<T>(this._node, this._nil, this._root);
+    return new RBTreeIterator<T>(this._node, this._nil, this._root);
   }
 }
 
@@ -187,6 +216,19 @@ function subtreeMax<T>(node: RBNode<T>, nil: RBNode<T>): RBNode<T> {
 /** Comparator function: negative ⇒ a < b, 0 ⇒ equal, positive ⇒ a > b. */
 export type Comparator<T> = (a: T, b: T) => number;
 
+/**
+ * Storage layout of a SortedSet: `rbtree` for the red-black tree (SortedSet itself),
+ * `chunked` for ChunkedSortedSet.
+ */
+export type SortedSetLayout = 'rbtree' | 'chunked';
+
+/**
+ * Layout of the containers that leave the choice to SortedSet.create(), from the
+ * SORTED_SET_LAYOUT environment variable.  Defaults to the red-black tree.
+ */
+const DEFAULT_LAYOUT: SortedSetLayout =
+  typeof process !== 'undefined' && process.env?.SORTED_SET_LAYOUT === 'chunked' ? 'chunked' : 'rbtree';
+
 /**
  * A sorted set backed by a red-black tree with a custom comparator.
  *
@@ -200,6 +242,8 @@ export class SortedSet<T> {
   /** @internal */ _root: RBNode<T>;
   /** @internal */ _size: number;
   /** @internal */ _cmp: Comparator<T>;
+  /** @internal Nodes kept by clear(true), reused by insert() */
+  _spare: RBNode<T>[] | null = null;
 
   constructor(comparator: Comparator<T>) {
     // Sentinel NIL node — always black, parent/left/right point to itself.
@@ -213,6 +257,16 @@ export class SortedSet<T> {
     this._cmp = comparator;
   }
 
+  /**
+   * Construct an empty set with the given layout.
+   * @param comparator orders the elements
+   * @param layout selects the storage; by default the SORTED_SET_LAYOUT environment
+   *        variable picks it, falling back to the red-black tree
+   */
+  static create<T>(comparator: Comparator<T>, layout: SortedSetLayout = DEFAULT_LAYOUT): SortedSet<T> {
+    return layout === 'chunked' ? new ChunkedSortedSet<T>(comparator) : new SortedSet<T>(comparator);
+  }
+
   // -- Capacity -----------------------------------------------------------
 
   /** Number of elements in the set. */
@@ -229,7 +283,7 @@ export class SortedSet<T> {
 
   /** @internal helper to create an iterator */
   private _iter(node: RBNode<T>): SortedSetIterator<T> {
-    return new SortedSetIterator<T>(node, this._nil, () => this._root);
+    return new RBTreeIterator<T>(node, this._nil, () => this._root);
   }
 
   /** Iterator to the minimum element, or `end()` if empty. */
@@ -346,7 +400,16 @@ export class SortedSet<T> {
       }
     }
 
-    const z = new RBNode<T>(value, Color.RED, nil);
+    let z: RBNode<T>;
+    if (this._spare !== null && this._spare.length > 0) {
+      z = this._spare.pop()!;
+      z.value = value;
+      z.color = Color.RED;
+      z.left = nil;
+      z.right = nil;
+    } else {
+      z = new RBNode<T>(value, Color.RED, nil);
+    }
     z.parent = parent;
     if (parent === nil) {
       this._root = z;
@@ -366,7 +429,7 @@ export class SortedSet<T> {
    *          C++ `std::set::erase(iterator)`).
    */
   erase(it: SortedSetIterator<T>): SortedSetIterator<T> {
-    const z = it._node;
+    const z = (it as RBTreeIterator<T>)._node;
     if (z === this._nil) {
       return this.end();
     }
@@ -388,8 +451,28 @@ export class SortedSet<T> {
     return true;
   }
 
-  /** Remove all elements. */
-  clear(): void {
+  /**
+   * Remove all elements.
+   * @param recycle keeps the tree nodes for later inserts, which saves allocating them
+   *        again when the set is refilled to a similar size. Every iterator into the set
+   *        must be dead, since its node may come back holding another element. Without
+   *        it, nodes kept by earlier clears are dropped as well.
+   */
+  clear(recycle: boolean = false): void {
+    if (!recycle)
+      this._spare = null;
+    else if (this._root !== this._nil) {
+      const nil = this._nil;
+      const spare = this._spare ?? (this._spare = []);
+      const stack: RBNode<T>[] = [this._root];
+      while (stack.length > 0) {
+        const node = stack.pop()!;
+        if (node.left !== nil) stack.push(node.left);
+        if (node.right !== nil) stack.push(node.right);
+        node.value = undefined as unknown as T;
+        spare.push(node);
+      }
+    }
     this._root = this._nil;
     this._size = 0;
   }
@@ -621,6 +704,389 @@ export class SortedSet<T> {
   }
 }
 
+// ---------------------------------------------------------------------------
+// ChunkedSortedSet<T>
+// ---------------------------------------------------------------------------
+
+/**
+ * One element of a ChunkedSortedSet.  The node stays with its element while chunks
+ * split and merge, and always knows the chunk holding it, so an iterator can find its
+ * element again without comparing it to anything.
+ */
+class ChunkedNode<T> {
+  value: T;
+  /** The chunk holding this element, or null once it is erased */
+  chunk: ChunkedNode<T>[] | null;
+
+  constructor(value: T, chunk: ChunkedNode<T>[]) {
+    this.value = value;
+    this.chunk = chunk;
+  }
+}
+
+/**
+ * Iterator over a ChunkedSortedSet: the node of its element, plus the chunk and slot
+ * where the node was.  The position is trusted only while the set's version is
+ * unchanged; after any insert or erase, it is found again from the node's chunk.
+ */
+class ChunkedIterator<T> extends SortedSetIterator<T> {
+  /** @internal */ _set: ChunkedSortedSet<T>;
+  /** @internal The element's node, or null at the end */ _node: ChunkedNode<T> | null;
+  /** @internal Index of the chunk, or -1 at the end */ _ci: number;
+  /** @internal Index within the chunk */ _i: number;
+  /** @internal Version of the set when the position was computed */ _version: number;
+
+  /** @internal */
+  constructor(set: ChunkedSortedSet<T>, ci: number, i: number, node: ChunkedNode<T> | null, version: number) {
+    super();
+    this._set = set;
+    this._node = node;
+    this._ci = ci;
+    this._i = i;
+    this._version = version;
+  }
+
+  get value(): T {
+    return this._node === null ? undefined as unknown as T : this._node.value;
+  }
+
+  get isEnd(): boolean {
+    return this._ci < 0;
+  }
+
+  next(): this {
+    if (this._ci < 0) return this;
+    const set = this._set;
+    if (!set._locate(this)) {
+      // The element is gone: the next one is the first greater than it
+      set._bound(this, this._node!.value, true);
+      return this;
+    }
+    const chunks = set._chunks;
+    if (this._i + 1 < chunks[this._ci].length)
+      set._place(this, this._ci, this._i + 1);
+    else if (this._ci + 1 < chunks.length)
+      set._place(this, this._ci + 1, 0);
+    else
+      set._place(this, -1, 0);
+    return this;
+  }
+
+  prev(): this {
+    const set = this._set;
+    if (this._ci >= 0 && !set._locate(this))
+      set._bound(this, this._node!.value, false);
+    const chunks = set._chunks;
+    if (this._ci < 0) {
+      if (chunks.length > 0)
+        set._place(this, chunks.length - 1, chunks[chunks.length - 1].length - 1);
+    } else if (this._i > 0) {
+      set._place(this, this._ci, this._i - 1);
+    } else if (this._ci > 0) {
+      set._place(this, this._ci - 1, chunks[this._ci - 1].length - 1);
+    } else {
+      set._place(this, -1, 0);     // Before the minimum, as the red-black tree does
+    }
+    return this;
+  }
+
+  equals(other: SortedSetIterator<T>): boolean {
+    const o = other as ChunkedIterator<T>;
+    if (this._ci < 0 || o._ci < 0) return this._ci === o._ci;
+    return this._node === o._node;
+  }
+
+  clone(): SortedSetIterator<T> {
+    return new ChunkedIterator<T>(this._set, this._ci, this._i, this._node, this._version);
+  }
+}
+
+/**
+ * A sorted set stored as a list of short sorted arrays (chunks).
+ *
+ * Same semantics and iterator guarantees as the red-black SortedSet, from which it
+ * inherits only its interface.  A search is a binary search over the last element of
+ * each chunk followed by one within the chunk, and an in-order walk steps through
+ * contiguous arrays.  Chunks split when they grow past CHUNK_SIZE and merge with a
+ * neighbour when they shrink below a quarter of it.
+ *
+ * Each element sits in a ChunkedNode that moves with it between chunks.  An iterator
+ * holds the node, so after other elements change it finds its element again through
+ * the node's chunk, and erase() removes exactly that element, as the tree erases by
+ * node.  Neither compares the element, so, as with the tree, the owner may change an
+ * element's sort key just before erasing it through an iterator it kept (VarnodeBank
+ * and PcodeOpBank do).  Only an iterator whose element is already gone falls back to
+ * searching by value.
+ */
+export class ChunkedSortedSet<T> extends SortedSet<T> {
+  /** Most elements in one chunk */
+  static readonly CHUNK_SIZE = 128;
+
+  /** @internal Nodes in order, in chunks of 1 to CHUNK_SIZE nodes */
+  _chunks: ChunkedNode<T>[][] = [];
+  /** @internal Last element of each chunk, searched to find the chunk of a value */
+  _maxes: T[] = [];
+  /** @internal Incremented by every change, so iterators can tell their position is stale */
+  _version: number = 0;
+  /** @internal Empty chunk arrays, reused by later splits */
+  private _spareChunks: ChunkedNode<T>[][] = [];
+
+  constructor(comparator: Comparator<T>) {
+    super(comparator);
+  }
+
+  // -- Positions ------------------------------------------------------------
+
+  /** @internal Point an iterator at a chunk and slot (ci = -1 for the end) */
+  _place(it: ChunkedIterator<T>, ci: number, i: number): void {
+    it._ci = ci;
+    it._i = i;
+    it._node = ci < 0 ? null : this._chunks[ci][i];
+    it._version = this._version;
+  }
+
+  /**
+   * @internal Bring an iterator's position up to date from its node, without comparing.
+   * @returns false if its element is no longer in the set
+   */
+  _locate(it: ChunkedIterator<T>): boolean {
+    if (it._version === this._version) return true;
+    const node = it._node!;
+    const chunk = node.chunk;
+    if (chunk === null) return false;
+    const chunks = this._chunks;
+    let ci = it._ci;
+    if (chunks[ci] !== chunk) {
+      ci = chunks.indexOf(chunk);
+      if (ci < 0) return false;          // Cleared, and the array reused or kept spare
+    }
+    let i = it._i;
+    if (chunk[i] !== node) {
+      i = chunk.indexOf(node);
+      if (i < 0) return false;
+    }
+    it._ci = ci;
+    it._i = i;
+    it._version = this._version;
+    return true;
+  }
+
+  /** @internal Index of the first chunk holding an element ≥ value (> value if upper) */
+  private _chunkOf(value: T, upper: boolean): number {
+    const maxes = this._maxes;
+    let lo = 0;
+    let hi = maxes.length;
+    while (lo < hi) {
+      const mid = (lo + hi) >> 1;
+      const c = this._cmp(value, maxes[mid]);
+      if (upper ? c < 0 : c <= 0) hi = mid;
+      else lo = mid + 1;
+    }
+    return lo;
+  }
+
+  /** @internal Index within a chunk of the first element ≥ value (> value if upper) */
+  private _slotOf(chunk: ChunkedNode<T>[], value: T, upper: boolean): number {
+    let lo = 0;
+    let hi = chunk.length;
+    while (lo < hi) {
+      const mid = (lo + hi) >> 1;
+      const c = this._cmp(value, chunk[mid].value);
+      if (upper ? c < 0 : c <= 0) hi = mid;
+      else lo = mid + 1;
+    }
+    return lo;
+  }
+
+  /** @internal Point an iterator at the first element ≥ value (> value if upper) */
+  _bound(it: ChunkedIterator<T>, value: T, upper: boolean): void {
+    const ci = this._chunkOf(value, upper);
+    if (ci === this._chunks.length)
+      this._place(it, -1, 0);
+    else
+      this._place(it, ci, this._slotOf(this._chunks[ci], value, upper));
+  }
+
+  private _at(ci: number, i: number): ChunkedIterator<T> {
+    if (ci >= this._chunks.length)
+      return new ChunkedIterator<T>(this, -1, 0, null, this._version);
+    return new ChunkedIterator<T>(this, ci, i, this._chunks[ci][i], this._version);
+  }
+
+  private _newChunk(): ChunkedNode<T>[] {
+    return this._spareChunks.pop() ?? [];
+  }
+
+  /** Remove chunk ci, keeping its array for reuse */
+  private _dropChunk(ci: number): void {
+    const chunk = this._chunks[ci];
+    chunk.length = 0;
+    this._spareChunks.push(chunk);
+    this._chunks.splice(ci, 1);
+    this._maxes.splice(ci, 1);
+  }
+
+  /** Move the nodes of one chunk to the end of another */
+  private static _moveNodes<T>(from: ChunkedNode<T>[], to: ChunkedNode<T>[], start: number): void {
+    for (let j = start; j < from.length; ++j) {
+      const node = from[j];
+      node.chunk = to;
+      to.push(node);
+    }
+  }
+
+  // -- Iterators ------------------------------------------------------------
+
+  begin(): SortedSetIterator<T> {
+    return this._at(0, 0);
+  }
+
+  end(): SortedSetIterator<T> {
+    return this._at(this._chunks.length, 0);
+  }
+
+  rbegin(): SortedSetIterator<T> {
+    const last = this._chunks.length - 1;
+    return last < 0 ? this.end() : this._at(last, this._chunks[last].length - 1);
+  }
+
+  // -- Lookup ---------------------------------------------------------------
+
+  find(value: T): SortedSetIterator<T> {
+    const ci = this._chunkOf(value, false);
+    if (ci === this._chunks.length) return this.end();
+    const chunk = this._chunks[ci];
+    const i = this._slotOf(chunk, value, false);
+    return this._cmp(value, chunk[i].value) === 0 ? this._at(ci, i) : this.end();
+  }
+
+  lower_bound(value: T): SortedSetIterator<T> {
+    const it = this._at(this._chunks.length, 0);
+    this._bound(it, value, false);
+    return it;
+  }
+
+  upper_bound(value: T): SortedSetIterator<T> {
+    const it = this._at(this._chunks.length, 0);
+    this._bound(it, value, true);
+    return it;
+  }
+
+  // -- Modifiers ------------------------------------------------------------
+
+  insert(value: T): [SortedSetIterator<T>, boolean] {
+    const chunks = this._chunks;
+    const maxes = this._maxes;
+    if (chunks.length === 0) {
+      const chunk = this._newChunk();
+      chunk.push(new ChunkedNode<T>(value, chunk));
+      chunks.push(chunk);
+      maxes.push(value);
+      this._size = 1;
+      this._version++;
+      return [this._at(0, 0), true];
+    }
+    let ci = this._chunkOf(value, false);
+    if (ci === chunks.length) ci -= 1;         // Greater than everything: append to the last chunk
+    const chunk = chunks[ci];
+    let i = this._slotOf(chunk, value, false);
+    if (i < chunk.length && this._cmp(value, chunk[i].value) === 0)
+      return [this._at(ci, i), false];
+    chunk.splice(i, 0, new ChunkedNode<T>(value, chunk));
+    if (i === chunk.length - 1) maxes[ci] = value;
+    this._size++;
+    this._version++;
+    if (chunk.length > ChunkedSortedSet.CHUNK_SIZE) {
+      const half = chunk.length >> 1;
+      const right = this._newChunk();
+      ChunkedSortedSet._moveNodes(chunk, right, half);
+      chunk.length = half;
+      chunks.splice(ci + 1, 0, right);
+      maxes.splice(ci + 1, 0, right[right.length - 1].value);
+      maxes[ci] = chunk[half - 1].value;
+      if (i >= half) {
+        ci += 1;
+        i -= half;
+      }
+    }
+    return [this._at(ci, i), true];
+  }
+
+  erase(it: SortedSetIterator<T>): SortedSetIterator<T> {
+    const cit = it as ChunkedIterator<T>;
+    if (cit._ci < 0) return this.end();
+    if (!this._locate(cit)) {
+      // Already erased: nothing to remove, return where it would have been
+      return this.lower_bound(cit._node!.value);
+    }
+    let ci = cit._ci;
+    let i = cit._i;
+    const chunks = this._chunks;
+    const maxes = this._maxes;
+    const chunk = chunks[ci];
+    chunk[i].chunk = null;
+    chunk.splice(i, 1);
+    this._size--;
+    this._version++;
+    if (chunk.length === 0) {
+      this._dropChunk(ci);
+      return this._at(ci, 0);
+    }
+    if (i === chunk.length) maxes[ci] = chunk[i - 1].value;
+    if (chunk.length < (ChunkedSortedSet.CHUNK_SIZE >> 2)) {
+      // Merge with a neighbour when both fit in one chunk
+      if (ci + 1 < chunks.length && chunk.length + chunks[ci + 1].length <= ChunkedSortedSet.CHUNK_SIZE) {
+        ChunkedSortedSet._moveNodes(chunks[ci + 1], chunk, 0);
+        maxes[ci] = maxes[ci + 1];
+        this._dropChunk(ci + 1);
+      } else if (ci > 0 && chunks[ci - 1].length + chunk.length <= ChunkedSortedSet.CHUNK_SIZE) {
+        const left = chunks[ci - 1];
+        i += left.length;
+        ChunkedSortedSet._moveNodes(chunk, left, 0);
+        maxes[ci - 1] = maxes[ci];
+        this._dropChunk(ci);
+        ci -= 1;
+      }
+    }
+    if (i === chunks[ci].length) {
+      ci += 1;
+      i = 0;
+    }
+    return this._at(ci, i);
+  }
+
+  /**
+   * Remove all elements.
+   * @param recycle keeps the chunk arrays for later inserts.  Unlike the red-black
+   *        tree, iterators into the set stay safe, though they no longer find their element.
+   */
+  clear(recycle: boolean = false): void {
+    if (recycle) {
+      for (const chunk of this._chunks) {
+        chunk.length = 0;
+        this._spareChunks.push(chunk);
+      }
+    } else {
+      this._spareChunks = [];
+    }
+    this._chunks = [];
+    this._maxes = [];
+    this._size = 0;
+    this._version++;
+  }
+
+  // -- ES iteration ---------------------------------------------------------
+
+  *[Symbol.iterator](): IterableIterator<T> {
+    // Through an iterator, so changes to the set during the loop are tolerated as for the tree
+    const it = this.begin();
+    while (!it.isEnd) {
+      yield it.value;
+      it.next();
+    }
+  }
+}
+
 // ---------------------------------------------------------------------------
 // SortedMap<K, V>
 // ---------------------------------------------------------------------------
@@ -679,7 +1145,8 @@ export class SortedMapIterator<K, V> {
 }
 
 /**
- * A sorted map backed by a red-black tree, keyed by a custom comparator.
+ * A sorted map backed by a SortedSet of entries (a red-black tree unless another
+ * layout is given), keyed by a custom comparator.
  *
  * Semantics mirror C++ `std::map<K, V, Compare>`:
  *   - Unique keys
@@ -692,8 +1159,12 @@ export class SortedMap<K, V> {
   /** @internal – reusable probe entry to avoid allocation in lookups. */
   private _probe: MapEntry<K, V>;
 
-  constructor(comparator: Comparator<K>) {
-    this._set = new SortedSet<MapEntry<K, V>>((a, b) => comparator(a.key, b.key));
+  /**
+   * @param comparator orders the keys
+   * @param layout is the storage layout of the entries
+   */
+  constructor(comparator: Comparator<K>, layout: SortedSetLayout = 'rbtree') {
+    this._set = SortedSet.create<MapEntry<K, V>>((a, b) => comparator(a.key, b.key), layout);
     this._probe = { key: undefined as unknown as K, value: undefined as unknown as V };
   }
 
@@ -3,6 +3,8 @@
  * @description Writer interface replacing C++ ostream for string output.
  */
 
+import * as fs from 'fs';
+
 /**
  * Abstract writer interface that replaces C++ ostream.
  * Implementations can write to strings, files, or other destinations.
@@ -30,6 +32,79 @@ export class StringWriter implements Writer {
   }
 }
 
+/**
+ * Writer that encodes output as UTF-8 into a fixed-size byte chunk, which is handed to a
+ * sink whenever it fills up.
+ *
+ * No intermediate string is ever built, so large outputs (a whole program of C code or
+ * its markup) cost one reusable chunk of memory instead of a transient string. The sink
+ * is either a file descriptor, written synchronously, or a callback. A callback must
+ * consume (or copy) the bytes before returning, as the chunk is reused.
+ */
+export class ChunkedWriter implements Writer {
+  /** Default number of bytes in a chunk */
+  static readonly CHUNK_SIZE = 64 * 1024;
+  private static readonly encoder = new TextEncoder();
+  private chunk: Uint8Array;
+  private pos: number = 0;
+  private total: number = 0;
+  private sink: (bytes: Uint8Array) => void;
+
+  /**
+   * @param sink is a file descriptor or a callback receiving each full chunk
+   * @param chunkSize is the number of bytes in a chunk
+   */
+  constructor(sink: number | ((bytes: Uint8Array) => void), chunkSize: number = ChunkedWriter.CHUNK_SIZE) {
+    this.chunk = new Uint8Array(Math.max(chunkSize, 16));
+    if (typeof sink === 'number') {
+      const fd = sink;
+      this.sink = (bytes: Uint8Array): void => {
+        let off = 0;
+        while (off < bytes.length)
+          off += fs.writeSync(fd, bytes, off, bytes.length - off);
+      };
+    } else {
+      this.sink = sink;
+    }
+  }
+
+  write(s: string): void {
+    const len = s.length;
+    const chunk = this.chunk;
+    // Most tokens are short ASCII strings, which are copied without the encoder
+    if (len <= chunk.length - this.pos) {
+      let pos = this.pos;
+      let i = 0;
+      for (; i < len; ++i) {
+        const c = s.charCodeAt(i);
+        if (c >= 0x80) break;
+        chunk[pos++] = c;
+      }
+      this.pos = pos;
+      if (i === len) return;
+      s = s.substring(i);
+    }
+    for (;;) {
+      const res = ChunkedWriter.encoder.encodeInto(s, chunk.subarray(this.pos));
+      this.pos += res.written;
+      if (res.read === s.length) return;
+      s = s.substring(res.read);
+      this.flush();
+    }
+  }
+
+  /** Hand any buffered bytes to the sink */
+  flush(): void {
+    if (this.pos === 0) return;
+    this.total += this.pos;
+    this.sink(this.chunk.subarray(0, this.pos));
+    this.pos = 0;
+  }
+
+  /** Get the number of bytes written so far, including those still buffered */
+  getByteCount(): number { return this.total + this.pos; }
+}
+
 /**
  * Writer that writes to process stdout.
  */
@@ -1,8 +1,8 @@
 /**
  * Benchmark: Action tree cloning overhead.
  *
- * Measures time to clone the action tree vs time to decompile,
- * to quantify the overhead of the parallel infrastructure.
+ * Measures time to clone the action tree, and to create the per-job ActionJobState
+ * that the parallel infrastructure uses instead, vs time to decompile.
  *
  * Usage:
  *   npx tsx test/bench-clone-time.ts
@@ -73,6 +73,14 @@ console.log(`Found ${testFiles.length} test files\n`);
     const cloneTotal = performance.now() - cloneStart;
     const cloneAvg = cloneTotal / CLONE_ITERATIONS;
 
+    // Measure job state time
+    const root = allacts.getCurrent();
+    const stateStart = performance.now();
+    for (let i = 0; i < CLONE_ITERATIONS; i++) {
+      root.newJobState();
+    }
+    const stateAvg = (performance.now() - stateStart) / CLONE_ITERATIONS;
+
     // Measure decompile time (full test run)
     const RUN_ITERATIONS = 10;
     const runTimes: number[] = [];
@@ -93,7 +101,7 @@ console.log(`Found ${testFiles.length} test files\n`);
 
     const overheadPct = (cloneAvg / runMedian * 100);
 
-    console.log(`  ${basename.padEnd(20)} clone: ${cloneAvg.toFixed(2)}ms  decompile: ${runMedian.toFixed(1)}ms  overhead: ${overheadPct.toFixed(1)}%`);
+    console.log(`  ${basename.padEnd(20)} clone: ${cloneAvg.toFixed(2)}ms  job state: ${stateAvg.toFixed(3)}ms  decompile: ${runMedian.toFixed(1)}ms  overhead: ${overheadPct.toFixed(1)}%`);
   }
 }
 
@@ -133,6 +141,20 @@ console.log(`Found ${testFiles.length} test files\n`);
     console.log(`    Avg:    ${avg.toFixed(1)}ms`);
     console.log(`    Per-clone: ${(median / 79).toFixed(2)}ms`);
 
+    const root = allacts.getCurrent();
+    const stateTimes: number[] = [];
+    for (let iter = 0; iter < ITERATIONS; iter++) {
+      const start = performance.now();
+      for (let i = 0; i < 79; i++) {
+        root.newJobState();
+      }
+      stateTimes.push(performance.now() - start);
+    }
+    stateTimes.sort((a, b) => a - b);
+    const stateMedian = stateTimes[Math.floor(stateTimes.length / 2)];
+    console.log(`  Creating 79 job states over the shared tree:`);
+    console.log(`    Median: ${stateMedian.toFixed(2)}ms`);
+
     // Compare to total decompilation time
     const decompStart = performance.now();
     for (const f of testFiles) {
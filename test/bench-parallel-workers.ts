@@ -7,6 +7,8 @@
  *
  * Usage:
  *   npx tsx test/bench-parallel-workers.ts [binary.xml]
+ *
+ * Set TRACE_DIR to write a Chrome trace of each worker run (workers-<N>.json) there.
  */
 import { fileURLToPath } from 'url';
 import { dirname } from 'path';
@@ -37,6 +39,11 @@ function formatMs(ms: number): string {
   return `${(ms / 1000).toFixed(2)}s`;
 }
 
+/** Count the `<com>lo fu NAME</com>` scripts of an export, without parsing it */
+function countFunctions(xml: string): number {
+  return xml.match(/<com>\s*(?:lo(?:ad)?\s+fu(?:nction)?)\s+\S+\s*<\/com>/g)?.length ?? 0;
+}
+
 function formatBytes(bytes: number): string {
   if (bytes < 1024) return `${bytes} B`;
   if (bytes < 1024 * 1024) return `${(bytes / 1024).toFixed(1)} KB`;
@@ -122,16 +129,14 @@ if (xmlsToTest.length === 0) {
 
   for (const xmlPath of xmlsToTest) {
     const binaryName = path.basename(path.dirname(xmlPath));
-    const funcNames = WorkerParallelDecompiler.extractFunctionNames(
-      fs.readFileSync(xmlPath, 'utf-8')
-    );
+    const numFunctions = countFunctions(fs.readFileSync(xmlPath, 'utf-8'));
 
-    if (funcNames.length > MAX_FUNCTIONS) {
-      console.log(`=== ${binaryName}: ${funcNames.length} functions (skipped — exceeds ${MAX_FUNCTIONS} limit) ===\n`);
+    if (numFunctions > MAX_FUNCTIONS) {
+      console.log(`=== ${binaryName}: ${numFunctions} functions (skipped — exceeds ${MAX_FUNCTIONS} limit) ===\n`);
       continue;
     }
 
-    console.log(`=== ${binaryName}: ${funcNames.length} functions ===`);
+    console.log(`=== ${binaryName}: ${numFunctions} functions ===`);
 
     // Sequential baseline (using FunctionTestCollection) — single run for both timing and output
     if (!datatestFiles.length) {
@@ -154,7 +159,9 @@ if (xmlsToTest.length === 0) {
     // Worker runs at various concurrency levels
     for (const nWorkers of uniqueCounts) {
       const nullWriter = { write: (_s: string) => {} };
-      const pd = new WorkerParallelDecompiler(xmlPath, nWorkers, nullWriter);
+      const traceDir = process.env.TRACE_DIR;
+      const pd = new WorkerParallelDecompiler(xmlPath, nWorkers, nullWriter, false,
+        traceDir ? { trace: path.join(traceDir, `workers-${nWorkers}.json`) } : undefined);
 
       const wStart = performance.now();
       const results = await pd.decompileAll();
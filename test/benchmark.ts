@@ -0,0 +1,886 @@
+#!/usr/bin/env npx tsx
+/**
+ * Benchmark runner: time the TS decompiler on the datatests corpus and on binaries.
+ *
+ * Each input runs in its own child process, so that peak RSS is per input and a large binary
+ * running out of memory does not take the whole run down. The child installs an
+ * ActionProfiler recording per function timing, and reports wall time split into SLEIGH lift,
+ * the phases of the root action (its child actions) and print, with GC time, peak RSS and
+ * rule test/apply counts.
+ *
+ * Results are written as JSON (default output/bench/bench-<date>.json) and a one-line
+ * summary is appended to output/bench/history.jsonl. With --baseline they are compared
+ * against an earlier result, and when the C++ decomp_test_dbg is available (--cpp, or
+ * DECOMP_TEST_DBG) together with SLEIGHHOME, it runs on the same inputs for reference.
+ *
+ * With --emulate the p-code emulators are compared as well: a constant-folding style x86-64
+ * loop runs under the interpreted EmulatePcodeCache and under EmulateCompiled, with the
+ * temporaries of the unique space in a hashed and in a paged memory bank, and the
+ * instructions per second are reported.
+ *
+ * With --root another root Action (e.g. triage) is benchmarked: each input runs under it and
+ * under the full "decompile" root, and a table gives the speedup and the quality kept, as
+ * the datatests string matches still passing and the functions decompiled without failure.
+ *
+ * Usage: npx tsx test/benchmark.ts [options] [binary...]
+ *   --datatests <dir>     datatests directory (default DATATESTS_PATH or ghidra-src)
+ *   --no-datatests        skip the datatests corpus
+ *   --xml <file> <label>  add a pre-exported XML file
+ *   --out <file>          where to write the JSON result
+ *   --baseline <file>     compare against an earlier JSON result
+ *   --threshold <pct>     slowdown reported as a regression (default 10)
+ *   --fail-on-regression  exit with status 1 if a regression is found
+ *   --no-functions        leave the per function breakdown out of the JSON
+ *   --cpp <path>          C++ decomp_test_dbg to compare against
+ *   --no-cpp              skip the C++ comparison
+ *   --root <name>         root Action to benchmark against "decompile" (default decompile)
+ *   --emulate             compare the interpreted and compiled p-code emulators
+ *   --trace-trees <dir>   record the VarnodeBank loc_tree/def_tree operations of each input to
+ *                         <dir>/<label>.trees.json, for test/unit/sorted-set.bench.ts
+ */
+import { fileURLToPath } from 'url';
+import { spawnSync, execSync } from 'child_process';
+import { PerformanceObserver } from 'perf_hooks';
+import * as fs from 'fs';
+import * as os from 'os';
+import * as path from 'path';
+import type { FunctionProfile } from '../src/decompiler/actionprofile.js';
+
+const __filename = fileURLToPath(import.meta.url);
+const ROOT = path.resolve(path.dirname(__filename), '..');
+
+const DEFAULT_DATATESTS = path.join(ROOT, 'ghidra-src', 'Ghidra', 'Features', 'Decompiler', 'src', 'decompile', 'datatests');
+const DEFAULT_CPP = path.join(ROOT, 'ghidra-src', 'Ghidra', 'Features', 'Decompiler', 'src', 'decompile', 'cpp', 'decomp_test_dbg');
+const OUTPUT_DIR = path.join(ROOT, 'output', 'bench');
+const RESULT_TAG = 'BENCH_RESULT:';
+/** Functions per FunctionTestCollection when running a large export */
+const BATCH_SIZE = 500;
+/** The full root Action */
+const FULL_ROOT = 'decompile';
+
+// Processors available via bundled spec files
+const BUNDLED_PROCESSORS = new Set(['x86', 'AARCH64', 'ARM']);
+
+/** One thing to benchmark */
+interface BenchInput {
+  label: string;
+  kind: 'datatests' | 'xml' | 'binary';
+  /** XML files to decompile; one per datatest, or the single export of a binary */
+  files: string[];
+  sizeKB: number;
+  /** Root Action to decompile with */
+  root: string;
+  /** Where to write the trace of the Varnode trees, if recorded */
+  traceTrees?: string;
+}
+
+/** Timing of a function, as recorded by the profiler */
+interface BenchFunction extends FunctionProfile {
+  /** The file the function came from */
+  file: string;
+  /** lift + actions + print, in milliseconds */
+  totalMs: number;
+}
+
+/** Reference timing from the C++ decompiler */
+interface CppResult {
+  wallMs: number;
+  peakRssMB: number;
+  failures: number;
+}
+
+/** Result for one input */
+interface InputResult {
+  label: string;
+  kind: BenchInput['kind'];
+  sizeKB: number;
+  functions: number;
+  failures: number;
+  /** stringmatch tests run and passed (datatests) */
+  testsApplied: number;
+  testsPassed: number;
+  wallMs: number;
+  /** Milliseconds per phase: lift, actions, action:<name>, print */
+  phases: Record<string, number>;
+  peakRssMB: number;
+  gcMs: number;
+  gcCount: number;
+  ruleTests: number;
+  ruleApplies: number;
+  functionProfiles?: BenchFunction[];
+  cpp?: CppResult;
+  error?: string;
+}
+
+/** Speed of the p-code emulators on the same loop, for one layout of the memory banks */
+interface EmulateRun {
+  /** hashed: the unique space in a MemoryHashOverlay, as in the C++ sleigh example; paged:
+   *  every space in a MemoryPageOverlay */
+  banks: 'hashed' | 'paged';
+  interpretedMs: number;
+  compiledMs: number;
+  /** Whether both left the same values in the loop registers */
+  match: boolean;
+}
+
+interface EmulateResult {
+  instructions: number;
+  runs: EmulateRun[];
+}
+
+/** The JSON written by a run */
+interface BenchReport {
+  version: 1;
+  date: string;
+  commit: string;
+  node: string;
+  platform: string;
+  cpus: number;
+  /** Root Action of inputs */
+  root: string;
+  inputs: InputResult[];
+  totals: Omit<InputResult, 'label' | 'kind' | 'sizeKB' | 'functionProfiles' | 'error'>;
+  /** The same inputs under the full root, when root is another one */
+  full?: InputResult[];
+  emulate?: EmulateResult;
+}
+
+/** Operations recorded per trace, beyond which the rest of the run is left out */
+const MAX_TRACE_OPS = 2000000;
+
+/**
+ * The operations on one VarnodeBank tree between two clears, as read by sorted-set.bench.ts.
+ * Keys are [space, offset, size, class, pc space, pc offset, uniq, create_index], with class
+ * 0 for a free Varnode, 1 for an input and 2 for a written one (pc and uniq give its defining
+ * op). A key is either inserted or used as a search key, never both.
+ */
+interface TreeTraceSet {
+  tree: 'loc_tree' | 'def_tree';
+  keys: (number | string)[][];
+  /** One letter per operation: i insert, e erase, l lower_bound, u upper_bound, f find */
+  ops: string;
+  /** The key of each operation */
+  args: number[];
+}
+
+/** A recording of the Varnode trees over a decompilation */
+interface TreeTrace {
+  source: string;
+  /** Address spaces the keys refer to, as [index, name, type]; keys use -1 for the invalid
+   *  address and -2 for the maximal one */
+  spaces: [number, string, number][];
+  sets: TreeTraceSet[];
+}
+
+/**
+ * Record every loc_tree and def_tree operation from here on, by wrapping the sets that
+ * SortedSet.create() makes with the Varnode comparators.
+ * @returns the function that stops recording and writes the trace
+ */
+async function traceTrees(source: string, file: string): Promise<() => void> {
+  const { SortedSet } = await import('../src/util/sorted-set.js');
+  const { Varnode, varnodeCompareLocDef, varnodeCompareDefLoc } = await import('../src/decompiler/varnode.js');
+  type Vn = InstanceType<typeof Varnode>;
+  const trace: TreeTrace = { source, spaces: [], sets: [] };
+  const spaces = new Set<number>();
+  let total = 0;
+  const spaceOf = (spc: any): number => {
+    if (spc === null) return -1;
+    if (typeof spc.getIndex !== 'function') return -2;
+    const index = spc.getIndex();
+    if (!spaces.has(index)) {
+      spaces.add(index);
+      trace.spaces.push([index, spc.getName(), spc.getType()]);
+    }
+    return index;
+  };
+  const keyOf = (vn: Vn): (number | string)[] => {
+    const fl = vn.flags & (Varnode.input | Varnode.written);
+    const key = [spaceOf(vn.loc.getSpace()), vn.loc.getOffset().toString(), vn.size,
+                 fl === Varnode.written ? 2 : fl === Varnode.input ? 1 : 0, -1, '0', 0, vn.getCreateIndex()];
+    if (fl === Varnode.written) {
+      const seq = vn.def!.getSeqNum();
+      key[4] = spaceOf(seq.getAddr().getSpace());
+      key[5] = seq.getAddr().getOffset().toString();
+      key[6] = seq.getTime();
+    }
+    return key;
+  };
+
+  const create = SortedSet.create;
+  SortedSet.create = function <T>(cmp: (a: T, b: T) => number, layout?: any) {
+    const set = create.call(this, cmp, layout) as any;
+    const tree = (cmp as any) === varnodeCompareLocDef ? 'loc_tree' : (cmp as any) === varnodeCompareDefLoc ? 'def_tree' : null;
+    if (tree === null) return set;
+    let cur: TreeTraceSet | null = null;
+    const live = new Map<Vn, number>();    // Key under which each element was inserted
+    let queries = new Map<string, number>();
+    let depth = 0;                         // Calls the set makes to itself are not recorded
+    const current = (): TreeTraceSet => {
+      if (cur === null) {
+        cur = { tree, keys: [], ops: '', args: [] };
+        trace.sets.push(cur);
+      }
+      return cur;
+    };
+    const record = (op: string, key: number) => {
+      const c = current();
+      c.ops += op;
+      c.args.push(key);
+      total += 1;
+    };
+    const newKey = (vn: Vn) => current().keys.push(keyOf(vn)) - 1;
+    const wrap = (name: string, fn: (orig: (...a: any[]) => any, arg: any) => any) => {
+      const orig = set[name];
+      set[name] = (arg: any) => {
+        if (depth > 0 || total >= MAX_TRACE_OPS) return orig.call(set, arg);
+        depth += 1;
+        try {
+          return fn(orig, arg);
+        } finally {
+          depth -= 1;
+        }
+      };
+    };
+    wrap('insert', (orig, vn: Vn) => {
+      const res = orig.call(set, vn);
+      const key = newKey(vn);
+      record('i', key);
+      if (res[1]) live.set(vn, key);
+      return res;
+    });
+    wrap('erase', (orig, it: any) => {
+      const key = it.isEnd ? undefined : live.get(it.value);
+      if (key !== undefined) {
+        record('e', key);
+        live.delete(it.value);
+      }
+      return orig.call(set, it);
+    });
+    for (const [name, op] of [['lower_bound', 'l'], ['upper_bound', 'u'], ['find', 'f']]) {
+      wrap(name, (orig, vn: Vn) => {
+        const text = keyOf(vn).join(',');
+        let key = queries.get(text);
+        if (key === undefined) {
+          key = newKey(vn);
+          queries.set(text, key);
+        }
+        record(op, key);
+        return orig.call(set, vn);
+      });
+    }
+    const clear = set.clear;
+    set.clear = (recycle?: boolean) => {
+      // The next function starts a new trace set
+      cur = null;
+      live.clear();
+      queries = new Map();
+      return clear.call(set, recycle);
+    };
+    return set;
+  } as typeof SortedSet.create;
+
+  return () => {
+    SortedSet.create = create;
+    fs.mkdirSync(path.dirname(file), { recursive: true });
+    fs.writeFileSync(file, JSON.stringify(trace));
+    process.stderr.write(`  ${total} tree operations in ${trace.sets.length} sets written to ${file}\n`);
+  };
+}
+
+// ---------------------------------------------------------------------------
+// Child: decompile one input in this process
+// ---------------------------------------------------------------------------
+
+async function runChild(input: BenchInput): Promise<InputResult> {
+  await import('../src/console/xml_arch.js');
+  const { startDecompilerLibrary } = await import('../src/console/libdecomp.js');
+  const { FunctionTestCollection } = await import('../src/console/testfunction.js');
+  const { ActionProfiler } = await import('../src/decompiler/actionprofile.js');
+  const { StringWriter } = await import('../src/util/writer.js');
+
+  startDecompilerLibrary();
+  const finishTrace = input.traceTrees !== undefined ? await traceTrees(input.label, input.traceTrees) : null;
+  const prof = new ActionProfiler();
+  prof.recordFunctions = true;
+
+  let gcMs = 0;
+  let gcCount = 0;
+  const gcObserver = new PerformanceObserver(list => {
+    for (const e of list.getEntries()) {
+      gcMs += e.duration;
+      gcCount += 1;
+    }
+  });
+  gcObserver.observe({ entryTypes: ['gc'] });
+
+  const functionProfiles: BenchFunction[] = [];
+  let failures = 0;
+  let functions = 0;
+  let testsApplied = 0;
+  let testsPassed = 0;
+  const collect = (file: string) => {
+    const all = prof.getFunctionProfiles();
+    for (let i = functionProfiles.length; i < all.length; ++i) {
+      const f = all[i];
+      const totalMs = (f.phases['lift'] ?? 0) + (f.phases['actions'] ?? 0) + (f.phases['print'] ?? 0);
+      functionProfiles.push({ ...f, file, totalMs });
+    }
+  };
+  const runOne = (tc: any, file: string) => {
+    const lateStream: string[] = [];
+    try {
+      tc.runTests(lateStream);
+    } catch (e: any) {
+      lateStream.push(e?.message ?? String(e));
+    }
+    failures += lateStream.length;
+    testsApplied += tc.getTestsApplied();
+    testsPassed += tc.getTestsSucceeded();
+    collect(file);
+  };
+  const load = (xml: string, file: string) => {
+    const tc = new FunctionTestCollection(new StringWriter());
+    tc.loadTestFromString(xml, file);
+    if (input.root !== FULL_ROOT) (tc as any).dcp.conf.allacts.setCurrent(input.root);
+    return tc;
+  };
+
+  ActionProfiler.active = prof;
+  const start = performance.now();
+  for (const file of input.files) {
+    const content = fs.readFileSync(file, 'utf8');
+    const scripts = content.match(/<script>[\s\S]*?<\/script>/g) ?? [];
+    functions += scripts.length;
+    try {
+      if (scripts.length <= BATCH_SIZE) {
+        runOne(load(content, file), path.basename(file));
+        continue;
+      }
+      // Large exports in batches, each with a fresh collection, to bound the heap
+      const image = content.match(/<binaryimage[\s\S]*?<\/binaryimage>/)![0];
+      const matches = content.match(/<stringmatch[\s\S]*?<\/stringmatch>/g) ?? [];
+      for (let i = 0; i < scripts.length; i += BATCH_SIZE) {
+        const xml = ['<decompilertest>', image, ...scripts.slice(i, i + BATCH_SIZE), ...matches, '</decompilertest>'].join('\n');
+        runOne(load(xml, file), path.basename(file));
+      }
+    } catch (e: any) {
+      failures += 1;
+      process.stderr.write(`  ${path.basename(file)}: ${e?.explain ?? e?.message ?? String(e)}\n`);
+    }
+  }
+  const wallMs = performance.now() - start;
+  ActionProfiler.active = null;
+  finishTrace?.();
+
+  // GC entries are delivered asynchronously
+  await new Promise(resolve => setImmediate(resolve));
+  for (const e of gcObserver.takeRecords()) {
+    gcMs += e.duration;
+    gcCount += 1;
+  }
+  gcObserver.disconnect();
+
+  let ruleTests = 0;
+  let ruleApplies = 0;
+  for (const e of prof.getEntries()) {
+    if (e.kind !== 'rule') continue;
+    ruleTests += e.calls;
+    ruleApplies += e.applied;
+  }
+  return {
+    label: input.label, kind: input.kind, sizeKB: input.sizeKB,
+    functions, failures, testsApplied, testsPassed, wallMs,
+    phases: prof.getPhases(),
+    peakRssMB: process.resourceUsage().maxRSS / 1024,
+    gcMs, gcCount, ruleTests, ruleApplies,
+    functionProfiles,
+  };
+}
+
+/** Iterations of the emulated loop; each runs 6 instructions */
+const EMULATE_LOOPS = 100000;
+const EMULATE_BASE = 0x100000n;
+
+/**
+ * x86-64 code of the emulated loop, a hash over a linear congruential sequence such as
+ * deobfuscation scripts step through:
+ *     mov ecx, EMULATE_LOOPS; xor eax, eax; xor edx, edx
+ *   loop:
+ *     imul eax, eax, 0x41c64e6d; add eax, 0x3039; xor edx, eax; rol edx, 5; dec ecx; jnz loop
+ */
+function emulateCode(): string {
+  const loops = EMULATE_LOOPS.toString(16).padStart(8, '0').match(/../g)!.reverse().join('');
+  return 'b9' + loops + '31c0' + '31d2' +
+    '69c06d4ec641' + '0539300000' + '31c2' + 'c1c205' + 'ffc9' + '75ec';
+}
+
+/** Run the loop of emulateCode() under both emulators in this process */
+async function runEmulateChild(): Promise<EmulateResult> {
+  await import('../src/console/xml_arch.js');
+  const { startDecompilerLibrary } = await import('../src/console/libdecomp.js');
+  const { ArchitectureCapability } = await import('../src/decompiler/architecture.js');
+  const { DocumentStorage } = await import('../src/core/xml.js');
+  const { Address } = await import('../src/core/address.js');
+  const { MemoryState, MemoryImage, MemoryPageOverlay, MemoryHashOverlay } = await import('../src/decompiler/memstate.js');
+  const { EmulatePcodeCache, EmulateCompiled, BreakTableCallBack } = await import('../src/decompiler/emulate.js');
+
+  startDecompilerLibrary();
+  const store = new DocumentStorage();
+  const doc = store.parseDocument('<binaryimage arch="x86:LE:64:default:gcc"><bytechunk space="ram" offset="0x' +
+                                  EMULATE_BASE.toString(16) + '" readonly="true">' + emulateCode() + '</bytechunk></binaryimage>');
+  store.registerTag(doc.getRoot());
+  const arch: any = ArchitectureCapability.getCapability('xml')!.buildArchitecture('emulate', '', { write: () => {} });
+  arch.init(store);
+  const trans = arch.translate;
+  const instructions = 3 + 6 * EMULATE_LOOPS;
+
+  const run = (compiled: boolean, banks: EmulateRun['banks']) => {
+    // 8-byte words over 4K pages, as in the C++ sleigh example
+    const mem = new MemoryState(trans);
+    const ram = trans.getDefaultCodeSpace();
+    const uniq = trans.getUniqueSpace();
+    mem.setMemoryBank(new MemoryPageOverlay(ram, 8, 4096, new MemoryImage(ram, 8, 4096, arch.loader)));
+    mem.setMemoryBank(new MemoryPageOverlay(trans.getSpaceByName('register'), 8, 4096, null));
+    mem.setMemoryBank(banks === 'hashed' ? new MemoryHashOverlay(uniq, 8, 4096, 4096, null)
+                                         : new MemoryPageOverlay(uniq, 8, 4096, null));
+    const table = new BreakTableCallBack(trans);
+    const start = performance.now();
+    if (compiled) {
+      const emu = new EmulateCompiled(trans, mem, table);
+      emu.setExecuteAddress(new Address(ram, EMULATE_BASE));
+      emu.run(instructions);
+    } else {
+      const emu = new EmulatePcodeCache(trans, mem, table);
+      emu.setExecuteAddress(new Address(ram, EMULATE_BASE));
+      for (let i = 0; i < instructions; ++i) emu.executeInstruction();
+    }
+    const ms = performance.now() - start;
+    return { ms, regs: ['RAX', 'RCX', 'RDX'].map(nm => mem.getValueName(nm)) };
+  };
+  const runs: EmulateRun[] = [];
+  for (const banks of ['hashed', 'paged'] as const) {
+    const interpreted = run(false, banks);
+    const compiled = run(true, banks);
+    runs.push({
+      banks,
+      interpretedMs: interpreted.ms,
+      compiledMs: compiled.ms,
+      match: interpreted.regs.every((v, i) => v === compiled.regs[i]),
+    });
+  }
+  return { instructions, runs };
+}
+
+// ---------------------------------------------------------------------------
+// Parent: gather inputs, spawn children, report
+// ---------------------------------------------------------------------------
+
+function formatSize(kb: number): string {
+  if (kb < 1024) return `${kb}K`;
+  return `${(kb / 1024).toFixed(1)}M`;
+}
+
+function padR(s: string, w: number): string {
+  return s.length >= w ? s.slice(0, w) : s + ' '.repeat(w - s.length);
+}
+function padL(s: string, w: number): string {
+  return s.length >= w ? s : ' '.repeat(w - s.length) + s;
+}
+
+function getProcessor(xmlPath: string): string | null {
+  const content = fs.readFileSync(xmlPath, 'utf-8');
+  const m = content.match(/arch="([^":]+)/);
+  return m ? m[1] : null;
+}
+
+/** Export a binary to XML (cached by name and modification time) */
+async function exportBinary(binaryPath: string): Promise<string | null> {
+  const { parseBinary, generateXml } = await import('../src/console/binary_to_xml.js');
+  const stat = fs.statSync(binaryPath);
+  const xmlDir = path.join(ROOT, 'output', 'bench-cache', `${path.basename(binaryPath)}_${Math.floor(stat.mtimeMs / 1000)}`);
+  const xmlFile = path.join(xmlDir, 'exported.xml');
+  if (!fs.existsSync(xmlFile)) {
+    fs.mkdirSync(xmlDir, { recursive: true });
+    try {
+      fs.writeFileSync(xmlFile, generateXml(parseBinary(fs.readFileSync(binaryPath) as Buffer)));
+    } catch (e: any) {
+      process.stderr.write(`Export failed for ${binaryPath}: ${e.message}\n`);
+      return null;
+    }
+  }
+  return xmlFile;
+}
+
+/** Run one input in a child process */
+function spawnChild(input: BenchInput): InputResult {
+  const res = spawnSync(process.execPath, [...process.execArgv, __filename, '--child', JSON.stringify(input)], {
+    encoding: 'utf8',
+    maxBuffer: 1024 * 1024 * 1024,
+    stdio: ['ignore', 'pipe', 'inherit'],
+  });
+  const line = (res.stdout ?? '').split('\n').find(l => l.startsWith(RESULT_TAG));
+  if (line !== undefined) return JSON.parse(line.slice(RESULT_TAG.length));
+  return {
+    label: input.label, kind: input.kind, sizeKB: input.sizeKB,
+    functions: 0, failures: 0, testsApplied: 0, testsPassed: 0, wallMs: 0, phases: {}, peakRssMB: 0, gcMs: 0, gcCount: 0,
+    ruleTests: 0, ruleApplies: 0,
+    error: res.signal !== null ? `killed by ${res.signal}` : `exit status ${res.status}`,
+  };
+}
+
+/** Run the emulator comparison in a child process */
+function spawnEmulate(): EmulateResult | null {
+  const res = spawnSync(process.execPath, [...process.execArgv, __filename, '--emulate-child'], {
+    encoding: 'utf8',
+    stdio: ['ignore', 'pipe', 'inherit'],
+  });
+  const line = (res.stdout ?? '').split('\n').find(l => l.startsWith(RESULT_TAG));
+  return line !== undefined ? JSON.parse(line.slice(RESULT_TAG.length)) : null;
+}
+
+function printEmulate(r: EmulateResult): void {
+  const rate = (ms: number) => `${(r.instructions / ms / 1000).toFixed(2)}M/s`;
+  console.log('');
+  console.log(`Emulator, ${r.instructions} instructions of x86-64`);
+  for (const run of r.runs) {
+    console.log(`  ${padR(run.banks + ' unique', 16)} interpreted ${padL(rate(run.interpretedMs), 9)}` +
+                `  compiled ${padL(rate(run.compiledMs), 9)}  ${padL((run.interpretedMs / run.compiledMs).toFixed(1), 5)}x` +
+                (run.match ? '' : '  FINAL STATES DIFFER'));
+  }
+}
+
+/** Parse peak RSS in MB from /usr/bin/time output (the -v or -l form) */
+function parseTimeRss(output: string): number {
+  const linux = output.match(/Maximum resident set size \(kbytes\): (\d+)/);
+  if (linux) return parseInt(linux[1]) / 1024;
+  const mac = output.match(/(\d+)\s+maximum resident set size/);
+  if (mac) return parseInt(mac[1]) / (1024 * 1024);
+  return 0;
+}
+
+/** Run the C++ decompiler on the same files */
+function runCpp(cppBin: string, input: BenchInput): CppResult {
+  const byDir = new Map<string, string[]>();
+  for (const f of input.files) {
+    const dir = path.dirname(f);
+    if (!byDir.has(dir)) byDir.set(dir, []);
+    byDir.get(dir)!.push(path.basename(f));
+  }
+  const timeBin = fs.existsSync('/usr/bin/time') ? '/usr/bin/time' : null;
+  const timeFlag = process.platform === 'darwin' ? '-l' : '-v';
+  const res: CppResult = { wallMs: 0, peakRssMB: 0, failures: 0 };
+  for (const [dir, names] of byDir) {
+    const argv = ['-usesleighenv', '-path', dir, 'datatests', ...names];
+    const start = performance.now();
+    const run = timeBin !== null
+      ? spawnSync(timeBin, [timeFlag, cppBin, ...argv], { encoding: 'utf8', maxBuffer: 1024 * 1024 * 1024 })
+      : spawnSync(cppBin, argv, { encoding: 'utf8', maxBuffer: 1024 * 1024 * 1024 });
+    res.wallMs += performance.now() - start;
+    const output = (run.stdout ?? '') + (run.stderr ?? '');
+    res.peakRssMB = Math.max(res.peakRssMB, parseTimeRss(output));
+    res.failures += (output.match(/^FAIL -- /gm) ?? []).length + (output.match(/Unable to proceed/g) ?? []).length;
+  }
+  return res;
+}
+
+function sumPhases(into: Record<string, number>, from: Record<string, number>): void {
+  for (const name of Object.keys(from)) into[name] = (into[name] ?? 0) + from[name];
+}
+
+function buildTotals(inputs: InputResult[]): BenchReport['totals'] {
+  const totals: BenchReport['totals'] = {
+    functions: 0, failures: 0, testsApplied: 0, testsPassed: 0, wallMs: 0, phases: {}, peakRssMB: 0, gcMs: 0, gcCount: 0,
+    ruleTests: 0, ruleApplies: 0,
+  };
+  let cpp: CppResult | undefined;
+  for (const r of inputs) {
+    totals.functions += r.functions;
+    totals.failures += r.failures;
+    totals.testsApplied += r.testsApplied;
+    totals.testsPassed += r.testsPassed;
+    totals.wallMs += r.wallMs;
+    sumPhases(totals.phases, r.phases);
+    totals.peakRssMB = Math.max(totals.peakRssMB, r.peakRssMB);
+    totals.gcMs += r.gcMs;
+    totals.gcCount += r.gcCount;
+    totals.ruleTests += r.ruleTests;
+    totals.ruleApplies += r.ruleApplies;
+    if (r.cpp !== undefined) {
+      cpp ??= { wallMs: 0, peakRssMB: 0, failures: 0 };
+      cpp.wallMs += r.cpp.wallMs;
+      cpp.peakRssMB = Math.max(cpp.peakRssMB, r.cpp.peakRssMB);
+      cpp.failures += r.cpp.failures;
+    }
+  }
+  if (cpp !== undefined) totals.cpp = cpp;
+  return totals;
+}
+
+function printTable(inputs: InputResult[], totals: BenchReport['totals']): void {
+  const hasCpp = totals.cpp !== undefined;
+  const W = 24;
+  const header = padR('Input', W) + padL('Size', 7) + padL('Funcs', 7) + padL('Fail', 6) +
+    padL('Wall(s)', 9) + padL('Lift', 8) + padL('Actions', 9) + padL('Print', 8) +
+    padL('GC', 7) + padL('RSS', 8) + padL('Rules', 11) +
+    (hasCpp ? padL('C++(s)', 9) + padL('Ratio', 7) : '');
+  console.log('');
+  console.log(header);
+  console.log('─'.repeat(header.length));
+  const row = (label: string, sizeKB: number, r: BenchReport['totals']) => {
+    const sec = (ms: number | undefined) => ((ms ?? 0) / 1000).toFixed(2);
+    console.log(
+      padR(label, W) + padL(sizeKB > 0 ? formatSize(sizeKB) : '', 7) +
+      padL(String(r.functions), 7) + padL(String(r.failures), 6) +
+      padL(sec(r.wallMs), 9) + padL(sec(r.phases['lift']), 8) + padL(sec(r.phases['actions']), 9) +
+      padL(sec(r.phases['print']), 8) + padL(sec(r.gcMs), 7) +
+      padL(r.peakRssMB.toFixed(0) + 'MB', 8) + padL(String(r.ruleTests), 11) +
+      (hasCpp
+        ? padL(r.cpp !== undefined ? sec(r.cpp.wallMs) : '-', 9) +
+          padL(r.cpp !== undefined && r.cpp.wallMs > 0 ? (r.wallMs / r.cpp.wallMs).toFixed(2) + 'x' : '-', 7)
+        : '')
+    );
+  };
+  for (const r of inputs) {
+    if (r.error !== undefined) {
+      console.log(padR(r.label, W) + '  (' + r.error + ')');
+      continue;
+    }
+    row(r.label, r.sizeKB, r);
+  }
+  if (inputs.length > 1) {
+    console.log('─'.repeat(header.length));
+    row('TOTAL', 0, totals);
+  }
+
+  // The most expensive phases of the root action across all inputs
+  const actions = Object.entries(totals.phases)
+    .filter(([name]) => name.startsWith('action:'))
+    .sort((a, b) => b[1] - a[1])
+    .slice(0, 8);
+  if (actions.length > 0) {
+    console.log('');
+    console.log('Action phases: ' + actions.map(([name, ms]) => `${name.slice(7)} ${(ms / 1000).toFixed(2)}s`).join(', '));
+  }
+  if (hasCpp) console.log('Ratio = TS/C++ wall time (lower = TS faster)');
+}
+
+/** Speedup and quality of a root Action against the full root, per input */
+function printRootComparison(root: string, inputs: InputResult[], full: InputResult[]): void {
+  const W = 24;
+  const header = padR('Input', W) + padL(FULL_ROOT + '(s)', 14) + padL(root + '(s)', 12) + padL('Speedup', 9) +
+    padL('Tests', 14) + padL('Decompiled', 16) + padL('RSS', 12);
+  console.log('');
+  console.log(`Root ${root} against ${FULL_ROOT}`);
+  console.log(header);
+  console.log('─'.repeat(header.length));
+  const pct = (n: number, d: number) => (d > 0 ? ((n / d) * 100).toFixed(1) + '%' : '-');
+  const ok = (r: InputResult) => Math.max(0, r.functions - r.failures);
+  const rows: [string, InputResult, InputResult][] = [];
+  const byLabel = new Map(full.map(r => [r.label, r]));
+  for (const r of inputs) {
+    const f = byLabel.get(r.label);
+    if (f !== undefined && r.error === undefined && f.error === undefined) rows.push([r.label, r, f]);
+  }
+  for (const [label, r, f] of rows) {
+    console.log(
+      padR(label, W) + padL((f.wallMs / 1000).toFixed(2), 14) + padL((r.wallMs / 1000).toFixed(2), 12) +
+      padL(r.wallMs > 0 ? (f.wallMs / r.wallMs).toFixed(2) + 'x' : '-', 9) +
+      padL(r.testsApplied > 0 ? `${r.testsPassed}/${f.testsPassed}` : '-', 14) +
+      padL(pct(ok(r), ok(f)), 16) +
+      padL(`${f.peakRssMB.toFixed(0)}/${r.peakRssMB.toFixed(0)}MB`, 12)
+    );
+  }
+  console.log('Tests = string matches passed under ' + root + '/' + FULL_ROOT +
+              '; Decompiled = functions without failure, relative to ' + FULL_ROOT);
+}
+
+/**
+ * Compare against a baseline report. Wall time, the main phases and peak RSS of each input
+ * present in both are checked, ignoring differences under 20ms / 5MB as noise.
+ * @returns the regressions found
+ */
+function compareBaseline(report: BenchReport, baseline: BenchReport, threshold: number): string[] {
+  const regressions: string[] = [];
+  const base = new Map(baseline.inputs.map(r => [r.label, r]));
+  const check = (label: string, what: string, now: number, then: number, noise: number) => {
+    if (then <= 0 || now - then < noise) return;
+    const pct = (now / then - 1) * 100;
+    if (pct > threshold) regressions.push(`${label}: ${what} ${then.toFixed(1)} -> ${now.toFixed(1)} (+${pct.toFixed(1)}%)`);
+  };
+  console.log('');
+  console.log(`Baseline ${baseline.commit.slice(0, 10)} from ${baseline.date}`);
+  if ((baseline.root ?? FULL_ROOT) !== report.root)
+    console.log(`  (baseline root ${baseline.root ?? FULL_ROOT}, this run ${report.root})`);
+  for (const r of report.inputs) {
+    const b = base.get(r.label);
+    if (b === undefined || r.error !== undefined || b.error !== undefined) continue;
+    const ratio = b.wallMs > 0 ? r.wallMs / b.wallMs : 0;
+    console.log(`  ${padR(r.label, 24)} ${padL((b.wallMs / 1000).toFixed(2) + 's', 9)} -> ${padL((r.wallMs / 1000).toFixed(2) + 's', 9)}` +
+                (ratio > 0 ? `  ${ratio.toFixed(2)}x` : ''));
+    check(r.label, 'wall ms', r.wallMs, b.wallMs, 20);
+    for (const phase of ['lift', 'actions', 'print'])
+      check(r.label, phase + ' ms', r.phases[phase] ?? 0, b.phases[phase] ?? 0, 20);
+    check(r.label, 'peak RSS MB', r.peakRssMB, b.peakRssMB, 5);
+    if (r.failures > b.failures) regressions.push(`${r.label}: failures ${b.failures} -> ${r.failures}`);
+  }
+  return regressions;
+}
+
+function gitCommit(): string {
+  try {
+    return execSync('git rev-parse HEAD', { cwd: ROOT, encoding: 'utf8', stdio: ['ignore', 'pipe', 'ignore'] }).trim();
+  } catch {
+    return '';
+  }
+}
+
+async function main(): Promise<void> {
+  const argv = process.argv.slice(2);
+  if (argv[0] === '--child') {
+    const result = await runChild(JSON.parse(argv[1]));
+    process.stdout.write(RESULT_TAG + JSON.stringify(result) + '\n');
+    return;
+  }
+  if (argv[0] === '--emulate-child') {
+    const result = await runEmulateChild();
+    process.stdout.write(RESULT_TAG + JSON.stringify(result) + '\n');
+    return;
+  }
+
+  let datatestsDir: string | null = process.env.DATATESTS_PATH || DEFAULT_DATATESTS;
+  let outFile: string | null = null;
+  let baselineFile: string | null = null;
+  let threshold = 10;
+  let failOnRegression = false;
+  let keepFunctions = true;
+  let cppBin: string | null = process.env.DECOMP_TEST_DBG || DEFAULT_CPP;
+  let root = FULL_ROOT;
+  let traceDir: string | null = null;
+  let emulate = false;
+  const inputs: BenchInput[] = [];
+  const binaries: string[] = [];
+  for (let i = 0; i < argv.length; ++i) {
+    const arg = argv[i];
+    if (arg === '--datatests') datatestsDir = argv[++i];
+    else if (arg === '--no-datatests') datatestsDir = null;
+    else if (arg === '--xml') {
+      const file = argv[++i];
+      inputs.push({ label: argv[++i], kind: 'xml', files: [path.resolve(file)], sizeKB: 0, root });
+    }
+    else if (arg === '--out') outFile = argv[++i];
+    else if (arg === '--baseline') baselineFile = argv[++i];
+    else if (arg === '--threshold') threshold = parseFloat(argv[++i]);
+    else if (arg === '--fail-on-regression') failOnRegression = true;
+    else if (arg === '--no-functions') keepFunctions = false;
+    else if (arg === '--cpp') cppBin = argv[++i];
+    else if (arg === '--no-cpp') cppBin = null;
+    else if (arg === '--root') root = argv[++i];
+    else if (arg === '--emulate') emulate = true;
+    else if (arg === '--trace-trees') traceDir = path.resolve(argv[++i]);
+    else if (arg.startsWith('--')) {
+      process.stderr.write(`Unknown option ${arg}\n`);
+      process.exit(2);
+    } else binaries.push(arg);
+  }
+
+  if (datatestsDir !== null && fs.existsSync(datatestsDir)) {
+    const files = fs.readdirSync(datatestsDir)
+      .filter(f => f.endsWith('.xml'))
+      .sort()
+      .map(f => path.join(datatestsDir!, f))
+      .filter(f => BUNDLED_PROCESSORS.has(getProcessor(f) ?? ''));
+    if (files.length > 0) inputs.unshift({ label: 'datatests', kind: 'datatests', files, sizeKB: 0, root });
+  }
+  for (const bin of binaries) {
+    if (!fs.existsSync(bin)) {
+      process.stderr.write(`Skipping ${bin} (not found)\n`);
+      continue;
+    }
+    const real = fs.realpathSync(bin);
+    const xml = await exportBinary(real);
+    if (xml !== null)
+      inputs.push({ label: path.basename(bin), kind: 'binary', files: [xml], sizeKB: Math.round(fs.statSync(real).size / 1024), root });
+  }
+  if (inputs.length === 0 && !emulate) {
+    process.stderr.write('No inputs: set DATATESTS_PATH or name binaries / --xml files\n');
+    process.exit(1);
+  }
+
+  if (traceDir !== null) {
+    for (const input of inputs)
+      input.traceTrees = path.join(traceDir, `${input.label}.trees.json`);
+  }
+
+  const sleighHome = process.env.SLEIGHHOME || process.env.GHIDRA_HOME;
+  const hasCpp = cppBin !== null && fs.existsSync(cppBin) && sleighHome !== undefined && fs.existsSync(sleighHome);
+  if (cppBin !== null && !hasCpp)
+    process.stderr.write('C++ decomp_test_dbg or SLEIGHHOME not found, running TS only\n');
+  if (hasCpp) process.env.SLEIGHHOME = sleighHome;
+
+  const results: InputResult[] = [];
+  for (const input of inputs) {
+    process.stderr.write(`${input.label}: ${input.files.length} file(s)\n`);
+    const r = spawnChild(input);
+    if (hasCpp && r.error === undefined) r.cpp = runCpp(cppBin!, input);
+    if (!keepFunctions) delete r.functionProfiles;
+    results.push(r);
+  }
+  // The same inputs under the full root, for the speedup and quality of the other root
+  let full: InputResult[] | undefined;
+  if (root !== FULL_ROOT) {
+    full = [];
+    for (const input of inputs) {
+      process.stderr.write(`${input.label}: ${FULL_ROOT} root\n`);
+      const r = spawnChild({ ...input, root: FULL_ROOT, traceTrees: undefined });
+      delete r.functionProfiles;
+      full.push(r);
+    }
+  }
+
+  const report: BenchReport = {
+    version: 1,
+    date: new Date().toISOString(),
+    commit: gitCommit(),
+    node: process.version,
+    platform: `${process.platform}-${process.arch}`,
+    cpus: os.cpus().length,
+    root,
+    inputs: results,
+    totals: buildTotals(results),
+  };
+  if (full !== undefined) report.full = full;
+  if (emulate) {
+    process.stderr.write('emulator comparison\n');
+    const r = spawnEmulate();
+    if (r !== null) report.emulate = r;
+  }
+  if (results.length > 0) printTable(results, report.totals);
+  if (full !== undefined) printRootComparison(root, results, full);
+  if (report.emulate !== undefined) printEmulate(report.emulate);
+
+  fs.mkdirSync(OUTPUT_DIR, { recursive: true });
+  const out = outFile ?? path.join(OUTPUT_DIR, `bench-${report.date.replace(/[:.]/g, '-')}.json`);
+  fs.writeFileSync(out, JSON.stringify(report, null, 1) + '\n');
+  const { inputs: _inputs, full: _full, ...summary } = report;
+  fs.appendFileSync(path.join(OUTPUT_DIR, 'history.jsonl'), JSON.stringify(summary) + '\n');
+  console.log('');
+  console.log(`Results saved to: ${out}`);
+
+  if (baselineFile !== null) {
+    const baseline: BenchReport = JSON.parse(fs.readFileSync(baselineFile, 'utf8'));
+    const regressions = compareBaseline(report, baseline, threshold);
+    if (regressions.length === 0) {
+      console.log(`No regressions over ${threshold}%`);
+    } else {
+      console.log(`Regressions over ${threshold}%:`);
+      for (const r of regressions) console.log('  ' + r);
+      if (failOnRegression) process.exitCode = 1;
+    }
+  }
+}
+
+main().catch(e => {
+  process.stderr.write(String(e?.stack ?? e) + '\n');
+  process.exit(1);
+});
@@ -1,10 +1,11 @@
 /**
  * Run both C++ and TS decompilers on an exported XML and compare per-function.
  *
- * Usage: npx tsx test/run-compare-binary.ts [--workers N] [--enhance] [--metrics] <exported.xml> [output-dir]
+ * Usage: npx tsx test/run-compare-binary.ts [--workers N] [--recycle-rss MB] [--enhance] [--metrics] <exported.xml> [output-dir]
  *
  * --workers N  Use N worker threads for true multi-core parallelism.
  *              Without this flag, decompilation is sequential (single-threaded).
+ * --recycle-rss MB  Replace a worker whose resident set size passes MB megabytes.
  * --enhance    Enable enhanced display mode.
  * --metrics    Print per-function and aggregate SAILR metrics table.
  */
@@ -19,6 +20,7 @@ import path from 'path';
 
 // --- Parse arguments ---
 let numWorkers = 0;
+let recycleRssMb = 0;
 let enhancedDisplay = false;
 let showMetrics = false;
 const positional: string[] = [];
@@ -26,6 +28,9 @@ for (let i = 2; i < process.argv.length; i++) {
     if (process.argv[i] === '--workers' || process.argv[i] === '-w') {
         i++;
         numWorkers = parseInt(process.argv[i], 10) || 4;
+    } else if (process.argv[i] === '--recycle-rss') {
+        i++;
+        recycleRssMb = parseInt(process.argv[i], 10) || 0;
     } else if (process.argv[i] === '--enhance') {
         enhancedDisplay = true;
     } else if (process.argv[i] === '--metrics') {
@@ -59,7 +64,8 @@ if (numWorkers > 0) {
     const tsStart = performance.now();
 
     const progressWriter = { write: (s: string) => process.stderr.write(s) };
-    const pd = new WorkerParallelDecompiler(xmlFile, numWorkers, progressWriter, enhancedDisplay);
+    const pd = new WorkerParallelDecompiler(xmlFile, numWorkers, progressWriter, enhancedDisplay,
+                                            recycleRssMb > 0 ? { recycleRssMb } : undefined);
     console.log(`Found ${pd.getFunctionCount()} functions\n`);
 
     const results = await pd.decompileAll();
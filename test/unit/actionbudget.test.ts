@@ -0,0 +1,108 @@
+/**
+ * @file actionbudget.test.ts
+ * @description Tests that an ActionBudget stops a runaway root Action at its limit and reports it.
+ */
+
+import { describe, it, expect } from 'vitest';
+import {
+  Action, ActionGroup, ActionDatabase, ActionBudget, ActionBudgetExceeded, type ActionGroupList,
+} from '../../src/decompiler/action.js';
+import { DecompileJob } from '../../src/decompiler/parallel.js';
+
+/** Busy-wait so that timings are measurable */
+function spin(ms: number): void {
+  const end = performance.now() + ms;
+  while (performance.now() < end) { /* spin */ }
+}
+
+/** Makes a change on every application, so a repeating group around it never settles */
+class ActionRunaway extends Action {
+  constructor(g: string, private work: (data: any) => void) {
+    super(0, 'runaway', g);
+  }
+  clone(grouplist: ActionGroupList): Action | null {
+    if (!grouplist.contains(this.getGroup())) return null;
+    return new ActionRunaway(this.getGroup(), this.work);
+  }
+  apply(data: any): number {
+    this.work(data);
+    data.applied += 1;
+    this.count += 1;
+    return 0;
+  }
+}
+
+function build(work: (data: any) => void): Action {
+  const db = new ActionDatabase();
+  const universal = new ActionGroup(Action.rule_repeatapply | Action.rule_onceperfunc, 'universal');
+  universal.addAction(new ActionRunaway('base', work));
+  (db as any).registerAction(ActionDatabase.universalname, universal);
+  db.setGroup('full', ['base']);
+  return db.setCurrent('full');
+}
+
+function func(): any {
+  return {
+    applied: 0,
+    getName: () => 'func',
+    hasNoCode: () => false,
+    clear: () => {},
+    getAddress: () => null,
+    getArch: () => ({ printMessage: () => {} }),
+  };
+}
+
+describe('ActionBudget', () => {
+  it('stops the action at the time limit and reports where', () => {
+    const root = build(() => spin(2));
+    const data = func();
+    const budget = new ActionBudget({ timeMs: 30 });
+    root.reset(data);
+    let err: unknown = null;
+    try {
+      ActionBudget.run(budget, () => root.perform(data));
+    } catch (e) {
+      err = e;
+    }
+    expect(err).toBeInstanceOf(ActionBudgetExceeded);
+    const ex = err as ActionBudgetExceeded;
+    expect(ex.reason).toBe('time');
+    expect(['universal', 'runaway']).toContain(ex.actionName);
+    expect(ex.explain).toMatch(/^Timed out in (universal|runaway) after \d+ms$/);
+    // Stopped at the first safe point past the deadline: within one application of it
+    expect(ex.elapsedMs).toBeGreaterThanOrEqual(30);
+    expect(ex.elapsedMs).toBeLessThan(30 + 50);
+    expect(data.applied).toBeLessThanOrEqual(16);
+    expect(budget.exceeded).toBe(ex);
+    expect(ActionBudget.active).toBeNull();
+  });
+
+  it('stops the action at the heap growth limit', () => {
+    const keep: number[][] = [];
+    const root = build(() => { keep.push(new Array(1 << 17).fill(keep.length)); });
+    const data = func();
+    root.reset(data);
+    expect(() => ActionBudget.run(new ActionBudget({ heapGrowthMb: 16 }), () => root.perform(data)))
+      .toThrow(/^Exceeded memory budget in (universal|runaway)/);
+    expect(data.applied).toBeGreaterThan(0);
+  });
+
+  it('is reported by DecompileJob as budgetExceeded', () => {
+    const root = build(() => spin(2));
+    const job = new DecompileJob({ commentdb: null } as any, root, func(), undefined, { timeMs: 20 });
+    const res = job.run();
+    expect(res.success).toBe(false);
+    expect(res.budgetExceeded).toBeDefined();
+    expect(res.budgetExceeded!.reason).toBe('time');
+    expect(['universal', 'runaway']).toContain(res.budgetExceeded!.action);
+    expect(res.budgetExceeded!.elapsedMs).toBeGreaterThanOrEqual(20);
+    expect(res.error).toMatch(/^Timed out in /);
+  });
+
+  it('ignores limits that cannot be exceeded', () => {
+    expect(ActionBudget.isLimited(undefined)).toBe(false);
+    expect(ActionBudget.isLimited({})).toBe(false);
+    expect(ActionBudget.isLimited({ timeMs: 0, heapGrowthMb: 0 })).toBe(false);
+    expect(ActionBudget.isLimited({ timeMs: 5 })).toBe(true);
+  });
+});
@@ -0,0 +1,68 @@
+/**
+ * @file actionjobstate.test.ts
+ * @description Tests that jobs sharing one root Action keep independent progress in their ActionJobState.
+ */
+
+import { describe, it, expect } from 'vitest';
+import { Action, ActionGroup, ActionDatabase, type ActionGroupList } from '../../src/decompiler/action.js';
+import { LowlevelError } from '../../src/core/error.js';
+
+/** Makes one change per application until the function's budget is used up */
+class ActionBump extends Action {
+  constructor(g: string) {
+    super(0, 'bump', g);
+  }
+  clone(grouplist: ActionGroupList): Action | null {
+    if (!grouplist.contains(this.getGroup())) return null;
+    return new ActionBump(this.getGroup());
+  }
+  apply(data: any): number {
+    if (data.left > 0) {
+      data.left -= 1;
+      this.count += 1;
+    }
+    return 0;
+  }
+}
+
+function build() {
+  const db = new ActionDatabase();
+  const universal = new ActionGroup(Action.rule_repeatapply | Action.rule_onceperfunc, 'universal');
+  universal.addAction(new ActionBump('base'));
+  (db as any).registerAction(ActionDatabase.universalname, universal);
+  db.setGroup('full', ['base']);
+  return db.setCurrent('full');
+}
+
+function func(left: number): any {
+  return { left, getName: () => 'func', getArch: () => ({ printMessage: () => {} }) };
+}
+
+describe('ActionJobState', () => {
+  it('keeps the progress of each job apart on a shared root', () => {
+    const root = build();
+    const stateA = root.newJobState();
+    const stateB = root.newJobState();
+    const prev = root.bindJobState(stateA);
+    root.reset(func(0));
+    root.perform(func(3));
+    root.bindJobState(stateB);
+    root.reset(func(0));
+    root.perform(func(1));
+    root.bindJobState(prev);
+    expect(root.getStatus()).toBe(Action.status_start);
+
+    root.bindJobState(stateA);
+    expect(root.getStatus()).toBe(Action.status_end);
+    expect((root as any).count).toBe(3);
+    root.bindJobState(stateB);
+    expect((root as any).count).toBe(1);
+    root.bindJobState(prev);
+  });
+
+  it('rejects a state laid out for another tree', () => {
+    const root = build();
+    const other = build();
+    expect(() => root.bindJobState(other.newJobState())).toThrow(LowlevelError);
+  });
+});
@@ -0,0 +1,97 @@
+/**
+ * @file actionlimits.test.ts
+ * @description Tests that grouplist caps bound the repeats and restarts of a derived root Action.
+ */
+
+import { describe, it, expect } from 'vitest';
+import { Action, ActionGroup, ActionRestartGroup, ActionDatabase, type ActionGroupList } from '../../src/decompiler/action.js';
+
+/** Makes a change on each of its first `changes` applications */
+class ActionBump extends Action {
+  applied = 0;
+  constructor(g: string, private changes: { left: number }) {
+    super(0, 'bump', g);
+  }
+  clone(grouplist: ActionGroupList): Action | null {
+    if (!grouplist.contains(this.getGroup())) return null;
+    return new ActionBump(this.getGroup(), this.changes);
+  }
+  apply(): number {
+    this.applied += 1;
+    if (this.changes.left > 0) {
+      this.changes.left -= 1;
+      this.count += 1;
+    }
+    return 0;
+  }
+}
+
+/** A universal Action of one repeating "fullloop" group, restarting while a restart is pending */
+function build(changes: { left: number }) {
+  const db = new ActionDatabase();
+  const universal = new ActionRestartGroup(Action.rule_onceperfunc, 'universal', 1);
+  const loop = new ActionGroup(Action.rule_repeatapply, 'fullloop');
+  loop.addAction(new ActionBump('base', changes));
+  universal.addAction(loop);
+  (db as any).registerAction(ActionDatabase.universalname, universal);
+  db.setGroup('full', ['base']);
+  db.cloneGroup('full', 'capped');
+  db.setLimit('capped', 'universal', 0);
+  db.setLimit('capped', 'fullloop', 2);
+  return db;
+}
+
+function run(root: Action, restartPending: boolean) {
+  const stats = { warnings: [] as string[], restarts: 0 };
+  const data: any = {
+    getName: () => 'func',
+    hasRestartPending: () => restartPending,
+    isJumptableRecoveryOn: () => false,
+    warningHeader: (m: string) => { stats.warnings.push(m); },
+    getArch: () => ({ clearAnalysis: () => { stats.restarts += 1; }, printMessage: () => {} }),
+  };
+  const bump = (root as any).list[0].list[0] as ActionBump;
+  const before = bump.applied;
+  root.reset(data);
+  root.perform(data);
+  return { ...stats, applied: bump.applied - before };
+}
+
+describe('ActionGroupList limits', () => {
+  it('caps the rounds of a repeating group', () => {
+    const changes = { left: 5 };
+    const db = build(changes);
+    expect(run(db.setCurrent('full'), false).applied).toBe(6);
+    changes.left = 5;
+    expect(run(db.setCurrent('capped'), false).applied).toBe(2);
+    // A cap set after deriving the root derives it again
+    db.setLimit('full', 'fullloop', 3);
+    changes.left = 5;
+    expect(run(db.getCurrent()!, false).applied).toBe(2);
+    expect(run(db.setCurrent('full'), false).applied).toBe(3);
+  });
+
+  it('runs one round of a repeating group capped at 0, as a restart group does', () => {
+    const changes = { left: 5 };
+    const db = build(changes);
+    db.setLimit('full', 'fullloop', 0);
+    expect(run(db.setCurrent('full'), false).applied).toBe(1);
+    db.setLimit('full', 'fullloop', 1);
+    changes.left = 5;
+    expect(run(db.getCurrent()!, false).applied).toBe(1);
+    // Removing the cap repeats until nothing changes again
+    db.setLimit('full', 'fullloop', -1);
+    changes.left = 5;
+    expect(run(db.getCurrent()!, false).applied).toBe(6);
+  });
+
+  it('caps restarts', () => {
+    const db = build({ left: 0 });
+    const full = run(db.setCurrent('full'), true);
+    expect(full.restarts).toBe(1);
+    expect(full.warnings).toEqual(['Exceeded maximum restarts with more pending']);
+    const capped = run(db.setCurrent('capped'), true);
+    expect(capped.restarts).toBe(0);
+    expect(capped.warnings.length).toBe(1);
+  });
+});
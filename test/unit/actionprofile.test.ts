@@ -0,0 +1,95 @@
+/**
+ * @file actionprofile.test.ts
+ * @description Tests for the self/total accounting and export formats of ActionProfiler.
+ */
+
+import { describe, it, expect } from 'vitest';
+import { ActionProfiler } from '../../src/decompiler/actionprofile.js';
+
+/** Busy-wait so that timings are measurable */
+function spin(ms: number): void {
+  const end = performance.now() + ms;
+  while (performance.now() < end) { /* spin */ }
+}
+
+const fd = { getName: () => 'func_a' };
+
+function leafRule(name: string, ms: number) {
+  return { getName: () => name, applyOp: () => { spin(ms); return 1; } };
+}
+
+describe('ActionProfiler', () => {
+  it('separates self time from nested time and builds folded stacks', () => {
+    const prof = new ActionProfiler();
+    const rule = leafRule('ruleX', 2);
+    let count = 0;
+    const pool = {
+      getName: () => 'pool',
+      getCount: () => count,
+      apply: (data: any) => { count += prof.applyRule(rule, null, data); return 0; },
+    };
+    prof.applyAction(pool, fd);
+
+    const entries = prof.getEntries();
+    const poolEnt = entries.find(e => e.name === 'pool')!;
+    const ruleEnt = entries.find(e => e.name === 'ruleX')!;
+    expect(ruleEnt.kind).toBe('rule');
+    expect(ruleEnt.applied).toBe(1);
+    expect(poolEnt.applied).toBe(1);
+    expect(poolEnt.totalMs).toBeGreaterThanOrEqual(ruleEnt.totalMs);
+    expect(poolEnt.selfMs).toBeLessThan(ruleEnt.selfMs);
+    expect(ruleEnt.maxFunction).toBe('func_a');
+    expect(prof.getFunctionCount()).toBe(1);
+
+    const folded = prof.toFolded().trim().split('\n');
+    expect(folded.some(l => l.startsWith('pool;ruleX '))).toBe(true);
+  });
+
+  it('merges exported profiles', () => {
+    const a = new ActionProfiler();
+    const b = new ActionProfiler();
+    const rule = leafRule('ruleY', 1);
+    a.applyRule(rule, null, fd);
+    b.applyRule(rule, null, { getName: () => 'func_b' });
+    b.applyRule(rule, null, { getName: () => 'func_c' });
+    a.merge(JSON.parse(JSON.stringify(b.toData())));
+    const ent = a.getEntries().find(e => e.name === 'ruleY')!;
+    expect(ent.calls).toBe(3);
+    expect(a.getFunctionCount()).toBe(3);
+  });
+
+  it('merges event counters', () => {
+    const a = new ActionProfiler();
+    const b = new ActionProfiler();
+    a.count('scope.findAddr');
+    b.count('scope.findAddr', 2);
+    b.count('scope.findByName');
+    a.merge(JSON.parse(JSON.stringify(b.toData())));
+    expect(a.getCounters()).toEqual([['scope.findAddr', 3], ['scope.findByName', 1]]);
+  });
+
+  it('breaks time down per function and phase', () => {
+    const prof = new ActionProfiler();
+    prof.recordFunctions = true;
+    const child = { getName: () => 'child', getCount: () => 0, apply: (data: any) => prof.applyRule(leafRule('ruleZ', 1), null, data) };
+    const root = { getName: () => 'root', getCount: () => 0, apply: (data: any) => prof.applyAction(child, data) };
+    const other = { getName: () => 'func_b' };
+    for (const data of [fd, other]) {
+      prof.addPhase('lift', 2, data);
+      prof.applyAction(root, data);
+      prof.addPhase('print', 1, data);
+    }
+    const funcs = prof.getFunctionProfiles();
+    expect(funcs.map(f => f.name)).toEqual(['func_a', 'func_b']);
+    expect(funcs[0].ruleTests).toBe(1);
+    expect(funcs[0].ruleApplies).toBe(1);
+    expect(Object.keys(funcs[0].phases).sort()).toEqual(['action:child', 'actions', 'lift', 'print']);
+    expect(funcs[0].phases['actions']).toBeGreaterThanOrEqual(funcs[0].phases['action:child']);
+    expect(prof.getPhases()['lift']).toBe(4);
+
+    const merged = new ActionProfiler();
+    merged.merge(JSON.parse(JSON.stringify(prof.toData())));
+    expect(merged.getPhases()['print']).toBe(2);
+    expect(merged.getFunctionProfiles().length).toBe(2);
+  });
+});
@@ -0,0 +1,161 @@
+/**
+ * @file actionworklist.test.ts
+ * @description Tests that the ActionPool worklist (the actionworklist option) makes the same
+ * edits in the same order as the full rule scan while testing fewer ops.
+ */
+
+import { describe, it, expect } from 'vitest';
+import {
+  Action, ActionGroup, ActionDatabase, ActionPool, Rule, type ActionGroupList,
+} from '../../src/decompiler/action.js';
+import { OpCode } from '../../src/core/opcodes.js';
+
+// ---------------------------------------------------------------------------
+// A synthetic function: a chain of COPY ops, each reading the output of the previous one
+// ---------------------------------------------------------------------------
+
+class FakeVarnode {
+  def: FakeOp | null = null;
+  descend: FakeOp[] = [];
+  getDef(): FakeOp | null { return this.def; }
+}
+
+class FakeOp {
+  out: FakeVarnode = new FakeVarnode();
+  ins: FakeVarnode[] = [];
+  constructor(public val: number) { this.out.def = this; }
+  code(): number { return OpCode.CPUI_COPY; }
+  isDead(): boolean { return false; }
+  getOut(): FakeVarnode { return this.out; }
+  numInput(): number { return this.ins.length; }
+  getIn(i: number): FakeVarnode { return this.ins[i]; }
+}
+
+class FakeFunc {
+  ops: FakeOp[] = [];
+  /** Position and new value of each edit, in the order the rules made them */
+  edits: string[] = [];
+  private watcher: ((op: any, vn: any) => void) | null = null;
+
+  /**
+   * @param seeds the starting value of each op, by position in the chain
+   * @param worklist the value of the actionworklist option
+   */
+  constructor(seeds: number[], private worklist: boolean) {
+    for (let i = 0; i < seeds.length; ++i) {
+      const op = new FakeOp(seeds[i]);
+      if (i > 0) {
+        op.ins.push(this.ops[i - 1].out);
+        this.ops[i - 1].out.descend.push(op);
+      }
+      this.ops.push(op);
+    }
+  }
+
+  /** Change the value of an op, telling the watcher as Funcdata's edit methods do */
+  edit(op: FakeOp, val: number): void {
+    op.val = val;
+    this.edits.push(`${this.ops.indexOf(op)}=${val}`);
+    if (this.watcher !== null) this.watcher(op, null);
+  }
+
+  getName(): string { return 'func'; }
+  hasNoCode(): boolean { return false; }
+  clear(): void {}
+  getAddress(): any { return null; }
+  getArch(): any { return { action_worklist: this.worklist, printMessage: () => {} }; }
+  opDeadAndGone(): void {}
+  setOpWatcher(w: ((op: any, vn: any) => void) | null): ((op: any, vn: any) => void) | null {
+    const prev = this.watcher;
+    this.watcher = w;
+    return prev;
+  }
+  beginOpAll(): any {
+    const ops = this.ops;
+    let i = 0;
+    return {
+      get isEnd(): boolean { return i >= ops.length; },
+      get: (): FakeOp => ops[i],
+      next: (): void => { i += 1; },
+    };
+  }
+}
+
+/**
+ * Pull each op's value up to one less than the largest value of its readers. Values flow
+ * against the sweep order, so the pool needs one sweep per step of the chain.
+ */
+class RuleFlowBack extends Rule {
+  constructor(g: string) { super(g, 0, 'flowback'); }
+  clone(grouplist: ActionGroupList): Rule | null {
+    if (!grouplist.contains(this.getGroup())) return null;
+    return new RuleFlowBack(this.getGroup());
+  }
+  getOpList(oplist: number[]): void { oplist.push(OpCode.CPUI_COPY); }
+  applyOp(op: any, data: any): number {
+    let max = -Infinity;
+    for (const rd of op.getOut().descend) max = Math.max(max, rd.val);
+    if (max - 1 <= op.val) return 0;
+    data.edit(op, max - 1);
+    return 1;
+  }
+}
+
+function build(): Action {
+  const db = new ActionDatabase();
+  const universal = new ActionGroup(Action.rule_repeatapply | Action.rule_onceperfunc, 'universal');
+  const pool = new ActionPool(Action.rule_repeatapply, 'pool');
+  pool.addRule(new RuleFlowBack('base'));
+  universal.addAction(pool);
+  (db as any).registerAction(ActionDatabase.universalname, universal);
+  db.setGroup('full', ['base']);
+  return db.setCurrent('full');
+}
+
+/** Run the pool over a fresh chain, returning the final values, the edits and the number of rule tests */
+function run(seeds: number[], worklist: boolean): { vals: number[]; edits: string[]; tests: number; applies: number } {
+  const root = build();
+  const data = new FakeFunc(seeds, worklist);
+  root.reset(data as any);
+  root.perform(data as any);
+  const pool = (root as any).list[0] as ActionPool;
+  const rl = (pool as any).allrules[0] as Rule;
+  return { vals: data.ops.map(op => op.val), edits: data.edits, tests: rl.getNumTests(), applies: rl.getNumApply() };
+}
+
+describe('ActionPool worklist', () => {
+  it('reaches the same result as the full scan on a single chain', () => {
+    const seeds = new Array(40).fill(0);
+    seeds[39] = 25;
+    const full = run(seeds, false);
+    const work = run(seeds, true);
+    expect(work.vals).toEqual(full.vals);
+    expect(work.edits).toEqual(full.edits);
+    expect(work.applies).toBe(full.applies);
+    expect(full.vals[39 - 24]).toBe(1);
+    expect(full.vals[0]).toBe(0);
+    expect(work.tests).toBeLessThan(full.tests / 4);
+  });
+
+  it('reaches the same result with several sources of change', () => {
+    const seeds = new Array(60).fill(0);
+    seeds[10] = 8;
+    seeds[35] = 30;
+    seeds[59] = 12;
+    const full = run(seeds, false);
+    const work = run(seeds, true);
+    expect(work.vals).toEqual(full.vals);
+    expect(work.edits).toEqual(full.edits);
+    expect(work.applies).toBe(full.applies);
+    expect(work.tests).toBeLessThan(full.tests);
+  });
+
+  it('does nothing extra when no rule applies', () => {
+    const seeds = Array.from({ length: 12 }, (_, i) => (12 - i) * 2);
+    const full = run(seeds, false);
+    const work = run(seeds, true);
+    expect(work.vals).toEqual(seeds);
+    expect(full.vals).toEqual(seeds);
+    expect(work.tests).toBe(full.tests);
+  });
+});
@@ -0,0 +1,117 @@
+/**
+ * @file address.test.ts
+ * @description Checks the three-way Address/SeqNum comparators against equals()/lessThan()
+ * and the raw bigint offsets, and the BigInt.asIntN/asUintN extension helpers against the
+ * shift-and-mask forms.
+ */
+
+import { describe, it, expect } from 'vitest';
+import { Address, SeqNum, sign_extend, zero_extend } from '../../src/core/address.js';
+import { AddrSpace, spacetype } from '../../src/core/space.js';
+
+const MASK64 = 0xFFFFFFFFFFFFFFFFn;
+
+/** sign_extend as the C++ computes it: shift the bit to the top, then shift back arithmetically */
+function refSignExtend(val: bigint, bit: number): bigint {
+  const sa = BigInt(64 - (bit + 1));
+  return BigInt.asIntN(64, (val << sa) & MASK64) >> sa;
+}
+
+/** zero_extend as the C++ computes it, on unsigned 64-bit values */
+function refZeroExtend(val: bigint, bit: number): bigint {
+  const sa = BigInt(64 - (bit + 1));
+  return ((val << sa) & MASK64) >> sa;
+}
+
+const VALUES = [
+  0n, 1n, 0x7fn, 0x80n, 0xffn, 0x7fffn, 0x8000n, 0x7fffffffn, 0x80000000n, 0xffffffffn,
+  0x123456789abcdefn, 0x4000000000000000n, 0x7fffffffffffffffn, 0x8000000000000000n, MASK64,
+];
+
+describe('sign_extend / zero_extend', () => {
+  for (const bit of [0, 1, 7, 8, 15, 31, 32, 52, 53, 61, 62, 63]) {
+    it(`match the shift-and-mask forms at bit ${bit}`, () => {
+      for (const val of VALUES) {
+        expect(sign_extend(val, bit)).toBe(refSignExtend(val, bit));
+        expect(zero_extend(val, bit)).toBe(refZeroExtend(val, bit));
+      }
+    });
+  }
+
+  it('extend from the given bit', () => {
+    expect(sign_extend(0x80n, 7)).toBe(-128n);
+    expect(sign_extend(0x7fn, 7)).toBe(127n);
+    expect(sign_extend(0x1ffn, 7)).toBe(-1n);
+    expect(sign_extend(0x4000000000000000n, 62)).toBe(-0x4000000000000000n);
+    expect(sign_extend(0x8000000000000000n, 63)).toBe(-0x8000000000000000n);
+    expect(zero_extend(-1n, 0)).toBe(1n);
+    expect(zero_extend(-1n, 62)).toBe(0x7fffffffffffffffn);
+    expect(zero_extend(-1n, 63)).toBe(MASK64);
+  });
+});
+
+describe('Address.compare / SeqNum.compare', () => {
+  const ram = new AddrSpace(null as any, null as any, spacetype.IPTR_PROCESSOR, 'ram', false, 8, 1, 1, 0, 0, 0);
+  const reg = new AddrSpace(null as any, null as any, spacetype.IPTR_PROCESSOR, 'register', false, 4, 1, 2, 0, 0, 0);
+  const addrs: Address[] = [new Address(), new Address().setMaximal()];
+  for (const spc of [ram, reg])
+    for (const off of [0n, 1n, 0x1000n, 0xffffffffn, MASK64])
+      addrs.push(new Address(spc, off));
+  // Offsets on both sides of the edges of the two number-key ranges
+  const edges = [
+    0xfffffffffffffn, 0x10000000000000n, 0x1fffffffffffffn, 0x20000000000000n, 0x7fffffffffffffffn,
+    0xffefffffffffffffn, 0xfff0000000000000n, 0xfff0000000000001n, 0xfffffffffffffff8n, MASK64,
+  ];
+
+  it('agree with equals() and lessThan() on addresses', () => {
+    for (const a of addrs) {
+      for (const b of addrs) {
+        const c = Address.compare(a, b);
+        expect(c === 0).toBe(a.equals(b));
+        expect(c < 0).toBe(a.lessThan(b));
+        expect(Address.compare(b, a)).toBe(c === 0 ? 0 : -c);
+      }
+    }
+  });
+
+  it('order offsets near the number-key edges as bigints do', () => {
+    const edgeAddrs = edges.map(off => new Address(ram, off));
+    for (const a of edgeAddrs) {
+      for (const b of edgeAddrs) {
+        const c = Address.compare(a, b);
+        const ref = a.offset === b.offset ? 0 : (a.offset < b.offset ? -1 : 1);
+        expect(c).toBe(ref);
+        expect(a.equals(b)).toBe(ref === 0);
+        expect(new Address(a).lessThan(b)).toBe(ref < 0);
+      }
+    }
+  });
+
+  it('recompute the number key when the offset changes', () => {
+    const a = new Address(ram, 0x1000n);
+    const b = new Address(ram, 0x2000n);
+    expect(Address.compare(a, b)).toBe(-1);
+    a.offset = 0x3000n;
+    expect(Address.compare(a, b)).toBe(1);
+    a.set(ram, 0x2000n);
+    expect(a.equals(b)).toBe(true);
+    b.assign(new Address(ram, MASK64));
+    expect(Address.compare(a, b)).toBe(-1);
+  });
+
+  it('agree with equals() and lessThan() on sequence numbers', () => {
+    const seqs: SeqNum[] = [];
+    let uniq = 0;
+    for (const a of addrs.slice(2))
+      for (let k = 0; k < 3; ++k)
+        seqs.push(new SeqNum(a, (uniq++ * 7919) % 97));   // Uniq order differs from pc order
+    for (const a of seqs) {
+      for (const b of seqs) {
+        const c = SeqNum.compare(a, b);
+        expect(c === 0).toBe(a.equals(b));
+        expect(c < 0).toBe(a.lessThan(b));
+      }
+      expect(SeqNum.compare(a, new SeqNum(a.getAddr(), a.getTime()))).toBe(0);
+    }
+  });
+});
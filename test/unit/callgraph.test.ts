@@ -0,0 +1,46 @@
+/**
+ * @file callgraph.test.ts
+ * @description Tests for the strongly connected components and leaf walk of CallGraph.
+ */
+
+import { describe, it, expect } from 'vitest';
+import { Address } from '../../src/core/address.js';
+import { CallGraph } from '../../src/decompiler/callgraph.js';
+
+const space: any = { getName: () => 'ram', getIndex: () => 1, getWordSize: () => 1 };
+
+/** main calls parse and log; parse and eval call each other; eval calls log */
+function makeGraph() {
+  const graph = new CallGraph(null);
+  const node = (off: bigint, nm: string) => graph.addNode(new Address(space, off), nm);
+  const main = node(0x1000n, 'main');
+  const parse = node(0x2000n, 'parse');
+  const evalf = node(0x3000n, 'eval');
+  const log = node(0x4000n, 'log');
+  const call = (from: any, to: any, off: bigint) => graph.addEdge(from, to, new Address(space, off));
+  call(main, parse, 0x1004n);
+  call(main, log, 0x1008n);
+  call(parse, evalf, 0x2004n);
+  call(evalf, parse, 0x3004n);
+  call(evalf, log, 0x3008n);
+  return graph;
+}
+
+describe('CallGraph', () => {
+  it('orders components callee-first and collapses recursion', () => {
+    const comps = makeGraph().getComponents();
+    expect(comps.map(c => c.nodes.map(n => n.getName()))).toEqual([['log'], ['parse', 'eval'], ['main']]);
+    expect(comps.map(c => c.level)).toEqual([0, 1, 2]);
+    expect(comps[2].callees).toEqual([0, 1]);
+  });
+
+  it('visits every node once in the leaf walk', () => {
+    const graph = makeGraph();
+    const seen: string[] = [];
+    for (let node = graph.initLeafWalk(); node !== null; node = graph.nextLeaf(node))
+      seen.push(node.getName());
+    expect(seen.length).toBe(4);
+    expect(seen.indexOf('log')).toBeLessThan(seen.indexOf('main'));
+    expect(seen[seen.length - 1]).toBe('main');
+  });
+});
@@ -0,0 +1,99 @@
+/**
+ * @file cover.test.ts
+ * @description Tests that the bitset intersection of Cover agrees with the block walk.
+ */
+
+import { describe, it, expect, afterEach } from 'vitest';
+import { Cover } from '../../src/decompiler/cover.js';
+import { OpCode } from '../../src/core/opcodes.js';
+
+/** Blocks of a random forward graph, with a few back edges, each holding four ops */
+function makeGraph(numBlocks: number, rand: (n: number) => number) {
+  const blocks: any[] = [];
+  for (let i = 0; i < numBlocks; ++i) {
+    const bl: any = { ins: [] as any[], getIndex: () => i };
+    bl.sizeIn = () => bl.ins.length;
+    bl.getIn = (j: number) => bl.ins[j];
+    bl.ops = [1, 2, 3, 4].map(order => ({
+      isMarker: () => false,
+      code: () => OpCode.CPUI_COPY,
+      getParent: () => bl,
+      getSeqNum: () => ({ getOrder: () => order }),
+    }));
+    blocks.push(bl);
+  }
+  for (let i = 1; i < numBlocks; ++i) {
+    blocks[i].ins.push(blocks[rand(i)]);
+    if (rand(4) === 0) blocks[i].ins.push(blocks[rand(i)]);
+    if (i > 4 && rand(10) === 0) blocks[rand(i)].ins.push(blocks[i]);
+  }
+  return blocks;
+}
+
+/** The Cover of a value defined and read within one block, between two of its ops */
+function makeLocalCover(block: any, defOrder: number, refOrder: number): Cover {
+  const def = block.ops[defOrder - 1];
+  const vn: any = { getDef: () => def, isInput: () => false };
+  const cover = new Cover();
+  cover.addDefPoint(vn);
+  cover.addRefPoint(block.ops[refOrder - 1], vn);
+  return cover;
+}
+
+/** The Cover of a value defined at one op and read at a few others */
+function makeCover(blocks: any[], rand: (n: number) => number): Cover {
+  const def = blocks[rand(blocks.length)].ops[rand(4)];
+  const vn: any = { getDef: () => def, isInput: () => false };
+  const cover = new Cover();
+  cover.addDefPoint(vn);
+  for (let k = rand(4); k >= 0; --k)
+    cover.addRefPoint(blocks[rand(blocks.length)].ops[rand(4)], vn);
+  return cover;
+}
+
+describe('Cover', () => {
+  afterEach(() => {
+    Cover.dense = true;
+  });
+
+  it('gives the same intersections with bitsets as with the block walk', () => {
+    let seed = 11;
+    const rand = (n: number) => {
+      seed = (seed * 1103515245 + 12345) & 0x7fffffff;
+      return seed % n;
+    };
+    const blocks = makeGraph(150, rand);
+    const covers = Array.from({ length: 60 }, () => makeCover(blocks, rand));
+    // Known disjoint pairs: different blocks, and one block at different ops
+    covers.push(makeLocalCover(blocks[3], 1, 2), makeLocalCover(blocks[4], 1, 2));
+    covers.push(makeLocalCover(blocks[5], 1, 2), makeLocalCover(blocks[5], 3, 4));
+    const results = (dense: boolean) => {
+      Cover.dense = dense;
+      const out: any[] = [];
+      for (const a of covers) {
+        for (const b of covers) {
+          const list: number[] = [];
+          a.intersectList(list, b, 1);
+          out.push(a.intersect(b), list);
+        }
+      }
+      return out;
+    };
+    const sparse = results(false);
+    expect(results(true)).toEqual(sparse);
+    expect(sparse.filter(r => r === 0).length).toBeGreaterThan(0);
+    expect(sparse.filter(r => r === 2).length).toBeGreaterThan(0);
+
+    // After a cover changes, its bitsets follow
+    Cover.dense = true;
+    for (const b of covers) covers[0].intersect(b);
+    covers[0].merge(covers[1]);
+    covers[2].merge(covers[3]);
+    // An existing block extended by a later read, after its bitsets were built
+    const vn: any = { getDef: () => blocks[10].ops[0], isInput: () => false };
+    covers[4].addDefPoint(vn);
+    covers[4].intersect(covers[5]);
+    covers[4].addRefPoint(blocks[149].ops[3], vn);
+    expect(results(true)).toEqual(results(false));
+  });
+});
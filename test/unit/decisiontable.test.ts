@@ -0,0 +1,119 @@
+/**
+ * @file decisiontable.test.ts
+ * @description Tests that a DecisionTable compiled from a DecisionNode tree resolves the same
+ * constructor as walking the tree, across instruction and context encodings.
+ */
+
+import { describe, it, expect } from 'vitest';
+import { DecisionNode } from '../../src/sleigh/slghsymbol.js';
+import { ParserContext, ParserWalker } from '../../src/sleigh/context.js';
+
+/**
+ * A small deterministic generator, so failures can be reproduced. Its low bits have short
+ * periods, so callers draw small values from the high bits.
+ */
+function lcg(seed: number): () => number {
+  let s = seed >>> 0;
+  return () => {
+    s = (Math.imul(s, 1664525) + 1013904223) >>> 0;
+    return s;
+  };
+}
+
+/** A value in [0, n) from the high bits of the generator */
+function below(next: () => number, n: number): number {
+  return (next() >>> 16) % n;
+}
+
+interface Field { context: boolean; startbit: number; bitsize: number; }
+
+/**
+ * The fields the tree branches on, by depth. They include fields crossing byte boundaries,
+ * fields past the first instruction word, and a context field crossing two context words.
+ */
+const FIELDS: Field[][] = [
+  [{ context: false, startbit: 0, bitsize: 3 }],
+  [{ context: false, startbit: 6, bitsize: 5 }, { context: true, startbit: 29, bitsize: 6 }],
+  [{ context: false, startbit: 37, bitsize: 2 }, { context: true, startbit: 4, bitsize: 1 }],
+];
+
+/**
+ * Build a tree branching on FIELDS. Leaves hold two patterns: one matching only when a byte of
+ * the instruction is even, and a catch-all, so leaf pattern order is exercised as well.
+ */
+function buildTree(next: () => number, depth: number, leaves: object[]): DecisionNode {
+  const node = new DecisionNode(null) as any;
+  if (depth === FIELDS.length || (depth > 0 && below(next, 5) === 0)) {
+    const even = { leaf: leaves.length, even: true };
+    const other = { leaf: leaves.length, even: false };
+    leaves.push(even, other);
+    const byte = below(next, 8);
+    node.list.push([{ isMatch: (w: ParserWalker) => (w.getInstructionBits(byte * 8, 8) & 1) === 0 }, even]);
+    node.list.push([{ isMatch: () => true }, other]);
+    return node;
+  }
+  const opts = FIELDS[depth];
+  const field = opts[below(next, opts.length)];
+  node.contextdecision = field.context;
+  node.startbit = field.startbit;
+  node.bitsize = field.bitsize;
+  for (let i = 0; i < (1 << field.bitsize); ++i) {
+    const child = buildTree(next, depth + 1, leaves) as any;
+    child.parent = node;
+    node.children.push(child);
+  }
+  return node;
+}
+
+function makeWalker(): ParserWalker {
+  const ctx = new ParserContext(null, null);
+  ctx._contextsize = 2;
+  ctx._context = [0, 0];
+  ctx.initialize(1, 0, null as any);
+  const walker = new ParserWalker(ctx);
+  walker.baseState();
+  return walker;
+}
+
+describe('DecisionTable', () => {
+  for (const seed of [1, 7, 42]) {
+    it(`resolves the same constructor as the tree (seed ${seed})`, () => {
+      const next = lcg(seed);
+      const leaves: object[] = [];
+      const tree = buildTree(next, 0, leaves);
+      const table = tree.compile();
+      expect(table.numLeaves() * 2).toBe(leaves.length);
+
+      const walker = makeWalker();
+      const ctx = walker.getParserContext();
+      const seen = new Set<object>();
+      for (let i = 0; i < 4000; ++i) {
+        for (let j = 0; j < 16; ++j) ctx._buf[j] = next() >>> 24;
+        ctx._context[0] = next();
+        ctx._context[1] = next();
+        walker._point!.offset = below(next, 4);
+        const expected = tree.resolve(walker);
+        expect(table.resolve(walker)).toBe(expected);
+        seen.add(expected);
+      }
+      // The encodings reach most of the tree
+      expect(seen.size).toBeGreaterThan(leaves.length / 2);
+    });
+  }
+
+  it('reports an instruction longer than 16 bytes like the tree', () => {
+    const node = new DecisionNode(null) as any;
+    node.startbit = 0;
+    node.bitsize = 1;
+    for (let i = 0; i < 2; ++i) {
+      const leaf = new DecisionNode(node) as any;
+      leaf.list.push([{ isMatch: () => true }, { leaf: i }]);
+      node.children.push(leaf);
+    }
+    const table = (node as DecisionNode).compile();
+    const walker = makeWalker();
+    walker._point!.offset = 16;
+    expect(() => (node as DecisionNode).resolve(walker)).toThrow('Instruction is using more than 16 bytes');
+    expect(() => table.resolve(walker)).toThrow('Instruction is using more than 16 bytes');
+  });
+});
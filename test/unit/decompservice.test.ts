@@ -0,0 +1,132 @@
+/**
+ * @file decompservice.test.ts
+ * @description Request/response tests for DecompService against fake replicas.
+ */
+
+import { describe, it, expect, vi, beforeEach, afterEach } from 'vitest';
+import { PassThrough } from 'stream';
+import { FakeChild } from './fakechild.js';
+import { DecompService, type ServiceResponse } from '../../src/console/decompservice.js';
+
+vi.mock('child_process', async (importOriginal) => {
+  const { fakeFork } = await import('./fakechild.js');
+  return { ...(await importOriginal<typeof import('child_process')>()), fork: fakeFork };
+});
+
+// The fake replicas never read the snapshot, so no real Architecture is needed
+vi.mock('../../src/decompiler/worker_arch.js', async (importOriginal) => ({
+  ...(await importOriginal<typeof import('../../src/decompiler/worker_arch.js')>()),
+  buildXmlArchitectureFromFile: () => ({}),
+  encodeArchitectureSnapshot: () => new Uint8Array([0]),
+  encodeCoreTypeTable: () => null,
+}));
+
+/** Feed request lines to serveStream() and collect the responses once the output ends */
+async function serve(service: DecompService, lines: (object | string)[]): Promise<ServiceResponse[]> {
+  const input = new PassThrough();
+  const output = new PassThrough();
+  let text = '';
+  output.on('data', (d: Buffer) => { text += d.toString(); });
+  const finished = service.serveStream(input, output);
+  for (const l of lines) input.write((typeof l === 'string' ? l : JSON.stringify(l)) + '\n');
+  input.end();
+  await finished;
+  expect(output.writableEnded).toBe(true);
+  return text.trim().split('\n').map(l => JSON.parse(l));
+}
+
+const RENAME = { program: 'p', function: 'main', symbol: 'iVar1', name: 'count' };
+
+/** Messages of type run that a child received */
+const runs = (c: FakeChild): string[][] => c.received.filter(m => m.type === 'run').map(m => m.commands);
+
+let service: DecompService;
+
+beforeEach(async () => {
+  FakeChild.reset();
+  service = new DecompService(2);
+  const resp = await service.handle({ id: 0, method: 'load', params: { program: 'p', path: 'p.xml' } });
+  expect(resp.result).toEqual({ program: 'p', replicas: 2 });
+});
+
+afterEach(() => {
+  service.shutdown();
+});
+
+describe('DecompService requests', () => {
+  it('answers decompile with the C text or the packed tokens', async () => {
+    const resp = await serve(service, [
+      { id: 1, method: 'decompile', params: { program: 'p', function: 'main' } },
+      { id: 2, method: 'decompile', params: { program: 'p', function: 'main', format: 'packed' } },
+    ]);
+    resp.sort((a, b) => (a.id as number) - (b.id as number));
+    expect(resp[0].error).toBeUndefined();
+    expect(resp[0].result.function).toBe('main');
+    expect(resp[0].result.c).toBe('load function main\ndecompile\nprint C');
+    expect(resp[1].result.tokens).toBe('load function main\ndecompile\nprint C packed');
+  });
+
+  it('replies to bad requests with errors', async () => {
+    const resp = await serve(service, [
+      'not json',
+      { id: 2, method: 'bogus' },
+      { id: 3, method: 'decompile', params: { program: 'q', function: 'main' } },
+      { id: 4, method: 'rename', params: { ...RENAME, name: 'two words' } },
+      { id: 5, method: 'decompile', params: { program: 'p', function: 'main', format: 'html' } },
+    ]);
+    const byId = new Map(resp.map(r => [r.id, r]));
+    expect(byId.get(undefined)!.error).toBe('Malformed request');
+    expect(byId.get(2)!.error).toBe('Unknown method: bogus');
+    expect(byId.get(3)!.error).toBe('Program not loaded: q');
+    expect(byId.get(4)!.error).toBe('Invalid name: two words');
+    expect(byId.get(5)!.error).toBe('Unknown output format: html');
+    expect(service.metrics().methods.bogus.errors).toBe(1);
+  });
+
+  it('replays an applied rename onto a restarted replica', async () => {
+    const resp = await service.handle({ id: 1, method: 'rename', params: RENAME });
+    expect(resp.result).toMatchObject({ function: 'main', symbol: 'iVar1', name: 'count' });
+    FakeChild.spawned[0].kill();
+    await vi.waitFor(() => expect(FakeChild.spawned.length).toBe(3));
+    const fresh = FakeChild.spawned[2];
+    await vi.waitFor(() => expect(runs(fresh)).toEqual([['load function main', 'rename iVar1 count']]));
+  });
+
+  it('does not record a rename that failed everywhere', async () => {
+    FakeChild.behavior.run = (cmds) =>
+      cmds.some(c => c.startsWith('rename')) ? { success: false, error: 'No symbol iVar1' } : {};
+    const resp = await service.handle({ id: 1, method: 'rename', params: RENAME });
+    expect(resp.error).toBe('No symbol iVar1');
+    FakeChild.spawned[0].kill();
+    await vi.waitFor(() => expect(FakeChild.spawned[2]?.workerId).toBe(0));
+    await new Promise(res => setTimeout(res, 20));
+    expect(runs(FakeChild.spawned[2])).toEqual([]);
+  });
+
+  it('rebuilds a replica a rename failed on while the others took it', async () => {
+    const first = FakeChild.spawned[1];
+    FakeChild.behavior.run = (cmds, child) =>
+      child === first && cmds.some(c => c.startsWith('rename')) ? { success: false, error: 'Busy' } : {};
+    const resp = await service.handle({ id: 1, method: 'rename', params: RENAME });
+    expect(resp.error).toBeUndefined();
+    expect(FakeChild.spawned.length).toBe(3);
+    const fresh = FakeChild.spawned[2];
+    await vi.waitFor(() => expect(runs(fresh)).toEqual([['load function main', 'rename iVar1 count']]));
+    expect(fresh.workerId).toBe(1);
+    expect(first.received.some(m => m.type === 'shutdown')).toBe(true);
+  });
+
+  it('rebuilds a replica that crashed during a rename', async () => {
+    const first = FakeChild.spawned[1];
+    FakeChild.behavior.run = (cmds, child) =>
+      child === first && cmds.some(c => c.startsWith('rename')) ? null : {};
+    const resp = await service.handle({ id: 1, method: 'rename', params: RENAME });
+    expect(resp.error).toBeUndefined();
+    // Restarted on exit, then rebuilt once the rename was recorded; the last one has it
+    const last = (): FakeChild => FakeChild.spawned[FakeChild.spawned.length - 1];
+    await vi.waitFor(() => expect(runs(last())).toEqual([['load function main', 'rename iVar1 count']]));
+    expect(last().workerId).toBe(1);
+    const out = await service.handle({ id: 2, method: 'decompile', params: { program: 'p', function: 'main' } });
+    expect(out.error).toBeUndefined();
+  });
+});
@@ -0,0 +1,144 @@
+/**
+ * @file emulatecompiled.test.ts
+ * @description Runs a small p-code loop through EmulateCompiled over paged and hashed memory,
+ * and through the interpreted EmulatePcodeCache for the same result.
+ */
+
+import { describe, it, expect } from 'vitest';
+import { EmulateCompiled, EmulatePcodeCache, BreakTableCallBack, BreakCallBack } from '../../src/decompiler/emulate.js';
+import { MemoryState, MemoryPageOverlay, MemoryHashOverlay } from '../../src/decompiler/memstate.js';
+import { AddrSpace, ConstantSpace, spacetype } from '../../src/core/space.js';
+import { Address } from '../../src/core/address.js';
+import { VarnodeData } from '../../src/core/pcoderaw.js';
+import { OpCode } from '../../src/core/opcodes.js';
+
+const constspc = new ConstantSpace(null as any, null as any);
+const ram = new AddrSpace(null as any, null as any, spacetype.IPTR_PROCESSOR, 'ram', false, 4, 1, 1, 0, 0, 0);
+const reg = new AddrSpace(null as any, null as any, spacetype.IPTR_PROCESSOR, 'register', false, 4, 1, 2, 0, 0, 0);
+const uniq = new AddrSpace(null as any, null as any, spacetype.IPTR_INTERNAL, 'unique', false, 4, 1, 3, 0, 0, 0);
+
+const c = (val: number, size = 4) => new VarnodeData(constspc, BigInt(val), size);
+const r = (off: number, size = 4) => new VarnodeData(reg, BigInt(off), size);
+const u = (off: number, size = 1) => new VarnodeData(uniq, BigInt(off), size);
+const ramvn = (off: number) => new VarnodeData(ram, BigInt(off), 4);
+const spaces = [constspc, ram, reg, uniq];
+/** LOAD/STORE space operand: a constant holding the space index, as SLEIGH emits it */
+const spcid = c(ram.getIndex(), 8);
+
+type RawOp = [OpCode, VarnodeData | null, ...VarnodeData[]];
+
+/** Sum 10 down to 1 into r0, store it and load it back into r16, square it into the 8-byte r8, then halt */
+const program = new Map<number, RawOp[]>([
+  [0x100, [[OpCode.CPUI_COPY, r(0), c(0)], [OpCode.CPUI_COPY, r(4), c(10)]]],
+  [0x104, [
+    [OpCode.CPUI_INT_ADD, r(0), r(0), r(4)],
+    [OpCode.CPUI_INT_SUB, r(4), r(4), c(1)],
+    [OpCode.CPUI_INT_NOTEQUAL, u(0x10), r(4), c(0)],
+    [OpCode.CPUI_CBRANCH, null, ramvn(0x104), u(0x10)],
+  ]],
+  [0x108, [
+    [OpCode.CPUI_STORE, null, spcid, c(0x2000), r(0)],
+    [OpCode.CPUI_LOAD, r(16), spcid, c(0x2000)],
+    [OpCode.CPUI_CBRANCH, null, c(2), c(1, 1)],
+    [OpCode.CPUI_COPY, r(0), c(999)],
+    [OpCode.CPUI_INT_ZEXT, r(8, 8), r(0)],
+    [OpCode.CPUI_INT_MULT, r(8, 8), r(8, 8), r(8, 8)],
+  ]],
+  [0x10c, [[OpCode.CPUI_CALLOTHER, null, c(0)]]],
+]);
+
+const trans: any = {
+  translated: 0,
+  getUserOpNames(res: string[]): void { res.push('halt'); },
+  getSpace(i: number): AddrSpace | null { return spaces[i] ?? null; },
+  oneInstruction(emit: any, addr: Address): number {
+    trans.translated += 1;
+    for (const [opc, out, ...ins] of program.get(Number(addr.getOffset())) ?? [])
+      emit.dump(addr, opc, out, ins, ins.length);
+    return 4;
+  },
+};
+
+class HaltCallBack extends BreakCallBack {
+  hits = 0;
+  pcodeCallback(): boolean {
+    this.hits += 1;
+    this.emulate!.setHalt(true);
+    return true;
+  }
+  addressCallback(): boolean {
+    this.hits += 1;
+    this.emulate!.setHalt(true);
+    return true;
+  }
+}
+
+function buildState() {
+  const mem = new MemoryState(trans);
+  mem.setMemoryBank(new MemoryPageOverlay(ram, 4, 256, null));
+  mem.setMemoryBank(new MemoryPageOverlay(reg, 4, 16, null));
+  mem.setMemoryBank(new MemoryHashOverlay(uniq, 4, 16, 64, null));
+  return { mem, table: new BreakTableCallBack(trans) };
+}
+
+function build() {
+  const { mem, table } = buildState();
+  const emu = new EmulateCompiled(trans, mem, table);
+  return { mem, table, emu };
+}
+
+describe('EmulateCompiled', () => {
+  it('runs compiled instructions against the memory state', () => {
+    const { mem, table, emu } = build();
+    const halt = new HaltCallBack();
+    table.registerPcodeCallback('halt', halt);
+    trans.translated = 0;
+    emu.setExecuteAddress(new Address(ram, 0x100n));
+    const count = emu.run(1000);
+    expect(halt.hits).toBe(1);
+    expect(count).toBe(13);
+    expect(trans.translated).toBe(5);
+    expect(mem.getValueSpace(reg, 0n, 4)).toBe(55n);
+    expect(mem.getValueSpace(ram, 0x2000n, 4)).toBe(55n);
+    expect(mem.getValueSpace(reg, 16n, 4)).toBe(55n);
+    expect(mem.getValueSpace(reg, 8n, 8)).toBe(3025n);
+    expect(mem.getValueSpace(uniq, 0x10n, 1)).toBe(0n);
+  });
+
+  it('steps by op and honors address breakpoints', () => {
+    const { mem, table, emu } = build();
+    const halt = new HaltCallBack();
+    table.registerAddressCallback(new Address(ram, 0x108n), halt);
+    emu.setExecuteAddress(new Address(ram, 0x100n));
+    emu.executeCurrentOp();
+    expect(emu.isInstructionStart()).toBe(false);
+    expect(emu.getCurrentOpIndex()).toBe(1);
+    emu.executeCurrentOp();
+    expect(emu.getExecuteAddress().getOffset()).toBe(0x104n);
+    expect(mem.getValueSpace(reg, 4n, 4)).toBe(10n);
+    emu.run(1000);
+    expect(halt.hits).toBe(1);
+    expect(emu.getExecuteAddress().getOffset()).toBe(0x108n);
+    expect(mem.getValueSpace(reg, 0n, 4)).toBe(55n);
+  });
+
+  it('matches the interpreted emulator', () => {
+    const { mem, table } = buildState();
+    const emu = new EmulatePcodeCache(trans, mem, table);
+    const halt = new HaltCallBack();
+    table.registerPcodeCallback('halt', halt);
+    emu.setExecuteAddress(new Address(ram, 0x100n));
+    emu.setHalt(false);
+    let count = 0;
+    while (!emu.getHalt()) {
+      emu.executeInstruction();
+      count += 1;
+    }
+    expect(halt.hits).toBe(1);
+    expect(count).toBe(13);
+    expect(mem.getValueSpace(reg, 0n, 4)).toBe(55n);
+    expect(mem.getValueSpace(ram, 0x2000n, 4)).toBe(55n);
+    expect(mem.getValueSpace(reg, 16n, 4)).toBe(55n);
+    expect(mem.getValueSpace(reg, 8n, 8)).toBe(3025n);
+  });
+});
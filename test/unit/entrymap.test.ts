@@ -0,0 +1,69 @@
+/**
+ * @file entrymap.test.ts
+ * @description Tests that the lazily sorted, block indexed EntryMap answers address queries
+ * like a plain scan of the entries in offset order.
+ */
+
+import { describe, it, expect } from 'vitest';
+import { EntryMap } from '../../src/decompiler/database.js';
+
+/** Just enough of a SymbolEntry for EntryMap */
+function makeEntry(first: bigint, size: bigint, sub: number): any {
+  const subsort = { sub, lessThan: (o: any) => sub < o.sub };
+  return { getFirst: () => first, getLast: () => first + size - 1n, getSubsort: () => subsort };
+}
+
+describe('EntryMap', () => {
+  it('matches a scan of the sorted entries', () => {
+    let seed = 5;
+    const rand = (n: number) => {
+      seed = (seed * 1103515245 + 12345) & 0x7fffffff;
+      return seed % n;
+    };
+    const map = new EntryMap();
+    const live: any[] = [];
+    for (let i = 0; i < 3000; ++i) {
+      // Mostly small symbols, some large ones covering others
+      const size = rand(50) === 0 ? BigInt(1 + rand(4000)) : BigInt(1 + rand(8));
+      const e = makeEntry(BigInt(rand(20000)), size, rand(3));
+      map.insertEntry(e);
+      live.push(e);
+      if (rand(10) === 0) {
+        const victim = live.splice(rand(live.length), 1)[0];
+        map.eraseEntry(victim);
+      }
+      if (rand(100) === 0) map.buildIndex();
+    }
+    const order = (a: any, b: any) => {
+      if (a.getFirst() !== b.getFirst()) return a.getFirst() < b.getFirst() ? -1 : 1;
+      return a.getSubsort().sub - b.getSubsort().sub;
+    };
+    const sorted = live.slice().sort(order);
+    expect(map.getList().map(e => [e.getFirst(), e.getSubsort().sub]))
+      .toEqual(sorted.map(e => [e.getFirst(), e.getSubsort().sub]));
+
+    for (let q = 0; q < 500; ++q) {
+      const off = BigInt(rand(21000));
+      const expected = sorted.filter(e => e.getFirst() <= off && e.getLast() >= off);
+      const got = map.findByOffset(off);
+      expect(got.length).toBe(expected.length);
+      got.forEach((e, i) => expect(e).toBe(expected[i]));
+
+      const last = off + BigInt(rand(20));
+      const overlap = sorted.find(e => e.getFirst() <= last && e.getLast() >= off) ?? null;
+      expect(map.findOverlap(off, last)).toBe(overlap);
+    }
+  });
+
+  it('keeps equal entries in insertion order', () => {
+    const map = new EntryMap();
+    const a = makeEntry(10n, 4n, 0);
+    const b = makeEntry(10n, 4n, 0);
+    const c = makeEntry(2n, 4n, 0);
+    map.insertEntry(a);
+    map.insertEntry(b);
+    map.insertEntry(c);
+    expect(map.getList()).toEqual([c, a, b]);
+    expect(map.findByOffset(11n)).toEqual([a, b]);
+  });
+});
@@ -0,0 +1,59 @@
+/**
+ * @file eventtrace.test.ts
+ * @description Tests the depth limit, merging and file format of EventTracer.
+ */
+
+import { describe, it, expect } from 'vitest';
+import * as fs from 'fs';
+import * as os from 'os';
+import * as path from 'path';
+import { EventTracer, type TraceEvent } from '../../src/decompiler/eventtrace.js';
+
+const fd = { getName: () => 'func_a' };
+
+describe('EventTracer', () => {
+  it('reports actions down to the depth limit', () => {
+    const tracer = new EventTracer('test', 2);
+    const run = (depth: number): number =>
+      tracer.traceAction('depth' + depth, fd, () => (depth < 3 ? run(depth + 1) : 7));
+    expect(run(1)).toBe(7);
+    const spans = tracer.getEvents().filter(e => e.ph === 'X');
+    expect(spans.map(e => e.name).sort()).toEqual(['depth1', 'depth2']);
+    const [inner, outer] = spans;
+    expect(inner.args!.function).toBe('func_a');
+    expect(outer.ts).toBeLessThanOrEqual(inner.ts);
+    expect(outer.ts + outer.dur!).toBeGreaterThanOrEqual(inner.ts + inner.dur!);
+
+    // An exception still unwinds the depth
+    expect(() => tracer.traceAction('bad', fd, () => { throw new Error('x'); })).toThrow();
+    tracer.traceAction('after', fd, () => 0);
+    expect(tracer.getEvents().some(e => e.name === 'after')).toBe(true);
+  });
+
+  it('writes merged events from several processes as one sorted trace', () => {
+    const parent = new EventTracer('parent');
+    parent.nameThread(1, 'worker 0');
+    const start = EventTracer.now();
+    parent.complete('batch', 'scheduler', start, { functions: 2 }, 1);
+    const child: TraceEvent[] = [
+      { name: 'process_name', cat: '__metadata', ph: 'M', ts: 0, pid: 4242, tid: 0, args: { name: 'worker 0' } },
+      { name: 'f', cat: 'function', ph: 'X', ts: start - 5, dur: 3, pid: 4242, tid: 0 },
+    ];
+    parent.merge(child);
+    parent.instant('restart', 'action');
+
+    const file = path.join(os.tmpdir(), `eventtrace-${process.pid}.json`);
+    try {
+      parent.write(file);
+      const trace = JSON.parse(fs.readFileSync(file, 'utf8'));
+      const events: TraceEvent[] = trace.traceEvents;
+      expect(events.length).toBe(6);
+      expect(events.filter(e => e.ph === 'M').length).toBe(3);
+      const timed = events.filter(e => e.ph !== 'M');
+      expect(timed.map(e => e.name)).toEqual(['f', 'batch', 'restart']);
+      expect(new Set(events.map(e => e.pid)).size).toBe(2);
+    } finally {
+      fs.rmSync(file, { force: true });
+    }
+  });
+});
@@ -0,0 +1,141 @@
+/**
+ * @file fakechild.ts
+ * @description In-process stand-in for the decompiler worker processes.
+ *
+ * Tests mock child_process.fork() with fakeFork(), so the orchestrators can be exercised
+ * without spawning real children or loading any .sla. A FakeChild speaks the IPC protocol
+ * of worker_entry.ts: it answers init with ready, each function of an assign batch with a
+ * result, and run with output (the commands, one per line). FakeChild.behavior lets a test
+ * slow functions down, rewrite their results or outputs, or crash the child mid-request.
+ */
+
+import { EventEmitter } from 'events';
+
+/** Per-test hooks for the fake children */
+export interface FakeChildBehavior {
+  /** Delay (ms) before the result for the function is sent */
+  delayMs?: (name: string, child: FakeChild) => number;
+  /** Build the result message for a function; return null to crash the child instead */
+  result?: (name: string, child: FakeChild) => Record<string, any> | null;
+  /** Fields overriding the output message of a run request; return null to crash the child instead */
+  run?: (commands: string[], child: FakeChild) => Record<string, any> | null;
+}
+
+export class FakeChild extends EventEmitter {
+  /** Every child created by fakeFork() since the last reset() */
+  static spawned: FakeChild[] = [];
+  static behavior: FakeChildBehavior = {};
+
+  static reset(): void {
+    FakeChild.spawned = [];
+    FakeChild.behavior = {};
+  }
+
+  workerId = -1;
+  connected = true;
+  exitCode: number | null = null;
+  /** Every message the parent sent to this child */
+  received: any[] = [];
+  stdout = new EventEmitter();
+  stderr = new EventEmitter();
+  private chain: Promise<void> = Promise.resolve();
+
+  send(msg: any): boolean {
+    if (!this.connected) throw new Error('Channel closed');
+    this.received.push(msg);
+    // Messages are handled one at a time, in order, like the real child's event loop
+    this.chain = this.chain.then(() => this.handle(msg));
+    return true;
+  }
+
+  kill(): boolean {
+    this.exit(null, 'SIGKILL');
+    return true;
+  }
+
+  /** Terminate the child and report the exit to the parent */
+  exit(code: number | null, signal: string | null): void {
+    if (!this.connected) return;
+    this.connected = false;
+    this.exitCode = code;
+    setImmediate(() => this.emit('exit', code, signal));
+  }
+
+  private post(msg: any): void {
+    if (this.connected) this.emit('message', msg);
+  }
+
+  private async handle(msg: any): Promise<void> {
+    if (!this.connected) return;
+    await new Promise<void>(res => setImmediate(res));
+    if (msg.type === 'init') {
+      this.workerId = msg.workerId;
+      this.post({ type: 'ready', workerId: this.workerId });
+    } else if (msg.type === 'assign') {
+      const names: string[] = msg.functionNames ?? [msg.functionName];
+      for (const name of names) {
+        const delay = FakeChild.behavior.delayMs?.(name, this) ?? 0;
+        if (delay > 0) await new Promise<void>(res => setTimeout(res, delay));
+        if (!this.connected) return;
+        const res = FakeChild.behavior.result !== undefined
+          ? FakeChild.behavior.result(name, this)
+          : fakeResult(name, this.workerId);
+        if (res === null) {
+          this.exit(null, 'SIGSEGV');
+          return;
+        }
+        this.post(res);
+      }
+    } else if (msg.type === 'run') {
+      const fields = FakeChild.behavior.run !== undefined ? FakeChild.behavior.run(msg.commands, this) : {};
+      if (fields === null) {
+        this.exit(null, 'SIGSEGV');
+        return;
+      }
+      this.post({
+        type: 'output',
+        id: msg.id,
+        output: msg.commands.join('\n'),
+        messages: '',
+        timeMs: 1,
+        success: true,
+        workerId: this.workerId,
+        ...fields,
+      });
+    } else if (msg.type === 'shutdown') {
+      this.exit(0, null);
+    }
+  }
+}
+
+/** The result message a healthy worker sends for one function */
+export function fakeResult(name: string, workerId: number): Record<string, any> {
+  return {
+    type: 'result',
+    name,
+    output: `void ${name}(void)\n`,
+    timeMs: 1,
+    success: true,
+    workerId,
+  };
+}
+
+/** Replacement for child_process.fork() */
+export function fakeFork(..._args: any[]): FakeChild {
+  const child = new FakeChild();
+  FakeChild.spawned.push(child);
+  return child;
+}
+
+/**
+ * Build the text of a test XML file whose functions are f0 .. f(count-1).
+ * The architecture does not exist, so the parent's snapshot fails quickly and the
+ * children would be given the XML; the fake children never look at it.
+ */
+export function fakeProgramXml(count: number): string {
+  let xml = '<decompilertest>\n<binaryimage arch="nonexistent:LE:32:default"></binaryimage>\n<script>\n';
+  for (let i = 0; i < count; i++) {
+    xml += `<com>lo fu f${i}</com>\n<com>decompile</com>\n<com>print C</com>\n`;
+  }
+  return xml + '</script>\n</decompilertest>\n';
+}
@@ -0,0 +1,103 @@
+/**
+ * @file heritage.test.ts
+ * @description Tests that incremental phi-node placement in Heritage gives the same blocks as
+ * placement with freshly cleared marks.
+ */
+
+import { describe, it, expect } from 'vitest';
+import { BlockGraph, FlowBlock } from '../../src/decompiler/block.js';
+import { Heritage } from '../../src/decompiler/heritage.js';
+
+/** A small deterministic generator, so failures can be reproduced */
+function lcg(seed: number): () => number {
+  let s = seed >>> 0;
+  return () => {
+    s = (Math.imul(s, 1664525) + 1013904223) >>> 0;
+    return s >>> 8;
+  };
+}
+
+/** Build a control-flow graph from edges, with block 0 as the entry, ordered as Funcdata does */
+function buildGraph(size: number, edges: [number, number][]): BlockGraph {
+  const graph = new BlockGraph();
+  const blocks: FlowBlock[] = [];
+  for (let i = 0; i < size; ++i) blocks.push(graph.newBlock());
+  for (const [a, b] of edges) graph.addEdge(blocks[a], blocks[b]);
+  const rootlist: FlowBlock[] = [];
+  graph.structureLoops(rootlist);
+  graph.calcForwardDominator(rootlist);
+  return graph;
+}
+
+/** A Heritage over the graph, with its dominator tree augmentation built */
+function makeHeritage(graph: BlockGraph): any {
+  const h = new Heritage({ getBasicBlocks: () => graph } as any) as any;
+  h.buildADT();
+  return h;
+}
+
+/** Place phi-nodes for writes in the given blocks, returning the merge blocks by index */
+function place(h: any, graph: BlockGraph, writeBlocks: number[]): number[] {
+  const write = writeBlocks.map(i => {
+    const bl = graph.getBlock(i);
+    return { getDef: () => ({ getParent: () => bl }) };
+  });
+  h.calcMultiequals(write);
+  return h.merge.map((bl: FlowBlock) => bl.getIndex()).sort((a: number, b: number) => a - b);
+}
+
+/** Check that placement left no mark behind, only the boundary flags of the augmentation */
+function expectCleared(h: any): void {
+  for (const f of h.flags) expect(f & ~1).toBe(0);
+}
+
+describe('Heritage phi-node placement', () => {
+  it('places a merge at the join of a diamond', () => {
+    const graph = buildGraph(4, [[0, 1], [0, 2], [1, 3], [2, 3]]);
+    const h = makeHeritage(graph);
+    const join = graph.getBlock(0).getOut(0).getOut(0).getIndex();
+    const left = graph.getBlock(0).getOut(0).getIndex();
+    expect(place(h, graph, [left])).toEqual([join]);
+    expectCleared(h);
+    expect(place(h, graph, [0])).toEqual([]);
+    expectCleared(h);
+  });
+
+  it('places a merge at the head of a loop written in its body', () => {
+    const graph = buildGraph(4, [[0, 1], [1, 2], [2, 1], [2, 3]]);
+    const h = makeHeritage(graph);
+    const head = graph.getBlock(0).getOut(0);
+    const body = head.getOut(0);
+    expect(place(h, graph, [body.getIndex()])).toEqual([head.getIndex()]);
+    expectCleared(h);
+  });
+
+  for (const seed of [3, 11, 29, 101]) {
+    it(`matches placement with fresh marks over many ranges (seed ${seed})`, () => {
+      const next = lcg(seed);
+      const size = 10 + next() % 30;
+      const edges: [number, number][] = [];
+      const seen = new Set<string>();
+      const add = (a: number, b: number) => {
+        if (a === b || b === 0 || seen.has(a + ':' + b)) return;
+        seen.add(a + ':' + b);
+        edges.push([a, b]);
+      };
+      for (let i = 1; i < size; ++i) add(next() % i, i);
+      for (let i = 0; i < size; ++i) add(next() % size, next() % size);
+      const graph = buildGraph(size, edges);
+
+      // One Heritage kept across all ranges, as in a function's passes
+      const shared = makeHeritage(graph);
+      for (let r = 0; r < 50; ++r) {
+        const writes: number[] = [];
+        for (let k = 1 + next() % 4; k > 0; --k) writes.push(next() % size);
+        const expected = place(makeHeritage(graph), graph, writes);
+        expect(place(shared, graph, writes)).toEqual(expected);
+        expectCleared(shared);
+      }
+      const stats = shared.getStats();
+      expect(stats.placeBlocksMarked + stats.placeBlocksSkipped).toBe(50 * size);
+    });
+  }
+});
@@ -0,0 +1,65 @@
+/**
+ * @file irpool.test.ts
+ * @description Tests for the free lists that recycle IR objects between functions.
+ */
+
+import { describe, it, expect } from 'vitest';
+import { FreeList, IrPool, poisonObject } from '../../src/decompiler/irpool.js';
+import { LowlevelError } from '../../src/core/error.js';
+import { OptionIrPool } from '../../src/decompiler/options.js';
+
+class Node {
+  value = 1;
+  get(): number { return this.value; }
+}
+
+describe('FreeList', () => {
+  it('hands back given objects and counts reuse', () => {
+    const list = new FreeList<Node>('Node', 2);
+    expect(list.take()).toBeUndefined();
+    const a = new Node();
+    const b = new Node();
+    list.give(a, false);
+    list.give(b, false);
+    list.give(new Node(), false);               // Over the limit: dropped
+    expect(list.take()).toBe(b);
+    expect(list.take()).toBe(a);
+    expect(list.take()).toBeUndefined();
+    expect(list.getStats()).toEqual({ reused: 2, allocated: 2, released: 3, held: 0 });
+  });
+
+  it('poisons instead of keeping when asked', () => {
+    const list = new FreeList<Node>('Node', 8);
+    const a = new Node();
+    list.give(a, true);
+    expect(list.take()).toBeUndefined();
+    expect(() => a.get()).toThrow(LowlevelError);
+    expect(() => { a.value = 2; }).toThrow(/recycled Node/);
+  });
+});
+
+describe('IrPool', () => {
+  it('poisons objects so stale uses fail but identity still works', () => {
+    const obj = new Node();
+    const seen = new Set([obj]);
+    poisonObject(obj, 'Varnode');
+    expect(seen.has(obj)).toBe(true);
+    expect(() => obj.value).toThrow(/recycled Varnode \(value\)/);
+    const pool = new IrPool(4, false);
+    expect(pool.formatStats()).toMatch(/^IR pool: varnodes 0 reused/);
+  });
+});
+
+describe('OptionIrPool', () => {
+  it('is off until the irpool option turns it on', () => {
+    const glb: any = { irpool: null };
+    const opt = new OptionIrPool();
+    expect(opt.apply(glb, 'on', '', '')).toBe('IR object recycling is on');
+    const pool = glb.irpool;
+    expect(pool).toBeInstanceOf(IrPool);
+    opt.apply(glb, 'on', '', '');
+    expect(glb.irpool).toBe(pool);            // Keeps the objects already pooled
+    opt.apply(glb, 'off', '', '');
+    expect(glb.irpool).toBeNull();
+  });
+});
@@ -0,0 +1,90 @@
+/**
+ * @file liftcache.test.ts
+ * @description Tests for the program-wide cache of lifted instructions.
+ */
+
+import { describe, it, expect } from 'vitest';
+import { LiftCache } from '../../src/sleigh/sleigh.js';
+
+/** An address in space 0, as far as LiftCache looks at it */
+function addr(off: number): any {
+  return { getSpace: () => ({ getIndex: () => 0 }), getOffset: () => BigInt(off) };
+}
+
+/** A context cache holding the same context word everywhere */
+function context(word: number): any {
+  return { getContext: (_a: any, buf: number[]) => { buf[0] = word; } };
+}
+
+/** A load image whose bytes at offset i are mem[i] */
+function image(mem: Uint8Array): any {
+  return {
+    loadFill: (buf: Uint8Array, size: number, a: any) => {
+      const off = Number(a.getOffset());
+      for (let i = 0; i < size; ++i) buf[i] = off + i < mem.length ? mem[off + i] : 0;
+    },
+  };
+}
+
+const ops = [{ opc: 1, outvar: null, invar: [], isize: 0 }];
+
+describe('LiftCache', () => {
+  it('hits on the same address, context and bytes', () => {
+    const mem = new Uint8Array([0x90, 0x55, 0x48, 0x89]);
+    const cache = new LiftCache(8);
+    const key = cache.makeKey(addr(1), context(3), 1);
+    expect(cache.lookup(key, addr(1), image(mem))).toBeNull();
+    cache.store(key, mem.subarray(1), 2, ops);
+
+    const ent = cache.lookup(key, addr(1), image(mem))!;
+    expect(ent.length).toBe(2);
+    expect(ent.ops).toEqual(ops);
+    expect(cache.makeKey(addr(1), context(4), 1)).not.toBe(key);
+    expect(cache.hits).toBe(1);
+    expect(cache.misses).toBe(1);
+
+    mem[2] = 0x00;      // Patched bytes invalidate the entry
+    expect(cache.lookup(key, addr(1), image(mem))).toBeNull();
+    expect(cache.size()).toBe(0);
+  });
+
+  it('evicts the oldest entries once full', () => {
+    const mem = new Uint8Array(16).fill(0xc3);
+    const cache = new LiftCache(3);
+    const ctx = context(0);
+    const keys = [0, 1, 2, 3, 4].map(i => cache.makeKey(addr(i), ctx, 1));
+    for (let i = 0; i < 5; ++i) cache.store(keys[i], mem.subarray(i), 1, null);
+    expect(cache.size()).toBe(3);
+    expect(cache.lookup(keys[0], addr(0), image(mem))).toBeNull();
+    expect(cache.lookup(keys[1], addr(1), image(mem))).toBeNull();
+    expect(cache.lookup(keys[4], addr(4), image(mem))).not.toBeNull();
+
+    cache.setCapacity(1);
+    expect(cache.size()).toBe(1);
+  });
+
+  it('is disabled by a capacity of 0', () => {
+    const cache = new LiftCache(0);
+    expect(cache.isEnabled()).toBe(false);
+    cache.store('k', new Uint8Array([1]), 1, null);
+    expect(cache.size()).toBe(0);
+  });
+
+  it('is enabled again by reset at the configured capacity', () => {
+    const mem = new Uint8Array([1, 2, 3, 4]);
+    const cache = new LiftCache(2);
+    const key = cache.makeKey(addr(0), context(0), 1);
+    cache.store(key, mem, 1, null);
+    cache.lookup(key, addr(0), image(mem));
+
+    cache.disable();
+    expect(cache.isEnabled()).toBe(false);
+    expect(cache.size()).toBe(0);
+
+    cache.reset();
+    expect(cache.isEnabled()).toBe(true);
+    expect(cache.hits).toBe(0);
+    for (let i = 0; i < 3; ++i) cache.store('k' + i, mem.subarray(i), 1, null);
+    expect(cache.size()).toBe(2);
+  });
+});
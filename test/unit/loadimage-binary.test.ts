@@ -0,0 +1,63 @@
+/**
+ * @file loadimage-binary.test.ts
+ * @description Tests for reading ELF segments through LoadImageBinary without XML.
+ */
+
+import { describe, it, expect } from 'vitest';
+import { Address } from '../../src/core/address.js';
+import { AddrSpace, spacetype } from '../../src/core/space.js';
+import { DataUnavailError } from '../../src/decompiler/loadimage.js';
+import { LoadImageBinary } from '../../src/console/loadimage_binary.js';
+
+/** Build a 64-bit little-endian x86-64 ELF with a single PT_LOAD segment and no sections */
+function makeElf(vaddr: bigint, code: number[]): Buffer {
+  const phoff = 64;
+  const dataOff = phoff + 56;
+  const buf = Buffer.alloc(dataOff + code.length);
+  buf.writeUInt32BE(0x7f454c46, 0);
+  buf.writeUInt8(2, 4);                 // ELFCLASS64
+  buf.writeUInt8(1, 5);                 // ELFDATA2LSB
+  buf.writeUInt16LE(62, 18);            // EM_X86_64
+  buf.writeBigUInt64LE(vaddr, 24);      // e_entry
+  buf.writeBigUInt64LE(BigInt(phoff), 32);
+  buf.writeUInt16LE(56, 54);            // e_phentsize
+  buf.writeUInt16LE(1, 56);             // e_phnum
+  buf.writeUInt32LE(1, phoff);          // PT_LOAD
+  buf.writeUInt32LE(5, phoff + 4);      // R+X
+  buf.writeBigUInt64LE(BigInt(dataOff), phoff + 8);
+  buf.writeBigUInt64LE(vaddr, phoff + 16);
+  buf.writeBigUInt64LE(BigInt(code.length), phoff + 32);
+  buf.writeBigUInt64LE(BigInt(code.length), phoff + 40);
+  Buffer.from(code).copy(buf, dataOff);
+  return buf;
+}
+
+const space = new AddrSpace(null as any, null as any, spacetype.IPTR_PROCESSOR, 'ram', false, 8, 1, 1, 0, 0, 0);
+const manager = { getDefaultCodeSpace: () => space };
+
+describe('LoadImageBinary', () => {
+  const code = [0x55, 0x48, 0x89, 0xe5, 0x5d, 0xc3];
+  const elf = makeElf(0x401000n, code);
+  const img = new LoadImageBinary('test.elf', elf);
+  img.open(manager);
+
+  it('reads the architecture from the header', () => {
+    expect(img.getArchType()).toMatch(/^x86:LE:64/);
+    expect(img.getEntryPoint().getOffset()).toBe(0x401000n);
+  });
+
+  it('serves segment bytes and pads the tail with zeros', () => {
+    const buf = new Uint8Array(16).fill(0xff);
+    img.loadFill(buf, 16, new Address(space, 0x401002n));
+    expect(Array.from(buf.subarray(0, 4))).toEqual([0x89, 0xe5, 0x5d, 0xc3]);
+    expect(buf.subarray(4).every(b => b === 0)).toBe(true);
+    expect(Array.from(img.loadView(2, new Address(space, 0x401000n))!)).toEqual([0x55, 0x48]);
+  });
+
+  it('rejects unmapped addresses and applies the vma adjustment', () => {
+    expect(() => img.load(4, new Address(space, 0x400000n))).toThrow(DataUnavailError);
+    expect(() => img.load(4, new Address(space, 0x400000n))).toThrow('Unable to load 4 bytes at');
+    img.adjustVma(0x1000);
+    expect(Array.from(img.load(1, new Address(space, 0x402000n)))).toEqual([0x55]);
+  });
+});
@@ -0,0 +1,64 @@
+/**
+ * @file loadtablecache.test.ts
+ * @description Tests that LoadTableCache serves repeated jump-table reads without the load image.
+ */
+
+import { describe, it, expect } from 'vitest';
+import { LoadTableCache } from '../../src/decompiler/jumptable.js';
+import { DataUnavailError } from '../../src/decompiler/loadimage.js';
+
+/** A load image mapping [0x1000,0x1100) with each byte holding the low byte of its address */
+function makeLoader() {
+  const loader = {
+    reads: 0,
+    loadFill(ptr: Uint8Array, size: number, addr: any): void {
+      loader.reads += 1;
+      const off = Number(addr.getOffset());
+      if (off < 0x1000 || off + size > 0x1100)
+        throw new DataUnavailError('Bytes at ' + off.toString(16) + ' are not mapped');
+      for (let i = 0; i < size; ++i) ptr[i] = (off + i) & 0xff;
+    },
+  };
+  return loader;
+}
+
+describe('LoadTableCache', () => {
+  it('reads each address from the load image once, including failures', () => {
+    const loader = makeLoader();
+    const cache = LoadTableCache.forLoader(loader);
+    expect(LoadTableCache.forLoader(loader)).toBe(cache);
+    const spc: any = {};
+    const buf = new Uint8Array(8);
+    for (let pass = 0; pass < 3; ++pass) {
+      for (let off = 0x1000n; off <= 0x10f8n; off += 4n) {
+        cache.fill(buf, spc, off);
+        expect(buf[0]).toBe(Number(off & 0xffn));
+        expect(buf[7]).toBe(Number((off + 7n) & 0xffn));
+      }
+      expect(() => cache.fill(buf, spc, 0x2000n)).toThrow(DataUnavailError);
+    }
+    expect(loader.reads).toBe(64);
+    cache.clear();
+    cache.fill(buf, spc, 0x1000n);
+    expect(loader.reads).toBe(65);
+  });
+
+  it('keeps failed reads out of the slab', () => {
+    const loader = makeLoader();
+    const cache = LoadTableCache.forLoader(loader);
+    const spc: any = {};
+    const buf = new Uint8Array(8);
+    for (let i = 0; i < 64; ++i) {
+      expect(() => cache.fill(buf, spc, 0x2000n + BigInt(i))).toThrow(DataUnavailError);
+      cache.fill(buf, spc, 0x1000n + BigInt(i));
+    }
+    expect((cache as any).count).toBe(64);
+    expect((cache as any).misses).toBe(64);
+    expect((cache as any).slab.length).toBe(8 * 64);
+    for (let i = 0; i < 64; ++i) {
+      cache.fill(buf, spc, 0x1000n + BigInt(i));
+      expect(buf[0]).toBe(i & 0xff);
+    }
+    expect(loader.reads).toBe(128);
+  });
+});
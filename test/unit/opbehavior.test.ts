@@ -0,0 +1,76 @@
+/**
+ * @file opbehavior.test.ts
+ * @description Checks that the uint32 OpBehavior evaluators agree with the bigint evaluators.
+ */
+
+import { describe, it, expect } from 'vitest';
+import * as opb from '../../src/core/opbehavior.js';
+import { OpBehavior } from '../../src/core/opbehavior.js';
+
+/** Boundary values plus a deterministic pseudo-random spread for a given byte size */
+function sampleValues(size: number): bigint[] {
+  const mask = (1n << BigInt(8 * size)) - 1n;
+  const res: bigint[] = [0n, 1n, 2n, 7n, 8n, 31n, 32n, 0x7Fn, 0x80n, 0xFFn, 0x100n,
+                         mask, mask - 1n, mask >> 1n, (mask >> 1n) + 1n];
+  let seed = 0x12345678;
+  for (let i = 0; i < 12; ++i) {
+    seed = (Math.imul(seed, 1103515245) + 12345) >>> 0;
+    res.push(BigInt(seed) & mask);
+  }
+  return res.map(v => v & mask);
+}
+
+/** Evaluate through both paths, capturing either the value or the error class */
+function evaluate(fn: () => bigint): bigint | string {
+  try {
+    return fn();
+  } catch (e: any) {
+    return e.name as string;
+  }
+}
+
+const behaviors: OpBehavior[] = [];
+for (const [name, ctor] of Object.entries(opb)) {
+  if (!name.startsWith('OpBehavior') || name === 'OpBehavior' || name.startsWith('OpBehaviorFloat')) continue;
+  behaviors.push(new (ctor as any)());
+}
+
+// ---------------------------------------------------------------------------
+// Sized dispatch
+// ---------------------------------------------------------------------------
+describe('OpBehavior sized evaluation', () => {
+  for (const behave of behaviors) {
+    it(`${behave.constructor.name} matches the bigint evaluator`, () => {
+      for (let sizein = 1; sizein <= 4; ++sizein) {
+        const vals = sampleValues(sizein);
+        for (let sizeout = 1; sizeout <= 4; ++sizeout) {
+          for (const in1 of vals) {
+            if (behave.isUnary()) {
+              const ref = evaluate(() => behave.evaluateUnary(sizeout, sizein, in1));
+              const fast = evaluate(() => behave.evaluateUnarySized(sizeout, sizein, in1));
+              expect(fast).toBe(ref);
+              continue;
+            }
+            for (const in2 of vals) {
+              const ref = evaluate(() => behave.evaluateBinary(sizeout, sizein, in1, in2));
+              const fast = evaluate(() => behave.evaluateBinarySized(sizeout, sizein, in1, in2));
+              expect(fast).toBe(ref);
+            }
+          }
+        }
+      }
+    });
+  }
+
+  it('falls back to bigint for operands wider than 4 bytes', () => {
+    const add = new opb.OpBehaviorIntAdd();
+    expect(add.evaluateBinarySized(8, 8, 0xFFFFFFFFFFFFFFFFn, 1n)).toBe(0n);
+    expect(add.evaluateBinarySized(8, 8, 0xFFFFFFFFn, 1n)).toBe(0x100000000n);
+  });
+
+  it('sign-extends signed division operands', () => {
+    const sdiv = new opb.OpBehaviorIntSdiv();
+    expect(sdiv.evaluateBinary(1, 1, 0xFFn, 0x7Fn)).toBe(0n);
+    expect(sdiv.evaluateBinary(1, 1, 0xFEn, 0xFFn)).toBe(2n);
+  });
+});
@@ -0,0 +1,106 @@
+/**
+ * @file parallel-iter.test.ts
+ * @description Tests that ParallelDecompiler.decompileIter() keeps at most `concurrency` jobs in
+ * flight, yields in input order, and holds each job's comment writes until its result is taken.
+ */
+
+import { describe, it, expect } from 'vitest';
+import { Action, ActionGroup, ActionDatabase, type ActionGroupList } from '../../src/decompiler/action.js';
+import { ParallelDecompiler } from '../../src/decompiler/parallel.js';
+import { Comment, CommentDatabaseInternal } from '../../src/decompiler/comment.js';
+import { Address } from '../../src/core/address.js';
+import { AddrSpace, spacetype } from '../../src/core/space.js';
+
+const ram = new AddrSpace(null as any, null as any, spacetype.IPTR_PROCESSOR, 'ram', false, 8, 1, 1, 0, 0, 0);
+
+/** Records that the function ran, and issues a warning through the Architecture's comment database */
+class ActionWarn extends Action {
+  constructor(g: string, private log: string[]) {
+    super(0, 'warn', g);
+  }
+  clone(grouplist: ActionGroupList): Action | null {
+    if (!grouplist.contains(this.getGroup())) return null;
+    return new ActionWarn(this.getGroup(), this.log);
+  }
+  apply(data: any): number {
+    this.log.push('run ' + data.getName());
+    const arch = data.getArch();
+    arch.commentdb.addCommentNoDuplicate(Comment.warning, data.getAddress(), data.getAddress(),
+                                         'warning for ' + data.getName());
+    return 0;
+  }
+}
+
+/** Return the texts of the comments stored for a function */
+function comments(db: CommentDatabaseInternal, fad: Address): string[] {
+  const res: string[] = [];
+  const end = db.endComment(fad);
+  for (const iter = db.beginComment(fad); !iter.equals(end); iter.next())
+    res.push(iter.value.getText());
+  return res;
+}
+
+function setup(count: number) {
+  const log: string[] = [];
+  const db = new ActionDatabase();
+  const universal = new ActionGroup(Action.rule_onceperfunc, 'universal');
+  universal.addAction(new ActionWarn('base', log));
+  (db as any).registerAction(ActionDatabase.universalname, universal);
+  db.setGroup('full', ['base']);
+  db.setCurrent('full');
+  const arch: any = { allacts: db, commentdb: new CommentDatabaseInternal(), printMessage: () => {} };
+  const funcs: any[] = [];
+  for (let i = 0; i < count; ++i) {
+    const addr = new Address(ram, BigInt(0x1000 + i * 0x10));
+    funcs.push({
+      getName: () => 'f' + i,
+      hasNoCode: () => false,
+      clear: () => {},
+      getAddress: () => addr,
+      getArch: () => arch,
+    });
+  }
+  return { log, arch, funcs };
+}
+
+describe('ParallelDecompiler.decompileIter', () => {
+  it('runs one function at a time at concurrency 1', () => {
+    const { log, arch, funcs } = setup(3);
+    const pd = new ParallelDecompiler(arch, 1);
+    for (const res of pd.decompileIter(funcs))
+      log.push('yield ' + res.name);
+    expect(log).toEqual(['run f0', 'yield f0', 'run f1', 'yield f1', 'run f2', 'yield f2']);
+  });
+
+  it('keeps up to N jobs in flight and yields in input order', () => {
+    const { log, arch, funcs } = setup(5);
+    const pd = new ParallelDecompiler(arch, 3);
+    for (const res of pd.decompileIter(funcs)) {
+      log.push('yield ' + res.name);
+      expect(res.success).toBe(true);
+    }
+    expect(log).toEqual([
+      'run f0', 'run f1', 'run f2', 'yield f0',
+      'run f3', 'yield f1',
+      'run f4', 'yield f2',
+      'yield f3',
+      'yield f4',
+    ]);
+  });
+
+  it('holds comment writes of jobs ahead until their result is taken', () => {
+    const { arch, funcs } = setup(4);
+    const db = arch.commentdb as CommentDatabaseInternal;
+    // A warning left by an earlier decompilation of f0 is cleared when f0 runs again
+    db.addComment(Comment.warning, funcs[0].getAddress(), funcs[0].getAddress(), 'stale');
+    const pd = new ParallelDecompiler(arch, 2);
+    const seen: string[][] = [];
+    for (const res of pd.decompileIter(funcs)) {
+      const i = funcs.findIndex(fd => fd.getName() === res.name);
+      expect(comments(db, funcs[i].getAddress())).toEqual(['warning for f' + i]);
+      if (i + 1 < funcs.length) seen.push(comments(db, funcs[i + 1].getAddress()));
+    }
+    expect(seen).toEqual([[], [], []]);
+    expect(arch.commentdb).toBe(db);
+  });
+});
@@ -0,0 +1,137 @@
+/**
+ * @file parallel-recycle.test.ts
+ * @description Tests that WorkerParallelDecompiler replaces recycled and crashed workers
+ * (the recycleRssMb option) and hands their unfinished functions to the next worker.
+ */
+
+import { describe, it, expect, vi, beforeEach, afterAll } from 'vitest';
+import * as fs from 'fs';
+import * as os from 'os';
+import { join } from 'path';
+import { FakeChild, fakeResult, fakeProgramXml } from './fakechild.js';
+import { WorkerParallelDecompiler, type WorkerDecompileResult } from '../../src/decompiler/parallel_workers.js';
+
+vi.mock('child_process', async (importOriginal) => {
+  const { fakeFork } = await import('./fakechild.js');
+  return { ...(await importOriginal<typeof import('child_process')>()), fork: fakeFork };
+});
+
+const tmpDir = fs.mkdtempSync(join(os.tmpdir(), 'parallel-recycle-'));
+
+function writeProgram(count: number): string {
+  const path = join(tmpDir, `prog${count}.xml`);
+  fs.writeFileSync(path, fakeProgramXml(count));
+  return path;
+}
+
+/** Batches of four in XML order: f0-f3, f4-f7, ... */
+const BATCHES = { maxBatchSize: 4, batchFraction: 1 };
+
+const names = (count: number): string[] => Array.from({ length: count }, (_v, i) => `f${i}`);
+
+/** Run the stream unordered, checking every function is reported exactly once */
+async function runAll(dec: WorkerParallelDecompiler, count: number): Promise<Map<string, WorkerDecompileResult>> {
+  const got = new Map<string, WorkerDecompileResult>();
+  for await (const r of dec.decompileStream({ ordered: false })) {
+    expect(got.has(r.name)).toBe(false);
+    got.set(r.name, r);
+  }
+  expect([...got.keys()].sort()).toEqual(names(count).sort());
+  return got;
+}
+
+/** Number of times each function was sent to any child */
+function assignCounts(): Map<string, number> {
+  const counts = new Map<string, number>();
+  for (const c of FakeChild.spawned) {
+    for (const m of c.received) {
+      if (m.type !== 'assign') continue;
+      for (const name of m.functionNames) counts.set(name, (counts.get(name) ?? 0) + 1);
+    }
+  }
+  return counts;
+}
+
+const totalRecycled = (dec: WorkerParallelDecompiler): number =>
+  dec.getUtilization().reduce((sum, u) => sum + u.recycled, 0);
+
+beforeEach(() => {
+  FakeChild.reset();
+  FakeChild.behavior.delayMs = (name) => 1 + (Number(name.slice(1)) * 7) % 5;
+});
+
+afterAll(() => {
+  fs.rmSync(tmpDir, { recursive: true, force: true });
+});
+
+describe('WorkerParallelDecompiler worker replacement', () => {
+  it('recycles a worker past recycleRssMb and requeues the rest of its batch', async () => {
+    FakeChild.behavior.result = (name, child) =>
+      ({ ...fakeResult(name, child.workerId), rssMb: name === 'f5' ? 900 : 10 });
+    const dec = new WorkerParallelDecompiler(writeProgram(24), 3, undefined, false,
+                                             { ...BATCHES, recycleRssMb: 500 });
+    const got = await runAll(dec, 24);
+    for (const r of got.values()) expect(r.success).toBe(true);
+    expect(FakeChild.spawned.length).toBe(4);
+    expect(totalRecycled(dec)).toBe(1);
+    // f5 ends its batch early; the rest of it goes to another worker
+    const counts = assignCounts();
+    expect(counts.get('f5')).toBe(1);
+    expect(counts.get('f6')).toBe(2);
+    expect(counts.get('f7')).toBe(2);
+    // The recycled child got no further work, and was stopped
+    const old = FakeChild.spawned.find(c => c.received.some(m => m.type === 'assign' &&
+                                                            m.functionNames.includes('f5')))!;
+    expect(old.connected).toBe(false);
+    const lastAssign = old.received.filter(m => m.type === 'assign').pop();
+    expect(lastAssign.functionNames).toContain('f5');
+  });
+
+  it('replaces a worker killed mid-batch and runs its functions elsewhere', async () => {
+    let killed: FakeChild | null = null;
+    const delay = FakeChild.behavior.delayMs!;
+    FakeChild.behavior.delayMs = (name, child) => {
+      if (name === 'f6' && killed === null) {
+        killed = child;
+        setImmediate(() => child.kill());
+        return 50;
+      }
+      return delay(name, child);
+    };
+    const dec = new WorkerParallelDecompiler(writeProgram(24), 3, undefined, false,
+                                             { ...BATCHES, recycleRssMb: 10000 });
+    const got = await runAll(dec, 24);
+    for (const r of got.values()) expect(r.success).toBe(true);
+    expect(killed).not.toBeNull();
+    expect(got.get('f6')!.workerId).not.toBe(-1);
+    expect(assignCounts().get('f6')).toBe(2);
+    expect(FakeChild.spawned.length).toBe(4);
+    expect(totalRecycled(dec)).toBe(1);
+  });
+
+  it('fails a function that brings down a second worker', async () => {
+    FakeChild.behavior.result = (name, child) => name === 'f3' ? null : fakeResult(name, child.workerId);
+    const dec = new WorkerParallelDecompiler(writeProgram(24), 3, undefined, false,
+                                             { ...BATCHES, recycleRssMb: 10000 });
+    const got = await runAll(dec, 24);
+    const bad = got.get('f3')!;
+    expect(bad.success).toBe(false);
+    expect(bad.error).toBe('Worker exited unexpectedly');
+    for (const r of got.values()) {
+      if (r.name !== 'f3') expect(r.success).toBe(true);
+    }
+    expect(assignCounts().get('f3')).toBe(2);
+    expect(FakeChild.spawned.length).toBe(5);
+    expect(totalRecycled(dec)).toBe(2);
+  });
+
+  it('without recycleRssMb, fails the batch of a worker that crashes', async () => {
+    FakeChild.behavior.result = (name, child) => name === 'f3' ? null : fakeResult(name, child.workerId);
+    const dec = new WorkerParallelDecompiler(writeProgram(24), 3, undefined, false, BATCHES);
+    const got = await runAll(dec, 24);
+    expect(got.get('f3')!.success).toBe(false);
+    expect(assignCounts().get('f3')).toBe(1);
+    expect(FakeChild.spawned.length).toBe(3);
+    expect(totalRecycled(dec)).toBe(0);
+  });
+});
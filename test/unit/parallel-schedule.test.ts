@@ -0,0 +1,84 @@
+/**
+ * @file parallel-schedule.test.ts
+ * @description Tests for the cost estimation and batching used by WorkerParallelDecompiler.
+ */
+
+import { describe, it, expect } from 'vitest';
+import {
+  estimateFunctionSizes,
+  estimateFunctionCosts,
+  planBatches,
+  WorkerParallelDecompiler,
+} from '../../src/decompiler/parallel_workers.js';
+import { xml_tree } from '../../src/core/xml.js';
+
+describe('estimateFunctionSizes', () => {
+  it('measures the gap to the next symbol in the same space', () => {
+    const xml = `<binaryimage arch="x86:LE:64:default">
+      <symbol space="ram" offset="0x1000" name="a"/>
+      <symbol space="ram" offset="0x1400" name="c"/>
+      <symbol name="b" offset="0x1100" space="ram"/>
+      <symbol space="other" offset="0x0" name="d"/>
+    </binaryimage>`;
+    const sizes = estimateFunctionSizes(xml);
+    expect(sizes.get('a')).toBe(0x100);
+    expect(sizes.get('b')).toBe(0x300);
+    expect(sizes.has('c')).toBe(false);   // Last in its space
+    expect(sizes.has('d')).toBe(false);
+  });
+});
+
+describe('estimateFunctionCosts', () => {
+  it('prefers timing hints and scales byte sizes by the observed ratio', () => {
+    const sizes = new Map([['a', 100], ['b', 200], ['c', 50]]);
+    const hints = new Map([['a', 10]]);
+    const costs = estimateFunctionCosts(['a', 'b', 'c', 'x'], sizes, hints);
+    expect(costs[0]).toBe(10);
+    expect(costs[1]).toBeCloseTo(20);
+    expect(costs[2]).toBeCloseTo(5);
+    expect(costs[3]).toBeCloseTo(10);    // Median of the known costs
+  });
+});
+
+describe('planBatches', () => {
+  it('dispatches expensive functions first and batches cheap ones', () => {
+    const costs = [1, 1, 1000, 1, 1, 500, 1, 1];
+    const batches = planBatches(costs, 2, 4, 1 / 16);
+    expect(batches[0]).toEqual([2]);
+    expect(batches[1]).toEqual([5]);
+    const rest = batches.slice(2);
+    expect(rest.every(b => b.length <= 4)).toBe(true);
+    expect(rest.flat().sort()).toEqual([0, 1, 3, 4, 6, 7]);
+  });
+
+  it('covers every function exactly once', () => {
+    const costs = Array.from({ length: 100 }, (_v, i) => (i * 37) % 101);
+    const seen = planBatches(costs, 4).flat().sort((a, b) => a - b);
+    expect(seen).toEqual(Array.from({ length: 100 }, (_v, i) => i));
+  });
+});
+
+describe('collectScriptCommands', () => {
+  it('gives each function the other commands of its script', () => {
+    const root = xml_tree(`<decompilertest>
+      <binaryimage arch="x86:LE:64:default"/>
+      <script>
+        <com>option readonly on</com>
+        <com>lo fu a</com>
+        <com>decompile</com>
+        <com>lo fu b</com>
+      </script>
+      <script>
+        <com>load function c</com>
+        <com>print C</com>
+      </script>
+    </decompilertest>`).getRoot();
+    expect(WorkerParallelDecompiler.collectFunctionNames(root)).toEqual(['a', 'b', 'c']);
+    const commands = WorkerParallelDecompiler.collectScriptCommands(root);
+    expect(commands).toEqual([
+      ['option readonly on', 'decompile'],
+      ['option readonly on', 'decompile'],
+      ['print C'],
+    ]);
+  });
+});
@@ -0,0 +1,71 @@
+/**
+ * @file parallel-stream.test.ts
+ * @description Tests for WorkerParallelDecompiler.decompileStream() against fake workers.
+ */
+
+import { describe, it, expect, vi, beforeEach, afterAll } from 'vitest';
+import * as fs from 'fs';
+import * as os from 'os';
+import { join } from 'path';
+import { FakeChild, fakeProgramXml } from './fakechild.js';
+import { WorkerParallelDecompiler } from '../../src/decompiler/parallel_workers.js';
+
+vi.mock('child_process', async (importOriginal) => {
+  const { fakeFork } = await import('./fakechild.js');
+  return { ...(await importOriginal<typeof import('child_process')>()), fork: fakeFork };
+});
+
+const tmpDir = fs.mkdtempSync(join(os.tmpdir(), 'parallel-stream-'));
+
+function writeProgram(count: number): string {
+  const path = join(tmpDir, `prog${count}.xml`);
+  fs.writeFileSync(path, fakeProgramXml(count));
+  return path;
+}
+
+const names = (count: number): string[] => Array.from({ length: count }, (_v, i) => `f${i}`);
+
+beforeEach(() => {
+  FakeChild.reset();
+  // Uneven completion times so results finish out of XML order
+  FakeChild.behavior.delayMs = (name) => (Number(name.slice(1)) * 7) % 5;
+});
+
+afterAll(() => {
+  fs.rmSync(tmpDir, { recursive: true, force: true });
+});
+
+describe('WorkerParallelDecompiler.decompileStream', () => {
+  it('ordered: yields every function exactly once, in XML order', async () => {
+    const dec = new WorkerParallelDecompiler(writeProgram(40), 3, undefined, false, { maxBatchSize: 4 });
+    const got: string[] = [];
+    for await (const r of dec.decompileStream({ ordered: true, maxPending: 5 })) {
+      expect(r.success).toBe(true);
+      expect(r.output).toBe(`void ${r.name}(void)\n`);
+      got.push(r.name);
+    }
+    expect(got).toEqual(names(40));
+    expect(FakeChild.spawned.length).toBe(3);
+  });
+
+  it('unordered: yields every function exactly once', async () => {
+    const dec = new WorkerParallelDecompiler(writeProgram(40), 3, undefined, false, { maxBatchSize: 4 });
+    const got: string[] = [];
+    for await (const r of dec.decompileStream({ ordered: false, maxPending: 5 })) {
+      expect(r.success).toBe(true);
+      got.push(r.name);
+    }
+    expect(got.length).toBe(40);
+    expect([...got].sort()).toEqual(names(40).sort());
+  });
+
+  it('sends each child real function names', async () => {
+    const dec = new WorkerParallelDecompiler(writeProgram(10), 2, undefined, false, { maxBatchSize: 3 });
+    await dec.decompileAll();
+    const assigned = FakeChild.spawned
+      .flatMap(c => c.received)
+      .filter(m => m.type === 'assign')
+      .flatMap(m => m.functionNames);
+    expect(assigned.sort()).toEqual(names(10).sort());
+  });
+});
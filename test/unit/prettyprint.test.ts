@@ -0,0 +1,71 @@
+/**
+ * @file prettyprint.test.ts
+ * @description Tests the unbounded mode of EmitPrettyPrint and the ChunkedWriter back-end.
+ */
+
+import { describe, it, expect } from 'vitest';
+import { EmitPrettyPrint } from '../../src/decompiler/prettyprint.js';
+import { StringWriter, ChunkedWriter } from '../../src/util/writer.js';
+
+/** Emit a small function body, with a loop of many zero-width tokens in one group */
+function emitBody(emit: EmitPrettyPrint, blocks: number): void {
+  const func = emit.openGroup();
+  emit.print('int4 f(void)');
+  emit.tagLine();
+  emit.print('{');
+  const ind = emit.startIndent();
+  for (let k = 0; k < 3; ++k) {
+    emit.tagLine();
+    const grp = emit.openGroup();
+    emit.print('x' + k);
+    emit.spaces(1);
+    emit.print('=');
+    emit.spaces(1);
+    const paren = emit.openParen('(');
+    emit.print('é' + k);
+    emit.closeParen(')', paren);
+    for (let i = 0; i < blocks; ++i)
+      emit.endBlock(emit.beginBlock(null));
+    emit.print(';');
+    emit.closeGroup(grp);
+  }
+  emit.stopIndent(ind);
+  emit.tagLine();
+  emit.print('}');
+  emit.tagLine();
+  emit.closeGroup(func);
+  emit.flush();
+}
+
+function render(maxlinesize: number, blocks: number): string {
+  const emit = new EmitPrettyPrint();
+  const out = new StringWriter();
+  emit.setOutputStream(out);
+  emit.setMaxLineSize(maxlinesize);
+  emitBody(emit, blocks);
+  return out.toString();
+}
+
+describe('EmitPrettyPrint', () => {
+  it('prints short lines the same with and without a maximum line size', () => {
+    const bounded = render(100, 2);
+    expect(bounded).toBe('int4 f(void)\n{\n  x0 = (é0);\n  x1 = (é1);\n  x2 = (é2);\n}\n');
+    expect(render(0, 2)).toBe(bounded);
+    // Groups holding more tokens than the queue force it to expand
+    expect(render(20, 500)).toBe(render(0, 500));
+  });
+});
+
+describe('ChunkedWriter', () => {
+  it('encodes strings split across chunk boundaries', () => {
+    const parts: Buffer[] = [];
+    const w = new ChunkedWriter(bytes => { parts.push(Buffer.from(bytes)); }, 16);
+    const text = ['ab', 'cdefghijklmnopq', 'é€😀', 'x'.repeat(40), '😀'.repeat(9), 'z'];
+    for (const s of text) w.write(s);
+    w.flush();
+    expect(parts.length).toBeGreaterThan(4);
+    expect(parts.every(p => p.length <= 16)).toBe(true);
+    expect(Buffer.concat(parts).toString('utf8')).toBe(text.join(''));
+    expect(w.getByteCount()).toBe(Buffer.byteLength(text.join('')));
+  });
+});
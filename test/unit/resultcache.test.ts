@@ -0,0 +1,86 @@
+/**
+ * @file resultcache.test.ts
+ * @description Tests for the persistent decompilation result cache.
+ */
+
+import { describe, it, expect, afterEach } from 'vitest';
+import * as fs from 'fs';
+import * as os from 'os';
+import { join } from 'path';
+import { Address } from '../../src/core/address.js';
+import { ResultCache } from '../../src/decompiler/resultcache.js';
+
+const space: any = { getName: () => 'ram', getWordSize: () => 1 };
+
+/** A load image of 16 bytes at 0x1000, and a function covering its first 8 */
+function makeProgram() {
+  const image = new Uint8Array(16).map((_v, i) => i);
+  const history: string[] = [];
+  const arch: any = {
+    getDescription: () => 'x86:LE:64:default',
+    enhancedDisplay: false,
+    allacts: { getCurrentName: () => 'decompile' },
+    options: { getHistory: () => history },
+    commentdb: null,
+    getSpaceByName: (nm: string) => (nm === 'ram' ? space : null),
+    loader: {
+      load: (size: number, addr: Address) => {
+        const start = Number(addr.getOffset() - 0x1000n);
+        return image.slice(start, start + size);
+      },
+    },
+    symboltab: { getGlobalScope: () => ({ queryFunction: () => null }) },
+  };
+  const range = { getSpace: () => space, getFirst: () => 0x1000n, getLast: () => 0x1007n };
+  const fd: any = {
+    getAddress: () => new Address(space, 0x1000n),
+    getName: () => 'main',
+    getOverride: () => ({ encode: () => {} }),
+    getBasicBlocks: () => ({ getSize: () => 1, getBlock: () => ({ cover: { getRanges: () => [range] } }) }),
+    numCalls: () => 0,
+  };
+  return { arch, fd, image, history };
+}
+
+describe('ResultCache', () => {
+  let dir: string | null = null;
+
+  afterEach(() => {
+    if (dir !== null) fs.rmSync(dir, { recursive: true, force: true });
+    dir = null;
+  });
+
+  it('returns stored output until the function bytes or the options change', () => {
+    dir = fs.mkdtempSync(join(os.tmpdir(), 'resultcache-test-'));
+    const { arch, fd, image, history } = makeProgram();
+    const cache = new ResultCache(dir, 'test');
+
+    const key = cache.keyOf(arch, fd);
+    expect(cache.lookup(arch, key)).toBeNull();
+    cache.store(key, ResultCache.describe(arch, fd), 'void main(void)\n');
+    expect(new ResultCache(dir, 'test').lookup(arch, key)).toBe('void main(void)\n');
+    expect(new ResultCache(dir, 'other').keyOf(arch, fd)).not.toBe(key);
+    expect(cache.keyOf({ ...arch, allacts: { getCurrentName: () => 'triage' } }, fd)).not.toBe(key);
+
+    image[12] = 0xff;                          // Outside the function: still a hit
+    expect(cache.lookup(arch, key)).toBe('void main(void)\n');
+    image[3] = 0xff;                           // Patched instruction
+    expect(cache.lookup(arch, key)).toBeNull();
+
+    history.push('inferconstptr(off,,)');
+    expect(cache.keyOf(arch, fd)).not.toBe(key);
+    expect(cache.getStats()).toEqual({ hits: 1, misses: 1, stale: 1, stores: 1 });
+  });
+
+  it('keys on the commands applied before decompiling', () => {
+    dir = fs.mkdtempSync(join(os.tmpdir(), 'resultcache-test-'));
+    const { arch, fd } = makeProgram();
+    const cache = new ResultCache(dir, 'test');
+    const plain = cache.keyOf(arch, fd, []);
+    expect(cache.keyOf(arch, fd)).toBe(plain);
+    const proto = cache.keyOf(arch, fd, ['parse line extern int4 main(int4 argc);']);
+    expect(proto).not.toBe(plain);
+    expect(cache.keyOf(arch, fd, ['parse line extern void main(void);'])).not.toBe(proto);
+    expect(cache.keyOf(arch, fd, ['parse line extern int4 main(int4 argc);'])).toBe(proto);
+  });
+});
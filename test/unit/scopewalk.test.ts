@@ -0,0 +1,70 @@
+/**
+ * @file scopewalk.test.ts
+ * @description Tests that the console's function walks step through a Scope with MapIterator.
+ */
+
+import { describe, it, expect } from 'vitest';
+import { MapIterator } from '../../src/decompiler/database.js';
+import { IfaceDecompCommand, IfcDecompileParallel } from '../../src/console/ifacedecomp.js';
+
+/** An EntryMap as far as MapIterator looks at it */
+function entryMap(syms: any[]): any {
+  const entries = syms.map(sym => ({ getSymbol: () => sym }));
+  return {
+    getEntry: (i: number) => entries[i],
+    begin_list: () => 0,
+    end_list: () => entries.length,
+    size: () => entries.length,
+  };
+}
+
+function func(name: string, nocode = false): any {
+  return { name, hasNoCode: () => nocode };
+}
+
+function funcSym(fd: any): any {
+  return { getFunction: () => fd };
+}
+
+/**
+ * A scope over several address spaces, with empty and null maps between the full ones and a
+ * data symbol among the functions.
+ */
+function makeScope(children: any[] = []): any {
+  const f1 = func('f1');
+  const f2 = func('f2');
+  const f3 = func('f3', true);
+  const maptable = [null, entryMap([funcSym(f1), { getName: () => 'data' }]), entryMap([]), null,
+                    entryMap([funcSym(f2), funcSym(f3)])];
+  return {
+    funcs: [f1, f2, f3],
+    isGlobal: () => true,
+    begin: () => new MapIterator(maptable, 1, 0),
+    end: () => new MapIterator(maptable, maptable.length, 0),
+    childrenBegin: () => new Map(children.map((c, i) => [i, c])),
+  };
+}
+
+class IfcCollect extends IfaceDecompCommand {
+  seen: any[] = [];
+  execute(): void {}
+  iterationCallback(fd: any): void { this.seen.push(fd); }
+  walk(scope: any): void { this.iterateFunctionsAddrOrderInScope(scope); }
+}
+
+describe('console function walks', () => {
+  it('visit every function of a scope in map order', () => {
+    const scope = makeScope();
+    const cmd = new IfcCollect();
+    cmd.walk(scope);
+    expect(cmd.seen).toEqual(scope.funcs);
+  });
+
+  it('collect functions with code from the global scope and its children', () => {
+    const child = makeScope();
+    const scope = makeScope([child]);
+    const funcs: any[] = [];
+    (new IfcDecompileParallel() as any).collectFromScope(scope, funcs);
+    expect(funcs.map(fd => fd.name)).toEqual(['f1', 'f2', 'f1', 'f2']);
+  });
+});
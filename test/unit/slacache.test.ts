@@ -0,0 +1,40 @@
+/**
+ * @file slacache.test.ts
+ * @description Tests for the on-disk cache of inflated .sla payloads.
+ */
+
+import { describe, it, expect, afterEach } from 'vitest';
+import * as fs from 'fs';
+import * as os from 'os';
+import { join } from 'path';
+import { SlaCache } from '../../src/sleigh/slacache.js';
+import { FormatDecode } from '../../src/sleigh/slaformat.js';
+
+describe('SlaCache', () => {
+  let dir: string | null = null;
+
+  afterEach(() => {
+    SlaCache.directory = null;
+    if (dir !== null) fs.rmSync(dir, { recursive: true, force: true });
+    dir = null;
+  });
+
+  it('round-trips the payload and symbol index keyed by file contents', () => {
+    dir = fs.mkdtempSync(join(os.tmpdir(), 'slacache-test-'));
+    const raw = new Uint8Array([0x73, 0x6c, 0x61, 0x04, 1, 2, 3]);
+    const payload = new Uint8Array([9, 8, 7, 6, 5]);
+    const decoder = new FormatDecode(null);
+    decoder.ingestPayload(payload, null);
+    decoder.setSymbolIndex(Int32Array.from([5, 0, 2]));
+
+    expect(SlaCache.load(raw)).toBeNull();       // Disabled
+    SlaCache.directory = dir;
+    expect(SlaCache.load(raw)).toBeNull();       // Miss
+    SlaCache.store(raw, decoder);
+
+    const hit = SlaCache.load(raw)!;
+    expect(Array.from(hit.payload)).toEqual([9, 8, 7, 6, 5]);
+    expect(Array.from(hit.index)).toEqual([5, 0, 2]);
+    expect(SlaCache.load(new Uint8Array([1, 2, 3]))).toBeNull();
+  });
+});
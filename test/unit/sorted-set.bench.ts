@@ -0,0 +1,207 @@
+/**
+ * @file sorted-set.bench.ts
+ * @description Compares the red-black and chunked SortedSet layouts by replaying the
+ * loc_tree/def_tree operations recorded over a real decompilation: the whole sequence, then
+ * insert, erase, the searches (lower_bound, upper_bound, find) and in-order iteration timed
+ * on their own.
+ *
+ * The trace comes from the benchmark runner, one file per input:
+ *   npx tsx test/benchmark.ts --no-datatests --trace-trees output/bench/trees <binary>
+ *   SORTED_SET_TRACE=output/bench/trees/<binary>.trees.json npx vitest bench test/unit/sorted-set.bench.ts
+ */
+
+import * as fs from 'fs';
+import { bench, describe } from 'vitest';
+import { Address, SeqNum } from '../../src/core/address.js';
+import { AddrSpace, spacetype } from '../../src/core/space.js';
+import { SortedSet, type SortedSetIterator, type SortedSetLayout, type Comparator } from '../../src/util/sorted-set.js';
+import { Varnode, VarnodeBank, varnodeCompareLocDef, varnodeCompareDefLoc } from '../../src/decompiler/varnode.js';
+import { PcodeOp } from '../../src/decompiler/op.js';
+
+/** The operations on one tree between two clears, as written by test/benchmark.ts */
+interface TraceSet {
+  tree: 'loc_tree' | 'def_tree';
+  /** [space, offset, size, class, pc space, pc offset, uniq, create_index] */
+  keys: [number, string, number, number, number, string, number, number][];
+  /** One letter per operation: i insert, e erase, l lower_bound, u upper_bound, f find */
+  ops: string;
+  args: number[];
+}
+
+const traceFile = process.env.SORTED_SET_TRACE;
+if (traceFile === undefined || !fs.existsSync(traceFile))
+  throw new Error('Set SORTED_SET_TRACE to a trace written by test/benchmark.ts --trace-trees');
+const trace: { spaces: [number, string, spacetype][]; sets: TraceSet[] } = JSON.parse(fs.readFileSync(traceFile, 'utf8'));
+
+const spaces = new Map<number, AddrSpace>();
+for (const [index, name, tp] of trace.spaces)
+  spaces.set(index, new AddrSpace(null as any, null as any, tp, name, false, 8, 1, index, 0, 0, 0));
+const uniqueSpace = [...spaces.values()].find(spc => spc.getType() === spacetype.IPTR_INTERNAL) ?? null;
+const manager: any = { getUniqueSpace: () => uniqueSpace };
+
+function addrOf(space: number, offset: string): Address {
+  if (space === -1) return new Address();
+  if (space === -2) return new Address().setMaximal();
+  return new Address(spaces.get(space)!, BigInt(offset));
+}
+
+/** A trace set with its keys rebuilt as Varnodes */
+interface Replay {
+  cmp: Comparator<Varnode>;
+  keys: Varnode[];
+  ops: string;
+  args: number[];
+}
+
+/**
+ * Rebuild the keys of a trace set. Inserted keys are made by a VarnodeBank, in the recorded
+ * creation order so that free Varnodes keep their relative create_index; search keys are
+ * made the way VarnodeBank makes its searchvn.
+ */
+function rebuild(set: TraceSet): Replay {
+  const bank = new VarnodeBank(manager);
+  const keys: Varnode[] = new Array(set.keys.length);
+  const inserted = new Set<number>();
+  for (let i = 0; i < set.ops.length; ++i)
+    if (set.ops[i] === 'i') inserted.add(set.args[i]);
+  const made = set.keys.map((_, id) => id).filter(id => inserted.has(id) || set.keys[id][3] === 0);
+  made.sort((a, b) => set.keys[a][7] - set.keys[b][7] || a - b);
+  for (const id of made) {
+    const [space, offset, size, cls, pcSpace, pcOffset, uniq] = set.keys[id];
+    const vn = bank.create(size, addrOf(space, offset), null as any);
+    if (cls === 1)
+      keys[id] = bank.setInput(vn);
+    else if (cls === 2)
+      keys[id] = bank.setDef(vn, new PcodeOp(1, new SeqNum(addrOf(pcSpace, pcOffset), uniq)));
+    else
+      keys[id] = vn;
+  }
+  set.keys.forEach(([space, offset, size, cls, pcSpace, pcOffset, uniq], id) => {
+    if (keys[id] !== undefined) return;
+    const vn = new Varnode(size, addrOf(space, offset), null);
+    vn.flags = cls === 2 ? Varnode.written : Varnode.input;
+    if (cls === 2) vn.def = new PcodeOp(1, new SeqNum(addrOf(pcSpace, pcOffset), uniq));
+    keys[id] = vn;
+  });
+  return { cmp: set.tree === 'loc_tree' ? varnodeCompareLocDef : varnodeCompareDefLoc, keys, ops: set.ops, args: set.args };
+}
+
+/** A set filled with every key the trace inserts, and the iterators returned for them */
+interface Filled {
+  set: SortedSet<Varnode>;
+  iters: (SortedSetIterator<Varnode> | undefined)[];
+}
+
+function fill(r: Replay, layout: SortedSetLayout): Filled {
+  const set = SortedSet.create<Varnode>(r.cmp, layout);
+  const iters: (SortedSetIterator<Varnode> | undefined)[] = new Array(r.keys.length);
+  for (let i = 0; i < r.ops.length; ++i) {
+    if (r.ops[i] !== 'i') continue;
+    const [it, inserted] = set.insert(r.keys[r.args[i]]);
+    if (inserted) iters[r.args[i]] = it;
+  }
+  return { set, iters };
+}
+
+/** Run the recorded operations in order on a new set, erasing through saved iterators */
+function replay(r: Replay, layout: SortedSetLayout): void {
+  const set = SortedSet.create<Varnode>(r.cmp, layout);
+  const iters: (SortedSetIterator<Varnode> | undefined)[] = new Array(r.keys.length);
+  for (let i = 0; i < r.ops.length; ++i) {
+    const vn = r.keys[r.args[i]];
+    switch (r.ops[i]) {
+      case 'i': {
+        const [it, inserted] = set.insert(vn);
+        if (inserted) iters[r.args[i]] = it;
+        break;
+      }
+      case 'e': {
+        const it = iters[r.args[i]];
+        if (it !== undefined) set.erase(it);
+        break;
+      }
+      case 'l': set.lower_bound(vn); break;
+      case 'u': set.upper_bound(vn); break;
+      case 'f': set.find(vn); break;
+    }
+  }
+}
+
+const replays = trace.sets.map(rebuild);
+const LAYOUTS = ['rbtree', 'chunked'] as const;
+/** Timed rounds of the erase bench, each on sets filled beforehand */
+const ERASE_ROUNDS = 10;
+
+for (const treeName of ['loc_tree', 'def_tree'] as const) {
+  const trees = replays.filter((_, i) => trace.sets[i].tree === treeName);
+
+  describe(treeName + ' replay', () => {
+    for (const layout of LAYOUTS)
+      bench(layout, () => { for (const r of trees) replay(r, layout); });
+  });
+
+  describe(treeName + ' insert', () => {
+    for (const layout of LAYOUTS)
+      bench(layout, () => { for (const r of trees) fill(r, layout); });
+  });
+
+  describe(treeName + ' erase', () => {
+    for (const layout of LAYOUTS) {
+      // Each round takes sets filled by setup, so only the erasing is timed. There is no
+      // warmup round to fill for: the replay bench has already run the same erase path.
+      let stock: Filled[][] = [];
+      bench(layout, () => {
+        const round = stock.pop();
+        if (round === undefined) throw new Error('erase bench ran more rounds than were filled');
+        trees.forEach((r, k) => {
+          const { set, iters } = round[k];
+          for (let i = 0; i < r.ops.length; ++i) {
+            if (r.ops[i] !== 'e') continue;
+            const it = iters[r.args[i]];
+            if (it === undefined) continue;
+            set.erase(it);
+            iters[r.args[i]] = undefined;
+          }
+        });
+      }, {
+        time: 0, iterations: ERASE_ROUNDS, warmupTime: 0, warmupIterations: 0,
+        setup: (_task, mode) => {
+          if (mode !== 'warmup')
+            stock = Array.from({ length: ERASE_ROUNDS }, () => trees.map(r => fill(r, layout)));
+        },
+      });
+    }
+  });
+
+  describe(treeName + ' search', () => {
+    for (const layout of LAYOUTS) {
+      const filled = trees.map(r => fill(r, layout).set);
+      bench(layout, () => {
+        trees.forEach((r, k) => {
+          const set = filled[k];
+          for (let i = 0; i < r.ops.length; ++i) {
+            switch (r.ops[i]) {
+              case 'l': set.lower_bound(r.keys[r.args[i]]); break;
+              case 'u': set.upper_bound(r.keys[r.args[i]]); break;
+              case 'f': set.find(r.keys[r.args[i]]); break;
+            }
+          }
+        });
+      });
+    }
+  });
+
+  describe(treeName + ' iteration', () => {
+    for (const layout of LAYOUTS) {
+      const filled = trees.map(r => fill(r, layout).set);
+      bench(layout, () => {
+        let count = 0;
+        for (const set of filled) {
+          const end = set.end();
+          for (const it = set.begin(); !it.equals(end); it.next()) count += it.value.getSize();
+        }
+        if (count === 0) throw new Error('empty walk');
+      });
+    }
+  });
+}
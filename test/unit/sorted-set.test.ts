@@ -1,10 +1,11 @@
 /**
  * @file sorted-set.test.ts
- * @description Comprehensive tests for the red-black tree SortedSet and SortedMap.
+ * @description Comprehensive tests for the red-black tree SortedSet and SortedMap, and
+ * the chunked layout checked against them.
  */
 
 import { describe, it, expect } from 'vitest';
-import { SortedSet, SortedMap } from '../../src/util/sorted-set.js';
+import { SortedSet, SortedMap, ChunkedSortedSet } from '../../src/util/sorted-set.js';
 
 const numcmp = (a: number, b: number) => a - b;
 
@@ -183,6 +184,29 @@ describe('SortedSet', () => {
     expect(s.begin().isEnd).toBe(true);
   });
 
+  it('clear with recycling refills correctly from kept nodes', () => {
+    const s = new SortedSet<number>(numcmp);
+    for (let i = 0; i < 100; i++) s.insert((i * 37) % 100);
+    s.clear(true);
+    expect(s.size).toBe(0);
+    for (let i = 0; i < 150; i++) s.insert((i * 53) % 150);
+    expect([...s]).toEqual(Array.from({ length: 150 }, (_v, i) => i));
+    s.erase(s.find(75));
+    expect(s.has(75)).toBe(false);
+    expect(s.size).toBe(149);
+  });
+
+  it('clear without recycling drops the nodes kept by an earlier clear', () => {
+    const s = new SortedSet<number>(numcmp);
+    for (let i = 0; i < 10; i++) s.insert(i);
+    s.clear(true);
+    expect(s._spare!.length).toBe(10);
+    s.clear();
+    expect(s._spare).toBe(null);
+    s.insert(3);
+    expect([...s]).toEqual([3]);
+  });
+
   // -- iterator stability --
   it('iterators survive insertion of other elements', () => {
     const s = new SortedSet<number>(numcmp);
@@ -408,3 +432,102 @@ describe('SortedMap', () => {
     expect(m.get(1)).toBeUndefined();
   });
 });
+
+// ---------------------------------------------------------------------------
+// ChunkedSortedSet
+// ---------------------------------------------------------------------------
+describe('ChunkedSortedSet', () => {
+  it('matches the red-black tree through random inserts and erases', () => {
+    const tree = new SortedSet<number>(numcmp);
+    const chunked = new ChunkedSortedSet<number>(numcmp);
+    let seed = 7;
+    const rand = (n: number) => {
+      seed = (seed * 1103515245 + 12345) & 0x7fffffff;
+      return seed % n;
+    };
+    // Enough elements to split and merge chunks many times
+    for (let round = 0; round < 20000; round++) {
+      const v = rand(3000);
+      if (rand(3) === 0) {
+        const a = tree.lower_bound(v);
+        const b = chunked.lower_bound(v);
+        expect(b.isEnd).toBe(a.isEnd);
+        if (!a.isEnd) {
+          expect(b.value).toBe(a.value);
+          const an = tree.erase(a);
+          const bn = chunked.erase(b);
+          expect(bn.isEnd ? -1 : bn.value).toBe(an.isEnd ? -1 : an.value);
+        }
+      } else {
+        const [, ok1] = tree.insert(v);
+        const [it, ok2] = chunked.insert(v);
+        expect(ok2).toBe(ok1);
+        expect(it.value).toBe(v);
+      }
+    }
+    expect(chunked.size).toBe(tree.size);
+    expect([...chunked]).toEqual([...tree]);
+    const back: number[] = [];
+    for (let it = chunked.rbegin(); !it.isEnd; it.prev()) back.push(it.value);
+    expect(back.reverse()).toEqual([...tree]);
+  });
+
+  it('iterators keep their element across splits and merges', () => {
+    const s = SortedSet.create<number>(numcmp, 'chunked');
+    for (let i = 0; i < 1000; i += 2) s.insert(i);
+    const it = s.find(500);
+    const end = s.end();
+    for (let i = 1; i < 1000; i += 2) s.insert(i);         // Split the chunks
+    expect(it.value).toBe(500);
+    expect(it.clone().next().value).toBe(501);
+    for (let i = 0; i < 1000; i++)
+      if (i !== 500 && i !== 10) s.eraseValue(i);         // Merge them again
+    expect(it.clone().prev().value).toBe(10);
+    expect(it.clone().next().equals(end)).toBe(true);
+    expect(s.find(500).equals(it)).toBe(true);
+  });
+
+  it('erasing through a stale iterator removes only its own element', () => {
+    const s = new ChunkedSortedSet<{ k: number }>((a, b) => a.k - b.k);
+    const first = { k: 1 };
+    const [it] = s.insert(first);
+    s.erase(s.find(first));
+    s.insert({ k: 1 });                                    // An equal but different element
+    const nxt = s.erase(it);
+    expect(s.size).toBe(1);
+    expect(nxt.value.k).toBe(1);
+    it.next();                                             // Steps past its old place
+    expect(it.isEnd).toBe(true);
+  });
+
+  it('erases through an old iterator after the element\'s key has changed', () => {
+    // VarnodeBank and PcodeOpBank change an element's sort key before erasing it
+    const s = new ChunkedSortedSet<{ k: number | null }>((a, b) => a.k! - b.k!);
+    const elems: { k: number | null }[] = [];
+    for (let i = 0; i < 1000; i++) elems.push({ k: i });
+    const its = elems.map(e => s.insert(e)[0]);
+    for (let i = 0; i < 1000; i += 3) s.eraseValue(elems[i]);   // Shift, split and merge around them
+    const victim = elems[500];
+    victim.k = null;                                        // Comparing it would now fail
+    const nxt = s.erase(its[500]);
+    expect(s.size).toBe(1000 - 334 - 1);
+    expect(nxt.value).toBe(elems[502]);
+    expect(s.find({ k: 499 }).value).toBe(elems[499]);
+    expect(s.find({ k: 502 }).value).toBe(elems[502]);
+    // Iterators kept from insertion still step correctly after all the changes
+    expect(its[499].clone().next().value).toBe(elems[502]);
+    expect(its[502].clone().prev().value).toBe(elems[499]);
+  });
+
+  it('runs SortedMap entries in the chunked layout', () => {
+    const m = new SortedMap<number, string>(numcmp, 'chunked');
+    for (let i = 199; i >= 0; i--) m.set(i, 'v' + i);
+    expect(m.get(150)).toBe('v150');
+    expect(m.lower_bound(150).key).toBe(150);
+    expect(m.upper_bound(150).key).toBe(151);
+    expect(m.delete(150)).toBe(true);
+    expect([...m.keys()].length).toBe(199);
+    m.clear();
+    expect(m.begin().isEnd).toBe(true);
+  });
+});
@@ -1066,3 +1066,56 @@ describe('marshal XML additional coverage', () => {
     decoder.closeElement(el);
   });
 });
+
+// ---------------------------------------------------------------------------
+// Test: large binary payloads (packed)
+//
+// Load image snapshots carry raw chunk bytes as string attributes.
+// ---------------------------------------------------------------------------
+
+describe('marshal packed binary payloads', () => {
+  it('packed: round-trips a large latin1 string attribute', () => {
+    const len = 300000;
+    let payload = '';
+    for (let i = 0; i < len; ++i) {
+      payload += String.fromCharCode((i * 7 + (i >> 8)) & 0xff);
+    }
+    const encoder = new PackedEncode();
+    encoder.openElement(ELEM_DATA);
+    encoder.writeString(ATTRIB_CONTENT, payload);
+    encoder.writeString(ATTRIB_NAME, 'tail');
+    encoder.closeElement(ELEM_DATA);
+    const bytes = encoder.toBytes();
+    expect(bytes.length).toBe(encoder.size());
+
+    const decoder = new PackedDecode(null);
+    decoder.ingestBytes(bytes);
+    const el = decoder.openElementId(ELEM_DATA);
+    expect(decoder.readStringById(ATTRIB_CONTENT)).toBe(payload);
+    expect(decoder.readStringById(ATTRIB_NAME)).toBe('tail');
+    decoder.closeElement(el);
+  });
+
+  it('packed: round-trips raw bytes without a string', () => {
+    const payload = new Uint8Array(200000);
+    for (let i = 0; i < payload.length; ++i) {
+      payload[i] = (i * 13 + (i >> 9)) & 0xff;
+    }
+    const encoder = new PackedEncode();
+    encoder.openElement(ELEM_DATA);
+    encoder.writeBytes(ATTRIB_CONTENT, payload);
+    encoder.writeString(ATTRIB_NAME, 'tail');
+    encoder.closeElement(ELEM_DATA);
+
+    const decoder = new PackedDecode(null);
+    decoder.ingestBytes(encoder.toBytes());
+    const el = decoder.openElementId(ELEM_DATA);
+    const res = decoder.readBytesById(ATTRIB_CONTENT);
+    expect(res).toEqual(payload);
+    expect(res.buffer.byteLength).toBe(payload.length);
+    // Same wire format as writeString() with one character per byte
+    expect(decoder.readStringById(ATTRIB_CONTENT).charCodeAt(1000)).toBe(payload[1000]);
+    expect(decoder.readStringById(ATTRIB_NAME)).toBe('tail');
+    decoder.closeElement(el);
+  });
+});
@@ -0,0 +1,82 @@
+/**
+ * @file tokenstream.test.ts
+ * @description Tests that the packed token stream decodes to the markup EmitMarkup writes as XML.
+ */
+
+import { describe, it, expect } from 'vitest';
+import { EmitPrettyPrint, syntax_highlight } from '../../src/decompiler/prettyprint.js';
+import { EmitPackedTokens, decodeTokenStream, tokenStreamToXml } from '../../src/decompiler/tokenstream.js';
+import { StringWriter } from '../../src/util/writer.js';
+
+const ram: any = { getName: () => 'ram' };
+
+/** Emit a function whose statements repeat the same tokens, with a comment and a label */
+function emitBody(emit: EmitPrettyPrint, lines: number): void {
+  const func = emit.beginFunction(null);
+  emit.tagComment('/* entry */', syntax_highlight.comment_color, ram, 0x401000n);
+  emit.tagLine();
+  emit.tagLabel('LAB_00401000', syntax_highlight.no_color, ram, 0x401000n);
+  for (let k = 0; k < lines; ++k) {
+    emit.tagLine();
+    const st = emit.beginStatement({ getTime: () => k });
+    emit.tagVariable('iVar' + (k % 3), syntax_highlight.var_color, { getCreateIndex: () => k }, null);
+    emit.spaces(1);
+    emit.tagOp('=', syntax_highlight.no_color, { getTime: () => k });
+    emit.spaces(1);
+    const paren = emit.openParen('(', 1);
+    emit.print('é' + (k % 2), syntax_highlight.const_color);
+    emit.closeParen(')', paren);
+    emit.print(';');
+    emit.endStatement(st);
+  }
+  emit.tagLine();
+  emit.endFunction(func);
+  emit.flush();
+}
+
+function render(packed: boolean, lines: number): string {
+  const emit = new EmitPrettyPrint();
+  const out = new StringWriter();
+  emit.setOutputStream(out);
+  if (packed) {
+    emit.setLowlevel(new EmitPackedTokens());
+  } else {
+    emit.setMarkup(true);
+    emit.setPackedOutput(false);
+  }
+  emitBody(emit, lines);
+  return out.toString();
+}
+
+/**
+ * Number paren ids in order of first use.  The ids come from a counter shared by every
+ * print, so two prints of the same body differ in them; the pairing of each open with its
+ * close is what must agree.
+ */
+function renumberParens(xml: string): string {
+  const ids = new Map<string, number>();
+  return xml.replace(/ (open|close)="([^"]*)"/g, (_m, attr: string, id: string) => {
+    if (!ids.has(id)) ids.set(id, ids.size);
+    return ` ${attr}="${ids.get(id)}"`;
+  });
+}
+
+describe('EmitPackedTokens', () => {
+  it('decodes to the XML markup', () => {
+    const xml = render(false, 20);
+    const tokens = decodeTokenStream(render(true, 20));
+    expect(tokens.length).toBe(1);
+    expect(tokens[0].tag).toBe('function');
+    expect(xml).toContain(' open="');
+    expect(renumberParens(tokenStreamToXml(tokens))).toBe(renumberParens(xml));
+    // The label's address is a reference to the comment's
+    const label = tokens[0].children.find(t => t.tag === 'label')!;
+    expect(label.attributes).toEqual([['space', 'ram'], ['off', 0x401000n]]);
+  });
+
+  it('is several times smaller than the XML', () => {
+    const xml = render(false, 200);
+    const bytes = Buffer.from(render(true, 200), 'base64');
+    expect(bytes.length * 3).toBeLessThan(xml.length);
+  });
+});
@@ -0,0 +1,107 @@
+/**
+ * @file typefactory.test.ts
+ * @description Tests the hash-consed lookups and core type tables of TypeFactory.
+ */
+
+import { describe, it, expect, beforeAll } from 'vitest';
+import '../../src/console/xml_arch.js';
+import { startDecompilerLibrary } from '../../src/console/libdecomp.js';
+import { TypeFactory, DEFAULT_CORE_TYPES, DT_coretype, type_metatype } from '../../src/decompiler/type.js';
+import { ArchitectureCapability } from '../../src/decompiler/architecture.js';
+import { DocumentStorage } from '../../src/core/xml.js';
+
+function buildArch(coreTypes: any = null): any {
+  const capa = ArchitectureCapability.getCapability('xml');
+  const store = new DocumentStorage();
+  const doc = store.parseDocument(`<decompilertest><binaryimage arch="x86:LE:64:default:gcc"><bytechunk space="ram" offset="0x100000" readonly="true">00</bytechunk></binaryimage></decompilertest>`);
+  for (const child of doc.getRoot().getChildren()) {
+    if (child.getName() === 'binaryimage') {
+      store.registerTag(child);
+      break;
+    }
+  }
+  const arch: any = capa!.buildArchitecture('test', '', { write: () => {} });
+  if (coreTypes !== null) arch.setCoreTypeTable(coreTypes);
+  arch.init(store);
+  return arch;
+}
+
+describe('TypeFactory', () => {
+  let types: TypeFactory;
+
+  beforeAll(() => {
+    startDecompilerLibrary();
+    types = buildArch().types;
+  });
+
+  it('returns the same pointer and array objects for the same structure', () => {
+    const int4 = types.findByName('int4')!;
+    const uint4 = types.findByName('uint4')!;
+    const p1 = types.getTypePointer(8, int4, 1);
+    expect(types.getTypePointer(8, int4, 1)).toBe(p1);
+    expect(types.getTypePointer(8, uint4, 1)).not.toBe(p1);
+    expect(types.getTypePointer(4, int4, 1)).not.toBe(p1);
+    expect(types.getTypePointer(8, p1, 1)).toBe(types.getTypePointer(8, p1, 1));
+
+    const a1 = types.getTypeArray(10, int4);
+    expect(types.getTypeArray(10, int4)).toBe(a1);
+    expect(types.getTypeArray(10, uint4)).not.toBe(a1);
+    expect(types.getTypeArray(10, int4).getSize()).toBe(40);
+  });
+
+  it('finds named data-types by id after a rename', () => {
+    const st = types.getTypeStruct('hashcons_test');
+    expect(types.getTypeStruct('hashcons_test')).toBe(st);
+    expect(types.findById('hashcons_test', st.getId(), 0)).toBe(st);
+
+    const ptr = types.getTypePointer(8, types.findByName('int2')!, 1);
+    types.setName(ptr, 'int2ptr');
+    expect(types.findByName('int2ptr')).toBe(ptr);
+    // The renamed pointer is no longer anonymous, so a new one is made
+    expect(types.getTypePointer(8, types.findByName('int2')!, 1)).not.toBe(ptr);
+  });
+
+  it('exports its core data-types as a table that rebuilds them', () => {
+    const table = types.exportCoreTable()!;
+    expect(table).not.toBeNull();
+    expect(Object.isFrozen(table)).toBe(true);
+    const names = (t: readonly { name: string }[]) => t.map(e => e.name).sort();
+    expect(names(table)).toEqual(names(DEFAULT_CORE_TYPES));
+
+    const custom = [...JSON.parse(JSON.stringify(table)),
+      { name: 'int16', size: 16, metatype: type_metatype.TYPE_INT, chartp: false }];
+    const other: TypeFactory = buildArch(custom).types;
+    expect(other.findByName('int16')!.getSize()).toBe(16);
+    expect(other.getBase(4, type_metatype.TYPE_INT).getName()).toBe('int4');
+    expect(other.getTypeChar(1).getName()).toBe('char');
+  });
+
+  it('exports core typedefs and display formats', () => {
+    const own: TypeFactory = buildArch().types;
+    const hex = own.findByName('uint2')!;
+    hex.setDisplayFormat(1);
+    const size = own.getTypedef(own.findByName('uint8')!, 'size_t', 0n, 2);
+    (size as any).flags |= DT_coretype;
+    const ssize = own.getTypedef(size, 'ssize_t', 0n, 0);
+    (ssize as any).flags |= DT_coretype;
+
+    const table = own.exportCoreTable();
+    const last = table.slice(-2).map(e => e.name);
+    expect(last).toEqual(['size_t', 'ssize_t']);         // After their targets
+    const other: TypeFactory = buildArch(JSON.parse(JSON.stringify(table))).types;
+    expect(other.findByName('uint2')!.getDisplayFormat()).toBe(1);
+    const size2 = other.findByName('size_t')!;
+    expect(size2.getTypedef()!.getName()).toBe('uint8');
+    expect(size2.getDisplayFormat()).toBe(2);
+    expect(size2.getId()).toBe(size.getId());
+    expect(size2.isCoreType()).toBe(true);
+    expect(other.findByName('ssize_t')!.getTypedef()).toBe(size2);
+  });
+
+  it('refuses to export a core typedef of a non-core data-type', () => {
+    const own: TypeFactory = buildArch().types;
+    const user = own.getBaseNamed(4, type_metatype.TYPE_INT, 'user_int');
+    (own.getTypedef(user, 'core_alias', 0n, 0) as any).flags |= DT_coretype;
+    expect(() => own.exportCoreTable()).toThrow(/core_alias/);
+  });
+});
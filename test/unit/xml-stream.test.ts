@@ -0,0 +1,50 @@
+/**
+ * @file xml-stream.test.ts
+ * @description Tests for parsing XML files incrementally with binary content decoded in place.
+ */
+
+import { describe, it, expect, afterEach } from 'vitest';
+import * as fs from 'fs';
+import * as os from 'os';
+import { join } from 'path';
+import { DocumentStorage, BinaryContentElement, xml_tree } from '../../src/core/xml.js';
+
+describe('DocumentStorage.openDocumentStream', () => {
+  let dir: string | null = null;
+
+  afterEach(() => {
+    if (dir !== null) fs.rmSync(dir, { recursive: true, force: true });
+    dir = null;
+  });
+
+  it('matches the string parser across refill boundaries and decodes bytechunks', () => {
+    dir = fs.mkdtempSync(join(os.tmpdir(), 'xml-stream-test-'));
+    // Larger than several parser blocks, so refills and compaction both happen mid-element
+    let hex = '';
+    for (let i = 0; i < 3 * (1 << 20); ++i) hex += (i & 0xff).toString(16).padStart(2, '0');
+    const xml = '<binaryimage arch="x86:LE:64:default">\n' +
+      '<bytechunk space="ram" offset="0x1000" readonly="true">\n' + hex + '\n</bytechunk>\n' +
+      '<symbol space="ram" offset="0x1000" name="main"/>\n' +
+      '</binaryimage>\n';
+    const path = join(dir, 'image.xml');
+    fs.writeFileSync(path, xml);
+
+    const doc = new DocumentStorage().openDocumentStream(path);
+    const ref = xml_tree(xml);
+    const root = doc.getRoot();
+    expect(root.getName()).toBe('binaryimage');
+    expect(root.getAttributeValue('arch')).toBe(ref.getRoot().getAttributeValue('arch'));
+    const [chunk, sym] = root.getChildren();
+    expect(chunk).toBeInstanceOf(BinaryContentElement);
+    const bytes = (chunk as BinaryContentElement).getBytes();
+    expect(bytes.length).toBe(3 * (1 << 20));
+    expect(bytes.buffer.byteLength).toBe(bytes.length);     // No spare capacity kept alive
+    expect(bytes[0x1ff]).toBe(0xff);
+    expect(bytes[bytes.length - 1]).toBe((bytes.length - 1) & 0xff);
+    expect(sym.getAttributeValue('name')).toBe('main');
+  });
+
+  it('reports a parse error for a missing file', () => {
+    expect(() => new DocumentStorage().openDocumentStream('/nonexistent/image.xml')).toThrow();
+  });
+});